@@ -0,0 +1,326 @@
+#include "adjacency_index.h"
+#include "persistence.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace gtaf::core {
+
+namespace {
+
+// Recent edges tolerated before merging: at least this many, or a quarter
+// of the compacted edges, so merge cost stays amortized O(1) per edge
+constexpr size_t kMinRecentEdges = 1024;
+
+template<typename T>
+void write_array(BinaryWriter& writer, const std::vector<T>& values) {
+    writer.write_u64(values.size());
+    writer.write_bytes(values.data(), values.size() * sizeof(T));
+}
+
+template<typename T>
+std::vector<T> read_array(BinaryReader& reader, size_t max_count) {
+    uint64_t count = reader.read_u64();
+    if (count > max_count) {
+        throw std::runtime_error("Adjacency array too large");
+    }
+    std::vector<T> values(count);
+    reader.read_bytes(values.data(), count * sizeof(T));
+    return values;
+}
+
+} // namespace
+
+// ---- Csr ----
+
+std::pair<uint32_t, uint32_t> AdjacencyIndex::Csr::compacted_range(uint32_t row) const {
+    if (row < row_begin || row - row_begin + 1 >= offsets.size()) {
+        return {0, 0};
+    }
+    const size_t r = row - row_begin;
+    return {offsets[r], offsets[r + 1]};
+}
+
+void AdjacencyIndex::Csr::add(uint32_t row, uint32_t target, uint64_t lsn) {
+    RecentRow& pending = recent[row];
+    pending.targets.push_back(target);
+    pending.lsns.push_back(lsn);
+    if (!pending.ends.empty()) {
+        pending.ends.push_back(Neighbours::kLive);
+    }
+    if (++recent_count > std::max(kMinRecentEdges, targets.size() / 4)) {
+        compact();
+    }
+}
+
+bool AdjacencyIndex::Csr::retire(uint32_t row, uint32_t target, uint64_t lsn) {
+    // Each run allocates its end LSNs on first retirement
+    auto stamp = [&](std::vector<uint64_t>& run_ends, size_t run_size, size_t first, size_t last,
+                     const uint32_t* run_targets) {
+        for (size_t i = first; i < last; ++i) {
+            if (run_targets[i] != target || (!run_ends.empty() && run_ends[i] != Neighbours::kLive)) {
+                continue;
+            }
+            if (run_ends.empty()) {
+                run_ends.assign(run_size, Neighbours::kLive);
+            }
+            run_ends[i] = lsn;
+            return true;
+        }
+        return false;
+    };
+
+    const auto [first, last] = compacted_range(row);
+    if (stamp(ends, targets.size(), first, last, targets.data())) {
+        return true;
+    }
+    if (auto it = recent.find(row); it != recent.end()) {
+        RecentRow& pending = it->second;
+        return stamp(pending.ends, pending.targets.size(), 0, pending.targets.size(), pending.targets.data());
+    }
+    return false;
+}
+
+void AdjacencyIndex::Csr::compact() {
+    if (recent_count == 0) {
+        return;
+    }
+
+    // New row range covers the compacted rows and every recent row
+    const size_t old_rows = offsets.empty() ? 0 : offsets.size() - 1;
+    uint32_t begin = old_rows > 0 ? row_begin : recent.begin()->first;
+    uint32_t end = old_rows > 0 ? static_cast<uint32_t>(row_begin + old_rows) : begin;
+    for (const auto& [row, list] : recent) {
+        begin = std::min(begin, row);
+        end = std::max(end, row + 1);
+    }
+
+    const size_t rows = end - begin;
+    std::vector<uint32_t> new_offsets(rows + 1, 0);
+    for (size_t r = 0; r < old_rows; ++r) {
+        new_offsets[row_begin - begin + r + 1] = offsets[r + 1] - offsets[r];
+    }
+    for (const auto& [row, pending] : recent) {
+        new_offsets[row - begin + 1] += static_cast<uint32_t>(pending.targets.size());
+    }
+    for (size_t r = 0; r < rows; ++r) {
+        new_offsets[r + 1] += new_offsets[r];
+    }
+
+    // End LSNs stay unallocated until some edge was retired
+    bool retired = !ends.empty();
+    for (const auto& [row, pending] : recent) {
+        retired |= !pending.ends.empty();
+    }
+
+    // Each row keeps its compacted neighbours first, then recent ones
+    std::vector<uint32_t> new_targets(new_offsets.back());
+    std::vector<uint64_t> new_lsns(new_offsets.back());
+    std::vector<uint64_t> new_ends(retired ? new_offsets.back() : 0, Neighbours::kLive);
+    for (size_t r = 0; r < old_rows; ++r) {
+        const uint32_t dest = new_offsets[row_begin - begin + r];
+        std::copy(targets.begin() + offsets[r], targets.begin() + offsets[r + 1], new_targets.begin() + dest);
+        std::copy(lsns.begin() + offsets[r], lsns.begin() + offsets[r + 1], new_lsns.begin() + dest);
+        if (!ends.empty()) {
+            std::copy(ends.begin() + offsets[r], ends.begin() + offsets[r + 1], new_ends.begin() + dest);
+        }
+    }
+    for (const auto& [row, pending] : recent) {
+        const auto [first, last] = compacted_range(row);
+        const uint32_t dest = new_offsets[row - begin] + (last - first);
+        std::copy(pending.targets.begin(), pending.targets.end(), new_targets.begin() + dest);
+        std::copy(pending.lsns.begin(), pending.lsns.end(), new_lsns.begin() + dest);
+        if (!pending.ends.empty()) {
+            std::copy(pending.ends.begin(), pending.ends.end(), new_ends.begin() + dest);
+        }
+    }
+
+    row_begin = begin;
+    offsets = std::move(new_offsets);
+    targets = std::move(new_targets);
+    lsns = std::move(new_lsns);
+    ends = std::move(new_ends);
+    recent.clear();
+    recent_count = 0;
+}
+
+// ---- AdjacencyIndex ----
+
+std::optional<AdjacencyIndex::RelationId> AdjacencyIndex::find_relation(const std::string& relation) const {
+    auto it = m_relation_ids.find(relation);
+    if (it == m_relation_ids.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+AdjacencyIndex::RelationId AdjacencyIndex::intern(const std::string& relation) {
+    auto [it, inserted] = m_relation_ids.try_emplace(relation, static_cast<RelationId>(m_relations.size()));
+    if (inserted) {
+        m_relations.push_back({relation, {}, {}});
+    }
+    return it->second;
+}
+
+Neighbours AdjacencyIndex::neighbours(uint32_t ordinal, RelationId relation, EdgeDirection direction) const {
+    if (relation >= m_relations.size()) {
+        return {};
+    }
+    const Csr& csr = direction == EdgeDirection::Outgoing ? m_relations[relation].out : m_relations[relation].in;
+    Neighbours result;
+    const auto [first, last] = csr.compacted_range(ordinal);
+    result.compacted = std::span<const uint32_t>(csr.targets.data() + first, last - first);
+    result.compacted_lsns = std::span<const uint64_t>(csr.lsns.data() + first, last - first);
+    if (!csr.ends.empty()) {
+        result.compacted_ends = std::span<const uint64_t>(csr.ends.data() + first, last - first);
+    }
+    if (csr.recent_count > 0) {
+        if (auto it = csr.recent.find(ordinal); it != csr.recent.end()) {
+            result.recent = it->second.targets;
+            result.recent_lsns = it->second.lsns;
+            result.recent_ends = it->second.ends;
+        }
+    }
+    return result;
+}
+
+bool AdjacencyIndex::add_edge(uint32_t source, RelationId relation, uint32_t target,
+                              types::LogSequenceNumber lsn) {
+    Relation& r = m_relations[relation];
+
+    // Duplicate check walks the source's live forward list: O(out-degree)
+    bool present = false;
+    neighbours(source, relation, EdgeDirection::Outgoing).for_each([&](uint32_t existing) {
+        present |= existing == target;
+    });
+    if (present) {
+        return false;
+    }
+
+    r.out.add(source, target, lsn.value);
+    r.in.add(target, source, lsn.value);
+    ++m_edge_count;
+    return true;
+}
+
+bool AdjacencyIndex::retire_edge(uint32_t source, RelationId relation, uint32_t target,
+                                 types::LogSequenceNumber lsn) {
+    Relation& r = m_relations[relation];
+    if (!r.out.retire(source, target, lsn.value)) {
+        return false;
+    }
+    r.in.retire(target, source, lsn.value);
+    --m_edge_count;
+    return true;
+}
+
+void AdjacencyIndex::compact() {
+    for (auto& relation : m_relations) {
+        relation.out.compact();
+        relation.in.compact();
+    }
+}
+
+void AdjacencyIndex::clear() {
+    m_relations.clear();
+    m_relation_ids.clear();
+    m_edge_count = 0;
+}
+
+size_t AdjacencyIndex::memory_bytes() const noexcept {
+    size_t bytes = m_relations.capacity() * sizeof(Relation);
+    for (const auto& relation : m_relations) {
+        for (const Csr* csr : {&relation.out, &relation.in}) {
+            bytes += (csr->offsets.capacity() + csr->targets.capacity()) * sizeof(uint32_t);
+            bytes += (csr->lsns.capacity() + csr->ends.capacity()) * sizeof(uint64_t);
+            for (const auto& [row, pending] : csr->recent) {
+                bytes += sizeof(row) + sizeof(pending) + 2 * sizeof(void*) +
+                         pending.targets.capacity() * sizeof(uint32_t) +
+                         (pending.lsns.capacity() + pending.ends.capacity()) * sizeof(uint64_t);
+            }
+        }
+    }
+    return bytes;
+}
+
+void AdjacencyIndex::write_to(BinaryWriter& writer) const {
+    size_t entries = 0;   // Live and retired edges
+    for (const auto& relation : m_relations) {
+        entries += relation.out.targets.size() + relation.out.recent_count;
+    }
+    writer.write_u64(m_relations.size());
+    writer.write_u64(m_edge_count);
+    writer.write_u64(entries);
+    for (const auto& relation : m_relations) {
+        writer.write_string(relation.name);
+        for (const Csr* csr : {&relation.out, &relation.in}) {
+            // Saved files hold only compacted rows; merge a copy if needed
+            Csr merged;
+            if (csr->recent_count > 0) {
+                merged = *csr;
+                merged.compact();
+                csr = &merged;
+            }
+            writer.write_u32(csr->row_begin);
+            write_array(writer, csr->offsets);
+            write_array(writer, csr->targets);
+            write_array(writer, csr->lsns);
+            write_array(writer, csr->ends);
+        }
+    }
+}
+
+AdjacencyIndex AdjacencyIndex::read_from(BinaryReader& reader, size_t entity_count) {
+    AdjacencyIndex index;
+    uint64_t relation_count = reader.read_u64();
+    index.m_edge_count = reader.read_u64();
+    const uint64_t entries = reader.read_u64();
+
+    size_t total_entries = 0;
+    size_t live_edges = 0;
+    for (uint64_t i = 0; i < relation_count; ++i) {
+        RelationId id = index.intern(reader.read_string());
+        if (id != i) {
+            throw std::runtime_error("Duplicate adjacency relation");
+        }
+        Relation& relation = index.m_relations[id];
+        for (Csr* csr : {&relation.out, &relation.in}) {
+            csr->row_begin = reader.read_u32();
+            csr->offsets = read_array<uint32_t>(reader, entity_count + 1);
+            csr->targets = read_array<uint32_t>(reader, entries);
+            csr->lsns = read_array<uint64_t>(reader, entries);
+            csr->ends = read_array<uint64_t>(reader, entries);
+
+            // Offsets must be monotonic and end at the target count, and
+            // LSNs sorted within each row (as_of() binary-searches them)
+            const auto& offsets = csr->offsets;
+            bool ok = csr->lsns.size() == csr->targets.size() &&
+                      (csr->ends.empty() || csr->ends.size() == csr->targets.size()) &&
+                      (offsets.empty() ? csr->targets.empty()
+                                       : offsets.front() == 0 && offsets.back() == csr->targets.size() &&
+                                         csr->row_begin + offsets.size() - 1 <= entity_count);
+            for (size_t r = 1; ok && r < offsets.size(); ++r) {
+                ok = offsets[r - 1] <= offsets[r] &&
+                     std::is_sorted(csr->lsns.begin() + offsets[r - 1], csr->lsns.begin() + offsets[r]);
+            }
+            for (uint32_t target : csr->targets) {
+                ok &= target < entity_count;
+            }
+            if (!ok) {
+                throw std::runtime_error("Inconsistent adjacency data");
+            }
+        }
+        if (relation.out.targets.size() != relation.in.targets.size()) {
+            throw std::runtime_error("Adjacency directions disagree");
+        }
+        total_entries += relation.out.targets.size();
+        live_edges += relation.out.ends.empty()
+            ? relation.out.targets.size()
+            : static_cast<size_t>(std::count(relation.out.ends.begin(), relation.out.ends.end(), Neighbours::kLive));
+    }
+    if (total_entries != entries || live_edges != index.m_edge_count) {
+        throw std::runtime_error("Adjacency edge count mismatch");
+    }
+    return index;
+}
+
+} // namespace gtaf::core
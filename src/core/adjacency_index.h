@@ -0,0 +1,258 @@
+#pragma once
+
+#include "../types/types.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gtaf::core {
+
+class AtomStore;
+class BinaryWriter;
+class BinaryReader;
+
+/**
+ * @brief Direction of an adjacency lookup
+ */
+enum class EdgeDirection : uint8_t {
+    Outgoing = 0,  // source -> targets
+    Incoming = 1   // target -> sources
+};
+
+/**
+ * @brief Neighbour ordinals of one entity in one relation and direction
+ *
+ * Most neighbours sit in the compacted CSR array; edges added since the
+ * last compaction are in a second, per-entity contiguous run. Each edge
+ * carries the LSN at which it became visible, non-decreasing along the
+ * compacted run followed by the recent run, and the LSN at which it was
+ * retired (kLive while current); the ends spans are empty when no edge
+ * of the run was retired. The runs include retired edges: visit them
+ * with for_each(), which skips edges not visible at the lookup's LSN.
+ * All spans stay valid until the next append to the owning store.
+ */
+struct Neighbours {
+    static constexpr uint64_t kLive = std::numeric_limits<uint64_t>::max();
+
+    std::span<const uint32_t> compacted;
+    std::span<const uint32_t> recent;
+    std::span<const uint64_t> compacted_lsns;   // Parallel to compacted
+    std::span<const uint64_t> recent_lsns;      // Parallel to recent
+    std::span<const uint64_t> compacted_ends;   // Empty, or parallel to compacted
+    std::span<const uint64_t> recent_ends;      // Empty, or parallel to recent
+    types::LogSequenceNumber at;                // Set by as_of() (invalid: latest)
+
+    /**
+     * @brief Number of visible neighbours (O(degree) once edges were retired)
+     */
+    [[nodiscard]] size_t size() const noexcept {
+        size_t count = 0;
+        for_each([&](uint32_t) { ++count; });
+        return count;
+    }
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    /**
+     * @brief Neighbours whose edge was visible at a given LSN
+     *
+     * Trims both runs with a binary search over their LSNs; edges retired
+     * at or before the LSN are skipped when visited.
+     */
+    [[nodiscard]] Neighbours as_of(types::LogSequenceNumber lsn) const {
+        auto visible = [&](std::span<const uint64_t> lsns) {
+            return static_cast<size_t>(std::upper_bound(lsns.begin(), lsns.end(), lsn.value) - lsns.begin());
+        };
+        const size_t c = visible(compacted_lsns);
+        const size_t r = visible(recent_lsns);
+        return {compacted.first(c), recent.first(r), compacted_lsns.first(c), recent_lsns.first(r),
+                compacted_ends.empty() ? compacted_ends : compacted_ends.first(c),
+                recent_ends.empty() ? recent_ends : recent_ends.first(r), lsn};
+    }
+
+    /**
+     * @brief Invoke fn(ordinal) for every visible neighbour in insertion order
+     */
+    template<typename Fn>
+    void for_each(Fn&& fn) const {
+        visit(compacted, compacted_ends, fn);
+        visit(recent, recent_ends, fn);
+    }
+
+private:
+    template<typename Fn>
+    void visit(std::span<const uint32_t> ordinals, std::span<const uint64_t> ends, Fn& fn) const {
+        if (ends.empty()) {
+            for (uint32_t ordinal : ordinals) fn(ordinal);
+            return;
+        }
+        for (size_t i = 0; i < ordinals.size(); ++i) {
+            if (ends[i] == kLive || (at.is_valid() && at.value < ends[i])) fn(ordinals[i]);
+        }
+    }
+};
+
+/**
+ * @brief Bidirectional CSR adjacency over EdgeValue atoms, per interned relation
+ *
+ * Every reference from a source entity to an EdgeValue atom adds the edge
+ * (source, relation, target) once, stamped with the LSN of that reference
+ * (or of the target's first atom, if later); re-asserting an existing edge
+ * is a no-op. A later reference with the same tag supersedes the edge,
+ * like any latest value: the edge is retired at that LSN (unless another
+ * tag of the source still holds it) and stays visible only to as-of
+ * lookups before it. Retired edges are dropped when the store compacts
+ * the references that asserted them. For each
+ * relation the index keeps a forward (Outgoing) and a reverse (Incoming)
+ * compressed-sparse-row structure over dense entity ordinals, so a
+ * neighbour lookup is one offset read plus a contiguous scan.
+ *
+ * Appends go to a small per-entity overflow that is merged into the CSR
+ * arrays once it exceeds a fraction of the compacted size, keeping
+ * incremental maintenance amortized O(1) per edge.
+ *
+ * Owned and maintained by AtomStore (see AtomStore::adjacency()) and
+ * saved in the same file. Edges whose target has no atoms yet are parked
+ * by the store and added once the target is assigned an ordinal.
+ */
+class AdjacencyIndex {
+public:
+    using RelationId = uint32_t;
+
+    AdjacencyIndex() = default;
+
+    /**
+     * @brief Look up an interned relation name
+     *
+     * @return Relation id, or nullopt if no edge used the relation
+     */
+    [[nodiscard]] std::optional<RelationId> find_relation(const std::string& relation) const;
+
+    /**
+     * @brief Name of an interned relation (ids are 0..relation_count()-1)
+     */
+    [[nodiscard]] const std::string& relation_name(RelationId relation) const { return m_relations[relation].name; }
+
+    [[nodiscard]] size_t relation_count() const noexcept { return m_relations.size(); }
+
+    /**
+     * @brief Neighbours of an entity ordinal in one relation and direction
+     *
+     * O(1) to locate, O(degree) to visit; unknown ordinals have none.
+     * Use Neighbours::as_of() to see the graph at an earlier LSN.
+     */
+    [[nodiscard]] Neighbours neighbours(uint32_t ordinal, RelationId relation, EdgeDirection direction) const;
+
+    [[nodiscard]] Neighbours outgoing(uint32_t ordinal, RelationId relation) const {
+        return neighbours(ordinal, relation, EdgeDirection::Outgoing);
+    }
+
+    [[nodiscard]] Neighbours incoming(uint32_t ordinal, RelationId relation) const {
+        return neighbours(ordinal, relation, EdgeDirection::Incoming);
+    }
+
+    /**
+     * @brief Number of distinct resolved, unretired edges across all relations
+     */
+    [[nodiscard]] size_t edge_count() const noexcept { return m_edge_count; }
+
+    /**
+     * @brief Approximate heap footprint in bytes
+     */
+    [[nodiscard]] size_t memory_bytes() const noexcept;
+
+private:
+    friend class AtomStore;
+
+    /**
+     * @brief One direction of one relation: CSR arrays plus recent overflow
+     *
+     * Compacted rows cover ordinals [row_begin, row_begin + offsets.size() - 1),
+     * so a relation used by a contiguous block of entities (e.g. one
+     * imported table) does not pay for offsets below that block.
+     */
+    struct Csr {
+        struct RecentRow {
+            std::vector<uint32_t> targets;
+            std::vector<uint64_t> lsns;
+            std::vector<uint64_t> ends;   // Empty until an edge of the row is retired
+        };
+
+        uint32_t row_begin = 0;
+        std::vector<uint32_t> offsets;    // Empty, or rows + 1 entries
+        std::vector<uint32_t> targets;
+        std::vector<uint64_t> lsns;       // Parallel to targets
+        std::vector<uint64_t> ends;       // Empty until an edge is retired, then parallel
+        std::unordered_map<uint32_t, RecentRow> recent;
+        size_t recent_count = 0;
+
+        /**
+         * @brief Compacted [begin, end) range of a row in targets/lsns
+         */
+        [[nodiscard]] std::pair<uint32_t, uint32_t> compacted_range(uint32_t row) const;
+        void add(uint32_t row, uint32_t target, uint64_t lsn);
+
+        /**
+         * @brief Stamp the row's live edge to target as retired at lsn
+         *
+         * @return false if the row has no live edge to target
+         */
+        bool retire(uint32_t row, uint32_t target, uint64_t lsn);
+        void compact();
+    };
+
+    struct Relation {
+        std::string name;
+        Csr out;
+        Csr in;
+    };
+
+    RelationId intern(const std::string& relation);
+
+    /**
+     * @brief Add a resolved edge, visible from the given LSN on
+     *
+     * LSNs must be non-decreasing across calls so each row stays sorted.
+     *
+     * @return false if the edge was already present
+     */
+    bool add_edge(uint32_t source, RelationId relation, uint32_t target, types::LogSequenceNumber lsn);
+
+    /**
+     * @brief Retire a live edge as of an LSN (as-of lookups before it still see it)
+     *
+     * @return false if the edge was not live
+     */
+    bool retire_edge(uint32_t source, RelationId relation, uint32_t target, types::LogSequenceNumber lsn);
+
+    /**
+     * @brief Merge all recent overflow into the CSR arrays
+     */
+    void compact();
+
+    void clear();
+
+    /**
+     * @brief Serialize relations and CSR arrays (merging recent edges on the fly)
+     */
+    void write_to(BinaryWriter& writer) const;
+
+    /**
+     * @brief Deserialize an index written by write_to()
+     *
+     * @param entity_count Ordinals in the store being loaded (bounds check)
+     * @throws std::runtime_error on truncated or inconsistent data
+     */
+    static AdjacencyIndex read_from(BinaryReader& reader, size_t entity_count);
+
+    std::vector<Relation> m_relations;
+    std::unordered_map<std::string, RelationId> m_relation_ids;
+    size_t m_edge_count = 0;
+};
+
+} // namespace gtaf::core
@@ -1,19 +1,43 @@
 #include "atom_store.h"
-#include "../types/hash_utils.h"
 #include "persistence.h"
 #include <chrono>
+#include <filesystem>
 #include <algorithm>
 #include <iostream>
+#include <string_view>
 
 namespace gtaf::core {
 
+namespace {
+
+bool same_edge(const types::EdgeValue& a, const types::EdgeValue& b) {
+    return a.target == b.target && a.relation == b.relation;
+}
+
+} // namespace
+
 // ---- AtomStore Implementation ----
 
+AtomStore::~AtomStore() {
+    remove_spill_files();
+}
+
 Atom AtomStore::append(
     types::EntityId entity,
     std::string tag,
     types::AtomValue value,
     types::AtomType classification
+) {
+    Atom atom = route_append(entity, std::move(tag), std::move(value), classification);
+    notify_listeners();
+    return atom;
+}
+
+Atom AtomStore::route_append(
+    types::EntityId entity,
+    std::string tag,
+    types::AtomValue value,
+    types::AtomType classification
 ) {
     // Route to appropriate write path based on classification
     switch (classification) {
@@ -28,16 +52,373 @@ Atom AtomStore::append(
     return append_temporal(entity, std::move(tag), std::move(value));
 }
 
+AtomStore::ListenerId AtomStore::add_append_listener(AppendListener listener, ResetListener on_reset) {
+    ListenerId id = ++m_next_listener_id;
+    m_listeners.push_back({id, std::move(listener), std::move(on_reset)});
+    return id;
+}
+
+void AtomStore::remove_append_listener(ListenerId id) {
+    m_listeners.erase(
+        std::remove_if(m_listeners.begin(), m_listeners.end(),
+                       [id](const auto& entry) { return entry.id == id; }),
+        m_listeners.end());
+}
+
+void AtomStore::notify_listeners() {
+    if (m_pending_events.empty()) {
+        return;
+    }
+    std::vector<AppendEvent> events;
+    events.reserve(m_pending_events.size());
+    for (const auto& pending : m_pending_events) {
+        events.push_back({m_entity_ids[pending.ordinal], pending.ordinal, &m_atoms[pending.atom_index], pending.lsn});
+    }
+    m_pending_events.clear();
+
+    for (const auto& listener : m_listeners) {
+        listener.on_append(events);
+    }
+}
+
+void AtomStore::notify_reset() {
+    m_pending_events.clear();
+    for (const auto& listener : m_listeners) {
+        if (listener.on_reset) {
+            listener.on_reset();
+        }
+    }
+}
+
 const std::vector<Atom>& AtomStore::all() const {
     return m_atoms;
 }
 
 const std::vector<AtomReference>* AtomStore::get_entity_atoms(types::EntityId entity) const {
-    auto it = m_entity_refs.find(entity);
-    if (it == m_entity_refs.end()) {
+    auto it = m_entity_ordinals.find(entity);
+    if (it == m_entity_ordinals.end()) {
         return nullptr;  // No atoms for this entity
     }
-    return &it->second;  // Return pointer to avoid copy
+    return &m_entity_refs[it->second];  // Return pointer to avoid copy
+}
+
+std::optional<uint32_t> AtomStore::find_ordinal(const types::EntityId& entity) const {
+    auto it = m_entity_ordinals.find(entity);
+    if (it == m_entity_ordinals.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+uint32_t AtomStore::ordinal_for(const types::EntityId& entity) {
+    auto [it, inserted] = m_entity_ordinals.try_emplace(entity, static_cast<uint32_t>(m_entity_ids.size()));
+    if (inserted) {
+        m_entity_ids.push_back(entity);
+        m_entity_refs.emplace_back();
+        m_latest_refs.emplace_back();
+
+        // Edges that pointed at this entity before it had atoms
+        if (!m_parked_edges.empty()) {
+            if (auto parked = m_parked_edges.find(entity); parked != m_parked_edges.end()) {
+                for (const auto& edge : parked->second) {
+                    m_adjacency.add_edge(edge.source, edge.relation, it->second, {m_next_lsn});
+                }
+                m_parked_edges.erase(parked);
+            }
+        }
+    }
+    return it->second;
+}
+
+TagId AtomStore::intern_tag(const std::string& tag) {
+    auto it = m_tag_ids.find(tag);
+    if (it == m_tag_ids.end()) {
+        it = m_tag_ids.emplace(tag, TagDictionary::global().intern(tag)).first;
+    }
+    return it->second;
+}
+
+std::optional<TagId> AtomStore::find_tag(const std::string& tag) const {
+    auto it = m_tag_ids.find(tag);
+    if (it == m_tag_ids.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void AtomStore::index_latest(uint32_t ordinal, TagId id) {
+    const auto ref = static_cast<uint32_t>(m_entity_refs[ordinal].size() - 1);
+    auto& latest = m_latest_refs[ordinal];
+    auto it = std::lower_bound(latest.begin(), latest.end(), id,
+                               [](const LatestRef& entry, TagId tag_id) { return entry.tag < tag_id; });
+    if (it != latest.end() && it->tag == id) {
+        it->ref = ref;
+    } else {
+        latest.insert(it, LatestRef{id, ref});
+    }
+}
+
+void AtomStore::rebuild_latest_refs() {
+    m_latest_refs.assign(m_entity_refs.size(), {});
+
+    for (uint32_t ordinal = 0; ordinal < m_entity_refs.size(); ++ordinal) {
+        const auto& refs = m_entity_refs[ordinal];
+        auto& latest = m_latest_refs[ordinal];
+        for (uint32_t i = 0; i < refs.size(); ++i) {
+            const Atom* atom = get_atom(refs[i].atom_id);
+            if (!atom) continue;
+            const TagId tag = intern_tag(atom->type_tag());
+            auto it = std::lower_bound(latest.begin(), latest.end(), tag,
+                                       [](const LatestRef& entry, TagId id) { return entry.tag < id; });
+            if (it != latest.end() && it->tag == tag) {
+                it->ref = i;
+            } else {
+                latest.insert(it, LatestRef{tag, i});
+            }
+        }
+    }
+}
+
+const AtomReference* AtomStore::latest_ref_at(uint32_t ordinal, TagId tag) const {
+    const auto& latest = m_latest_refs[ordinal];
+    auto it = std::lower_bound(latest.begin(), latest.end(), tag,
+                               [](const LatestRef& entry, TagId id) { return entry.tag < id; });
+    if (it == latest.end() || it->tag != tag) {
+        return nullptr;
+    }
+    return &m_entity_refs[ordinal][it->ref];
+}
+
+const AtomReference* AtomStore::latest_ref_at(uint32_t ordinal, const std::string& tag) const {
+    auto id = find_tag(tag);
+    return id ? latest_ref_at(ordinal, *id) : nullptr;
+}
+
+const Atom* AtomStore::latest_atom_at(uint32_t ordinal, const std::string& tag) const {
+    const AtomReference* ref = latest_ref_at(ordinal, tag);
+    return ref ? get_atom(ref->atom_id) : nullptr;
+}
+
+std::optional<types::AtomValue> AtomStore::get_latest_value(const types::EntityId& entity,
+                                                           const std::string& tag) const {
+    auto ordinal = find_ordinal(entity);
+    if (!ordinal) {
+        return std::nullopt;
+    }
+    if (const Atom* atom = latest_atom_at(*ordinal, tag)) {
+        return atom->value();
+    }
+    return std::nullopt;
+}
+
+std::vector<std::optional<types::AtomValue>> AtomStore::get_latest_values(
+    const std::vector<types::EntityId>& entities, const std::string& tag) const {
+    std::vector<std::optional<types::AtomValue>> values(entities.size());
+    auto id = find_tag(tag);
+    if (!id) {
+        return values;  // No atom ever carried the tag
+    }
+    for (size_t i = 0; i < entities.size(); ++i) {
+        auto ordinal = find_ordinal(entities[i]);
+        if (!ordinal) continue;
+        if (const AtomReference* ref = latest_ref_at(*ordinal, *id)) {
+            if (const Atom* atom = get_atom(ref->atom_id)) {
+                values[i] = atom->value();
+            }
+        }
+    }
+    return values;
+}
+
+bool AtomStore::is_snapshot_tag(uint32_t ordinal, const std::string& tag) const {
+    constexpr std::string_view kSuffix = ".snapshot";
+    if (tag.size() <= kSuffix.size() || !tag.ends_with(kSuffix)) {
+        return false;
+    }
+    auto base = find_tag(tag.substr(0, tag.size() - kSuffix.size()));
+    const AtomReference* ref = base ? latest_ref_at(ordinal, *base) : nullptr;
+    return ref && m_mutable_versions.count(ref->atom_id);
+}
+
+void AtomStore::index_edge(uint32_t source, TagId tag, const types::AtomValue& value, types::LogSequenceNumber lsn) {
+    const auto* edge = std::get_if<types::EdgeValue>(&value);
+
+    // The tag's table entry is still the reference being superseded
+    if (m_adjacency.relation_count() > 0) {
+        if (const AtomReference* previous = latest_ref_at(source, tag)) {
+            const Atom* atom = get_atom(*previous);
+            const auto* old_edge = atom ? std::get_if<types::EdgeValue>(&atom->value()) : nullptr;
+            if (old_edge && !(edge && same_edge(*edge, *old_edge))) {
+                supersede_edge(source, tag, *old_edge, lsn);
+            }
+        }
+    }
+    if (edge) {
+        add_edge(source, *edge, lsn);
+    }
+}
+
+void AtomStore::supersede_edge(uint32_t source, TagId tag, const types::EdgeValue& edge,
+                               types::LogSequenceNumber lsn) {
+    // Another tag of the source may still hold the same edge
+    for (const auto& latest : m_latest_refs[source]) {
+        if (latest.tag == tag) continue;
+        const Atom* atom = get_atom(m_entity_refs[source][latest.ref]);
+        const auto* other = atom ? std::get_if<types::EdgeValue>(&atom->value()) : nullptr;
+        if (other && same_edge(*other, edge) && !is_snapshot_tag(source, atom->type_tag())) {
+            return;
+        }
+    }
+    remove_edge(source, edge, lsn);
+}
+
+void AtomStore::add_edge(uint32_t source, const types::EdgeValue& edge, types::LogSequenceNumber lsn) {
+    AdjacencyIndex::RelationId relation = m_adjacency.intern(edge.relation);
+    if (auto target = m_entity_ordinals.find(edge.target); target != m_entity_ordinals.end()) {
+        m_adjacency.add_edge(source, relation, target->second, lsn);
+        return;
+    }
+    auto& parked = m_parked_edges[edge.target];
+    for (const auto& existing : parked) {
+        if (existing.source == source && existing.relation == relation) return;
+    }
+    parked.push_back({source, relation});
+}
+
+void AtomStore::remove_edge(uint32_t source, const types::EdgeValue& edge, types::LogSequenceNumber lsn) {
+    auto relation = m_adjacency.find_relation(edge.relation);
+    if (!relation) {
+        return;
+    }
+    if (auto target = m_entity_ordinals.find(edge.target); target != m_entity_ordinals.end()) {
+        m_adjacency.retire_edge(source, *relation, target->second, lsn);
+        return;
+    }
+
+    // Never visible: the target has no atoms yet
+    if (auto parked = m_parked_edges.find(edge.target); parked != m_parked_edges.end()) {
+        auto& edges = parked->second;
+        edges.erase(std::remove_if(edges.begin(), edges.end(),
+                                   [&](const ParkedEdge& e) { return e.source == source && e.relation == *relation; }),
+                    edges.end());
+        if (edges.empty()) {
+            m_parked_edges.erase(parked);
+        }
+    }
+}
+
+void AtomStore::rebuild_adjacency() {
+    m_adjacency.clear();
+    m_parked_edges.clear();
+
+    // Replay edges in the order they became visible (the later of the
+    // reference and the target's first atom) and retire each at the LSN
+    // of the reference superseding it, as during appends
+    struct PendingEdge {
+        uint64_t lsn;
+        uint32_t source;
+        const types::EdgeValue* edge;   // nullptr: superseded before it became visible
+        bool retire;
+    };
+    std::vector<PendingEdge> edges;
+    std::vector<std::pair<TagId, const types::EdgeValue*>> held;   // Edge each tag of the source holds
+    std::vector<size_t> added;                                     // The source's add events
+    for (uint32_t ordinal = 0; ordinal < m_entity_refs.size(); ++ordinal) {
+        held.clear();
+        added.clear();
+        for (const auto& ref : m_entity_refs[ordinal]) {
+            const Atom* atom = get_atom(ref);
+            if (!atom || is_snapshot_tag(ordinal, atom->type_tag())) {
+                continue;
+            }
+            const auto* edge = std::get_if<types::EdgeValue>(&atom->value());
+            const TagId tag = intern_tag(atom->type_tag());
+            auto slot = std::find_if(held.begin(), held.end(), [&](const auto& h) { return h.first == tag; });
+            if (slot == held.end()) {
+                if (!edge) continue;
+                slot = held.insert(held.end(), {tag, nullptr});
+            }
+
+            const types::EdgeValue* old_edge = slot->second;
+            if (old_edge && edge && same_edge(*edge, *old_edge)) {
+                continue;   // Re-asserted
+            }
+            slot->second = edge;
+            if (old_edge && std::none_of(held.begin(), held.end(), [&](const auto& h) {
+                    return h.second && same_edge(*h.second, *old_edge);
+                })) {
+                for (size_t index : added) {
+                    if (edges[index].edge && same_edge(*edges[index].edge, *old_edge) &&
+                        edges[index].lsn >= ref.lsn.value) {
+                        edges[index].edge = nullptr;
+                    }
+                }
+                edges.push_back({ref.lsn.value, ordinal, old_edge, true});
+            }
+            if (!edge) continue;
+
+            uint64_t lsn = ref.lsn.value;
+            if (auto target = m_entity_ordinals.find(edge->target); target != m_entity_ordinals.end()) {
+                const auto& target_refs = m_entity_refs[target->second];
+                if (!target_refs.empty()) {
+                    lsn = std::max(lsn, target_refs.front().lsn.value);
+                }
+            }
+            added.push_back(edges.size());
+            edges.push_back({lsn, ordinal, edge, false});
+        }
+    }
+    std::stable_sort(edges.begin(), edges.end(),
+                     [](const PendingEdge& a, const PendingEdge& b) { return a.lsn < b.lsn; });
+    for (const auto& edge : edges) {
+        if (!edge.edge) continue;
+        if (edge.retire) {
+            remove_edge(edge.source, *edge.edge, {edge.lsn});
+        } else {
+            add_edge(edge.source, *edge.edge, {edge.lsn});
+        }
+    }
+    m_adjacency.compact();
+}
+
+bool AtomStore::load_adjacency(BinaryReader& reader) {
+    try {
+        if (reader.at_end()) {
+            return false;
+        }
+        char magic[4];
+        reader.read_bytes(magic, 4);
+        if (std::memcmp(magic, "GADJ", 4) != 0) {
+            std::cerr << "Unknown trailing section; rebuilding adjacency\n";
+            return false;
+        }
+        if (reader.read_u32() != 3) {
+            // Version 2 predates retired edges
+            std::cerr << "Outdated adjacency section; rebuilding\n";
+            return false;
+        }
+        m_adjacency = AdjacencyIndex::read_from(reader, m_entity_ids.size());
+
+        uint64_t parked_targets = reader.read_u64();
+        for (uint64_t i = 0; i < parked_targets; ++i) {
+            types::EntityId target = reader.read_entity_id();
+            auto& edges = m_parked_edges[target];
+            edges.resize(reader.read_u64());
+            for (auto& edge : edges) {
+                edge.source = reader.read_u32();
+                edge.relation = reader.read_u32();
+                if (edge.source >= m_entity_ids.size() || edge.relation >= m_adjacency.relation_count()) {
+                    throw std::runtime_error("Parked edge out of range");
+                }
+            }
+        }
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid adjacency section (" << e.what() << "); rebuilding\n";
+        m_adjacency.clear();
+        m_parked_edges.clear();
+        return false;
+    }
 }
 
 const Atom* AtomStore::get_atom(types::AtomId atom_id) const {
@@ -48,13 +429,191 @@ const Atom* AtomStore::get_atom(types::AtomId atom_id) const {
     return &m_atoms[it->second];
 }
 
+const Atom* AtomStore::get_atom(const AtomReference& ref) const {
+    auto position = atom_position(ref);
+    return position ? &m_atoms[*position] : nullptr;
+}
+
+std::optional<size_t> AtomStore::atom_position(const AtomReference& ref) const {
+    if (auto it = m_mutable_versions.find(ref.atom_id); it != m_mutable_versions.end()) {
+        const auto& versions = it->second;
+        auto version = std::lower_bound(versions.begin(), versions.end(), ref.lsn,
+                                        [](const MutableVersion& v, types::LogSequenceNumber lsn) { return v.lsn < lsn; });
+        if (version != versions.end() && version->lsn == ref.lsn) {
+            return version->index;
+        }
+    }
+    auto it = m_content_index.find(ref.atom_id);
+    if (it == m_content_index.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void AtomStore::rebuild_mutable_versions() {
+    m_mutable_versions.clear();
+
+    // Copies of a mutable atom are stored in append order...
+    std::unordered_map<types::AtomId, std::vector<size_t>, AtomIdHash> copies;
+    for (size_t i = 0; i < m_atoms.size(); ++i) {
+        if (m_atoms[i].classification() == types::AtomType::Mutable) {
+            copies[m_atoms[i].atom_id()].push_back(i);
+        }
+    }
+    if (copies.empty()) {
+        return;
+    }
+
+    // ...as are the references to it, all owned by a single entity
+    for (const auto& refs : m_entity_refs) {
+        for (const auto& ref : refs) {
+            if (copies.count(ref.atom_id)) {
+                m_mutable_versions[ref.atom_id].push_back({ref.lsn, 0});
+            }
+        }
+    }
+
+    // Pair them up from the newest end, which both sides always retain
+    for (auto& [atom_id, indexes] : copies) {
+        m_content_index[atom_id] = indexes.back();
+        auto it = m_mutable_versions.find(atom_id);
+        if (it == m_mutable_versions.end()) {
+            continue;
+        }
+        auto& versions = it->second;
+        const size_t paired = std::min(versions.size(), indexes.size());
+        versions.erase(versions.begin(), versions.end() - static_cast<std::ptrdiff_t>(paired));
+        for (size_t i = 0; i < paired; ++i) {
+            versions[i].index = indexes[indexes.size() - paired + i];
+        }
+    }
+}
+
 std::vector<types::EntityId> AtomStore::get_all_entities() const {
-    std::vector<types::EntityId> result;
-    result.reserve(m_entity_refs.size());
-    for (const auto& [entity, refs] : m_entity_refs) {
-        result.push_back(entity);
+    return m_entity_ids;
+}
+
+namespace {
+
+// Approximate heap footprint of a stored atom, including its content-index entry
+size_t atom_bytes(const Atom& atom) {
+    size_t bytes = sizeof(Atom) + atom.type_tag().capacity();
+    const auto& value = atom.value();
+    if (auto* text = std::get_if<std::string>(&value)) {
+        bytes += text->capacity();
+    } else if (auto* vector = std::get_if<types::Vector>(&value)) {
+        bytes += vector->capacity() * sizeof(float);
+    } else if (auto* blob = std::get_if<std::vector<uint8_t>>(&value)) {
+        bytes += blob->capacity();
+    } else if (auto* edge = std::get_if<types::EdgeValue>(&value)) {
+        bytes += edge->relation.capacity();
     }
-    return result;
+    return bytes + sizeof(std::pair<types::AtomId, size_t>) + 2 * sizeof(void*);
+}
+
+} // namespace
+
+AtomStore::CompactionStats AtomStore::compact(const CompactionOptions& options) {
+    CompactionStats stats;
+
+    // 1. Trim references outside the retention window, newest first per entity
+    if (options.keep_versions > 0) {
+        std::unordered_map<TagId, size_t> versions;
+        for (auto& refs : m_entity_refs) {
+            versions.clear();
+            size_t kept = refs.size();
+            for (size_t i = refs.size(); i-- > 0;) {
+                const Atom* atom = get_atom(refs[i].atom_id);
+                bool keep = atom && options.keep_after.is_valid() && refs[i].lsn > options.keep_after;
+                if (atom) {
+                    keep |= versions[intern_tag(atom->type_tag())]++ < options.keep_versions;
+                }
+                if (!keep) {
+                    refs[i].lsn.value = 0;  // Marked for removal
+                    --kept;
+                }
+            }
+            if (kept != refs.size()) {
+                stats.references_removed += refs.size() - kept;
+                refs.erase(std::remove_if(refs.begin(), refs.end(),
+                                          [](const AtomReference& ref) { return !ref.lsn.is_valid(); }),
+                           refs.end());
+                refs.shrink_to_fit();
+            }
+        }
+    }
+
+    // 2. An atom slot is live if a remaining reference resolves to it
+    std::vector<uint8_t> live(m_atoms.size(), 0);
+    for (const auto& refs : m_entity_refs) {
+        for (const auto& ref : refs) {
+            if (const Atom* atom = get_atom(ref)) {
+                live[static_cast<size_t>(atom - m_atoms.data())] = 1;
+            }
+        }
+    }
+
+    // 3. Renumber surviving atoms into a dense prefix and reindex them
+    size_t next = 0;
+    for (size_t i = 0; i < m_atoms.size(); ++i) {
+        if (!live[i]) {
+            stats.bytes_reclaimed += atom_bytes(m_atoms[i]);
+            ++stats.atoms_removed;
+            continue;
+        }
+        if (next != i) {
+            m_atoms[next] = std::move(m_atoms[i]);
+        }
+        ++next;
+    }
+    m_atoms.erase(m_atoms.begin() + static_cast<std::ptrdiff_t>(next), m_atoms.end());
+    m_atoms.shrink_to_fit();
+    ++m_layout_version;
+
+    m_content_index.clear();
+    m_content_index.reserve(m_atoms.size());
+    m_canonical_atom_count = 0;
+    for (size_t i = 0; i < m_atoms.size(); ++i) {
+        m_content_index.emplace(m_atoms[i].atom_id(), i);
+        if (m_atoms[i].is_canonical()) {
+            ++m_canonical_atom_count;
+        }
+    }
+    rebuild_mutable_versions();
+
+    // 4. Recount canonical references; atoms left without any are gone
+    for (auto& [atom_id, count] : m_refcounts) {
+        count = 0;
+    }
+    for (const auto& refs : m_entity_refs) {
+        for (const auto& ref : refs) {
+            if (auto it = m_refcounts.find(ref.atom_id); it != m_refcounts.end()) {
+                ++it->second;
+            }
+        }
+    }
+    for (auto it = m_refcounts.begin(); it != m_refcounts.end();) {
+        it = it->second == 0 ? m_refcounts.erase(it) : std::next(it);
+    }
+
+    stats.bytes_reclaimed += stats.references_removed * sizeof(AtomReference);
+
+    // 5. Derived indexes address references by position; the tag map is
+    //    refilled from the surviving atoms as the latest-ref table is rebuilt
+    m_tag_ids.clear();
+    rebuild_latest_refs();
+    if (stats.references_removed > 0) {
+        rebuild_adjacency();
+    }
+    return stats;
+}
+
+bool AtomStore::set_hash_algorithm(types::HashAlgorithm algorithm) {
+    if (!m_atoms.empty()) {
+        return false;
+    }
+    m_hash_algorithm = algorithm;
+    return true;
 }
 
 AtomStore::Stats AtomStore::get_stats() const {
@@ -63,11 +622,11 @@ AtomStore::Stats AtomStore::get_stats() const {
     stats.canonical_atoms = m_canonical_atom_count;
     stats.deduplicated_hits = m_dedup_hits;
     stats.unique_canonical_atoms = m_canonical_atom_count;
-    stats.total_entities = m_entity_refs.size();
+    stats.total_entities = m_entity_ids.size();
 
     // Count total references across all entities
     size_t total_refs = 0;
-    for (const auto& [entity, refs] : m_entity_refs) {
+    for (const auto& refs : m_entity_refs) {
         total_refs += refs.size();
     }
     stats.total_references = total_refs;
@@ -81,12 +640,7 @@ size_t AtomStore::append_batch(const std::vector<BatchAtom>& atoms) {
     // Get timestamp once for the entire batch
     types::Timestamp batch_timestamp = get_current_timestamp();
 
-    // Phase 1: Pre-calculate how many atoms each entity will receive
-    // Use a local map to batch entity references before committing
-    std::unordered_map<types::EntityId, std::vector<AtomReference>, EntityIdHash> batch_entity_refs;
-    batch_entity_refs.reserve(atoms.size() / 8);  // Estimate unique entities
-
-    // Phase 2: Pre-reserve main storage
+    // Phase 1: Pre-reserve main storage
     m_atoms.reserve(m_atoms.size() + atoms.size() / 2);
 
     // Pre-reserve hash maps to avoid rehashing during batch
@@ -98,17 +652,17 @@ size_t AtomStore::append_batch(const std::vector<BatchAtom>& atoms) {
 
     size_t stored_count = 0;
 
-    // Phase 3: Process atoms with minimal map operations
+    // Phase 2: Process atoms with minimal map operations
     for (const auto& batch_atom : atoms) {
         // Only support Canonical atoms in batch mode for now
         if (batch_atom.classification != types::AtomType::Canonical) {
-            append(batch_atom.entity, batch_atom.tag, batch_atom.value, batch_atom.classification);
+            route_append(batch_atom.entity, batch_atom.tag, batch_atom.value, batch_atom.classification);
             ++stored_count;
             continue;
         }
 
         // Compute content-based hash
-        types::AtomId atom_id = types::compute_content_hash(batch_atom.tag, batch_atom.value);
+        types::AtomId atom_id = types::compute_content_hash(batch_atom.tag, batch_atom.value, m_hash_algorithm);
 
         // Use insert to do lookup + insert in ONE operation (critical optimization)
         auto [it, inserted] = m_content_index.try_emplace(atom_id, m_atoms.size());
@@ -116,8 +670,15 @@ size_t AtomStore::append_batch(const std::vector<BatchAtom>& atoms) {
         // Generate LSN
         types::LogSequenceNumber lsn{++m_next_lsn};
 
-        // Batch entity references locally (much faster than direct map access)
-        batch_entity_refs[batch_atom.entity].push_back({atom_id, lsn});
+        // Entity references live in a flat vector indexed by ordinal, so
+        // appending directly keeps per-entity refs in LSN order even when
+        // canonical and non-canonical atoms are mixed in one batch
+        uint32_t ordinal = ordinal_for(batch_atom.entity);
+        m_entity_refs[ordinal].push_back({atom_id, lsn});
+        const TagId tag_id = intern_tag(batch_atom.tag);
+        index_edge(ordinal, tag_id, batch_atom.value, lsn);
+        index_latest(ordinal, tag_id);
+        record_event(ordinal, it->second, lsn);
 
         if (inserted) {
             // New atom - store it
@@ -138,15 +699,7 @@ size_t AtomStore::append_batch(const std::vector<BatchAtom>& atoms) {
         }
     }
 
-    // Phase 4: Merge batch entity references into main map (bulk operation)
-    for (auto& [entity, refs] : batch_entity_refs) {
-        auto& main_refs = m_entity_refs[entity];
-        main_refs.reserve(main_refs.size() + refs.size());
-        main_refs.insert(main_refs.end(),
-                        std::make_move_iterator(refs.begin()),
-                        std::make_move_iterator(refs.end()));
-    }
-
+    notify_listeners();
     return stored_count;
 }
 
@@ -158,7 +711,10 @@ void AtomStore::reserve(size_t atom_count, size_t entity_count) {
     m_refcounts.reserve(atom_count);
 
     if (entity_count > 0) {
+        m_entity_ids.reserve(entity_count);
+        m_entity_ordinals.reserve(entity_count);
         m_entity_refs.reserve(entity_count);
+        m_latest_refs.reserve(entity_count);
     }
 }
 
@@ -168,7 +724,7 @@ Atom AtomStore::append_canonical(
     types::AtomValue value
 ) {
     // Compute content-based hash
-    types::AtomId atom_id = types::compute_content_hash(tag, value);
+    types::AtomId atom_id = types::compute_content_hash(tag, value, m_hash_algorithm);
 
     // Check for existing atom with same hash (deduplication)
     bool is_new_atom = false;
@@ -183,7 +739,12 @@ Atom AtomStore::append_canonical(
 
     // Add entity reference with per-entity LSN
     types::LogSequenceNumber lsn{++m_next_lsn};
-    m_entity_refs[entity].push_back({atom_id, lsn});
+    uint32_t ordinal = ordinal_for(entity);
+    m_entity_refs[ordinal].push_back({atom_id, lsn});
+    const TagId tag_id = intern_tag(tag);
+    index_edge(ordinal, tag_id, value, lsn);
+    index_latest(ordinal, tag_id);
+    record_event(ordinal, is_new_atom ? m_atoms.size() : m_content_index[atom_id], lsn);
 
     // If new content, create and store atom
     if (is_new_atom) {
@@ -237,7 +798,11 @@ Atom AtomStore::append_temporal(
     types::AtomId atom_id = generate_sequential_id();
 
     // Add entity reference with per-entity LSN
-    m_entity_refs[entity].push_back({atom_id, lsn});
+    uint32_t ordinal = ordinal_for(entity);
+    m_entity_refs[ordinal].push_back({atom_id, lsn});
+    const TagId tag_id = intern_tag(tag);
+    index_edge(ordinal, tag_id, value, lsn);
+    index_latest(ordinal, tag_id);
 
     // Create atom (content only, no entity_id or lsn in Atom itself)
     Atom atom(
@@ -252,6 +817,7 @@ Atom AtomStore::append_temporal(
     size_t index = m_atoms.size();
     m_atoms.push_back(atom);
     m_content_index[atom_id] = index;
+    record_event(ordinal, index, lsn);
 
     return atom;
 }
@@ -270,15 +836,14 @@ Atom AtomStore::append_mutable(
     // Apply mutation and log delta
     state.mutate(value, lsn, now);
 
-    // Check if snapshot should be emitted
-    if (state.should_snapshot(m_snapshot_delta_threshold)) {
-        emit_snapshot(state);
-    }
-
     types::AtomId atom_id = state.metadata().atom_id;
 
     // Add entity reference with per-entity LSN
-    m_entity_refs[entity].push_back({atom_id, lsn});
+    uint32_t ordinal = ordinal_for(entity);
+    m_entity_refs[ordinal].push_back({atom_id, lsn});
+    const TagId tag_id = intern_tag(tag);
+    index_edge(ordinal, tag_id, value, lsn);
+    index_latest(ordinal, tag_id);
 
     // Return atom reflecting current state
     Atom atom(
@@ -289,10 +854,17 @@ Atom AtomStore::append_mutable(
         now
     );
 
-    // Store in content index and atoms
+    // Store in content index and atoms; every version stays resolvable by LSN
     size_t index = m_atoms.size();
     m_atoms.push_back(atom);
     m_content_index[atom_id] = index;
+    m_mutable_versions[atom_id].push_back({lsn, index});
+    record_event(ordinal, index, lsn);
+
+    // The snapshot takes the next LSN, so it is referenced after the mutation
+    if (state.should_snapshot(m_snapshot_delta_threshold)) {
+        emit_snapshot(state);
+    }
 
     return atom;
 }
@@ -354,16 +926,302 @@ void AtomStore::seal_and_rotate_chunk(const TemporalKey& key) {
     types::Timestamp now = get_current_timestamp();
     chunk.seal(final_lsn, now);
 
-    // Move to sealed chunks
-    types::ChunkId chunk_id = chunk.metadata().chunk_id;
-    m_sealed_chunks.emplace(chunk_id, std::move(chunk));
+    // Move to the stream's sealed chunks
+    auto resident = std::make_shared<const TemporalChunk>(std::move(chunk));
+    types::ChunkId chunk_id = resident->metadata().chunk_id;
+    size_t bytes = resident->memory_bytes();
+    auto& sealed = m_sealed_chunks[key];
+    sealed.push_back({chunk_id, resident->min_timestamp(), resident->max_timestamp(), bytes, std::move(resident)});
+    ++m_sealed_chunk_count;
+    m_resident_chunk_bytes += bytes;
 
     // Remove from active chunks
     m_active_chunks.erase(it);
 
+    // Enforce retention incrementally, only for the stream that grew
+    if (const RetentionPolicy* policy = retention_policy_for(key.tag)) {
+        enforce_retention(sealed, *policy, now);
+    }
+
+    if (tiering_enabled()) {
+        m_resident_order.emplace_back(key, chunk_id);
+        spill_cold_chunks(now);
+    }
+
     // Note: Next call to get_or_create_active_chunk() will create a new chunk
 }
 
+void AtomStore::set_retention_policy(RetentionPolicy policy) {
+    auto it = std::find_if(m_retention_policies.begin(), m_retention_policies.end(),
+                           [&](const RetentionPolicy& existing) { return existing.tag == policy.tag; });
+    if (it != m_retention_policies.end()) {
+        *it = std::move(policy);
+    } else {
+        m_retention_policies.push_back(std::move(policy));
+    }
+}
+
+bool AtomStore::remove_retention_policy(const std::string& tag) {
+    auto it = std::find_if(m_retention_policies.begin(), m_retention_policies.end(),
+                           [&](const RetentionPolicy& existing) { return existing.tag == tag; });
+    if (it == m_retention_policies.end()) {
+        return false;
+    }
+    m_retention_policies.erase(it);
+    return true;
+}
+
+const AtomStore::RetentionPolicy* AtomStore::retention_policy_for(const std::string& tag) const {
+    const RetentionPolicy* best = nullptr;
+    size_t best_length = 0;
+    for (const auto& policy : m_retention_policies) {
+        if (!policy.tag.empty() && policy.tag.back() == '*') {
+            size_t length = policy.tag.size() - 1;
+            if (tag.compare(0, length, policy.tag, 0, length) == 0 && (!best || length > best_length)) {
+                best = &policy;
+                best_length = length;
+            }
+        } else if (policy.tag == tag) {
+            return &policy;   // An exact tag beats any prefix
+        }
+    }
+    return best;
+}
+
+size_t AtomStore::enforce_retention() {
+    return enforce_retention(get_current_timestamp());
+}
+
+size_t AtomStore::enforce_retention(types::Timestamp now) {
+    size_t dropped = 0;
+    for (auto it = m_sealed_chunks.begin(); it != m_sealed_chunks.end();) {
+        if (const RetentionPolicy* policy = retention_policy_for(it->first.tag)) {
+            dropped += enforce_retention(it->second, *policy, now);
+        }
+        it = it->second.empty() ? m_sealed_chunks.erase(it) : std::next(it);
+    }
+    return dropped;
+}
+
+size_t AtomStore::enforce_retention(std::deque<SealedChunk>& chunks, const RetentionPolicy& policy,
+                                    types::Timestamp now) {
+    // Chunks are in time order, so expired and surplus ones are at the front
+    size_t dropped = 0;
+    while (!chunks.empty()) {
+        const SealedChunk& oldest = chunks.front();
+        bool surplus = policy.max_chunks > 0 && chunks.size() > policy.max_chunks;
+        bool expired = policy.max_age > 0 && oldest.max_time < now && now - oldest.max_time > policy.max_age;
+        if (!surplus && !expired) {
+            break;
+        }
+        if (oldest.chunk) {
+            m_resident_chunk_bytes -= oldest.bytes;
+        } else {
+            remove_spill_file(oldest);
+            --m_spilled_chunk_count;
+        }
+        chunks.pop_front();
+        ++dropped;
+    }
+    m_sealed_chunk_count -= dropped;
+    return dropped;
+}
+
+bool AtomStore::enable_tiering(TieringOptions options) {
+    try {
+        std::filesystem::create_directories(options.directory);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to create chunk directory: " << e.what() << "\n";
+        return false;
+    }
+
+    if (tiering_enabled() && options.directory != m_tiering.directory && !disable_tiering()) {
+        return false;   // Files live in the old directory
+    }
+    const bool resize_cache = !tiering_enabled() || options.cache_budget_bytes != m_tiering.cache_budget_bytes;
+    m_tiering = std::move(options);
+    if (resize_cache) {
+        m_chunk_cache = std::make_unique<ChunkCache>(m_tiering.cache_budget_bytes);
+    }
+
+    // Queue every resident chunk, oldest first
+    m_resident_order.clear();
+    std::vector<std::tuple<types::Timestamp, const TemporalKey*, types::ChunkId>> resident;
+    for (const auto& [key, chunks] : m_sealed_chunks) {
+        for (const auto& sealed : chunks) {
+            if (sealed.chunk) {
+                resident.emplace_back(sealed.max_time, &key, sealed.chunk_id);
+            }
+        }
+    }
+    std::sort(resident.begin(), resident.end(), [](const auto& a, const auto& b) {
+        return std::get<0>(a) < std::get<0>(b);
+    });
+    for (const auto& [max_time, key, chunk_id] : resident) {
+        m_resident_order.emplace_back(*key, chunk_id);
+    }
+
+    spill_cold_chunks();
+    return true;
+}
+
+bool AtomStore::disable_tiering() {
+    if (!tiering_enabled()) {
+        return true;
+    }
+
+    // Read every file before changing anything, so a bad one loses nothing
+    std::vector<std::pair<SealedChunk*, std::shared_ptr<const TemporalChunk>>> paged;
+    paged.reserve(m_spilled_chunk_count);
+    for (auto& [key, chunks] : m_sealed_chunks) {
+        for (auto& sealed : chunks) {
+            if (!sealed.chunk) {
+                auto chunk = page_in(sealed);
+                if (!chunk) {
+                    return false;
+                }
+                paged.emplace_back(&sealed, std::move(chunk));
+            }
+        }
+    }
+    for (auto& [sealed, chunk] : paged) {
+        sealed->chunk = std::move(chunk);
+        m_resident_chunk_bytes += sealed->bytes;
+    }
+    remove_spill_files();
+    for (auto& [key, chunks] : m_sealed_chunks) {
+        for (auto& sealed : chunks) {
+            sealed.spill_id = 0;
+        }
+    }
+    m_spilled_chunk_count = 0;
+    m_resident_order.clear();
+    m_chunk_cache.reset();
+    return true;
+}
+
+size_t AtomStore::spill_cold_chunks() {
+    return spill_cold_chunks(get_current_timestamp());
+}
+
+size_t AtomStore::spill_cold_chunks(types::Timestamp now) {
+    if (!tiering_enabled()) {
+        return 0;
+    }
+
+    size_t spilled = 0;
+    while (!m_resident_order.empty()) {
+        const auto& [key, chunk_id] = m_resident_order.front();
+
+        // Skip chunks dropped by retention or spilled since they were queued
+        SealedChunk* sealed = nullptr;
+        if (auto it = m_sealed_chunks.find(key); it != m_sealed_chunks.end()) {
+            auto& chunks = it->second;
+            auto pos = std::lower_bound(chunks.begin(), chunks.end(), chunk_id,
+                                        [](const SealedChunk& c, types::ChunkId id) { return c.chunk_id < id; });
+            if (pos != chunks.end() && pos->chunk_id == chunk_id && pos->chunk) {
+                sealed = &*pos;
+            }
+        }
+        if (!sealed) {
+            m_resident_order.pop_front();
+            continue;
+        }
+
+        bool over_budget = m_tiering.memory_budget_bytes > 0 && m_resident_chunk_bytes > m_tiering.memory_budget_bytes;
+        bool cold = m_tiering.max_age > 0 && sealed->max_time < now && now - sealed->max_time > m_tiering.max_age;
+        if (!over_budget && !cold) {
+            break;
+        }
+        if (!spill(*sealed)) {
+            break;   // Retried on the next seal or tick
+        }
+        m_resident_order.pop_front();
+        ++spilled;
+    }
+    return spilled;
+}
+
+bool AtomStore::spill(SealedChunk& sealed) {
+    uint64_t spill_id = m_next_spill_id;
+    try {
+        BinaryWriter writer(spill_path(spill_id));
+        sealed.chunk->write_to(writer);
+        if (!writer.flush()) {
+            throw std::runtime_error("Failed to write " + spill_path(spill_id));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to spill chunk: " << e.what() << "\n";
+        std::error_code error;   // Cleanup must not throw out of the handler
+        std::filesystem::remove(spill_path(spill_id), error);
+        return false;
+    }
+
+    ++m_next_spill_id;
+    sealed.spill_id = spill_id;
+    sealed.chunk.reset();
+    m_resident_chunk_bytes -= sealed.bytes;
+    ++m_spilled_chunk_count;
+    return true;
+}
+
+std::shared_ptr<const TemporalChunk> AtomStore::page_in(const SealedChunk& sealed) const {
+    if (sealed.chunk) {
+        return sealed.chunk;
+    }
+    if (auto cached = m_chunk_cache->find(sealed.spill_id)) {
+        return cached;
+    }
+
+    std::shared_ptr<const TemporalChunk> chunk;
+    try {
+        MappedFile file(spill_path(sealed.spill_id));
+        MemoryReader reader(file.data(), file.size());
+        chunk = std::make_shared<const TemporalChunk>(TemporalChunk::read_from(reader));
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to page in chunk: " << e.what() << "\n";
+        return nullptr;
+    }
+    m_chunk_cache->insert(sealed.spill_id, chunk);
+    return chunk;
+}
+
+void AtomStore::remove_spill_file(const SealedChunk& sealed) {
+    std::error_code error;
+    std::filesystem::remove(spill_path(sealed.spill_id), error);
+    if (m_chunk_cache) {
+        m_chunk_cache->erase(sealed.spill_id);
+    }
+}
+
+void AtomStore::remove_spill_files() {
+    if (m_spilled_chunk_count == 0) {
+        return;
+    }
+    for (const auto& [key, chunks] : m_sealed_chunks) {
+        for (const auto& sealed : chunks) {
+            if (sealed.spill_id != 0) {
+                remove_spill_file(sealed);
+            }
+        }
+    }
+}
+
+std::string AtomStore::spill_path(uint64_t spill_id) const {
+    return (std::filesystem::path(m_tiering.directory) / ("chunk-" + std::to_string(spill_id) + ".bin")).string();
+}
+
+AtomStore::TieringStats AtomStore::tiering_stats() const {
+    TieringStats stats;
+    stats.spilled_chunks = m_spilled_chunk_count;
+    stats.resident_chunks = m_sealed_chunk_count - m_spilled_chunk_count;
+    stats.resident_bytes = m_resident_chunk_bytes;
+    if (m_chunk_cache) {
+        stats.cache = m_chunk_cache->stats();
+    }
+    return stats;
+}
+
 MutableState& AtomStore::get_or_create_mutable_state(
     const types::EntityId& entity,
     const std::string& tag,
@@ -403,10 +1261,12 @@ void AtomStore::emit_snapshot(const MutableState& state) {
     std::string snapshot_tag = metadata.tag + ".snapshot";
 
     // Snapshots can be content-addressed (deduplicated)
-    types::AtomId snapshot_id = types::compute_content_hash(snapshot_tag, state.current_value());
+    types::AtomId snapshot_id = types::compute_content_hash(snapshot_tag, state.current_value(), m_hash_algorithm);
 
     // Add entity reference for snapshot
-    m_entity_refs[metadata.entity_id].push_back({snapshot_id, lsn});
+    uint32_t ordinal = ordinal_for(metadata.entity_id);
+    m_entity_refs[ordinal].push_back({snapshot_id, lsn});
+    index_latest(ordinal, intern_tag(snapshot_tag));
 
     Atom snapshot_atom(
         snapshot_id,
@@ -420,6 +1280,7 @@ void AtomStore::emit_snapshot(const MutableState& state) {
     size_t index = m_atoms.size();
     m_atoms.push_back(snapshot_atom);
     m_content_index[snapshot_id] = index;
+    record_event(ordinal, index, lsn);
 
     // Mark snapshot in mutable state (clears delta history)
     const_cast<MutableState&>(state).mark_snapshot(lsn, now);
@@ -436,13 +1297,17 @@ AtomStore::TemporalQueryResult AtomStore::query_temporal_range(
     TemporalQueryResult result;
     TemporalKey key{entity, tag};
 
-    // Query sealed chunks
-    for (const auto& [chunk_id, chunk] : m_sealed_chunks) {
-        const auto& metadata = chunk.metadata();
-
-        // Check if chunk belongs to this stream
-        if (metadata.entity_id == entity && metadata.tag == tag) {
-            collect_chunk_values(chunk, start_time, end_time, result);
+    // Query sealed chunks overlapping the range, paging in spilled ones
+    if (auto it = m_sealed_chunks.find(key); it != m_sealed_chunks.end()) {
+        for (const auto& sealed : it->second) {
+            if (sealed.max_time < start_time || sealed.min_time > end_time) {
+                continue;
+            }
+            if (auto chunk = page_in(sealed)) {
+                collect_chunk_values(*chunk, start_time, end_time, result);
+            } else {
+                result.complete = false;
+            }
         }
     }
 
@@ -492,7 +1357,8 @@ bool AtomStore::save(const std::string& filepath) const {
 
         // Write header
         writer.write_bytes("GTAF", 4);  // Magic
-        writer.write_u32(2);             // Version 2 (new format with reference layer)
+        writer.write_u32(3);             // Version 3 (version 2 + hash algorithm)
+        writer.write_u8(static_cast<uint8_t>(m_hash_algorithm));
         writer.write_u64(m_next_lsn);
         writer.write_u64(m_next_atom_id);
         writer.write_u64(m_atoms.size());
@@ -506,10 +1372,12 @@ bool AtomStore::save(const std::string& filepath) const {
             writer.write_timestamp(atom.created_at());
         }
 
-        // Write entity reference layer
-        writer.write_u64(m_entity_refs.size());
-        for (const auto& [entity, refs] : m_entity_refs) {
-            writer.write_entity_id(entity);
+        // Write entity reference layer in ordinal order, so load() assigns
+        // every entity the same ordinal it had when saved
+        writer.write_u64(m_entity_ids.size());
+        for (uint32_t ordinal = 0; ordinal < m_entity_ids.size(); ++ordinal) {
+            const auto& refs = m_entity_refs[ordinal];
+            writer.write_entity_id(m_entity_ids[ordinal]);
             writer.write_u64(refs.size());
             for (const auto& ref : refs) {
                 writer.write_atom_id(ref.atom_id);
@@ -524,6 +1392,21 @@ bool AtomStore::save(const std::string& filepath) const {
             writer.write_u32(count);
         }
 
+        // Optional trailing section (older readers stop before it): the
+        // adjacency index, then edges still waiting for their target
+        writer.write_bytes("GADJ", 4);
+        writer.write_u32(3);
+        m_adjacency.write_to(writer);
+        writer.write_u64(m_parked_edges.size());
+        for (const auto& [target, edges] : m_parked_edges) {
+            writer.write_entity_id(target);
+            writer.write_u64(edges.size());
+            for (const auto& edge : edges) {
+                writer.write_u32(edge.source);
+                writer.write_u32(edge.relation);
+            }
+        }
+
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Failed to save: " << e.what() << "\n";
@@ -532,6 +1415,7 @@ bool AtomStore::save(const std::string& filepath) const {
 }
 
 bool AtomStore::load(const std::string& filepath) {
+    bool cleared = false;
     try {
         auto t_start = std::chrono::high_resolution_clock::now();
         BinaryReader reader(filepath);
@@ -545,20 +1429,44 @@ bool AtomStore::load(const std::string& filepath) {
         }
 
         uint32_t version = reader.read_u32();
-        if (version != 2) {
-            std::cerr << "Unsupported version: " << version << " (expected 2)\n";
+        if (version != 2 && version != 3) {
+            std::cerr << "Unsupported version: " << version << " (expected 2 or 3)\n";
             return false;
         }
 
+        // Version 2 predates the field: its AtomIds are FNV-1a
+        auto hash_algorithm = types::HashAlgorithm::Fnv1a;
+        if (version >= 3) {
+            hash_algorithm = static_cast<types::HashAlgorithm>(reader.read_u8());
+            if (hash_algorithm != types::HashAlgorithm::Fnv1a && hash_algorithm != types::HashAlgorithm::Wide128) {
+                std::cerr << "Unsupported hash algorithm: " << static_cast<int>(hash_algorithm) << "\n";
+                return false;
+            }
+        }
+
         // Clear current state
+        cleared = true;
         m_atoms.clear();
+        ++m_layout_version;
         m_content_index.clear();
+        m_entity_ids.clear();
+        m_entity_ordinals.clear();
         m_entity_refs.clear();
+        m_latest_refs.clear();
+        m_tag_ids.clear();
         m_refcounts.clear();
+        m_adjacency.clear();
+        m_parked_edges.clear();
         m_active_chunks.clear();
+        remove_spill_files();
         m_sealed_chunks.clear();
+        m_sealed_chunk_count = 0;
+        m_spilled_chunk_count = 0;
+        m_resident_chunk_bytes = 0;
+        m_resident_order.clear();
         m_mutable_states.clear();
         m_next_chunk_id.clear();
+        m_hash_algorithm = hash_algorithm;
 
         // Read counters
         m_next_lsn = reader.read_u64();
@@ -608,7 +1516,10 @@ bool AtomStore::load(const std::string& filepath) {
         // Read entity reference layer
         uint64_t entity_count = reader.read_u64();
         std::cerr << "[DEBUG] Loading " << entity_count << " entities...\n";
+        m_entity_ids.reserve(entity_count);
+        m_entity_ordinals.reserve(entity_count);
         m_entity_refs.reserve(entity_count);
+        m_latest_refs.reserve(entity_count);
 
         auto t_refs_start = std::chrono::high_resolution_clock::now();
 
@@ -622,8 +1533,8 @@ bool AtomStore::load(const std::string& filepath) {
             types::EntityId entity = reader.read_entity_id();
             uint64_t ref_count = reader.read_u64();
 
-            // Create vector directly in map
-            auto& refs = m_entity_refs[entity];
+            // Ordinals follow file order (save() writes in ordinal order)
+            auto& refs = m_entity_refs[ordinal_for(entity)];
             refs.resize(ref_count);
 
             if (ref_count > 0) {
@@ -643,6 +1554,12 @@ bool AtomStore::load(const std::string& filepath) {
             }
             total_refs_loaded += ref_count;
 
+            // Older files referenced a mutable snapshot ahead of its mutation
+            auto by_lsn = [](const AtomReference& a, const AtomReference& b) { return a.lsn < b.lsn; };
+            if (!std::is_sorted(refs.begin(), refs.end(), by_lsn)) {
+                std::stable_sort(refs.begin(), refs.end(), by_lsn);
+            }
+
             // Progress: first at 100, 1000, 10000, then every 100k
             if ((i + 1) == 100 || (i + 1) == 1000 || (i + 1) == 10000 || (i + 1) % 100000 == 0) {
                 auto now = std::chrono::high_resolution_clock::now();
@@ -664,13 +1581,25 @@ bool AtomStore::load(const std::string& filepath) {
             m_refcounts.emplace(atom_id, count);
         }
 
+        rebuild_mutable_versions();
+        rebuild_latest_refs();
+
+        // Adjacency section, or rebuild for files saved without one
+        if (!load_adjacency(reader)) {
+            rebuild_adjacency();
+        }
+
         // Reset session counters (dedup_hits is only meaningful during append)
         m_dedup_hits = 0;
         m_snapshot_count = 0;
 
+        notify_reset();
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Failed to load: " << e.what() << "\n";
+        if (cleared) {
+            notify_reset();
+        }
         return false;
     }
 }
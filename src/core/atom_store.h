@@ -1,12 +1,23 @@
 // atom_store.h
 #pragma once
+#include "../types/hash_utils.h"
 #include "atom.h"
+#include "adjacency_index.h"
+#include "chunk_cache.h"
 #include "temporal_chunk.h"
 #include "mutable_state.h"
+#include "small_vector.h"
+#include "tag_dictionary.h"
 #include <vector>
 #include <unordered_map>
+#include <algorithm>
+#include <deque>
+#include <string>
 #include <cstddef>
 #include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
 
 namespace gtaf::core {
 
@@ -73,6 +84,16 @@ struct AtomReference {
  */
 class AtomStore {
 public:
+    AtomStore() = default;
+
+    /**
+     * @brief Deletes any chunk files (see enable_tiering())
+     */
+    ~AtomStore();
+
+    AtomStore(const AtomStore&) = delete;
+    AtomStore& operator=(const AtomStore&) = delete;
+
     /**
      * @brief Append an atom to the log with proper classification handling
      *
@@ -112,6 +133,54 @@ public:
      */
     size_t append_batch(const std::vector<BatchAtom>& atoms);
 
+    /**
+     * @brief One committed entity -> atom reference, as seen by append listeners
+     */
+    struct AppendEvent {
+        types::EntityId entity;
+        uint32_t ordinal;                // Dense entity ordinal (see find_ordinal())
+        const Atom* atom;                // Valid only for the duration of the callback
+        types::LogSequenceNumber lsn;
+    };
+
+    /**
+     * @brief Callback receiving the references committed by one append or batch
+     *
+     * Events are in LSN order. Listeners run synchronously on the appending
+     * thread and must not append to the store themselves.
+     */
+    using AppendListener = std::function<void(const std::vector<AppendEvent>&)>;
+    using ListenerId = uint64_t;
+
+    /**
+     * @brief Callback run after load() replaced the store's contents
+     *
+     * Ordinals and LSNs restart with the loaded file, so state derived from
+     * earlier events must be rebuilt rather than caught up.
+     */
+    using ResetListener = std::function<void()>;
+
+    /**
+     * @brief Subscribe to committed appends
+     *
+     * Called once per append() and once per append_batch(), after all of
+     * the call's references are in place (including mutable snapshots).
+     *
+     * @param on_reset Optional; called once load() has replaced the contents
+     * @return Handle for remove_append_listener()
+     */
+    ListenerId add_append_listener(AppendListener listener, ResetListener on_reset = {});
+
+    /**
+     * @brief Unsubscribe a listener (no-op for unknown handles)
+     */
+    void remove_append_listener(ListenerId id);
+
+    /**
+     * @brief LSN of the most recently committed reference (0 if empty)
+     */
+    types::LogSequenceNumber current_lsn() const noexcept { return {m_next_lsn}; }
+
     /**
      * @brief Reserve capacity for expected number of atoms
      *
@@ -137,6 +206,105 @@ public:
      */
     const std::vector<AtomReference>* get_entity_atoms(types::EntityId entity) const;
 
+    /**
+     * @brief Get all atom references for an entity by its dense ordinal
+     *
+     * @param ordinal Ordinal below entity_count()
+     */
+    const std::vector<AtomReference>& get_entity_atoms_at(uint32_t ordinal) const {
+        return m_entity_refs[ordinal];
+    }
+
+    // ---- Latest value by tag ----
+
+    /**
+     * @brief Newest reference of an entity to an atom with the given tag
+     *
+     * Served from a per-entity tag table maintained on append, so the cost
+     * is independent of the entity's width and history length.
+     *
+     * @param ordinal Ordinal below entity_count()
+     * @return Reference (valid until the next append), or nullptr if none
+     */
+    const AtomReference* latest_ref_at(uint32_t ordinal, const std::string& tag) const;
+    const AtomReference* latest_ref_at(uint32_t ordinal, TagId tag) const;
+
+    /**
+     * @brief Atom behind latest_ref_at() (valid until the next append)
+     */
+    const Atom* latest_atom_at(uint32_t ordinal, const std::string& tag) const;
+
+    /**
+     * @brief Current value of (entity, tag), as ProjectionEngine would project it
+     *
+     * @return Value, or nullopt if the entity has no atom with the tag
+     */
+    std::optional<types::AtomValue> get_latest_value(const types::EntityId& entity, const std::string& tag) const;
+
+    /**
+     * @brief get_latest_value() for many entities, resolving the tag once
+     *
+     * @return One result per entity, in input order
+     */
+    std::vector<std::optional<types::AtomValue>> get_latest_values(
+        const std::vector<types::EntityId>& entities, const std::string& tag) const;
+
+    // ---- Entity ordinals ----
+
+    /**
+     * @brief Look up the dense ordinal of an entity
+     *
+     * Each entity is assigned the next 32-bit ordinal (0, 1, 2, ...) when
+     * it is first referenced. Ordinals are never reused and survive
+     * save()/load(), so per-entity state elsewhere can live in flat arrays
+     * indexed by ordinal instead of hash maps keyed by EntityId.
+     *
+     * @return Ordinal, or nullopt if the entity has no atoms
+     */
+    std::optional<uint32_t> find_ordinal(const types::EntityId& entity) const;
+
+    /**
+     * @brief Number of entities (ordinals are 0..entity_count()-1)
+     */
+    size_t entity_count() const noexcept { return m_entity_ids.size(); }
+
+    /**
+     * @brief Entity for an ordinal below entity_count()
+     */
+    const types::EntityId& entity_at(uint32_t ordinal) const { return m_entity_ids[ordinal]; }
+
+    /**
+     * @brief All entities in ordinal order
+     */
+    const std::vector<types::EntityId>& entities() const noexcept { return m_entity_ids; }
+
+    /**
+     * @brief TagId (in TagDictionary::global()) of a tag this store holds
+     *
+     * Served from the store's own map, so projections can resolve tags
+     * without taking the global dictionary lock.
+     *
+     * @return TagId, or nullopt if no atom in the store has the tag
+     */
+    [[nodiscard]] std::optional<TagId> find_tag(const std::string& tag) const;
+
+    /**
+     * @brief Bidirectional adjacency over EdgeValue atoms, by relation
+     *
+     * Maintained on every append and saved with the store, so neighbour
+     * lookups never scan references. Edges to entities without atoms are
+     * added once the target's first atom is appended.
+     *
+     * Example:
+     *   const auto& graph = store.adjacency();
+     *   if (auto follows = graph.find_relation("follows")) {
+     *       graph.outgoing(*store.find_ordinal(user), *follows).for_each([&](uint32_t target) {
+     *           visit(store.entity_at(target));
+     *       });
+     *   }
+     */
+    const AdjacencyIndex& adjacency() const noexcept { return m_adjacency; }
+
     /**
      * @brief Get an atom by its AtomId
      *
@@ -145,10 +313,42 @@ public:
      */
     const Atom* get_atom(types::AtomId atom_id) const;
 
+    /**
+     * @brief Get the atom a reference points to, as of the reference's LSN
+     *
+     * Mutable atoms keep one AtomId across mutations, so get_atom(AtomId)
+     * yields their latest value; this overload yields the value the
+     * reference recorded. Projections of history should resolve through it.
+     */
+    const Atom* get_atom(const AtomReference& ref) const;
+
+    /**
+     * @brief Position of the atom get_atom(ref) returns in the atom log
+     *
+     * Positions only change when compact() or load() rewrite the log, which
+     * bumps layout_version(); until then atom_at() resolves one without a
+     * content index lookup.
+     *
+     * @return Position, or nullopt if the store holds no such atom
+     */
+    std::optional<size_t> atom_position(const AtomReference& ref) const;
+
+    /**
+     * @brief Atom at a position from atom_position()
+     *
+     * @param position Position obtained under the current layout_version()
+     */
+    const Atom& atom_at(size_t position) const { return m_atoms[position]; }
+
+    /**
+     * @brief Incremented whenever atom positions change
+     */
+    uint64_t layout_version() const noexcept { return m_layout_version; }
+
     /**
      * @brief Get all entity IDs that have atoms
      *
-     * @return Vector of all entity IDs in the reference layer
+     * @return Vector of all entity IDs in the reference layer, in ordinal order
      */
     std::vector<types::EntityId> get_all_entities() const;
 
@@ -172,6 +372,7 @@ public:
         std::vector<types::Timestamp> timestamps;
         std::vector<types::LogSequenceNumber> lsns;
         size_t total_count = 0;
+        bool complete = true;             // false if a spilled chunk in range could not be read
     };
 
     /**
@@ -179,11 +380,181 @@ public:
      */
     Stats get_stats() const;
 
+    /**
+     * @brief Hash function that produced this store's canonical AtomIds
+     *
+     * New stores use HashAlgorithm::Wide128. A store loaded from a file
+     * keeps the algorithm recorded there (files saved before the field
+     * existed are Fnv1a), so new appends still deduplicate against it.
+     */
+    [[nodiscard]] types::HashAlgorithm hash_algorithm() const noexcept { return m_hash_algorithm; }
+
+    /**
+     * @brief Choose the content hash of an empty store
+     *
+     * @return false (leaving the algorithm unchanged) if the store has atoms
+     */
+    bool set_hash_algorithm(types::HashAlgorithm algorithm);
+
+    /**
+     * @brief History retained by compact()
+     */
+    struct CompactionOptions {
+        // Newest references kept per (entity, tag); 0 keeps every reference
+        size_t keep_versions = 0;
+        // References newer than this LSN are always kept (invalid: none)
+        types::LogSequenceNumber keep_after{};
+    };
+
+    /**
+     * @brief Outcome of compact()
+     */
+    struct CompactionStats {
+        size_t atoms_removed = 0;
+        size_t references_removed = 0;
+        size_t bytes_reclaimed = 0;       // Approximate heap bytes released
+    };
+
+    /**
+     * @brief Drop atoms unreachable from the retained history and repack the log
+     *
+     * First trims each entity's references to the retention window (the
+     * newest keep_versions per tag plus everything after keep_after), then
+     * drops every atom no remaining reference resolves to: trimmed
+     * versions, superseded copies of mutable atoms and orphaned snapshots.
+     * Surviving atoms are renumbered into a dense m_atoms, and the content
+     * index, refcounts, tag table and (if references were trimmed) the
+     * adjacency index are rebuilt. Entity ordinals and LSNs never change.
+     *
+     * Runs offline: it must not overlap appends or readers, and pointers
+     * to atoms or references obtained earlier are invalidated. Projections
+     * of trimmed history (history(), as-of rebuilds before the window)
+     * lose the dropped references.
+     */
+    CompactionStats compact(const CompactionOptions& options);
+    CompactionStats compact() { return compact(CompactionOptions{}); }
+
+    /**
+     * @brief Retention of sealed temporal chunks for a tag or tag prefix
+     *
+     * A chunk expires once its newest value is older than max_age, and
+     * only the newest max_chunks sealed chunks of each stream are kept.
+     * Active chunks are never dropped.
+     */
+    struct RetentionPolicy {
+        std::string tag;                   // Exact tag, or a prefix ending in '*' ("sensor.*")
+        types::Timestamp max_age = 0;      // Microseconds (0: no age limit)
+        size_t max_chunks = 0;             // Sealed chunks per stream (0: no count limit)
+    };
+
+    /**
+     * @brief Add a retention policy, replacing any with the same tag pattern
+     *
+     * A stream follows the exact-tag policy if there is one, otherwise the
+     * policy with the longest matching prefix. Policies are enforced for a
+     * stream whenever it seals a chunk; call enforce_retention() as a
+     * periodic tick so idle streams age out too.
+     */
+    void set_retention_policy(RetentionPolicy policy);
+
+    /**
+     * @brief Remove the policy with this tag pattern
+     *
+     * @return true if a policy was removed
+     */
+    bool remove_retention_policy(const std::string& tag);
+
+    /**
+     * @brief Apply retention policies to every stream
+     *
+     * @param now Reference time for max_age (default: current time)
+     * @return Number of sealed chunks dropped
+     */
+    size_t enforce_retention();
+    size_t enforce_retention(types::Timestamp now);
+
+    /**
+     * @brief Number of sealed temporal chunks held in memory
+     */
+    [[nodiscard]] size_t sealed_chunk_count() const noexcept { return m_sealed_chunk_count; }
+
+    /**
+     * @brief Where and when sealed temporal chunks move to disk
+     */
+    struct TieringOptions {
+        std::string directory;                 // Chunk files (created if missing; owned by this store)
+        types::Timestamp max_age = 0;          // Spill chunks whose newest value is older (0: no age limit)
+        size_t memory_budget_bytes = 0;        // Spill the oldest chunks beyond this resident size (0: none)
+        size_t cache_budget_bytes = 64u << 20; // Spilled chunks kept in memory after paging in
+    };
+
+    /**
+     * @brief Residency of sealed temporal chunks
+     */
+    struct TieringStats {
+        size_t resident_chunks = 0;
+        size_t spilled_chunks = 0;
+        size_t resident_bytes = 0;             // Approximate (see TemporalChunk::memory_bytes())
+        ChunkCacheStats cache;
+    };
+
+    /**
+     * @brief Spill cold sealed chunks to local chunk files
+     *
+     * A spilled chunk is written once to its own file and replaced in
+     * memory by a stub with its metadata and time range. Chunks spill
+     * oldest first, whenever one is sealed and on spill_cold_chunks(),
+     * while they are older than max_age or resident chunks exceed
+     * memory_budget_bytes. query_temporal_range() skips stubs outside the
+     * queried range and pages the others in through a bounded ChunkCache.
+     * Retention policies delete the files of chunks they drop.
+     *
+     * Chunk files only extend this store in memory: they are not part of
+     * save(), and are deleted by load(), disable_tiering() and the
+     * destructor. Calling again replaces the options.
+     *
+     * @return false if the directory cannot be created, or if changing it
+     *         fails to page the chunks in from the old one
+     */
+    bool enable_tiering(TieringOptions options);
+
+    /**
+     * @brief Page every spilled chunk back in and delete the chunk files
+     *
+     * @return false (leaving tiering enabled and the files in place) if a
+     *         chunk file cannot be read
+     */
+    bool disable_tiering();
+
+    [[nodiscard]] bool tiering_enabled() const noexcept { return m_chunk_cache != nullptr; }
+
+    /**
+     * @brief Spill chunks that are older than max_age or over the memory budget
+     *
+     * Runs on every seal; call it as a periodic tick so idle streams age
+     * out too. No-op unless tiering is enabled.
+     *
+     * @param now Reference time for max_age (default: current time)
+     * @return Number of chunks spilled
+     */
+    size_t spill_cold_chunks();
+    size_t spill_cold_chunks(types::Timestamp now);
+
+    [[nodiscard]] TieringStats tiering_stats() const;
+
+    /**
+     * @brief Set the number of values after which a temporal chunk is sealed
+     */
+    void set_chunk_size_threshold(size_t values) { m_chunk_size_threshold = std::max<size_t>(values, 1); }
+
     /**
      * @brief Query temporal data by timestamp range
      *
      * Scans both active and sealed chunks for the given (entity, tag) stream.
-     * Returns all values within [start_time, end_time] inclusive.
+     * Returns all values within [start_time, end_time] inclusive. Spilled
+     * chunks overlapping the range are paged in (see enable_tiering()); a
+     * chunk whose file cannot be read is logged and skipped, and the
+     * result is marked incomplete.
      *
      * @param entity The entity whose temporal data to query
      * @param tag The property tag (e.g., "sensor.temperature")
@@ -227,7 +598,9 @@ public:
      * @brief Load atom log from a binary file
      *
      * Replaces current state with data from file.
-     * Warning: Clears all existing data before loading.
+     * Warning: Clears all existing data before loading. Listeners' reset
+     * callbacks run once the contents are replaced (also if reading fails
+     * after the old state was cleared).
      *
      * @param filepath Path to input file
      * @return true on success, false on failure
@@ -235,6 +608,111 @@ public:
     bool load(const std::string& filepath);
 
 private:
+    // A sealed chunk, resident or spilled to a chunk file
+    struct SealedChunk {
+        types::ChunkId chunk_id;
+        types::Timestamp min_time;
+        types::Timestamp max_time;
+        size_t bytes;                                  // Resident footprint
+        std::shared_ptr<const TemporalChunk> chunk;    // Null while spilled
+        uint64_t spill_id = 0;                         // Chunk file (0: none)
+    };
+
+    /**
+     * @brief Route an append by classification without notifying listeners
+     */
+    Atom route_append(
+        types::EntityId entity,
+        std::string tag,
+        types::AtomValue value,
+        types::AtomType classification
+    );
+
+    /**
+     * @brief Record an entity reference for listeners (no-op without listeners)
+     *
+     * @param atom_index Position of the referenced atom in m_atoms
+     */
+    void record_event(uint32_t ordinal, size_t atom_index, types::LogSequenceNumber lsn) {
+        if (!m_listeners.empty()) {
+            m_pending_events.push_back({ordinal, atom_index, lsn});
+        }
+    }
+
+    /**
+     * @brief Get (or assign) the dense ordinal of an entity
+     */
+    uint32_t ordinal_for(const types::EntityId& entity);
+
+    /**
+     * @brief Index the edge held by a newly referenced value of a tag
+     *
+     * Runs before index_latest() for the same reference: an edge the tag
+     * held before is retired at lsn unless the value re-asserts it. Edges
+     * to unknown targets are parked and become visible at the LSN of the
+     * target's first atom.
+     */
+    void index_edge(uint32_t source, TagId tag, const types::AtomValue& value, types::LogSequenceNumber lsn);
+
+    /**
+     * @brief Retire an edge a tag no longer holds, unless another tag holds it
+     */
+    void supersede_edge(uint32_t source, TagId tag, const types::EdgeValue& edge, types::LogSequenceNumber lsn);
+
+    /**
+     * @brief Add an edge to the adjacency index, or park it
+     */
+    void add_edge(uint32_t source, const types::EdgeValue& edge, types::LogSequenceNumber lsn);
+
+    /**
+     * @brief Retire an edge in the adjacency index, or unpark it
+     */
+    void remove_edge(uint32_t source, const types::EdgeValue& edge, types::LogSequenceNumber lsn);
+
+    /**
+     * @brief Whether a tag is the snapshot tag of one of the entity's mutable atoms
+     *
+     * Snapshots repeat a mutable value; they assert no edge of their own.
+     */
+    [[nodiscard]] bool is_snapshot_tag(uint32_t ordinal, const std::string& tag) const;
+
+    /**
+     * @brief Rebuild the adjacency index from the reference layer
+     */
+    void rebuild_adjacency();
+
+    /**
+     * @brief TagId of a tag, served from the store's own map after first use
+     */
+    TagId intern_tag(const std::string& tag);
+
+    /**
+     * @brief Point the entity's tag table at its newest reference
+     */
+    void index_latest(uint32_t ordinal, TagId tag);
+
+    /**
+     * @brief Rebuild every entity's tag table from the reference layer
+     */
+    void rebuild_latest_refs();
+
+    /**
+     * @brief Read the optional adjacency section at the end of a saved file
+     *
+     * @return false if the file has no (valid) section; the caller rebuilds
+     */
+    bool load_adjacency(BinaryReader& reader);
+
+    /**
+     * @brief Deliver recorded references to all listeners
+     */
+    void notify_listeners();
+
+    /**
+     * @brief Run every listener's reset callback after load()
+     */
+    void notify_reset();
+
     /**
      * @brief Append a Canonical atom (immutable, content-addressed, deduplicated)
      */
@@ -282,6 +760,45 @@ private:
      */
     void seal_and_rotate_chunk(const TemporalKey& key);
 
+    /**
+     * @brief Policy governing a tag (exact match, else longest prefix)
+     */
+    const RetentionPolicy* retention_policy_for(const std::string& tag) const;
+
+    /**
+     * @brief Drop a stream's expired and surplus sealed chunks
+     *
+     * @return Number of chunks dropped
+     */
+    size_t enforce_retention(std::deque<SealedChunk>& chunks, const RetentionPolicy& policy,
+                             types::Timestamp now);
+
+    /**
+     * @brief Write a resident chunk to its chunk file and drop its values
+     *
+     * @return false (leaving the chunk resident) if the file cannot be written
+     */
+    bool spill(SealedChunk& sealed);
+
+    /**
+     * @brief A sealed chunk's values, paging them in if spilled
+     *
+     * @return nullptr (logged) if the chunk file cannot be read
+     */
+    std::shared_ptr<const TemporalChunk> page_in(const SealedChunk& sealed) const;
+
+    /**
+     * @brief Delete a spilled chunk's file and cache entry
+     */
+    void remove_spill_file(const SealedChunk& sealed);
+
+    /**
+     * @brief Delete every chunk file (chunks stay as they are)
+     */
+    void remove_spill_files();
+
+    std::string spill_path(uint64_t spill_id) const;
+
     /**
      * @brief Get or create mutable state for a (entity, tag) property
      */
@@ -296,6 +813,11 @@ private:
      */
     void emit_snapshot(const MutableState& state);
 
+    /**
+     * @brief Re-pair mutable atom copies with the references they record
+     */
+    void rebuild_mutable_versions();
+
     /**
      * @brief Helper to collect values from a chunk within time range
      */
@@ -314,6 +836,9 @@ private:
      */
     void rebuild_indexes();
 
+    // Content hash of canonical AtomIds (persisted in the file header)
+    types::HashAlgorithm m_hash_algorithm = types::HashAlgorithm::Wide128;
+
     // Sequential ID counter (for Temporal and Mutable atoms)
     uint64_t m_next_atom_id = 0;
 
@@ -324,17 +849,53 @@ private:
 
     // Append-only atom storage (content only, no entity associations)
     std::vector<Atom> m_atoms;
+    uint64_t m_layout_version = 0;   // Bumped when compact() or load() move atoms
 
     // Content index: AtomId -> index in m_atoms
     // Used for all atom types to enable efficient lookup
     std::unordered_map<types::AtomId, size_t, AtomIdHash> m_content_index;
 
+    // Every stored version of each mutable atom, in LSN order
+    // (the content index points at the latest one)
+    struct MutableVersion {
+        types::LogSequenceNumber lsn;
+        size_t index;   // In m_atoms
+    };
+    std::unordered_map<types::AtomId, std::vector<MutableVersion>, AtomIdHash> m_mutable_versions;
 
     // ===== REFERENCE LAYER (Entity-Atom Associations) =====
 
-    // Entity references: EntityId -> vector of (AtomId, LSN) pairs
+    // Dense entity ordinals: ordinal -> EntityId and EntityId -> ordinal
+    std::vector<types::EntityId> m_entity_ids;
+    std::unordered_map<types::EntityId, uint32_t, EntityIdHash> m_entity_ordinals;
+
+    // Entity references: ordinal -> vector of (AtomId, LSN) pairs
     // Tracks which atoms each entity references, with per-entity LSN
-    std::unordered_map<types::EntityId, std::vector<AtomReference>, EntityIdHash> m_entity_refs;
+    std::vector<std::vector<AtomReference>> m_entity_refs;
+
+    // Latest reference per tag: ordinal -> (TagId, index into m_entity_refs[ordinal]),
+    // sorted by TagId; most entities have few enough tags to stay inline
+    struct LatestRef {
+        TagId tag;
+        uint32_t ref;
+    };
+    std::vector<SmallVector<LatestRef, 4>> m_latest_refs;
+
+    // Tags this store has seen; appends resolve TagIds here instead of
+    // taking the global dictionary lock
+    std::unordered_map<std::string, TagId> m_tag_ids;
+
+    // ===== GRAPH LAYER =====
+
+    // CSR adjacency over EdgeValue references (per relation, both directions)
+    AdjacencyIndex m_adjacency;
+
+    // Edges whose target has no ordinal yet: target -> (source, relation)
+    struct ParkedEdge {
+        uint32_t source;
+        AdjacencyIndex::RelationId relation;
+    };
+    std::unordered_map<types::EntityId, std::vector<ParkedEdge>, EntityIdHash> m_parked_edges;
 
     // ===== GARBAGE COLLECTION LAYER =====
 
@@ -347,8 +908,21 @@ private:
     // Active chunks (one per entity+tag stream)
     std::unordered_map<TemporalKey, TemporalChunk, TemporalKeyHash> m_active_chunks;
 
-    // Sealed chunks for history queries
-    std::unordered_map<types::ChunkId, TemporalChunk> m_sealed_chunks;
+    // Sealed chunks for history queries, per stream in seal (and time) order
+    std::unordered_map<TemporalKey, std::deque<SealedChunk>, TemporalKeyHash> m_sealed_chunks;
+    size_t m_sealed_chunk_count = 0;
+    size_t m_resident_chunk_bytes = 0;
+
+    // Tiering: options, paged-in chunks, and resident chunks oldest first
+    // (entries for dropped or spilled chunks are skipped lazily)
+    TieringOptions m_tiering;
+    std::unique_ptr<ChunkCache> m_chunk_cache;
+    std::deque<std::pair<TemporalKey, types::ChunkId>> m_resident_order;
+    uint64_t m_next_spill_id = 1;
+    size_t m_spilled_chunk_count = 0;
+
+    // Retention policies for sealed chunks (few; matched by linear scan)
+    std::vector<RetentionPolicy> m_retention_policies;
 
     // Chunk ID counter per stream
     std::unordered_map<TemporalKey, types::ChunkId, TemporalKeyHash> m_next_chunk_id;
@@ -368,6 +942,24 @@ private:
     size_t m_canonical_atom_count = 0;
     size_t m_dedup_hits = 0;
     size_t m_snapshot_count = 0;
+
+    // --- Append Notification ---
+
+    struct PendingEvent {
+        uint32_t ordinal;
+        size_t atom_index;               // Resolved to a pointer once m_atoms stops growing
+        types::LogSequenceNumber lsn;
+    };
+
+    struct Listener {
+        ListenerId id;
+        AppendListener on_append;
+        ResetListener on_reset;
+    };
+
+    std::vector<Listener> m_listeners;
+    std::vector<PendingEvent> m_pending_events;
+    ListenerId m_next_listener_id = 0;
 };
 
 } // namespace gtaf::core
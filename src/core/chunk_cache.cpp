@@ -0,0 +1,76 @@
+#include "chunk_cache.h"
+
+namespace gtaf::core {
+
+// ---- ChunkCache Implementation ----
+
+ChunkCache::ChunkCache(size_t budget_bytes)
+    : m_budget_bytes(budget_bytes) {}
+
+std::shared_ptr<const TemporalChunk> ChunkCache::find(uint64_t spill_id) {
+    std::lock_guard lock(m_mutex);
+    auto it = m_entries.find(spill_id);
+    if (it == m_entries.end()) {
+        ++m_misses;
+        return nullptr;
+    }
+    m_lru.splice(m_lru.begin(), m_lru, it->second.position);
+    ++m_hits;
+    return it->second.chunk;
+}
+
+void ChunkCache::insert(uint64_t spill_id, std::shared_ptr<const TemporalChunk> chunk) {
+    const size_t bytes = chunk->memory_bytes();
+    if (bytes > m_budget_bytes) {
+        return;
+    }
+
+    std::lock_guard lock(m_mutex);
+    if (m_entries.count(spill_id)) {
+        return;   // Paged in concurrently by another reader
+    }
+    m_lru.push_front(spill_id);
+    m_entries.emplace(spill_id, Entry{std::move(chunk), bytes, m_lru.begin()});
+    m_bytes += bytes;
+    evict();
+}
+
+void ChunkCache::erase(uint64_t spill_id) {
+    std::lock_guard lock(m_mutex);
+    if (auto it = m_entries.find(spill_id); it != m_entries.end()) {
+        m_bytes -= it->second.bytes;
+        m_lru.erase(it->second.position);
+        m_entries.erase(it);
+    }
+}
+
+void ChunkCache::evict() {
+    while (m_bytes > m_budget_bytes && !m_lru.empty()) {
+        auto it = m_entries.find(m_lru.back());
+        m_bytes -= it->second.bytes;
+        m_entries.erase(it);
+        m_lru.pop_back();
+        ++m_evictions;
+    }
+}
+
+void ChunkCache::clear() {
+    std::lock_guard lock(m_mutex);
+    m_entries.clear();
+    m_lru.clear();
+    m_bytes = 0;
+}
+
+ChunkCacheStats ChunkCache::stats() const {
+    std::lock_guard lock(m_mutex);
+    ChunkCacheStats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.evictions = m_evictions;
+    stats.entries = m_entries.size();
+    stats.bytes = m_bytes;
+    stats.budget_bytes = m_budget_bytes;
+    return stats;
+}
+
+} // namespace gtaf::core
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "temporal_chunk.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace gtaf::core {
+
+/**
+ * @brief Counters of a ChunkCache
+ */
+struct ChunkCacheStats {
+    uint64_t hits = 0;          // Served from memory
+    uint64_t misses = 0;        // Paged in from a chunk file
+    uint64_t evictions = 0;     // Dropped to stay within budget
+    size_t entries = 0;
+    size_t bytes = 0;           // Approximate (see TemporalChunk::memory_bytes())
+    size_t budget_bytes = 0;
+};
+
+/**
+ * @brief Bounded LRU cache of spilled temporal chunks paged back in
+ *
+ * Entries are keyed by spill id and shared with the queries reading
+ * them, so an evicted chunk stays alive until its last reader is done.
+ * A single lock suffices: misses are dominated by the file read, which
+ * happens outside the cache. Chunks larger than the budget are not kept.
+ */
+class ChunkCache {
+public:
+    /**
+     * @param budget_bytes Approximate upper bound on cached chunk memory
+     */
+    explicit ChunkCache(size_t budget_bytes);
+
+    ChunkCache(const ChunkCache&) = delete;
+    ChunkCache& operator=(const ChunkCache&) = delete;
+
+    /**
+     * @brief Cached chunk, or nullptr on a miss
+     */
+    std::shared_ptr<const TemporalChunk> find(uint64_t spill_id);
+
+    /**
+     * @brief Cache a chunk just paged in
+     */
+    void insert(uint64_t spill_id, std::shared_ptr<const TemporalChunk> chunk);
+
+    /**
+     * @brief Forget a chunk whose file was removed
+     */
+    void erase(uint64_t spill_id);
+
+    /**
+     * @brief Drop all entries (counters are kept)
+     */
+    void clear();
+
+    [[nodiscard]] ChunkCacheStats stats() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<const TemporalChunk> chunk;
+        size_t bytes;
+        std::list<uint64_t>::iterator position;   // In m_lru
+    };
+
+    /**
+     * @brief Evict from the cold end until within budget (lock held)
+     */
+    void evict();
+
+    size_t m_budget_bytes;
+    mutable std::mutex m_mutex;
+    std::unordered_map<uint64_t, Entry> m_entries;
+    std::list<uint64_t> m_lru;                    // Most recently used first
+    size_t m_bytes = 0;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_evictions = 0;
+};
+
+} // namespace gtaf::core
@@ -0,0 +1,447 @@
+#include "column.h"
+#include "persistence.h"
+#include "../types/values_helper.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+namespace gtaf::core {
+
+namespace {
+
+// Strict integer parse: the whole string must be consumed
+bool parse_int(const std::string& text, int64_t& out) {
+    const char* first = text.data();
+    const char* last = first + text.size();
+    if (first != last && *first == '+') ++first;
+    auto [ptr, ec] = std::from_chars(first, last, out);
+    return ec == std::errc() && ptr == last && first != last;
+}
+
+bool parse_double(const std::string& text, double& out) {
+    const char* first = text.data();
+    const char* last = first + text.size();
+    if (first != last && *first == '+') ++first;
+    auto [ptr, ec] = std::from_chars(first, last, out);
+    return ec == std::errc() && ptr == last && first != last;
+}
+
+// Text form of a scalar stored in a widened String column (shortest round-trip doubles)
+std::string scalar_text(const types::AtomValue& value) {
+    if (auto* b = std::get_if<bool>(&value)) {
+        return *b ? "true" : "false";
+    }
+    char buffer[32];
+    std::to_chars_result result{};
+    if (auto* i = std::get_if<int64_t>(&value)) {
+        result = std::to_chars(buffer, buffer + sizeof(buffer), *i);
+    } else {
+        result = std::to_chars(buffer, buffer + sizeof(buffer), std::get<double>(value));
+    }
+    return std::string(buffer, result.ptr);
+}
+
+bool is_scalar(ColumnType type) {
+    return type == ColumnType::Bool || type == ColumnType::Int64 ||
+           type == ColumnType::Double || type == ColumnType::String;
+}
+
+// Set in the serialized type byte of adaptive columns
+constexpr uint8_t kAdaptiveFlag = 0x80;
+
+} // namespace
+
+std::optional<ColumnType> column_type_of(const types::AtomValue& value) {
+    switch (value.index()) {
+        case 1: return ColumnType::Bool;
+        case 2: return ColumnType::Int64;
+        case 3: return ColumnType::Double;
+        case 4: return ColumnType::String;
+        default: return std::nullopt;
+    }
+}
+
+const char* column_type_name(ColumnType type) {
+    switch (type) {
+        case ColumnType::Auto:      return "auto";
+        case ColumnType::Bool:      return "bool";
+        case ColumnType::Int64:     return "int64";
+        case ColumnType::Double:    return "double";
+        case ColumnType::Timestamp: return "timestamp";
+        case ColumnType::String:    return "string";
+        case ColumnType::Edge:      return "edge";
+    }
+    return "unknown";
+}
+
+// ---- Column Implementation ----
+
+Column::Column(ColumnType type)
+    : m_type(type),
+      m_adaptive(type == ColumnType::Auto) {}
+
+Column::Column(const Column& other)
+    : m_type(other.m_type),
+      m_adaptive(other.m_adaptive),
+      m_size(other.m_size),
+      m_count(other.m_count),
+      m_validity(other.m_validity),
+      m_ints(other.m_ints),
+      m_doubles(other.m_doubles),
+      m_bools(other.m_bools),
+      m_codes(other.m_codes),
+      m_dictionary(other.m_dictionary)
+{
+    // Views must point into this column's own dictionary
+    rebuild_dictionary_index();
+}
+
+Column& Column::operator=(const Column& other) {
+    if (this != &other) {
+        Column copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+void Column::rebuild_dictionary_index() {
+    m_dictionary_index.clear();
+    m_dictionary_index.reserve(m_dictionary.size());
+    for (size_t code = 0; code < m_dictionary.size(); ++code) {
+        m_dictionary_index.emplace(m_dictionary[code], static_cast<uint32_t>(code));
+    }
+}
+
+uint32_t Column::intern(const std::string& value) {
+    if (auto it = m_dictionary_index.find(value); it != m_dictionary_index.end()) {
+        return it->second;
+    }
+    auto code = static_cast<uint32_t>(m_dictionary.size());
+    m_dictionary.push_back(value);
+    m_dictionary_index.emplace(m_dictionary.back(), code);
+    return code;
+}
+
+std::optional<uint32_t> Column::find_code(std::string_view value) const {
+    auto it = m_dictionary_index.find(value);
+    if (it == m_dictionary_index.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+size_t Column::compact_dictionary() {
+    std::vector<uint8_t> held(m_dictionary.size(), 0);
+    for_each_valid([&](uint32_t row) { held[m_codes[row]] = 1; });
+    const size_t dropped = static_cast<size_t>(std::count(held.begin(), held.end(), 0));
+    if (dropped == 0) {
+        return 0;
+    }
+
+    std::vector<uint32_t> remap(m_dictionary.size(), 0);
+    std::deque<std::string> dictionary;
+    for (size_t code = 0; code < m_dictionary.size(); ++code) {
+        if (held[code]) {
+            remap[code] = static_cast<uint32_t>(dictionary.size());
+            dictionary.push_back(std::move(m_dictionary[code]));
+        }
+    }
+
+    // Null rows hold no meaningful code; point them at 0 like fresh rows
+    for (uint32_t row = 0; row < m_codes.size(); ++row) {
+        m_codes[row] = is_valid(row) ? remap[m_codes[row]] : 0;
+    }
+    m_dictionary = std::move(dictionary);
+    rebuild_dictionary_index();
+    return dropped;
+}
+
+void Column::resize(size_t rows) {
+    m_size = rows;
+    m_validity.resize((rows + 63) / 64, 0);
+
+    switch (m_type) {
+        case ColumnType::Bool:      m_bools.resize(rows, 0); break;
+        case ColumnType::Int64:
+        case ColumnType::Timestamp:
+        case ColumnType::Edge:      m_ints.resize(rows, 0); break;
+        case ColumnType::Double:    m_doubles.resize(rows, 0.0); break;
+        case ColumnType::String:    m_codes.resize(rows, 0); break;
+        case ColumnType::Auto:      break;
+    }
+}
+
+void Column::widen(ColumnType type) {
+    Column wider(type);
+    wider.m_adaptive = true;
+    wider.resize(m_size);
+    for_each_valid([&](uint32_t row) { wider.set(row, *get(row)); });
+    *this = std::move(wider);
+}
+
+void Column::mark_valid(uint32_t row) {
+    uint64_t& word = m_validity[row >> 6];
+    uint64_t bit = uint64_t{1} << (row & 63);
+    if (!(word & bit)) {
+        word |= bit;
+        ++m_count;
+    }
+}
+
+bool Column::set(uint32_t row, const types::AtomValue& value) {
+    if (m_type == ColumnType::Auto) {
+        auto resolved = column_type_of(value);
+        if (!resolved) {
+            return false;
+        }
+        m_type = *resolved;
+        resize(m_size);
+    } else if (m_adaptive && is_scalar(m_type)) {
+        auto incoming = column_type_of(value);
+        if (!incoming) {
+            return false;
+        }
+        if (*incoming != m_type && m_type != ColumnType::String &&
+            !(m_type == ColumnType::Double && *incoming == ColumnType::Int64)) {
+            widen(m_type == ColumnType::Int64 && *incoming == ColumnType::Double ? ColumnType::Double
+                                                                                 : ColumnType::String);
+        }
+        if (m_type == ColumnType::String && *incoming != ColumnType::String) {
+            return set(row, types::AtomValue{scalar_text(value)});
+        }
+    }
+
+    if (row >= m_size) {
+        // Geometric growth keeps sequential ordinal writes amortized O(1)
+        resize(std::max<size_t>(row + 1, m_size + m_size / 2));
+    }
+
+    switch (m_type) {
+        case ColumnType::Bool: {
+            if (auto* b = std::get_if<bool>(&value)) {
+                m_bools[row] = *b ? 1 : 0;
+            } else if (auto* i = std::get_if<int64_t>(&value)) {
+                m_bools[row] = *i != 0 ? 1 : 0;
+            } else if (auto* s = std::get_if<std::string>(&value)) {
+                if (*s == "true" || *s == "1") m_bools[row] = 1;
+                else if (*s == "false" || *s == "0") m_bools[row] = 0;
+                else return false;
+            } else {
+                return false;
+            }
+            break;
+        }
+        case ColumnType::Int64: {
+            int64_t v = 0;
+            if (auto* i = std::get_if<int64_t>(&value)) {
+                v = *i;
+            } else if (auto* b = std::get_if<bool>(&value)) {
+                v = *b ? 1 : 0;
+            } else if (auto* d = std::get_if<double>(&value)) {
+                // Integral and within [-2^63, 2^63), so the cast is defined (NaN fails both)
+                if (std::trunc(*d) != *d || !(*d >= -0x1p63 && *d < 0x1p63)) return false;
+                v = static_cast<int64_t>(*d);
+            } else if (auto* s = std::get_if<std::string>(&value)) {
+                if (!parse_int(*s, v)) return false;
+            } else {
+                return false;
+            }
+            m_ints[row] = v;
+            break;
+        }
+        case ColumnType::Double: {
+            double v = 0.0;
+            if (auto* d = std::get_if<double>(&value)) {
+                v = *d;
+            } else if (auto* i = std::get_if<int64_t>(&value)) {
+                v = static_cast<double>(*i);
+            } else if (auto* s = std::get_if<std::string>(&value)) {
+                if (!parse_double(*s, v)) return false;
+            } else {
+                return false;
+            }
+            m_doubles[row] = v;
+            break;
+        }
+        case ColumnType::Timestamp: {
+            int64_t v = 0;
+            if (auto* i = std::get_if<int64_t>(&value)) {
+                v = *i;
+            } else if (auto* s = std::get_if<std::string>(&value)) {
+                auto ts = types::parse_timestamp(*s);
+                if (!ts) return false;
+                v = static_cast<int64_t>(*ts);
+            } else {
+                return false;
+            }
+            m_ints[row] = v;
+            break;
+        }
+        case ColumnType::String: {
+            if (auto* s = std::get_if<std::string>(&value)) {
+                m_codes[row] = intern(*s);
+            } else {
+                return false;
+            }
+            break;
+        }
+        case ColumnType::Edge: {
+            // Already-resolved target ordinals only; EdgeValues go through set_edge()
+            auto* i = std::get_if<int64_t>(&value);
+            if (!i || *i < 0 || *i > std::numeric_limits<uint32_t>::max()) return false;
+            m_ints[row] = *i;
+            break;
+        }
+        case ColumnType::Auto:
+            return false;
+    }
+
+    mark_valid(row);
+    return true;
+}
+
+bool Column::set_edge(uint32_t row, uint32_t target) {
+    if (m_type == ColumnType::Auto) {
+        m_type = ColumnType::Edge;
+        resize(m_size);
+    }
+    if (m_type != ColumnType::Edge) {
+        return false;
+    }
+    if (row >= m_size) {
+        resize(std::max<size_t>(row + 1, m_size + m_size / 2));
+    }
+    m_ints[row] = target;
+    mark_valid(row);
+    return true;
+}
+
+void Column::set_null(uint32_t row) {
+    if (row >= m_size) {
+        return;
+    }
+    uint64_t& word = m_validity[row >> 6];
+    uint64_t bit = uint64_t{1} << (row & 63);
+    if (word & bit) {
+        word &= ~bit;
+        --m_count;
+    }
+}
+
+std::optional<types::AtomValue> Column::get(uint32_t row) const {
+    if (!is_valid(row)) {
+        return std::nullopt;
+    }
+    switch (m_type) {
+        case ColumnType::Bool:      return types::AtomValue{m_bools[row] != 0};
+        case ColumnType::Int64:
+        case ColumnType::Timestamp:
+        case ColumnType::Edge:      return types::AtomValue{m_ints[row]};
+        case ColumnType::Double:    return types::AtomValue{m_doubles[row]};
+        case ColumnType::String:    return types::AtomValue{string_at(row)};
+        case ColumnType::Auto:      break;
+    }
+    return std::nullopt;
+}
+
+size_t Column::memory_bytes() const noexcept {
+    size_t bytes = m_validity.capacity() * sizeof(uint64_t)
+                 + m_ints.capacity() * sizeof(int64_t)
+                 + m_doubles.capacity() * sizeof(double)
+                 + m_bools.capacity()
+                 + m_codes.capacity() * sizeof(uint32_t)
+                 + m_dictionary.size() * sizeof(std::string)
+                 + m_dictionary_index.size() * (sizeof(std::string_view) + sizeof(uint32_t) + 2 * sizeof(void*));
+    for (const auto& s : m_dictionary) {
+        if (s.capacity() > 15) bytes += s.capacity();
+    }
+    return bytes;
+}
+
+void Column::write_to(BinaryWriter& writer) const {
+    writer.write_u8(static_cast<uint8_t>(m_type) | (m_adaptive ? kAdaptiveFlag : 0));
+    writer.write_u64(m_size);
+    writer.write_bytes(m_validity.data(), m_validity.size() * sizeof(uint64_t));
+
+    switch (m_type) {
+        case ColumnType::Bool:
+            writer.write_bytes(m_bools.data(), m_bools.size());
+            break;
+        case ColumnType::Int64:
+        case ColumnType::Timestamp:
+        case ColumnType::Edge:
+            writer.write_bytes(m_ints.data(), m_ints.size() * sizeof(int64_t));
+            break;
+        case ColumnType::Double:
+            writer.write_bytes(m_doubles.data(), m_doubles.size() * sizeof(double));
+            break;
+        case ColumnType::String:
+            writer.write_bytes(m_codes.data(), m_codes.size() * sizeof(uint32_t));
+            writer.write_u64(m_dictionary.size());
+            for (const auto& value : m_dictionary) {
+                writer.write_string(value);
+            }
+            break;
+        case ColumnType::Auto:
+            break;
+    }
+}
+
+Column Column::read_from(MemoryReader& reader) {
+    uint8_t type = reader.read_u8();
+    const bool adaptive = (type & kAdaptiveFlag) != 0;
+    type &= static_cast<uint8_t>(~kAdaptiveFlag);
+    if (type > static_cast<uint8_t>(ColumnType::Edge)) {
+        throw std::runtime_error("Unknown column type");
+    }
+    Column column(static_cast<ColumnType>(type));
+    column.m_adaptive = adaptive;
+    column.m_size = reader.read_u64();
+    reader.read_array(column.m_validity, (column.m_size + 63) / 64);
+
+    switch (column.m_type) {
+        case ColumnType::Bool:
+            reader.read_array(column.m_bools, column.m_size);
+            break;
+        case ColumnType::Int64:
+        case ColumnType::Timestamp:
+        case ColumnType::Edge:
+            reader.read_array(column.m_ints, column.m_size);
+            break;
+        case ColumnType::Double:
+            reader.read_array(column.m_doubles, column.m_size);
+            break;
+        case ColumnType::String: {
+            reader.read_array(column.m_codes, column.m_size);
+            uint64_t entries = reader.read_u64();
+            for (uint64_t i = 0; i < entries; ++i) {
+                column.m_dictionary.push_back(reader.read_string());
+            }
+            column.rebuild_dictionary_index();
+            break;
+        }
+        case ColumnType::Auto:
+            break;
+    }
+
+    // Clear bits past the last row so count and iteration stay exact
+    if (column.m_size % 64 != 0 && !column.m_validity.empty()) {
+        column.m_validity.back() &= (uint64_t{1} << (column.m_size % 64)) - 1;
+    }
+    for (uint64_t word : column.m_validity) {
+        column.m_count += static_cast<size_t>(std::popcount(word));
+    }
+    if (column.m_type == ColumnType::String) {
+        bool codes_ok = true;
+        column.for_each_valid([&](uint32_t row) {
+            codes_ok &= column.m_codes[row] < column.m_dictionary.size();
+        });
+        if (!codes_ok) {
+            throw std::runtime_error("Column dictionary code out of range");
+        }
+    }
+    return column;
+}
+
+} // namespace gtaf::core
@@ -0,0 +1,240 @@
+#pragma once
+
+#include "../types/types.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace gtaf::core {
+
+class BinaryWriter;
+class MemoryReader;
+
+/**
+ * @brief Physical type of a typed column
+ *
+ * Columns store one native array per type instead of boxing every value
+ * in an AtomValue or a string. Auto resolves to a concrete type from the
+ * variant type of the first value written to the column, and widens when a
+ * later value conflicts with it (see Column::set()).
+ */
+enum class ColumnType : uint8_t {
+    Auto      = 0,  // Resolve from the first value's variant type
+    Bool      = 1,
+    Int64     = 2,
+    Double    = 3,
+    Timestamp = 4,  // Microseconds since epoch; ISO-8601 strings are parsed on write
+    String    = 5,
+    Edge      = 6   // Target entity ordinal of an EdgeValue (shares the int64 array)
+};
+
+/**
+ * @brief Map an AtomValue's variant type to its natural column type
+ *
+ * @return Column type, or nullopt for values that are not columnar
+ *         (null, vectors, blobs). Edges are not resolved here: their
+ *         targets are store ordinals, written through Column::set_edge().
+ */
+std::optional<ColumnType> column_type_of(const types::AtomValue& value);
+
+/**
+ * @brief Human-readable name of a column type (for diagnostics)
+ */
+const char* column_type_name(ColumnType type);
+
+/**
+ * @brief Typed, row-addressed column with a validity bitmap
+ *
+ * Rows are dense entity ordinals. Only the value array matching type() is
+ * populated; Int64, Timestamp and Edge share the int64 array. Values that cannot
+ * be represented in the column type are rejected by set() rather than
+ * stored lossily.
+ *
+ * String columns are dictionary-encoded: each row holds a 32-bit code into
+ * a dictionary of distinct values. Codes stay stable as rows change, so
+ * structures keyed by code remain valid until compact_dictionary() drops
+ * the values no row holds any more.
+ */
+class Column {
+public:
+    explicit Column(ColumnType type = ColumnType::Auto);
+
+    Column(const Column& other);
+    Column& operator=(const Column& other);
+    Column(Column&&) noexcept = default;
+    Column& operator=(Column&&) noexcept = default;
+
+    [[nodiscard]] ColumnType type() const noexcept { return m_type; }
+
+    /**
+     * @brief Whether the column was created as Auto and widens on conflicts
+     */
+    [[nodiscard]] bool is_adaptive() const noexcept { return m_adaptive; }
+
+    /**
+     * @brief Number of addressable rows (valid or not)
+     */
+    [[nodiscard]] size_t size() const noexcept { return m_size; }
+
+    /**
+     * @brief Number of rows holding a value
+     */
+    [[nodiscard]] size_t count() const noexcept { return m_count; }
+
+    /**
+     * @brief Grow (or shrink) the column to the given number of rows
+     */
+    void resize(size_t rows);
+
+    /**
+     * @brief Store a value at a row, coercing it to the column type
+     *
+     * Grows the column if needed. An Auto column adopts the type of the
+     * first value it accepts and widens on a conflict instead of rejecting:
+     * Int64 to Double for a double, anything else to String (numbers and
+     * booleans keep their text form). Its type thus depends on the set of
+     * values stored, not on their order. Explicitly typed columns coerce.
+     *
+     * @return true if stored, false if the value is not representable
+     */
+    bool set(uint32_t row, const types::AtomValue& value);
+
+    /**
+     * @brief Store the target ordinal of an edge at a row
+     *
+     * An Auto column becomes an Edge column.
+     *
+     * @return true if stored, false if the column is not an Edge column
+     */
+    bool set_edge(uint32_t row, uint32_t target);
+
+    /**
+     * @brief Mark a row as null
+     */
+    void set_null(uint32_t row);
+
+    /**
+     * @brief Check whether a row holds a value
+     */
+    [[nodiscard]] bool is_valid(uint32_t row) const noexcept {
+        return row < m_size && ((m_validity[row >> 6] >> (row & 63)) & 1u);
+    }
+
+    /**
+     * @brief Read a row back as an AtomValue
+     */
+    [[nodiscard]] std::optional<types::AtomValue> get(uint32_t row) const;
+
+    // ---- Native arrays (indexed by row, meaningful only where valid) ----
+    [[nodiscard]] const std::vector<uint64_t>& validity() const noexcept { return m_validity; }
+    [[nodiscard]] const std::vector<int64_t>& ints() const noexcept { return m_ints; }
+    [[nodiscard]] const std::vector<double>& doubles() const noexcept { return m_doubles; }
+    [[nodiscard]] const std::vector<uint8_t>& bools() const noexcept { return m_bools; }
+    [[nodiscard]] const std::vector<uint32_t>& codes() const noexcept { return m_codes; }
+
+    // ---- String dictionary ----
+
+    /**
+     * @brief String value of a valid row
+     */
+    [[nodiscard]] const std::string& string_at(uint32_t row) const noexcept {
+        return m_dictionary[m_codes[row]];
+    }
+
+    /**
+     * @brief Distinct value for a dictionary code
+     */
+    [[nodiscard]] const std::string& dictionary_value(uint32_t code) const noexcept {
+        return m_dictionary[code];
+    }
+
+    /**
+     * @brief Number of distinct values ever stored (codes are 0..size-1)
+     */
+    [[nodiscard]] size_t dictionary_size() const noexcept { return m_dictionary.size(); }
+
+    /**
+     * @brief Look up the code of a value
+     *
+     * @return Code, or nullopt if the value was never stored
+     */
+    [[nodiscard]] std::optional<uint32_t> find_code(std::string_view value) const;
+
+    /**
+     * @brief Drop dictionary values no valid row holds and renumber the rest
+     *
+     * Surviving codes keep their relative order. Every structure keyed by
+     * code must be rebuilt afterwards.
+     *
+     * @return Number of values dropped
+     */
+    size_t compact_dictionary();
+
+    /**
+     * @brief Invoke fn(row) for every valid row in ascending order
+     *
+     * Walks the validity bitmap a word at a time, so sparse columns skip
+     * empty ranges cheaply.
+     */
+    template<typename Fn>
+    void for_each_valid(Fn&& fn) const {
+        for (size_t w = 0; w < m_validity.size(); ++w) {
+            uint64_t bits = m_validity[w];
+            while (bits) {
+                uint32_t row = static_cast<uint32_t>(w * 64 + std::countr_zero(bits));
+                fn(row);
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    /**
+     * @brief Approximate heap footprint in bytes
+     */
+    [[nodiscard]] size_t memory_bytes() const noexcept;
+
+    /**
+     * @brief Serialize type, validity and native arrays (bulk, no per-row framing)
+     */
+    void write_to(BinaryWriter& writer) const;
+
+    /**
+     * @brief Deserialize a column written by write_to()
+     *
+     * @throws std::runtime_error on truncated or inconsistent data
+     */
+    static Column read_from(MemoryReader& reader);
+
+private:
+    void mark_valid(uint32_t row);
+
+    /**
+     * @brief Convert every stored value to a wider type (adaptive columns)
+     */
+    void widen(ColumnType type);
+    uint32_t intern(const std::string& value);
+    void rebuild_dictionary_index();
+
+    ColumnType m_type;
+    bool m_adaptive = false;              // Created as Auto
+    size_t m_size = 0;
+    size_t m_count = 0;
+
+    std::vector<uint64_t> m_validity;     // 1 bit per row
+    std::vector<int64_t> m_ints;          // Int64, Timestamp
+    std::vector<double> m_doubles;        // Double
+    std::vector<uint8_t> m_bools;         // Bool
+    std::vector<uint32_t> m_codes;        // String (dictionary codes)
+
+    // String dictionary: deque keeps element addresses stable for the views
+    std::deque<std::string> m_dictionary;
+    std::unordered_map<std::string_view, uint32_t> m_dictionary_index;
+};
+
+} // namespace gtaf::core
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "../types/types.h"
+#include "column.h"
+#include <string>
+#include <vector>
+
+namespace gtaf::core {
+
+/**
+ * @brief Requested tag and physical type for a projected column
+ *
+ * ColumnType::Auto picks the type from the first value's variant type; an
+ * explicit type coerces values while projecting (e.g. numeric strings to
+ * Int64, ISO dates to Timestamp).
+ */
+struct ColumnSpec {
+    std::string tag;
+    ColumnType type = ColumnType::Auto;
+};
+
+/**
+ * @brief Columnar projection: one typed Column per tag, aligned by entity ordinal
+ *
+ * Row r of every column holds the latest value of that column's tag for
+ * the store entity with ordinal r (AtomStore::entity_at(r)); entities
+ * without the tag, or whose value is not representable in the column
+ * type, are null in the validity bitmap. Built in a single pass over the
+ * reference layer by ProjectionEngine::project_columns(), so analytic
+ * scans read contiguous native arrays instead of per-entity Nodes.
+ *
+ * EdgeValue tags project as ColumnType::Edge columns holding the target
+ * entity's ordinal, so joins along a relation compare integers against
+ * row numbers instead of hashing 16-byte ids.
+ */
+class ColumnarProjection {
+public:
+    ColumnarProjection() = default;
+
+    /**
+     * @brief Number of rows (entity ordinals) in every column
+     */
+    [[nodiscard]] size_t row_count() const noexcept { return m_rows; }
+
+    [[nodiscard]] size_t column_count() const noexcept { return m_columns.size(); }
+
+    /**
+     * @brief Tag of the i-th column (specs order)
+     */
+    [[nodiscard]] const std::string& tag(size_t i) const { return m_tags[i]; }
+
+    /**
+     * @brief The i-th column (specs order)
+     */
+    [[nodiscard]] const Column& column(size_t i) const { return m_columns[i]; }
+
+    /**
+     * @brief Column for a tag, or nullptr if the tag was not projected
+     */
+    [[nodiscard]] const Column* find(const std::string& tag) const {
+        for (size_t i = 0; i < m_tags.size(); ++i) {
+            if (m_tags[i] == tag) return &m_columns[i];
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Store LSN the projection reflects
+     */
+    [[nodiscard]] types::LogSequenceNumber lsn() const noexcept { return {m_lsn}; }
+
+    /**
+     * @brief Approximate heap footprint in bytes
+     */
+    [[nodiscard]] size_t memory_bytes() const noexcept {
+        size_t bytes = 0;
+        for (const auto& column : m_columns) bytes += column.memory_bytes();
+        return bytes;
+    }
+
+private:
+    friend class ProjectionEngine;
+
+    std::vector<std::string> m_tags;
+    std::vector<Column> m_columns;
+    size_t m_rows = 0;
+    uint64_t m_lsn = 0;
+};
+
+} // namespace gtaf::core
@@ -0,0 +1,429 @@
+#include "entity_bitmap.h"
+#include <algorithm>
+#include <iterator>
+
+namespace gtaf::core {
+
+namespace {
+
+inline uint16_t high_bits(uint32_t row) { return static_cast<uint16_t>(row >> 16); }
+inline uint16_t low_bits(uint32_t row) { return static_cast<uint16_t>(row & 0xFFFFu); }
+
+inline bool test_bit(const std::vector<uint64_t>& words, uint16_t low) {
+    return (words[low >> 6] >> (low & 63)) & 1u;
+}
+
+} // namespace
+
+// ---- Container helpers ----
+
+void EntityBitmap::to_bitmap(Container& c) {
+    c.words.assign(BITMAP_WORDS, 0);
+    for (uint16_t low : c.array) {
+        c.words[low >> 6] |= uint64_t{1} << (low & 63);
+    }
+    c.array.clear();
+    c.array.shrink_to_fit();
+}
+
+void EntityBitmap::to_array(Container& c) {
+    c.array.clear();
+    c.array.reserve(c.cardinality);
+    for (uint32_t w = 0; w < BITMAP_WORDS; ++w) {
+        uint64_t bits = c.words[w];
+        while (bits) {
+            c.array.push_back(static_cast<uint16_t>(w * 64 + std::countr_zero(bits)));
+            bits &= bits - 1;
+        }
+    }
+    c.words.clear();
+    c.words.shrink_to_fit();
+}
+
+void EntityBitmap::normalize(Container& c) {
+    if (c.is_bitmap() && c.cardinality <= ARRAY_MAX) {
+        to_array(c);
+    } else if (!c.is_bitmap() && c.cardinality > ARRAY_MAX) {
+        to_bitmap(c);
+    }
+}
+
+EntityBitmap::Container EntityBitmap::intersect(const Container& a, const Container& b) {
+    Container out;
+    if (a.is_bitmap() && b.is_bitmap()) {
+        out.words.resize(BITMAP_WORDS);
+        for (uint32_t w = 0; w < BITMAP_WORDS; ++w) {
+            out.words[w] = a.words[w] & b.words[w];
+            out.cardinality += static_cast<uint32_t>(std::popcount(out.words[w]));
+        }
+        normalize(out);
+    } else if (a.is_bitmap() || b.is_bitmap()) {
+        const Container& arr = a.is_bitmap() ? b : a;
+        const Container& bmp = a.is_bitmap() ? a : b;
+        for (uint16_t low : arr.array) {
+            if (test_bit(bmp.words, low)) out.array.push_back(low);
+        }
+    } else {
+        std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                              std::back_inserter(out.array));
+    }
+    if (!out.is_bitmap()) {
+        out.cardinality = static_cast<uint32_t>(out.array.size());
+    }
+    return out;
+}
+
+void EntityBitmap::unite(Container& a, const Container& b) {
+    if (!a.is_bitmap() && !b.is_bitmap() && a.array.size() + b.array.size() <= ARRAY_MAX) {
+        std::vector<uint16_t> merged;
+        merged.reserve(a.array.size() + b.array.size());
+        std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                       std::back_inserter(merged));
+        a.array = std::move(merged);
+        a.cardinality = static_cast<uint32_t>(a.array.size());
+        return;
+    }
+    if (!a.is_bitmap()) {
+        to_bitmap(a);
+    }
+    if (b.is_bitmap()) {
+        for (uint32_t w = 0; w < BITMAP_WORDS; ++w) a.words[w] |= b.words[w];
+    } else {
+        for (uint16_t low : b.array) a.words[low >> 6] |= uint64_t{1} << (low & 63);
+    }
+    a.cardinality = 0;
+    for (uint64_t word : a.words) {
+        a.cardinality += static_cast<uint32_t>(std::popcount(word));
+    }
+    normalize(a);
+}
+
+void EntityBitmap::subtract(Container& a, const Container& b) {
+    if (a.is_bitmap()) {
+        if (b.is_bitmap()) {
+            for (uint32_t w = 0; w < BITMAP_WORDS; ++w) a.words[w] &= ~b.words[w];
+        } else {
+            for (uint16_t low : b.array) a.words[low >> 6] &= ~(uint64_t{1} << (low & 63));
+        }
+        a.cardinality = 0;
+        for (uint64_t word : a.words) {
+            a.cardinality += static_cast<uint32_t>(std::popcount(word));
+        }
+        normalize(a);
+        return;
+    }
+    if (b.is_bitmap()) {
+        a.array.erase(std::remove_if(a.array.begin(), a.array.end(),
+                                     [&](uint16_t low) { return test_bit(b.words, low); }),
+                      a.array.end());
+    } else {
+        std::vector<uint16_t> kept;
+        kept.reserve(a.array.size());
+        std::set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                            std::back_inserter(kept));
+        a.array = std::move(kept);
+    }
+    a.cardinality = static_cast<uint32_t>(a.array.size());
+}
+
+uint32_t EntityBitmap::intersect_count(const Container& a, const Container& b) {
+    uint32_t count = 0;
+    if (a.is_bitmap() && b.is_bitmap()) {
+        for (uint32_t w = 0; w < BITMAP_WORDS; ++w) {
+            count += static_cast<uint32_t>(std::popcount(a.words[w] & b.words[w]));
+        }
+    } else if (a.is_bitmap() || b.is_bitmap()) {
+        const Container& arr = a.is_bitmap() ? b : a;
+        const Container& bmp = a.is_bitmap() ? a : b;
+        for (uint16_t low : arr.array) {
+            count += test_bit(bmp.words, low) ? 1 : 0;
+        }
+    } else {
+        size_t i = 0, j = 0;
+        while (i < a.array.size() && j < b.array.size()) {
+            if (a.array[i] < b.array[j]) ++i;
+            else if (b.array[j] < a.array[i]) ++j;
+            else { ++count; ++i; ++j; }
+        }
+    }
+    return count;
+}
+
+// ---- EntityBitmap Implementation ----
+
+EntityBitmap EntityBitmap::from_rows(std::vector<uint32_t> rows) {
+    if (!std::is_sorted(rows.begin(), rows.end())) {
+        std::sort(rows.begin(), rows.end());
+    }
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    EntityBitmap bitmap;
+    size_t i = 0;
+    while (i < rows.size()) {
+        const uint16_t key = high_bits(rows[i]);
+        size_t j = i;
+        while (j < rows.size() && high_bits(rows[j]) == key) ++j;
+
+        Container c;
+        c.cardinality = static_cast<uint32_t>(j - i);
+        if (c.cardinality > ARRAY_MAX) {
+            c.words.assign(BITMAP_WORDS, 0);
+            for (size_t k = i; k < j; ++k) {
+                uint16_t low = low_bits(rows[k]);
+                c.words[low >> 6] |= uint64_t{1} << (low & 63);
+            }
+        } else {
+            c.array.reserve(c.cardinality);
+            for (size_t k = i; k < j; ++k) c.array.push_back(low_bits(rows[k]));
+        }
+        bitmap.m_keys.push_back(key);
+        bitmap.m_containers.push_back(std::move(c));
+        i = j;
+    }
+    return bitmap;
+}
+
+EntityBitmap EntityBitmap::range(uint32_t begin, uint32_t end) {
+    EntityBitmap bitmap;
+    uint64_t row = begin;
+    while (row < end) {
+        const uint16_t key = high_bits(static_cast<uint32_t>(row));
+        const uint64_t chunk_end = std::min<uint64_t>(end, (static_cast<uint64_t>(key) + 1) << 16);
+
+        Container c;
+        c.cardinality = static_cast<uint32_t>(chunk_end - row);
+        if (c.cardinality > ARRAY_MAX) {
+            c.words.assign(BITMAP_WORDS, 0);
+            for (uint64_t r = row; r < chunk_end; ++r) {
+                uint16_t low = low_bits(static_cast<uint32_t>(r));
+                c.words[low >> 6] |= uint64_t{1} << (low & 63);
+            }
+        } else {
+            for (uint64_t r = row; r < chunk_end; ++r) c.array.push_back(low_bits(static_cast<uint32_t>(r)));
+        }
+        bitmap.m_keys.push_back(key);
+        bitmap.m_containers.push_back(std::move(c));
+        row = chunk_end;
+    }
+    return bitmap;
+}
+
+const EntityBitmap::Container* EntityBitmap::find_container(uint16_t key) const {
+    auto it = std::lower_bound(m_keys.begin(), m_keys.end(), key);
+    if (it == m_keys.end() || *it != key) {
+        return nullptr;
+    }
+    return &m_containers[static_cast<size_t>(it - m_keys.begin())];
+}
+
+EntityBitmap::Container& EntityBitmap::container_for(uint16_t key) {
+    auto it = std::lower_bound(m_keys.begin(), m_keys.end(), key);
+    auto pos = static_cast<size_t>(it - m_keys.begin());
+    if (it == m_keys.end() || *it != key) {
+        m_keys.insert(it, key);
+        m_containers.insert(m_containers.begin() + static_cast<std::ptrdiff_t>(pos), Container{});
+    }
+    return m_containers[pos];
+}
+
+void EntityBitmap::add(uint32_t row) {
+    Container& c = container_for(high_bits(row));
+    const uint16_t low = low_bits(row);
+    if (c.is_bitmap()) {
+        uint64_t& word = c.words[low >> 6];
+        const uint64_t bit = uint64_t{1} << (low & 63);
+        if (!(word & bit)) {
+            word |= bit;
+            ++c.cardinality;
+        }
+        return;
+    }
+    if (c.array.empty() || c.array.back() < low) {
+        c.array.push_back(low);
+    } else {
+        auto it = std::lower_bound(c.array.begin(), c.array.end(), low);
+        if (it != c.array.end() && *it == low) {
+            return;
+        }
+        c.array.insert(it, low);
+    }
+    ++c.cardinality;
+    normalize(c);
+}
+
+bool EntityBitmap::remove(uint32_t row) {
+    auto it = std::lower_bound(m_keys.begin(), m_keys.end(), high_bits(row));
+    if (it == m_keys.end() || *it != high_bits(row)) {
+        return false;
+    }
+    auto pos = static_cast<size_t>(it - m_keys.begin());
+    Container& c = m_containers[pos];
+    const uint16_t low = low_bits(row);
+    if (c.is_bitmap()) {
+        uint64_t& word = c.words[low >> 6];
+        const uint64_t bit = uint64_t{1} << (low & 63);
+        if (!(word & bit)) {
+            return false;
+        }
+        word &= ~bit;
+    } else {
+        auto at = std::lower_bound(c.array.begin(), c.array.end(), low);
+        if (at == c.array.end() || *at != low) {
+            return false;
+        }
+        c.array.erase(at);
+    }
+    if (--c.cardinality == 0) {
+        m_keys.erase(it);
+        m_containers.erase(m_containers.begin() + static_cast<std::ptrdiff_t>(pos));
+    } else {
+        normalize(c);
+    }
+    return true;
+}
+
+bool EntityBitmap::contains(uint32_t row) const {
+    const Container* c = find_container(high_bits(row));
+    if (!c) {
+        return false;
+    }
+    const uint16_t low = low_bits(row);
+    if (c->is_bitmap()) {
+        return test_bit(c->words, low);
+    }
+    return std::binary_search(c->array.begin(), c->array.end(), low);
+}
+
+uint64_t EntityBitmap::cardinality() const noexcept {
+    uint64_t total = 0;
+    for (const auto& c : m_containers) {
+        total += c.cardinality;
+    }
+    return total;
+}
+
+void EntityBitmap::clear() noexcept {
+    m_keys.clear();
+    m_containers.clear();
+}
+
+EntityBitmap& EntityBitmap::operator&=(const EntityBitmap& other) {
+    size_t out = 0;
+    size_t j = 0;
+    for (size_t i = 0; i < m_keys.size(); ++i) {
+        while (j < other.m_keys.size() && other.m_keys[j] < m_keys[i]) ++j;
+        if (j == other.m_keys.size()) break;
+        if (other.m_keys[j] != m_keys[i]) continue;
+
+        Container c = intersect(m_containers[i], other.m_containers[j]);
+        if (c.cardinality > 0) {
+            m_keys[out] = m_keys[i];
+            m_containers[out] = std::move(c);
+            ++out;
+        }
+    }
+    m_keys.resize(out);
+    m_containers.resize(out);
+    return *this;
+}
+
+EntityBitmap& EntityBitmap::operator|=(const EntityBitmap& other) {
+    if (this == &other) {
+        return *this;
+    }
+    std::vector<uint16_t> keys;
+    std::vector<Container> containers;
+    keys.reserve(m_keys.size() + other.m_keys.size());
+    containers.reserve(m_keys.size() + other.m_keys.size());
+
+    size_t i = 0, j = 0;
+    while (i < m_keys.size() || j < other.m_keys.size()) {
+        if (j == other.m_keys.size() || (i < m_keys.size() && m_keys[i] < other.m_keys[j])) {
+            keys.push_back(m_keys[i]);
+            containers.push_back(std::move(m_containers[i]));
+            ++i;
+        } else if (i == m_keys.size() || other.m_keys[j] < m_keys[i]) {
+            keys.push_back(other.m_keys[j]);
+            containers.push_back(other.m_containers[j]);
+            ++j;
+        } else {
+            unite(m_containers[i], other.m_containers[j]);
+            keys.push_back(m_keys[i]);
+            containers.push_back(std::move(m_containers[i]));
+            ++i;
+            ++j;
+        }
+    }
+    m_keys = std::move(keys);
+    m_containers = std::move(containers);
+    return *this;
+}
+
+EntityBitmap& EntityBitmap::operator-=(const EntityBitmap& other) {
+    if (this == &other) {
+        clear();
+        return *this;
+    }
+    size_t out = 0;
+    size_t j = 0;
+    for (size_t i = 0; i < m_keys.size(); ++i) {
+        while (j < other.m_keys.size() && other.m_keys[j] < m_keys[i]) ++j;
+        if (j < other.m_keys.size() && other.m_keys[j] == m_keys[i]) {
+            subtract(m_containers[i], other.m_containers[j]);
+        }
+        if (m_containers[i].cardinality > 0) {
+            if (out != i) {
+                m_keys[out] = m_keys[i];
+                m_containers[out] = std::move(m_containers[i]);
+            }
+            ++out;
+        }
+    }
+    m_keys.resize(out);
+    m_containers.resize(out);
+    return *this;
+}
+
+uint64_t EntityBitmap::and_cardinality(const EntityBitmap& other) const {
+    uint64_t count = 0;
+    size_t i = 0, j = 0;
+    while (i < m_keys.size() && j < other.m_keys.size()) {
+        if (m_keys[i] < other.m_keys[j]) ++i;
+        else if (other.m_keys[j] < m_keys[i]) ++j;
+        else count += intersect_count(m_containers[i++], other.m_containers[j++]);
+    }
+    return count;
+}
+
+bool EntityBitmap::operator==(const EntityBitmap& other) const {
+    if (m_keys != other.m_keys) {
+        return false;
+    }
+    // Representation is canonical for a given cardinality, so compare payloads directly
+    for (size_t i = 0; i < m_containers.size(); ++i) {
+        const Container& a = m_containers[i];
+        const Container& b = other.m_containers[i];
+        if (a.cardinality != b.cardinality || a.array != b.array || a.words != b.words) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<uint32_t> EntityBitmap::to_vector() const {
+    std::vector<uint32_t> rows;
+    rows.reserve(cardinality());
+    for_each([&](uint32_t row) { rows.push_back(row); });
+    return rows;
+}
+
+size_t EntityBitmap::memory_bytes() const noexcept {
+    size_t bytes = m_keys.capacity() * sizeof(uint16_t)
+                 + m_containers.capacity() * sizeof(Container);
+    for (const auto& c : m_containers) {
+        bytes += c.array.capacity() * sizeof(uint16_t) + c.words.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+} // namespace gtaf::core
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace gtaf::core {
+
+/**
+ * @brief Compressed bitmap over dense 32-bit entity ordinals (roaring-style)
+ *
+ * The ordinal space is split into 65536-wide chunks keyed by the high 16
+ * bits. Each non-empty chunk is stored in one of two containers:
+ * - array:  sorted uint16_t low bits, used up to ARRAY_MAX members
+ * - bitmap: 1024 x 64-bit words, used above ARRAY_MAX members
+ *
+ * Sparse results cost 2 bytes per member, dense ones at most 1 bit per
+ * possible ordinal, and AND/OR/ANDNOT run container-by-container with
+ * word-level operations on dense chunks. Containers are converted back
+ * and forth as cardinality crosses ARRAY_MAX, so results stay compact.
+ */
+class EntityBitmap {
+public:
+    /**
+     * @brief Largest cardinality kept in an array container
+     */
+    static constexpr uint32_t ARRAY_MAX = 4096;
+
+    /**
+     * @brief Number of 64-bit words in a bitmap container
+     */
+    static constexpr uint32_t BITMAP_WORDS = 1024;
+
+    class const_iterator;
+
+    EntityBitmap() = default;
+
+    /**
+     * @brief Build a bitmap from ordinals in any order (duplicates allowed)
+     */
+    static EntityBitmap from_rows(std::vector<uint32_t> rows);
+
+    /**
+     * @brief Build a bitmap holding every ordinal in [begin, end)
+     */
+    static EntityBitmap range(uint32_t begin, uint32_t end);
+
+    /**
+     * @brief Add an ordinal
+     */
+    void add(uint32_t row);
+
+    /**
+     * @brief Remove an ordinal
+     *
+     * @return true if the ordinal was present
+     */
+    bool remove(uint32_t row);
+
+    /**
+     * @brief Check whether an ordinal is present
+     */
+    [[nodiscard]] bool contains(uint32_t row) const;
+
+    /**
+     * @brief Number of ordinals in the set
+     */
+    [[nodiscard]] uint64_t cardinality() const noexcept;
+
+    [[nodiscard]] bool empty() const noexcept { return m_keys.empty(); }
+
+    /**
+     * @brief Remove all ordinals
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Intersection (AND)
+     */
+    EntityBitmap& operator&=(const EntityBitmap& other);
+
+    /**
+     * @brief Union (OR)
+     */
+    EntityBitmap& operator|=(const EntityBitmap& other);
+
+    /**
+     * @brief Difference (AND NOT)
+     */
+    EntityBitmap& operator-=(const EntityBitmap& other);
+
+    friend EntityBitmap operator&(EntityBitmap lhs, const EntityBitmap& rhs) { return lhs &= rhs; }
+    friend EntityBitmap operator|(EntityBitmap lhs, const EntityBitmap& rhs) { return lhs |= rhs; }
+    friend EntityBitmap operator-(EntityBitmap lhs, const EntityBitmap& rhs) { return lhs -= rhs; }
+
+    /**
+     * @brief Cardinality of the intersection without materializing it
+     */
+    [[nodiscard]] uint64_t and_cardinality(const EntityBitmap& other) const;
+
+    bool operator==(const EntityBitmap& other) const;
+    bool operator!=(const EntityBitmap& other) const { return !(*this == other); }
+
+    /**
+     * @brief Invoke fn(row) for every ordinal in ascending order
+     */
+    template<typename Fn>
+    void for_each(Fn&& fn) const;
+
+    /**
+     * @brief Materialize all ordinals in ascending order
+     */
+    [[nodiscard]] std::vector<uint32_t> to_vector() const;
+
+    [[nodiscard]] const_iterator begin() const;
+    [[nodiscard]] const_iterator end() const;
+
+    /**
+     * @brief Number of array and bitmap containers (for diagnostics)
+     */
+    [[nodiscard]] size_t container_count() const noexcept { return m_keys.size(); }
+
+    /**
+     * @brief Approximate heap footprint in bytes
+     */
+    [[nodiscard]] size_t memory_bytes() const noexcept;
+
+private:
+    struct Container {
+        std::vector<uint16_t> array;   // Sorted low bits (array container)
+        std::vector<uint64_t> words;   // BITMAP_WORDS words (bitmap container)
+        uint32_t cardinality = 0;
+
+        [[nodiscard]] bool is_bitmap() const noexcept { return !words.empty(); }
+    };
+
+    /**
+     * @brief Find the container for a high key, or nullptr
+     */
+    [[nodiscard]] const Container* find_container(uint16_t key) const;
+
+    /**
+     * @brief Find or insert the container for a high key
+     */
+    Container& container_for(uint16_t key);
+
+    /**
+     * @brief Switch a container to the representation matching its cardinality
+     */
+    static void normalize(Container& c);
+    static void to_bitmap(Container& c);
+    static void to_array(Container& c);
+
+    static Container intersect(const Container& a, const Container& b);
+    static void unite(Container& a, const Container& b);
+    static void subtract(Container& a, const Container& b);
+    static uint32_t intersect_count(const Container& a, const Container& b);
+
+    std::vector<uint16_t> m_keys;          // Sorted high 16 bits
+    std::vector<Container> m_containers;   // Parallel to m_keys, never empty
+};
+
+/**
+ * @brief Forward iterator over the ordinals of an EntityBitmap
+ */
+class EntityBitmap::const_iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = uint32_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const uint32_t*;
+    using reference = uint32_t;
+
+    const_iterator() = default;
+
+    uint32_t operator*() const noexcept { return m_value; }
+
+    const_iterator& operator++() {
+        const Container& c = m_owner->m_containers[m_container];
+        if (c.is_bitmap()) {
+            m_bits &= m_bits - 1;
+        } else {
+            ++m_pos;
+        }
+        settle();
+        return *this;
+    }
+
+    const_iterator operator++(int) {
+        const_iterator copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    bool operator==(const const_iterator& other) const noexcept {
+        return m_container == other.m_container && m_pos == other.m_pos && m_bits == other.m_bits;
+    }
+    bool operator!=(const const_iterator& other) const noexcept { return !(*this == other); }
+
+private:
+    friend class EntityBitmap;
+
+    const_iterator(const EntityBitmap* owner, size_t container)
+        : m_owner(owner), m_container(container) {
+        enter();
+        settle();
+    }
+
+    // Position at the start of the current container
+    void enter() {
+        m_pos = 0;
+        m_bits = 0;
+        if (m_container < m_owner->m_containers.size()) {
+            const Container& c = m_owner->m_containers[m_container];
+            if (c.is_bitmap()) m_bits = c.words[0];
+        }
+    }
+
+    // Advance to the next present ordinal (or end) and cache its value
+    void settle() {
+        while (m_container < m_owner->m_containers.size()) {
+            const Container& c = m_owner->m_containers[m_container];
+            const uint32_t high = static_cast<uint32_t>(m_owner->m_keys[m_container]) << 16;
+            if (c.is_bitmap()) {
+                while (m_bits == 0 && ++m_pos < BITMAP_WORDS) {
+                    m_bits = c.words[m_pos];
+                }
+                if (m_bits) {
+                    m_value = high | (m_pos * 64 + static_cast<uint32_t>(std::countr_zero(m_bits)));
+                    return;
+                }
+            } else if (m_pos < c.array.size()) {
+                m_value = high | c.array[m_pos];
+                return;
+            }
+            ++m_container;
+            enter();
+        }
+    }
+
+    const EntityBitmap* m_owner = nullptr;
+    size_t m_container = 0;
+    uint32_t m_pos = 0;     // Array index, or word index for bitmap containers
+    uint64_t m_bits = 0;    // Unvisited bits of the current word
+    uint32_t m_value = 0;
+};
+
+inline EntityBitmap::const_iterator EntityBitmap::begin() const {
+    return const_iterator(this, 0);
+}
+
+inline EntityBitmap::const_iterator EntityBitmap::end() const {
+    return const_iterator(this, m_containers.size());
+}
+
+// Template implementations (must be in header)
+template<typename Fn>
+void EntityBitmap::for_each(Fn&& fn) const {
+    for (size_t i = 0; i < m_keys.size(); ++i) {
+        const uint32_t high = static_cast<uint32_t>(m_keys[i]) << 16;
+        const Container& c = m_containers[i];
+        if (c.is_bitmap()) {
+            for (uint32_t w = 0; w < BITMAP_WORDS; ++w) {
+                uint64_t bits = c.words[w];
+                while (bits) {
+                    fn(high | (w * 64 + static_cast<uint32_t>(std::countr_zero(bits))));
+                    bits &= bits - 1;
+                }
+            }
+        } else {
+            for (uint16_t low : c.array) {
+                fn(high | low);
+            }
+        }
+    }
+}
+
+} // namespace gtaf::core
@@ -0,0 +1,1439 @@
+#include "executor.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace gtaf::core::exec {
+
+static_assert(kBatchSize % 64 == 0, "scan batches must start on validity word boundaries");
+
+namespace {
+
+constexpr size_t kNoColumn = std::numeric_limits<size_t>::max();
+
+size_t find_field(const Schema& schema, std::string_view name) {
+    for (size_t i = 0; i < schema.size(); ++i) {
+        if (schema[i].name == name) return i;
+    }
+    throw std::invalid_argument("Unknown column: " + std::string(name));
+}
+
+bool is_numeric(DataType type) {
+    return type == DataType::Int64 || type == DataType::Double;
+}
+
+DataType scan_type(ColumnType type) {
+    switch (type) {
+        case ColumnType::Bool:   return DataType::Bool;
+        case ColumnType::Double: return DataType::Double;
+        case ColumnType::String: return DataType::String;
+        default:                 return DataType::Int64;  // Int64, Timestamp, Edge, Auto (all null)
+    }
+}
+
+// View of a numeric vector as doubles, converting Int64 into scratch
+const double* as_doubles(const Vector& v, std::vector<double>& scratch) {
+    if (v.type == DataType::Double) {
+        return v.doubles.data();
+    }
+    scratch.resize(v.size());
+    for (size_t i = 0; i < scratch.size(); ++i) {
+        scratch[i] = static_cast<double>(v.ints[i]);
+    }
+    return scratch.data();
+}
+
+uint64_t mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+uint64_t value_hash(const Vector& v, uint32_t row) {
+    if (!v.valid[row]) {
+        return 0x9e3779b97f4a7c15ULL;
+    }
+    switch (v.type) {
+        case DataType::Double: {
+            double d = v.doubles[row];
+            if (d == 0.0) d = 0.0;  // -0.0 groups with 0.0
+            return mix(std::bit_cast<uint64_t>(d));
+        }
+        case DataType::String:
+            return std::hash<std::string_view>{}(v.strings[row]);
+        default:
+            return mix(static_cast<uint64_t>(v.ints[row]));
+    }
+}
+
+bool values_equal(const Vector& a, uint32_t ra, const Vector& b, uint32_t rb) {
+    if (!a.valid[ra] || !b.valid[rb]) {
+        return !a.valid[ra] && !b.valid[rb];
+    }
+    switch (a.type) {
+        case DataType::Double: {
+            double x = a.doubles[ra], y = b.doubles[rb];
+            return x == y || (std::isnan(x) && std::isnan(y));
+        }
+        case DataType::String:
+            return a.strings[ra] == b.strings[rb];
+        default:
+            return a.ints[ra] == b.ints[rb];
+    }
+}
+
+// Three-way comparison with nulls ordered first
+int compare_values(const Vector& v, uint32_t a, uint32_t b) {
+    const bool va = v.valid[a] != 0, vb = v.valid[b] != 0;
+    if (!va || !vb) {
+        return static_cast<int>(va) - static_cast<int>(vb);
+    }
+    switch (v.type) {
+        case DataType::Double: {
+            double x = v.doubles[a], y = v.doubles[b];
+            return (x < y) ? -1 : (y < x) ? 1 : 0;
+        }
+        case DataType::String: {
+            int c = v.strings[a].compare(v.strings[b]);
+            return (c > 0) - (c < 0);
+        }
+        default: {
+            int64_t x = v.ints[a], y = v.ints[b];
+            return (x > y) - (x < y);
+        }
+    }
+}
+
+} // namespace
+
+// ---- Vector / Table ----
+
+const char* data_type_name(DataType type) {
+    switch (type) {
+        case DataType::Bool:   return "Bool";
+        case DataType::Int64:  return "Int64";
+        case DataType::Double: return "Double";
+        case DataType::String: return "String";
+    }
+    return "Unknown";
+}
+
+void Vector::reset(DataType new_type, size_t rows) {
+    type = new_type;
+    valid.resize(rows);
+    switch (type) {
+        case DataType::Double: doubles.resize(rows); break;
+        case DataType::String: strings.resize(rows); break;
+        default:               ints.resize(rows); break;
+    }
+}
+
+void Vector::append(const Vector& source, uint32_t row) {
+    valid.push_back(source.valid[row]);
+    switch (type) {
+        case DataType::Double: doubles.push_back(source.doubles[row]); break;
+        case DataType::String: strings.push_back(source.strings[row]); break;
+        default:               ints.push_back(source.ints[row]); break;
+    }
+}
+
+void Vector::gather(const Vector& source, const uint32_t* rows, size_t count) {
+    reset(source.type, count);
+    for (size_t i = 0; i < count; ++i) {
+        valid[i] = source.valid[rows[i]];
+    }
+    switch (type) {
+        case DataType::Double:
+            for (size_t i = 0; i < count; ++i) doubles[i] = source.doubles[rows[i]];
+            break;
+        case DataType::String:
+            for (size_t i = 0; i < count; ++i) strings[i] = source.strings[rows[i]];
+            break;
+        default:
+            for (size_t i = 0; i < count; ++i) ints[i] = source.ints[rows[i]];
+            break;
+    }
+}
+
+Table::Table(Schema schema)
+    : m_schema(std::move(schema)), m_columns(m_schema.size()) {
+    for (size_t i = 0; i < m_schema.size(); ++i) {
+        m_columns[i].reset(m_schema[i].type, 0);
+    }
+}
+
+std::optional<size_t> Table::column_index(std::string_view name) const {
+    for (size_t i = 0; i < m_schema.size(); ++i) {
+        if (m_schema[i].name == name) return i;
+    }
+    return std::nullopt;
+}
+
+const Vector* Table::find_column(std::string_view name) const {
+    auto index = column_index(name);
+    return index ? &m_columns[*index] : nullptr;
+}
+
+void Table::append(const Batch& batch) {
+    for (size_t i = 0; i < m_columns.size(); ++i) {
+        Vector& column = m_columns[i];
+        const Vector& source = batch.columns[i];
+        batch.for_each_active([&](uint32_t row) { column.append(source, row); });
+    }
+    m_rows += batch.active_count();
+}
+
+void Table::gather(const uint32_t* rows, size_t count, Batch& batch) const {
+    batch.rows = count;
+    batch.columns.resize(m_columns.size());
+    for (size_t i = 0; i < m_columns.size(); ++i) {
+        batch.columns[i].gather(m_columns[i], rows, count);
+    }
+    batch.selection.clear();
+    batch.selective = false;
+}
+
+// ---- Expressions ----
+
+/**
+ * @brief Expression bound to an input schema, evaluated a batch at a time
+ *
+ * Evaluation covers every physical row of the batch (not just the active
+ * ones) so the inner loops stay branch-free; results for inactive rows
+ * are ignored downstream. Column references return the input column
+ * itself; only computed expressions write a result of their own.
+ */
+class BoundExpr {
+public:
+    explicit BoundExpr(DataType type) : m_type(type) {}
+    virtual ~BoundExpr() = default;
+
+    [[nodiscard]] DataType type() const noexcept { return m_type; }
+
+    /**
+     * @brief Result for the batch, valid until the next evaluation
+     */
+    virtual const Vector& evaluate(const Batch& batch) = 0;
+
+    /**
+     * @brief Evaluate into an output column, copying only input columns
+     */
+    void evaluate_into(const Batch& batch, Vector& out) {
+        const Vector& result = evaluate(batch);
+        if (&result == &m_result) {
+            std::swap(out, m_result);   // Buffers are recycled on the next batch
+        } else {
+            out = result;
+        }
+    }
+
+protected:
+    Vector m_result;   // Computed results (unused by column references)
+
+private:
+    DataType m_type;
+};
+
+class ExprNode {
+public:
+    virtual ~ExprNode() = default;
+
+    virtual std::unique_ptr<BoundExpr> bind(const Schema& schema) const = 0;
+};
+
+namespace {
+
+enum class ArithOp : uint8_t { Add, Sub, Mul, Div };
+enum class CompareOp : uint8_t { Eq, Ne, Lt, Le, Gt, Ge };
+enum class LogicOp : uint8_t { And, Or, Not };
+
+class BoundColumn final : public BoundExpr {
+public:
+    BoundColumn(size_t index, DataType type) : BoundExpr(type), m_index(index) {}
+
+    const Vector& evaluate(const Batch& batch) override {
+        return batch.columns[m_index];
+    }
+
+private:
+    size_t m_index;
+};
+
+class ColumnNode final : public ExprNode {
+public:
+    explicit ColumnNode(std::string name) : m_name(std::move(name)) {}
+
+    std::unique_ptr<BoundExpr> bind(const Schema& schema) const override {
+        size_t index = find_field(schema, m_name);
+        return std::make_unique<BoundColumn>(index, schema[index].type);
+    }
+
+private:
+    std::string m_name;
+};
+
+class BoundLiteral final : public BoundExpr {
+public:
+    BoundLiteral(DataType type, int64_t i, double d, std::string s)
+        : BoundExpr(type), m_int(i), m_double(d), m_string(std::move(s)) {}
+
+    const Vector& evaluate(const Batch& batch) override {
+        Vector& out = m_result;
+        out.reset(type(), batch.rows);
+        std::fill(out.valid.begin(), out.valid.end(), uint8_t{1});
+        switch (type()) {
+            case DataType::Double: std::fill(out.doubles.begin(), out.doubles.end(), m_double); break;
+            case DataType::String: std::fill(out.strings.begin(), out.strings.end(), std::string_view(m_string)); break;
+            default:               std::fill(out.ints.begin(), out.ints.end(), m_int); break;
+        }
+        return out;
+    }
+
+private:
+    int64_t m_int;
+    double m_double;
+    std::string m_string;  // Owned: batch strings view into it
+};
+
+class LiteralNode final : public ExprNode {
+public:
+    LiteralNode(DataType type, int64_t i, double d, std::string s)
+        : m_type(type), m_int(i), m_double(d), m_string(std::move(s)) {}
+
+    std::unique_ptr<BoundExpr> bind(const Schema&) const override {
+        return std::make_unique<BoundLiteral>(m_type, m_int, m_double, m_string);
+    }
+
+private:
+    DataType m_type;
+    int64_t m_int;
+    double m_double;
+    std::string m_string;
+};
+
+class BoundArith final : public BoundExpr {
+public:
+    BoundArith(DataType type, ArithOp op, std::unique_ptr<BoundExpr> lhs, std::unique_ptr<BoundExpr> rhs)
+        : BoundExpr(type), m_op(op), m_lhs(std::move(lhs)), m_rhs(std::move(rhs)) {}
+
+    const Vector& evaluate(const Batch& batch) override {
+        const Vector& left = m_lhs->evaluate(batch);
+        const Vector& right = m_rhs->evaluate(batch);
+        const size_t n = batch.rows;
+        Vector& out = m_result;
+        out.reset(type(), n);
+        for (size_t i = 0; i < n; ++i) {
+            out.valid[i] = left.valid[i] & right.valid[i];
+        }
+
+        if (type() == DataType::Int64) {
+            // Wrapping arithmetic: null rows may hold arbitrary values
+            const int64_t* a = left.ints.data();
+            const int64_t* b = right.ints.data();
+            int64_t* r = out.ints.data();
+            auto wrap = [](uint64_t v) { return static_cast<int64_t>(v); };
+            switch (m_op) {
+                case ArithOp::Add:
+                    for (size_t i = 0; i < n; ++i) r[i] = wrap(static_cast<uint64_t>(a[i]) + static_cast<uint64_t>(b[i]));
+                    break;
+                case ArithOp::Sub:
+                    for (size_t i = 0; i < n; ++i) r[i] = wrap(static_cast<uint64_t>(a[i]) - static_cast<uint64_t>(b[i]));
+                    break;
+                case ArithOp::Mul:
+                    for (size_t i = 0; i < n; ++i) r[i] = wrap(static_cast<uint64_t>(a[i]) * static_cast<uint64_t>(b[i]));
+                    break;
+                case ArithOp::Div:
+                    break;  // Division always binds as Double
+            }
+            return out;
+        }
+
+        const double* a = as_doubles(left, m_left_scratch);
+        const double* b = as_doubles(right, m_right_scratch);
+        double* r = out.doubles.data();
+        switch (m_op) {
+            case ArithOp::Add: for (size_t i = 0; i < n; ++i) r[i] = a[i] + b[i]; break;
+            case ArithOp::Sub: for (size_t i = 0; i < n; ++i) r[i] = a[i] - b[i]; break;
+            case ArithOp::Mul: for (size_t i = 0; i < n; ++i) r[i] = a[i] * b[i]; break;
+            case ArithOp::Div: for (size_t i = 0; i < n; ++i) r[i] = a[i] / b[i]; break;
+        }
+        return out;
+    }
+
+private:
+    ArithOp m_op;
+    std::unique_ptr<BoundExpr> m_lhs, m_rhs;
+    std::vector<double> m_left_scratch, m_right_scratch;
+};
+
+class ArithNode final : public ExprNode {
+public:
+    ArithNode(ArithOp op, Expr lhs, Expr rhs) : m_op(op), m_lhs(std::move(lhs)), m_rhs(std::move(rhs)) {}
+
+    std::unique_ptr<BoundExpr> bind(const Schema& schema) const override {
+        auto lhs = m_lhs.node()->bind(schema);
+        auto rhs = m_rhs.node()->bind(schema);
+        if (!is_numeric(lhs->type()) || !is_numeric(rhs->type())) {
+            throw std::invalid_argument(std::string("Arithmetic needs numeric operands, got ") +
+                                        data_type_name(lhs->type()) + " and " + data_type_name(rhs->type()));
+        }
+        DataType type = (m_op == ArithOp::Div || lhs->type() == DataType::Double || rhs->type() == DataType::Double)
+            ? DataType::Double : DataType::Int64;
+        return std::make_unique<BoundArith>(type, m_op, std::move(lhs), std::move(rhs));
+    }
+
+private:
+    ArithOp m_op;
+    Expr m_lhs, m_rhs;
+};
+
+template<typename T>
+void compare_loop(CompareOp op, const T* a, const T* b, size_t n, int64_t* r) {
+    switch (op) {
+        case CompareOp::Eq: for (size_t i = 0; i < n; ++i) r[i] = a[i] == b[i]; break;
+        case CompareOp::Ne: for (size_t i = 0; i < n; ++i) r[i] = a[i] != b[i]; break;
+        case CompareOp::Lt: for (size_t i = 0; i < n; ++i) r[i] = a[i] < b[i]; break;
+        case CompareOp::Le: for (size_t i = 0; i < n; ++i) r[i] = a[i] <= b[i]; break;
+        case CompareOp::Gt: for (size_t i = 0; i < n; ++i) r[i] = a[i] > b[i]; break;
+        case CompareOp::Ge: for (size_t i = 0; i < n; ++i) r[i] = a[i] >= b[i]; break;
+    }
+}
+
+class BoundCompare final : public BoundExpr {
+public:
+    BoundCompare(CompareOp op, std::unique_ptr<BoundExpr> lhs, std::unique_ptr<BoundExpr> rhs)
+        : BoundExpr(DataType::Bool), m_op(op), m_lhs(std::move(lhs)), m_rhs(std::move(rhs)) {}
+
+    const Vector& evaluate(const Batch& batch) override {
+        const Vector& left = m_lhs->evaluate(batch);
+        const Vector& right = m_rhs->evaluate(batch);
+        const size_t n = batch.rows;
+        Vector& out = m_result;
+        out.reset(DataType::Bool, n);
+        for (size_t i = 0; i < n; ++i) {
+            out.valid[i] = left.valid[i] & right.valid[i];
+        }
+
+        int64_t* r = out.ints.data();
+        if (left.type == DataType::String) {
+            compare_loop(m_op, left.strings.data(), right.strings.data(), n, r);
+        } else if (left.type == DataType::Double || right.type == DataType::Double) {
+            compare_loop(m_op, as_doubles(left, m_left_scratch), as_doubles(right, m_right_scratch), n, r);
+        } else {
+            compare_loop(m_op, left.ints.data(), right.ints.data(), n, r);
+        }
+        return out;
+    }
+
+private:
+    CompareOp m_op;
+    std::unique_ptr<BoundExpr> m_lhs, m_rhs;
+    std::vector<double> m_left_scratch, m_right_scratch;
+};
+
+class CompareNode final : public ExprNode {
+public:
+    CompareNode(CompareOp op, Expr lhs, Expr rhs) : m_op(op), m_lhs(std::move(lhs)), m_rhs(std::move(rhs)) {}
+
+    std::unique_ptr<BoundExpr> bind(const Schema& schema) const override {
+        auto lhs = m_lhs.node()->bind(schema);
+        auto rhs = m_rhs.node()->bind(schema);
+        const bool strings = lhs->type() == DataType::String && rhs->type() == DataType::String;
+        const bool bools = lhs->type() == DataType::Bool && rhs->type() == DataType::Bool;
+        if (!strings && !bools && !(is_numeric(lhs->type()) && is_numeric(rhs->type()))) {
+            throw std::invalid_argument(std::string("Cannot compare ") + data_type_name(lhs->type()) +
+                                        " with " + data_type_name(rhs->type()));
+        }
+        return std::make_unique<BoundCompare>(m_op, std::move(lhs), std::move(rhs));
+    }
+
+private:
+    CompareOp m_op;
+    Expr m_lhs, m_rhs;
+};
+
+class BoundLogic final : public BoundExpr {
+public:
+    BoundLogic(LogicOp op, std::unique_ptr<BoundExpr> lhs, std::unique_ptr<BoundExpr> rhs)
+        : BoundExpr(DataType::Bool), m_op(op), m_lhs(std::move(lhs)), m_rhs(std::move(rhs)) {}
+
+    const Vector& evaluate(const Batch& batch) override {
+        const Vector& left = m_lhs->evaluate(batch);
+        const size_t n = batch.rows;
+        Vector& out = m_result;
+        out.reset(DataType::Bool, n);
+        const uint8_t* va = left.valid.data();
+        const int64_t* a = left.ints.data();
+
+        if (m_op == LogicOp::Not) {
+            for (size_t i = 0; i < n; ++i) {
+                out.valid[i] = va[i];
+                out.ints[i] = !a[i];
+            }
+            return out;
+        }
+
+        const Vector& right = m_rhs->evaluate(batch);
+        const uint8_t* vb = right.valid.data();
+        const int64_t* b = right.ints.data();
+        // Three-valued logic: a known dominant operand decides, otherwise null
+        const int64_t dominant = (m_op == LogicOp::Or) ? 1 : 0;
+        for (size_t i = 0; i < n; ++i) {
+            const bool decided = (va[i] && (a[i] != 0) == dominant) || (vb[i] && (b[i] != 0) == dominant);
+            out.valid[i] = decided || (va[i] && vb[i]);
+            out.ints[i] = decided ? dominant : 1 - dominant;
+        }
+        return out;
+    }
+
+private:
+    LogicOp m_op;
+    std::unique_ptr<BoundExpr> m_lhs, m_rhs;
+};
+
+class LogicNode final : public ExprNode {
+public:
+    LogicNode(LogicOp op, Expr lhs, std::optional<Expr> rhs) : m_op(op), m_lhs(std::move(lhs)), m_rhs(std::move(rhs)) {}
+
+    std::unique_ptr<BoundExpr> bind(const Schema& schema) const override {
+        auto lhs = m_lhs.node()->bind(schema);
+        std::unique_ptr<BoundExpr> rhs = m_rhs ? m_rhs->node()->bind(schema) : nullptr;
+        if (lhs->type() != DataType::Bool || (rhs && rhs->type() != DataType::Bool)) {
+            throw std::invalid_argument("Logical operators need Bool operands");
+        }
+        return std::make_unique<BoundLogic>(m_op, std::move(lhs), std::move(rhs));
+    }
+
+private:
+    LogicOp m_op;
+    Expr m_lhs;
+    std::optional<Expr> m_rhs;
+};
+
+Expr make_arith(ArithOp op, const Expr& lhs, const Expr& rhs) {
+    return Expr(std::make_shared<ArithNode>(op, lhs, rhs));
+}
+
+Expr make_compare(CompareOp op, const Expr& lhs, const Expr& rhs) {
+    return Expr(std::make_shared<CompareNode>(op, lhs, rhs));
+}
+
+} // namespace
+
+Expr col(std::string name) { return Expr(std::make_shared<ColumnNode>(std::move(name))); }
+
+Expr lit(bool value) { return Expr(std::make_shared<LiteralNode>(DataType::Bool, value ? 1 : 0, 0.0, std::string())); }
+Expr lit(int value) { return lit(static_cast<int64_t>(value)); }
+Expr lit(int64_t value) { return Expr(std::make_shared<LiteralNode>(DataType::Int64, value, 0.0, std::string())); }
+Expr lit(double value) { return Expr(std::make_shared<LiteralNode>(DataType::Double, 0, value, std::string())); }
+Expr lit(const char* value) { return lit(std::string(value)); }
+Expr lit(std::string value) { return Expr(std::make_shared<LiteralNode>(DataType::String, 0, 0.0, std::move(value))); }
+
+Expr operator+(const Expr& lhs, const Expr& rhs) { return make_arith(ArithOp::Add, lhs, rhs); }
+Expr operator-(const Expr& lhs, const Expr& rhs) { return make_arith(ArithOp::Sub, lhs, rhs); }
+Expr operator*(const Expr& lhs, const Expr& rhs) { return make_arith(ArithOp::Mul, lhs, rhs); }
+Expr operator/(const Expr& lhs, const Expr& rhs) { return make_arith(ArithOp::Div, lhs, rhs); }
+Expr operator==(const Expr& lhs, const Expr& rhs) { return make_compare(CompareOp::Eq, lhs, rhs); }
+Expr operator!=(const Expr& lhs, const Expr& rhs) { return make_compare(CompareOp::Ne, lhs, rhs); }
+Expr operator<(const Expr& lhs, const Expr& rhs) { return make_compare(CompareOp::Lt, lhs, rhs); }
+Expr operator<=(const Expr& lhs, const Expr& rhs) { return make_compare(CompareOp::Le, lhs, rhs); }
+Expr operator>(const Expr& lhs, const Expr& rhs) { return make_compare(CompareOp::Gt, lhs, rhs); }
+Expr operator>=(const Expr& lhs, const Expr& rhs) { return make_compare(CompareOp::Ge, lhs, rhs); }
+
+Expr operator&&(const Expr& lhs, const Expr& rhs) {
+    return Expr(std::make_shared<LogicNode>(LogicOp::And, lhs, rhs));
+}
+
+Expr operator||(const Expr& lhs, const Expr& rhs) {
+    return Expr(std::make_shared<LogicNode>(LogicOp::Or, lhs, rhs));
+}
+
+Expr operator!(const Expr& operand) {
+    return Expr(std::make_shared<LogicNode>(LogicOp::Not, operand, std::nullopt));
+}
+
+// ---- Operators ----
+
+namespace {
+
+class ScanOperator final : public Operator {
+public:
+    ScanOperator(const ColumnarProjection& source, std::vector<std::string> tags, std::string ordinal_column)
+        : m_rows(source.row_count()) {
+        if (tags.empty()) {
+            for (size_t i = 0; i < source.column_count(); ++i) tags.push_back(source.tag(i));
+        }
+        for (auto& tag : tags) {
+            const Column* column = source.find(tag);
+            if (!column) {
+                throw std::invalid_argument("Column not projected: " + tag);
+            }
+            m_columns.push_back(column);
+            m_schema.push_back({std::move(tag), scan_type(column->type())});
+        }
+        if (!ordinal_column.empty()) {
+            for (const auto& field : m_schema) {
+                if (field.name == ordinal_column) {
+                    throw std::invalid_argument("Duplicate column: " + ordinal_column);
+                }
+            }
+            m_with_ordinal = true;
+            m_schema.push_back({std::move(ordinal_column), DataType::Int64});
+        }
+
+        // Rows holding any scanned tag, counted a validity word at a time
+        std::vector<uint64_t> present((m_rows + 63) / 64, 0);
+        for (const Column* column : m_columns) {
+            const auto& validity = column->validity();
+            for (size_t w = 0; w < present.size() && w < validity.size(); ++w) {
+                present[w] |= validity[w];
+            }
+        }
+        for (uint64_t bits : present) m_estimate += static_cast<size_t>(std::popcount(bits));
+    }
+
+    size_t estimated_rows() const override { return m_estimate; }
+
+    bool next(Batch& batch) override {
+        while (m_position < m_rows) {
+            const size_t begin = m_position;
+            const size_t count = std::min(kBatchSize, m_rows - begin);
+            m_position += count;
+
+            // Rows holding at least one scanned tag, a validity word at a time
+            const size_t first_word = begin / 64;
+            const size_t words = (count + 63) / 64;
+            m_present.assign(words, 0);
+            for (const Column* column : m_columns) {
+                const auto& validity = column->validity();
+                for (size_t w = 0; w < words && first_word + w < validity.size(); ++w) {
+                    m_present[w] |= validity[first_word + w];
+                }
+            }
+            if (count % 64) {
+                m_present[words - 1] &= (uint64_t{1} << (count % 64)) - 1;
+            }
+            size_t present = 0;
+            for (uint64_t bits : m_present) present += static_cast<size_t>(std::popcount(bits));
+            if (present == 0) {
+                continue;  // No entity in this range has any scanned tag
+            }
+
+            batch.rows = count;
+            batch.columns.resize(m_schema.size());
+            for (size_t c = 0; c < m_columns.size(); ++c) {
+                load(*m_columns[c], m_schema[c].type, begin, count, batch.columns[c]);
+            }
+            if (m_with_ordinal) {
+                Vector& ordinals = batch.columns.back();
+                ordinals.reset(DataType::Int64, count);
+                std::fill(ordinals.valid.begin(), ordinals.valid.end(), uint8_t{1});
+                std::iota(ordinals.ints.begin(), ordinals.ints.end(), static_cast<int64_t>(begin));
+            }
+
+            batch.selection.clear();
+            batch.selective = present < count;
+            if (batch.selective) {
+                for (size_t w = 0; w < words; ++w) {
+                    for (uint64_t bits = m_present[w]; bits; bits &= bits - 1) {
+                        batch.selection.push_back(static_cast<uint32_t>(w * 64 + std::countr_zero(bits)));
+                    }
+                }
+            }
+            return true;
+        }
+        return false;
+    }
+
+private:
+    static void load(const Column& column, DataType type, size_t begin, size_t count, Vector& out) {
+        out.reset(type, count);
+        for (size_t i = 0; i < count; ++i) {
+            out.valid[i] = column.is_valid(static_cast<uint32_t>(begin + i)) ? 1 : 0;
+        }
+        switch (column.type()) {
+            case ColumnType::Bool:
+                std::copy_n(column.bools().begin() + begin, count, out.ints.begin());
+                break;
+            case ColumnType::Int64:
+            case ColumnType::Timestamp:
+            case ColumnType::Edge:
+                std::copy_n(column.ints().begin() + begin, count, out.ints.begin());
+                break;
+            case ColumnType::Double:
+                std::copy_n(column.doubles().begin() + begin, count, out.doubles.begin());
+                break;
+            case ColumnType::String:
+                for (size_t i = 0; i < count; ++i) {
+                    out.strings[i] = out.valid[i] ? std::string_view(column.string_at(static_cast<uint32_t>(begin + i)))
+                                                  : std::string_view();
+                }
+                break;
+            case ColumnType::Auto:
+                break;  // Never written: every row is null
+        }
+    }
+
+    std::vector<const Column*> m_columns;
+    bool m_with_ordinal = false;
+    size_t m_rows;
+    size_t m_estimate = 0;
+    size_t m_position = 0;
+    std::vector<uint64_t> m_present;
+};
+
+class FilterOperator final : public Operator {
+public:
+    FilterOperator(std::unique_ptr<Operator> child, const Expr& predicate)
+        : m_child(std::move(child)), m_predicate(predicate.node()->bind(m_child->schema())) {
+        if (m_predicate->type() != DataType::Bool) {
+            throw std::invalid_argument("Filter predicate must be Bool");
+        }
+        m_schema = m_child->schema();
+    }
+
+    size_t estimated_rows() const override { return m_child->estimated_rows(); }
+
+    bool next(Batch& batch) override {
+        while (m_child->next(batch)) {
+            const Vector& mask = m_predicate->evaluate(batch);
+            const uint8_t* valid = mask.valid.data();
+            const int64_t* pass = mask.ints.data();
+
+            // Branch-free compaction of the selection vector
+            size_t kept = 0;
+            if (batch.selective) {
+                for (uint32_t row : batch.selection) {
+                    batch.selection[kept] = row;
+                    kept += valid[row] & (pass[row] != 0);
+                }
+            } else {
+                batch.selection.resize(batch.rows);
+                for (uint32_t row = 0; row < batch.rows; ++row) {
+                    batch.selection[kept] = row;
+                    kept += valid[row] & (pass[row] != 0);
+                }
+            }
+            batch.selection.resize(kept);
+            batch.selective = true;
+            if (kept > 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::unique_ptr<Operator> m_child;
+    std::unique_ptr<BoundExpr> m_predicate;
+};
+
+class ProjectOperator final : public Operator {
+public:
+    ProjectOperator(std::unique_ptr<Operator> child, const std::vector<NamedExpr>& outputs)
+        : m_child(std::move(child)) {
+        for (const auto& output : outputs) {
+            m_exprs.push_back(output.expr.node()->bind(m_child->schema()));
+            m_schema.push_back({output.name, m_exprs.back()->type()});
+        }
+    }
+
+    size_t estimated_rows() const override { return m_child->estimated_rows(); }
+
+    bool next(Batch& batch) override {
+        if (!m_child->next(m_input)) {
+            return false;
+        }
+        batch.rows = m_input.rows;
+        batch.columns.resize(m_exprs.size());
+        for (size_t i = 0; i < m_exprs.size(); ++i) {
+            m_exprs[i]->evaluate_into(m_input, batch.columns[i]);
+        }
+        batch.selection.swap(m_input.selection);
+        batch.selective = m_input.selective;
+        return true;
+    }
+
+private:
+    std::unique_ptr<Operator> m_child;
+    std::vector<std::unique_ptr<BoundExpr>> m_exprs;
+    Batch m_input;
+};
+
+class HashAggregateOperator final : public Operator {
+public:
+    HashAggregateOperator(std::unique_ptr<Operator> child,
+                          const std::vector<std::string>& group_by,
+                          const std::vector<Aggregate>& aggregates)
+        : m_child(std::move(child)) {
+        const Schema& input = m_child->schema();
+        for (const auto& key : group_by) {
+            size_t index = find_field(input, key);
+            m_key_index.push_back(index);
+            m_keys.emplace_back().reset(input[index].type, 0);
+            m_schema.push_back(input[index]);
+        }
+        for (const auto& aggregate : aggregates) {
+            State state;
+            state.op = aggregate.op;
+            if (!aggregate.column.empty()) {
+                state.input = find_field(input, aggregate.column);
+                state.input_type = input[state.input].type;
+            } else if (aggregate.op != Aggregate::Op::Count) {
+                throw std::invalid_argument("Aggregate " + aggregate.name + " needs an input column");
+            }
+            switch (aggregate.op) {
+                case Aggregate::Op::Count:
+                    state.output_type = DataType::Int64;
+                    break;
+                case Aggregate::Op::Sum:
+                case Aggregate::Op::Avg:
+                    if (state.input_type == DataType::String) {
+                        throw std::invalid_argument("Aggregate " + aggregate.name + " needs a numeric input");
+                    }
+                    state.output_type = (aggregate.op == Aggregate::Op::Avg || state.input_type == DataType::Double)
+                        ? DataType::Double : DataType::Int64;
+                    break;
+                case Aggregate::Op::Min:
+                case Aggregate::Op::Max:
+                    state.output_type = state.input_type;
+                    break;
+            }
+            m_states.push_back(state);
+            m_schema.push_back({aggregate.name, state.output_type});
+        }
+        m_slots.assign(1024, 0);
+    }
+
+    size_t estimated_rows() const override {
+        return m_key_index.empty() ? 1 : m_child->estimated_rows();
+    }
+
+    bool next(Batch& batch) override {
+        if (!m_finished) {
+            consume();
+            finish();
+            m_finished = true;
+        }
+        if (m_emitted >= m_group_count) {
+            return false;
+        }
+        const size_t count = std::min(kBatchSize, m_group_count - m_emitted);
+        m_indices.resize(count);
+        std::iota(m_indices.begin(), m_indices.end(), static_cast<uint32_t>(m_emitted));
+        batch.rows = count;
+        batch.columns.resize(m_result.size());
+        for (size_t i = 0; i < m_result.size(); ++i) {
+            batch.columns[i].gather(m_result[i], m_indices.data(), count);
+        }
+        batch.selection.clear();
+        batch.selective = false;
+        m_emitted += count;
+        return true;
+    }
+
+private:
+    struct State {
+        Aggregate::Op op = Aggregate::Op::Count;
+        size_t input = kNoColumn;
+        DataType input_type = DataType::Int64;
+        DataType output_type = DataType::Int64;
+        std::vector<int64_t> counts;    // Non-null inputs seen per group
+        std::vector<int64_t> ints;
+        std::vector<double> doubles;
+        std::vector<std::string_view> strings;
+    };
+
+    void consume() {
+        Batch batch;
+        while (m_child->next(batch)) {
+            assign_groups(batch);
+            for (auto& state : m_states) {
+                update(state, batch);
+            }
+        }
+    }
+
+    // Map every active row to its group id, creating groups as needed
+    void assign_groups(const Batch& batch) {
+        m_hashes.resize(batch.rows);
+        m_row_groups.resize(batch.rows);
+        batch.for_each_active([&](uint32_t row) { m_hashes[row] = 0x84222325cbf29ce4ULL; });
+        for (size_t k = 0; k < m_key_index.size(); ++k) {
+            const Vector& key = batch.columns[m_key_index[k]];
+            batch.for_each_active([&](uint32_t row) {
+                m_hashes[row] = mix(m_hashes[row] ^ value_hash(key, row));
+            });
+        }
+
+        batch.for_each_active([&](uint32_t row) {
+            const uint64_t hash = m_hashes[row];
+            size_t mask = m_slots.size() - 1;
+            for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+                const uint32_t entry = m_slots[slot];
+                if (entry == 0) {
+                    m_row_groups[row] = add_group(&batch, row, hash);
+                    m_slots[slot] = m_row_groups[row] + 1;
+                    if (m_group_count * 2 > m_slots.size()) {
+                        grow();
+                    }
+                    return;
+                }
+                const uint32_t group = entry - 1;
+                if (m_group_hashes[group] == hash && keys_equal(group, batch, row)) {
+                    m_row_groups[row] = group;
+                    return;
+                }
+            }
+        });
+    }
+
+    bool keys_equal(uint32_t group, const Batch& batch, uint32_t row) const {
+        for (size_t k = 0; k < m_key_index.size(); ++k) {
+            if (!values_equal(m_keys[k], group, batch.columns[m_key_index[k]], row)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // batch is null only for the empty global group (no keys to copy)
+    uint32_t add_group(const Batch* batch, uint32_t row, uint64_t hash) {
+        for (size_t k = 0; k < m_key_index.size(); ++k) {
+            m_keys[k].append(batch->columns[m_key_index[k]], row);
+        }
+        m_group_hashes.push_back(hash);
+        for (auto& state : m_states) {
+            state.counts.push_back(0);
+            state.ints.push_back(0);
+            state.doubles.push_back(0.0);
+            state.strings.emplace_back();
+        }
+        return static_cast<uint32_t>(m_group_count++);
+    }
+
+    void grow() {
+        m_slots.assign(m_slots.size() * 2, 0);
+        const size_t mask = m_slots.size() - 1;
+        for (uint32_t group = 0; group < m_group_count; ++group) {
+            size_t slot = m_group_hashes[group] & mask;
+            while (m_slots[slot] != 0) slot = (slot + 1) & mask;
+            m_slots[slot] = group + 1;
+        }
+    }
+
+    void update(State& state, const Batch& batch) {
+        const uint32_t* groups = m_row_groups.data();
+        int64_t* counts = state.counts.data();
+        if (state.input == kNoColumn) {
+            batch.for_each_active([&](uint32_t row) { ++counts[groups[row]]; });
+            return;
+        }
+
+        const Vector& in = batch.columns[state.input];
+        const uint8_t* valid = in.valid.data();
+        switch (state.op) {
+            case Aggregate::Op::Count:
+                batch.for_each_active([&](uint32_t row) { counts[groups[row]] += valid[row]; });
+                break;
+            case Aggregate::Op::Sum:
+            case Aggregate::Op::Avg:
+                if (state.output_type == DataType::Int64) {
+                    int64_t* sums = state.ints.data();
+                    batch.for_each_active([&](uint32_t row) {
+                        if (!valid[row]) return;
+                        const uint32_t g = groups[row];
+                        sums[g] = static_cast<int64_t>(static_cast<uint64_t>(sums[g]) + static_cast<uint64_t>(in.ints[row]));
+                        ++counts[g];
+                    });
+                } else {
+                    const double* values = as_doubles(in, m_scratch);
+                    double* sums = state.doubles.data();
+                    batch.for_each_active([&](uint32_t row) {
+                        if (!valid[row]) return;
+                        sums[groups[row]] += values[row];
+                        ++counts[groups[row]];
+                    });
+                }
+                break;
+            case Aggregate::Op::Min:
+            case Aggregate::Op::Max: {
+                const bool want_min = state.op == Aggregate::Op::Min;
+                auto fold = [&](auto& best, const auto& values) {
+                    batch.for_each_active([&](uint32_t row) {
+                        if (!valid[row]) return;
+                        const uint32_t g = groups[row];
+                        const auto& value = values[row];
+                        if (counts[g] == 0 || (want_min ? value < best[g] : best[g] < value)) {
+                            best[g] = value;
+                        }
+                        ++counts[g];
+                    });
+                };
+                if (in.type == DataType::Double) {
+                    fold(state.doubles, in.doubles);
+                } else if (in.type == DataType::String) {
+                    fold(state.strings, in.strings);
+                } else {
+                    fold(state.ints, in.ints);
+                }
+                break;
+            }
+        }
+    }
+
+    void finish() {
+        // A global aggregate yields one row even over empty input
+        if (m_key_index.empty() && m_group_count == 0) {
+            add_group(nullptr, 0, 0);
+        }
+
+        m_result.clear();
+        for (auto& keys : m_keys) {
+            m_result.push_back(std::move(keys));
+        }
+        for (const auto& state : m_states) {
+            Vector& out = m_result.emplace_back();
+            out.reset(state.output_type, m_group_count);
+            for (size_t g = 0; g < m_group_count; ++g) {
+                const int64_t count = state.counts[g];
+                out.valid[g] = (state.op == Aggregate::Op::Count || count > 0) ? 1 : 0;
+                switch (state.op) {
+                    case Aggregate::Op::Count:
+                        out.ints[g] = count;
+                        break;
+                    case Aggregate::Op::Avg:
+                        out.doubles[g] = count > 0 ? state.doubles[g] / static_cast<double>(count) : 0.0;
+                        break;
+                    default:
+                        if (out.type == DataType::Double) out.doubles[g] = state.doubles[g];
+                        else if (out.type == DataType::String) out.strings[g] = state.strings[g];
+                        else out.ints[g] = state.ints[g];
+                        break;
+                }
+            }
+        }
+    }
+
+    std::unique_ptr<Operator> m_child;
+    std::vector<size_t> m_key_index;
+    std::vector<Vector> m_keys;             // Key values, one row per group
+    std::vector<State> m_states;
+
+    // Open-addressing table: slot -> group id + 1 (0 = empty)
+    std::vector<uint32_t> m_slots;
+    std::vector<uint64_t> m_group_hashes;
+    size_t m_group_count = 0;
+
+    // Per-batch scratch
+    std::vector<uint64_t> m_hashes;
+    std::vector<uint32_t> m_row_groups;
+    std::vector<double> m_scratch;
+
+    bool m_finished = false;
+    std::vector<Vector> m_result;
+    std::vector<uint32_t> m_indices;
+    size_t m_emitted = 0;
+};
+
+class SortOperator final : public Operator {
+public:
+    SortOperator(std::unique_ptr<Operator> child, const std::vector<SortKey>& keys, size_t limit)
+        : m_child(std::move(child)), m_limit(limit), m_rows(m_child->schema()) {
+        m_schema = m_child->schema();
+        for (const auto& key : keys) {
+            m_keys.push_back({find_field(m_schema, key.column), key.ascending});
+        }
+    }
+
+    size_t estimated_rows() const override { return std::min(m_limit, m_child->estimated_rows()); }
+
+    bool next(Batch& batch) override {
+        if (!m_sorted) {
+            sort_input();
+            m_sorted = true;
+        }
+        if (m_emitted >= m_order.size()) {
+            return false;
+        }
+        const size_t count = std::min(kBatchSize, m_order.size() - m_emitted);
+        m_rows.gather(m_order.data() + m_emitted, count, batch);
+        m_emitted += count;
+        return true;
+    }
+
+private:
+    struct Key {
+        size_t column;
+        bool ascending;
+    };
+
+    void sort_input() {
+        Batch batch;
+        while (m_child->next(batch)) {
+            m_rows.append(batch);
+        }
+
+        m_order.resize(m_rows.row_count());
+        std::iota(m_order.begin(), m_order.end(), 0u);
+        // Ties fall back to input order, so the result is stable
+        auto before = [&](uint32_t a, uint32_t b) {
+            for (const auto& key : m_keys) {
+                int c = compare_values(m_rows.column(key.column), a, b);
+                if (c != 0) return key.ascending ? c < 0 : c > 0;
+            }
+            return a < b;
+        };
+        if (m_limit < m_order.size()) {
+            std::partial_sort(m_order.begin(), m_order.begin() + static_cast<std::ptrdiff_t>(m_limit),
+                              m_order.end(), before);
+            m_order.resize(m_limit);
+        } else {
+            std::sort(m_order.begin(), m_order.end(), before);
+        }
+    }
+
+    std::unique_ptr<Operator> m_child;
+    std::vector<Key> m_keys;
+    size_t m_limit;
+    Table m_rows;
+    std::vector<uint32_t> m_order;
+    bool m_sorted = false;
+    size_t m_emitted = 0;
+};
+
+class LimitOperator final : public Operator {
+public:
+    LimitOperator(std::unique_ptr<Operator> child, size_t limit)
+        : m_child(std::move(child)), m_remaining(limit) {
+        m_schema = m_child->schema();
+    }
+
+    size_t estimated_rows() const override { return std::min(m_remaining, m_child->estimated_rows()); }
+
+    bool next(Batch& batch) override {
+        if (m_remaining == 0 || !m_child->next(batch)) {
+            return false;
+        }
+        const size_t active = batch.active_count();
+        if (active > m_remaining) {
+            if (!batch.selective) {
+                batch.selection.resize(m_remaining);
+                std::iota(batch.selection.begin(), batch.selection.end(), 0u);
+                batch.selective = true;
+            } else {
+                batch.selection.resize(m_remaining);
+            }
+        }
+        m_remaining -= std::min(active, m_remaining);
+        return true;
+    }
+
+private:
+    std::unique_ptr<Operator> m_child;
+    size_t m_remaining;
+};
+
+class HashJoinOperator final : public Operator {
+public:
+    HashJoinOperator(std::unique_ptr<Operator> left, std::unique_ptr<Operator> right,
+                     const std::string& left_key, const std::string& right_key) {
+        const size_t left_index = find_field(left->schema(), left_key);
+        const size_t right_index = find_field(right->schema(), right_key);
+        if (left->schema()[left_index].type != right->schema()[right_index].type) {
+            throw std::invalid_argument("Join keys " + left_key + " and " + right_key + " have different types");
+        }
+        m_schema = left->schema();
+        for (const auto& field : right->schema()) {
+            for (const auto& existing : left->schema()) {
+                if (existing.name == field.name) {
+                    throw std::invalid_argument("Duplicate column in join: " + field.name);
+                }
+            }
+            m_schema.push_back(field);
+        }
+        m_left_width = left->schema().size();
+        m_estimate = std::max(left->estimated_rows(), right->estimated_rows());
+
+        // Build on the smaller side; output order stays left columns first
+        m_build_is_left = left->estimated_rows() < right->estimated_rows();
+        if (m_build_is_left) {
+            m_build = std::move(left);
+            m_probe = std::move(right);
+            m_build_key = left_index;
+            m_probe_key = right_index;
+        } else {
+            m_build = std::move(right);
+            m_probe = std::move(left);
+            m_build_key = right_index;
+            m_probe_key = left_index;
+        }
+        m_table = Table(m_build->schema());
+    }
+
+    size_t estimated_rows() const override { return m_estimate; }
+
+    bool next(Batch& batch) override {
+        if (!m_built) {
+            build();
+            m_built = true;
+        }
+
+        m_probe_rows.clear();
+        m_build_rows.clear();
+        const Vector& build_keys = m_table.column(m_build_key);
+        while (m_probe_rows.size() < kBatchSize) {
+            // Continue the chain of the current probe row (chains may span batches)
+            if (m_chain != 0) {
+                const uint32_t candidate = m_chain - 1;
+                m_chain = m_next[candidate];
+                if (m_row_hashes[candidate] == m_hash &&
+                    values_equal(build_keys, candidate, m_input.columns[m_probe_key], m_row)) {
+                    m_probe_rows.push_back(m_row);
+                    m_build_rows.push_back(candidate);
+                }
+                continue;
+            }
+            if (m_cursor == m_active.size()) {
+                // Pending pairs reference the current input, so emit before pulling more
+                if (!m_probe_rows.empty() || !m_probe->next(m_input)) {
+                    break;
+                }
+                m_active.clear();
+                m_input.for_each_active([&](uint32_t row) { m_active.push_back(row); });
+                m_cursor = 0;
+                continue;
+            }
+            m_row = m_active[m_cursor++];
+            const Vector& keys = m_input.columns[m_probe_key];
+            if (!keys.valid[m_row]) {
+                continue;  // Null keys never match
+            }
+            m_hash = value_hash(keys, m_row);
+            m_chain = m_heads[m_hash & (m_heads.size() - 1)];
+        }
+        if (m_probe_rows.empty()) {
+            return false;
+        }
+
+        const size_t count = m_probe_rows.size();
+        batch.rows = count;
+        batch.columns.resize(m_schema.size());
+        const size_t probe_offset = m_build_is_left ? m_left_width : 0;
+        const size_t build_offset = m_build_is_left ? 0 : m_left_width;
+        for (size_t i = 0; i < m_input.columns.size(); ++i) {
+            batch.columns[probe_offset + i].gather(m_input.columns[i], m_probe_rows.data(), count);
+        }
+        for (size_t i = 0; i < m_table.schema().size(); ++i) {
+            batch.columns[build_offset + i].gather(m_table.column(i), m_build_rows.data(), count);
+        }
+        batch.selection.clear();
+        batch.selective = false;
+        return true;
+    }
+
+private:
+    void build() {
+        Batch input;
+        while (m_build->next(input)) {
+            m_table.append(input);
+        }
+
+        // Chained hash table: bucket -> first row + 1, next[row] -> following row + 1
+        const size_t rows = m_table.row_count();
+        m_heads.assign(std::bit_ceil(std::max<size_t>(16, rows * 2)), 0);
+        m_next.assign(rows, 0);
+        m_row_hashes.resize(rows);
+        const Vector& keys = m_table.column(m_build_key);
+        const size_t mask = m_heads.size() - 1;
+        // Insert back to front so each chain lists rows in build order
+        for (size_t r = rows; r-- > 0;) {
+            const auto row = static_cast<uint32_t>(r);
+            if (!keys.valid[row]) continue;
+            m_row_hashes[row] = value_hash(keys, row);
+            uint32_t& head = m_heads[m_row_hashes[row] & mask];
+            m_next[row] = head;
+            head = row + 1;
+        }
+    }
+
+    std::unique_ptr<Operator> m_build;
+    std::unique_ptr<Operator> m_probe;
+    size_t m_build_key = 0;
+    size_t m_probe_key = 0;
+    bool m_build_is_left = false;
+    size_t m_left_width = 0;
+    size_t m_estimate = 0;
+
+    bool m_built = false;
+    Table m_table;                         // Build side rows
+    std::vector<uint32_t> m_heads;
+    std::vector<uint32_t> m_next;
+    std::vector<uint64_t> m_row_hashes;
+
+    // Probe state, resumable across output batches
+    Batch m_input;
+    std::vector<uint32_t> m_active;
+    size_t m_cursor = 0;
+    uint32_t m_row = 0;
+    uint64_t m_hash = 0;
+    uint32_t m_chain = 0;
+
+    std::vector<uint32_t> m_probe_rows;
+    std::vector<uint32_t> m_build_rows;
+};
+
+} // namespace
+
+// ---- Plan / PlanBuilder ----
+
+Plan::Plan(std::unique_ptr<Operator> root)
+    : m_root(std::move(root)) {}
+
+Table Plan::execute() {
+    Table table(schema());
+    Batch batch;
+    while (next(batch)) {
+        table.append(batch);
+    }
+    return table;
+}
+
+PlanBuilder::PlanBuilder(std::unique_ptr<Operator> root)
+    : m_root(std::move(root)) {}
+
+PlanBuilder::PlanBuilder(PlanBuilder&&) noexcept = default;
+PlanBuilder& PlanBuilder::operator=(PlanBuilder&&) noexcept = default;
+PlanBuilder::~PlanBuilder() = default;
+
+// Operators validate their inputs while binding; the error stops here
+// instead of escaping the builder
+template<typename Fn>
+PlanBuilder& PlanBuilder::bind_step(Fn&& step) {
+    if (!m_error.empty()) {
+        return *this;
+    }
+    if (!m_root) {
+        m_error = "Plan already built";
+        return *this;
+    }
+    try {
+        step();
+    } catch (const std::exception& e) {
+        m_error = e.what();
+        if (m_error.empty()) m_error = "Invalid plan";
+        m_root.reset();
+        m_pending_sort.clear();
+        m_sort_pending = false;
+    }
+    return *this;
+}
+
+PlanBuilder PlanBuilder::scan(const ColumnarProjection& source, std::vector<std::string> tags,
+                              std::string ordinal_column) {
+    PlanBuilder builder(nullptr);
+    try {
+        builder.m_root = std::make_unique<ScanOperator>(source, std::move(tags), std::move(ordinal_column));
+    } catch (const std::exception& e) {
+        builder.m_error = e.what();
+    }
+    return builder;
+}
+
+PlanBuilder& PlanBuilder::filter(const Expr& predicate) {
+    return bind_step([&] {
+        flush_sort(kNoColumn);
+        m_root = std::make_unique<FilterOperator>(std::move(m_root), predicate);
+    });
+}
+
+PlanBuilder& PlanBuilder::project(const std::vector<NamedExpr>& outputs) {
+    return bind_step([&] {
+        flush_sort(kNoColumn);
+        m_root = std::make_unique<ProjectOperator>(std::move(m_root), outputs);
+    });
+}
+
+PlanBuilder& PlanBuilder::aggregate(const std::vector<std::string>& group_by, const std::vector<Aggregate>& aggregates) {
+    return bind_step([&] {
+        flush_sort(kNoColumn);
+        m_root = std::make_unique<HashAggregateOperator>(std::move(m_root), group_by, aggregates);
+    });
+}
+
+PlanBuilder& PlanBuilder::join(PlanBuilder& right, const std::string& left_key, const std::string& right_key) {
+    if (&right == this) {
+        // Both sides would drain the same operator; build the plan twice instead
+        if (m_error.empty()) {
+            m_error = "Cannot join a plan with itself";
+            m_root.reset();
+        }
+        return *this;
+    }
+    if (m_error.empty() && !right.m_error.empty()) {
+        m_error = right.m_error;
+        m_root.reset();
+    } else if (m_error.empty() && !right.m_root) {
+        m_error = "Right plan already built";
+        m_root.reset();
+    }
+    bind_step([&] {
+        flush_sort(kNoColumn);
+        right.flush_sort(kNoColumn);
+        m_root = std::make_unique<HashJoinOperator>(std::move(m_root), std::move(right.m_root), left_key, right_key);
+    });
+    right = PlanBuilder(nullptr);
+    return *this;
+}
+
+PlanBuilder& PlanBuilder::sort(const std::vector<SortKey>& keys) {
+    return bind_step([&] {
+        flush_sort(kNoColumn);
+        for (const auto& key : keys) {
+            find_field(m_root->schema(), key.column);  // Validate now, sort later
+        }
+        m_pending_sort = keys;
+        m_sort_pending = true;
+    });
+}
+
+PlanBuilder& PlanBuilder::limit(size_t n) {
+    return bind_step([&] {
+        if (m_sort_pending) {
+            flush_sort(n);  // Top-N: the sort emits at most n rows
+        } else {
+            m_root = std::make_unique<LimitOperator>(std::move(m_root), n);
+        }
+    });
+}
+
+const Schema& PlanBuilder::schema() const {
+    static const Schema empty;
+    return m_root ? m_root->schema() : empty;
+}
+
+std::optional<Plan> PlanBuilder::build(std::string* error) {
+    bind_step([&] { flush_sort(kNoColumn); });
+    if (!m_error.empty()) {
+        if (error) *error = m_error;
+        return std::nullopt;
+    }
+    return Plan(std::move(m_root));
+}
+
+void PlanBuilder::flush_sort(size_t limit) {
+    if (!m_sort_pending) {
+        return;
+    }
+    m_root = std::make_unique<SortOperator>(std::move(m_root), m_pending_sort, limit);
+    m_pending_sort.clear();
+    m_sort_pending = false;
+}
+
+} // namespace gtaf::core::exec
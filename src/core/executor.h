@@ -0,0 +1,408 @@
+#pragma once
+
+#include "columnar_projection.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gtaf::core::exec {
+
+/**
+ * @brief Rows per batch flowing between operators
+ */
+inline constexpr size_t kBatchSize = 1024;
+
+/**
+ * @brief Logical type of a batch column
+ *
+ * Timestamp columns are scanned as Int64 microseconds since epoch and Edge
+ * columns as the Int64 ordinal of the target entity.
+ */
+enum class DataType : uint8_t { Bool, Int64, Double, String };
+
+/**
+ * @brief Human-readable name of a data type (for diagnostics)
+ */
+const char* data_type_name(DataType type);
+
+/**
+ * @brief Named, typed output column of an operator
+ */
+struct Field {
+    std::string name;
+    DataType type;
+};
+
+using Schema = std::vector<Field>;
+
+/**
+ * @brief One column of a batch: a typed value array plus null flags
+ *
+ * Only the array matching type is populated; Bool and Int64 share ints.
+ * Strings are views into the source projection's dictionaries or into
+ * plan literals, so they stay valid while the plan and its source
+ * projection are alive.
+ */
+struct Vector {
+    DataType type = DataType::Int64;
+    std::vector<int64_t> ints;               // Bool (0/1), Int64
+    std::vector<double> doubles;             // Double
+    std::vector<std::string_view> strings;   // String
+    std::vector<uint8_t> valid;              // 1 = value present, 0 = null
+
+    /**
+     * @brief Number of rows
+     */
+    [[nodiscard]] size_t size() const noexcept { return valid.size(); }
+
+    [[nodiscard]] bool is_valid(size_t row) const noexcept { return valid[row] != 0; }
+
+    /**
+     * @brief Retype and resize to the given number of rows (contents unspecified)
+     */
+    void reset(DataType new_type, size_t rows);
+
+    /**
+     * @brief Append one row of another vector of the same type
+     */
+    void append(const Vector& source, uint32_t row);
+
+    /**
+     * @brief Replace contents with source rows picked by index
+     */
+    void gather(const Vector& source, const uint32_t* rows, size_t count);
+};
+
+/**
+ * @brief A batch of up to kBatchSize rows
+ *
+ * Filters never copy column data: they narrow the selection vector to the
+ * rows that passed. Consumers visit rows through for_each_active().
+ */
+struct Batch {
+    size_t rows = 0;                    // Physical rows in every column
+    std::vector<Vector> columns;        // Parallel to the producing operator's schema
+    std::vector<uint32_t> selection;    // Active rows, ascending (when selective)
+    bool selective = false;             // false: every physical row is active
+
+    [[nodiscard]] size_t active_count() const noexcept {
+        return selective ? selection.size() : rows;
+    }
+
+    /**
+     * @brief Invoke fn(row) for every active row in ascending order
+     */
+    template<typename Fn>
+    void for_each_active(Fn&& fn) const {
+        if (selective) {
+            for (uint32_t row : selection) fn(row);
+        } else {
+            for (uint32_t row = 0; row < rows; ++row) fn(row);
+        }
+    }
+};
+
+/**
+ * @brief Materialized rows with a schema (plan results, sort input)
+ */
+class Table {
+public:
+    explicit Table(Schema schema = {});
+
+    [[nodiscard]] const Schema& schema() const noexcept { return m_schema; }
+    [[nodiscard]] size_t row_count() const noexcept { return m_rows; }
+
+    /**
+     * @brief Index of a column by name, or nullopt
+     */
+    [[nodiscard]] std::optional<size_t> column_index(std::string_view name) const;
+
+    [[nodiscard]] const Vector& column(size_t i) const { return m_columns[i]; }
+
+    /**
+     * @brief Column by name, or nullptr if the table has no such column
+     */
+    [[nodiscard]] const Vector* find_column(std::string_view name) const;
+
+    /**
+     * @brief Append the active rows of a batch (columns must match the schema)
+     */
+    void append(const Batch& batch);
+
+    /**
+     * @brief Fill a batch with rows picked by index
+     */
+    void gather(const uint32_t* rows, size_t count, Batch& batch) const;
+
+private:
+    Schema m_schema;
+    std::vector<Vector> m_columns;
+    size_t m_rows = 0;
+};
+
+class ExprNode;
+
+/**
+ * @brief Scalar expression over the columns of a batch
+ *
+ * Built from col() and lit() with the arithmetic (+ - * /), comparison
+ * (== != < <= > >=) and logical (&& || !) operators, then bound to an
+ * operator's input schema when the plan is built. Integer arithmetic stays
+ * in int64 unless either side is Double; division always yields Double.
+ * Nulls propagate through arithmetic and comparisons; && and || follow
+ * SQL three-valued logic, and filters drop rows whose predicate is null.
+ */
+class Expr {
+public:
+    explicit Expr(std::shared_ptr<const ExprNode> node) : m_node(std::move(node)) {}
+
+    [[nodiscard]] const std::shared_ptr<const ExprNode>& node() const noexcept { return m_node; }
+
+private:
+    std::shared_ptr<const ExprNode> m_node;
+};
+
+/**
+ * @brief Reference an input column by name
+ */
+Expr col(std::string name);
+
+Expr lit(bool value);
+Expr lit(int value);
+Expr lit(int64_t value);
+Expr lit(double value);
+Expr lit(const char* value);
+Expr lit(std::string value);
+
+Expr operator+(const Expr& lhs, const Expr& rhs);
+Expr operator-(const Expr& lhs, const Expr& rhs);
+Expr operator*(const Expr& lhs, const Expr& rhs);
+Expr operator/(const Expr& lhs, const Expr& rhs);
+Expr operator==(const Expr& lhs, const Expr& rhs);
+Expr operator!=(const Expr& lhs, const Expr& rhs);
+Expr operator<(const Expr& lhs, const Expr& rhs);
+Expr operator<=(const Expr& lhs, const Expr& rhs);
+Expr operator>(const Expr& lhs, const Expr& rhs);
+Expr operator>=(const Expr& lhs, const Expr& rhs);
+Expr operator&&(const Expr& lhs, const Expr& rhs);
+Expr operator||(const Expr& lhs, const Expr& rhs);
+Expr operator!(const Expr& operand);
+
+/**
+ * @brief Output column of a project step
+ */
+struct NamedExpr {
+    std::string name;
+    Expr expr;
+};
+
+/**
+ * @brief Aggregate function of a hash-aggregate step
+ *
+ * Count counts non-null values (every row when column is empty); Sum and
+ * Avg need a numeric input; Min and Max also accept strings. Aggregates
+ * over groups with no non-null input are null (Count is 0).
+ */
+struct Aggregate {
+    enum class Op : uint8_t { Count, Sum, Min, Max, Avg };
+
+    Op op;
+    std::string column;   // Input column (empty: COUNT(*))
+    std::string name;     // Output column
+
+    static Aggregate count_all(std::string name) { return {Op::Count, {}, std::move(name)}; }
+    static Aggregate count(std::string column, std::string name) { return {Op::Count, std::move(column), std::move(name)}; }
+    static Aggregate sum(std::string column, std::string name) { return {Op::Sum, std::move(column), std::move(name)}; }
+    static Aggregate min(std::string column, std::string name) { return {Op::Min, std::move(column), std::move(name)}; }
+    static Aggregate max(std::string column, std::string name) { return {Op::Max, std::move(column), std::move(name)}; }
+    static Aggregate avg(std::string column, std::string name) { return {Op::Avg, std::move(column), std::move(name)}; }
+};
+
+/**
+ * @brief Sort key of a sort step (nulls sort as the smallest value)
+ */
+struct SortKey {
+    std::string column;
+    bool ascending = true;
+};
+
+/**
+ * @brief Pull-based physical operator producing batches
+ */
+class Operator {
+public:
+    virtual ~Operator() = default;
+
+    /**
+     * @brief Names and types of the columns this operator produces
+     */
+    [[nodiscard]] const Schema& schema() const noexcept { return m_schema; }
+
+    /**
+     * @brief Produce the next batch with at least one active row
+     *
+     * @return false once the operator is exhausted
+     */
+    virtual bool next(Batch& batch) = 0;
+
+    /**
+     * @brief Upper bound on the rows this operator will produce
+     *
+     * Computed without running the plan; joins use it to pick their build
+     * side.
+     */
+    [[nodiscard]] virtual size_t estimated_rows() const = 0;
+
+protected:
+    Schema m_schema;
+};
+
+/**
+ * @brief Executable operator tree produced by PlanBuilder
+ */
+class Plan {
+public:
+    explicit Plan(std::unique_ptr<Operator> root);
+
+    [[nodiscard]] const Schema& schema() const noexcept { return m_root->schema(); }
+
+    /**
+     * @brief Pull the next result batch; false when exhausted
+     */
+    bool next(Batch& batch) { return m_root->next(batch); }
+
+    /**
+     * @brief Run the plan to completion and materialize every result row
+     */
+    Table execute();
+
+private:
+    std::unique_ptr<Operator> m_root;
+};
+
+/**
+ * @brief Fluent builder for vectorized query plans
+ *
+ * Each step wraps the previous one; column names and expression types are
+ * checked as steps are added. The first step that fails to bind records
+ * its error and later steps are ignored, so build() returns nullopt and
+ * error() says what went wrong; no step throws. A sort directly followed
+ * by limit() runs as a top-N partial sort.
+ *
+ * Example (TPC-H Q1 style):
+ *   auto plan = PlanBuilder::scan(projection, {"l.flag", "l.qty", "l.shipdate"})
+ *       .filter(col("l.shipdate") <= lit(cutoff))
+ *       .aggregate({"l.flag"}, {Aggregate::sum("l.qty", "sum_qty"), Aggregate::count_all("n")})
+ *       .sort({{"l.flag"}})
+ *       .build();
+ *   Table result = plan->execute();
+ */
+class PlanBuilder {
+public:
+    /**
+     * @brief Scan projected columns in entity-ordinal order
+     *
+     * Output columns are named by tag. Entities holding none of the scanned
+     * tags are skipped, so a scan over one table's tags visits only that
+     * table's rows. The projection must outlive the plan.
+     *
+     * @param tags Tags to scan (empty: every projected column)
+     * @param ordinal_column If non-empty, also emit each row's entity
+     *        ordinal as an Int64 column of this name (the join target of
+     *        Edge columns pointing at these entities)
+     */
+    static PlanBuilder scan(const ColumnarProjection& source, std::vector<std::string> tags = {},
+                            std::string ordinal_column = {});
+
+    PlanBuilder(PlanBuilder&&) noexcept;
+    PlanBuilder& operator=(PlanBuilder&&) noexcept;
+    ~PlanBuilder();
+
+    /**
+     * @brief Keep rows whose Bool predicate is true
+     */
+    PlanBuilder& filter(const Expr& predicate);
+
+    /**
+     * @brief Replace the columns with the given expressions
+     */
+    PlanBuilder& project(const std::vector<NamedExpr>& outputs);
+
+    /**
+     * @brief Group by key columns and compute aggregates (one row per group)
+     *
+     * Output columns are the keys followed by the aggregates. With no keys
+     * the result is a single row, even for empty input.
+     */
+    PlanBuilder& aggregate(const std::vector<std::string>& group_by, const std::vector<Aggregate>& aggregates);
+
+    /**
+     * @brief Inner equi-join with another plan
+     *
+     * Drains the side with the smaller row estimate into a hash table and
+     * streams the other side through it a batch at a time. Output columns
+     * are this plan's followed by right's; names must not collide. Null
+     * keys never match. To follow an EdgeValue relation, join the Edge
+     * column with the target scan's ordinal column. The right builder is
+     * consumed (left empty), like build(), and its error, if any, becomes
+     * this plan's. Joining an already built or consumed plan, or the plan
+     * itself, is a bind error.
+     */
+    PlanBuilder& join(PlanBuilder& right, const std::string& left_key, const std::string& right_key);
+    PlanBuilder& join(PlanBuilder&& right, const std::string& left_key, const std::string& right_key) {
+        return join(right, left_key, right_key);
+    }
+
+    /**
+     * @brief Order rows by keys (stable for equal keys)
+     */
+    PlanBuilder& sort(const std::vector<SortKey>& keys);
+
+    /**
+     * @brief Stop after n rows
+     */
+    PlanBuilder& limit(size_t n);
+
+    /**
+     * @brief Output schema of the plan built so far (empty after an error)
+     */
+    [[nodiscard]] const Schema& schema() const;
+
+    /**
+     * @brief First bind error (unknown column, mistyped expression), or empty
+     */
+    [[nodiscard]] const std::string& error() const noexcept { return m_error; }
+
+    /**
+     * @brief Finish the plan (the builder is left empty)
+     *
+     * @param error If non-null, receives the bind error when there is one
+     * @return The plan, or nullopt if a step failed to bind
+     */
+    std::optional<Plan> build(std::string* error = nullptr);
+
+private:
+    explicit PlanBuilder(std::unique_ptr<Operator> root);
+
+    /**
+     * @brief Materialize a pending sort, as top-N when a limit follows
+     */
+    void flush_sort(size_t limit);
+
+    /**
+     * @brief Run one step unless an earlier one failed, recording its error
+     */
+    template<typename Fn>
+    PlanBuilder& bind_step(Fn&& step);
+
+    std::unique_ptr<Operator> m_root;
+    std::vector<SortKey> m_pending_sort;
+    bool m_sort_pending = false;
+    std::string m_error;   // First bind error; the plan is unusable once set
+};
+
+} // namespace gtaf::core::exec
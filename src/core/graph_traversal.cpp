@@ -0,0 +1,235 @@
+#include "graph_traversal.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <system_error>
+#include <thread>
+
+namespace gtaf::core {
+
+namespace {
+
+// Frontiers smaller than this are expanded on the calling thread
+constexpr size_t kParallelFrontier = 4096;
+
+// Frontier vertices handed to a worker at a time
+constexpr size_t kChunkSize = 1024;
+
+constexpr uint32_t kNoParent = std::numeric_limits<uint32_t>::max();
+
+} // namespace
+
+/**
+ * @brief State of one traversal: pinned snapshot, filters and visited bits
+ */
+struct GraphTraversal::Search {
+    const AdjacencyIndex& graph;
+    const size_t entity_count;
+    const types::LogSequenceNumber as_of;
+    const bool latest;                      // as_of covers every edge: skip trimming
+    const EdgeDirection direction;
+    std::vector<AdjacencyIndex::RelationId> relations;
+    std::vector<std::atomic<uint64_t>> visited;
+    std::vector<uint32_t>* parents;
+
+    Search(const AtomStore& store, const TraversalOptions& options, std::vector<uint32_t>* parent_out)
+        : graph(store.adjacency()),
+          entity_count(store.entity_count()),
+          as_of(options.as_of.is_valid() ? options.as_of : store.current_lsn()),
+          latest(as_of >= store.current_lsn()),
+          direction(options.direction),
+          visited((store.entity_count() + 63) / 64),
+          parents(parent_out) {
+        if (options.relations.empty()) {
+            for (AdjacencyIndex::RelationId id = 0; id < graph.relation_count(); ++id) {
+                relations.push_back(id);
+            }
+        } else {
+            for (const auto& name : options.relations) {
+                auto id = graph.find_relation(name);
+                if (id && std::find(relations.begin(), relations.end(), *id) == relations.end()) {
+                    relations.push_back(*id);
+                }
+            }
+        }
+        if (parents) {
+            parents->assign(entity_count, kNoParent);
+        }
+    }
+
+    /**
+     * @brief Mark an ordinal visited; true only for the caller that set the bit
+     */
+    bool claim(uint32_t ordinal) {
+        auto& word = visited[ordinal >> 6];
+        const uint64_t bit = uint64_t{1} << (ordinal & 63);
+        if (word.load(std::memory_order_relaxed) & bit) {
+            return false;
+        }
+        return (word.fetch_or(bit, std::memory_order_relaxed) & bit) == 0;
+    }
+
+    bool is_visited(uint32_t ordinal) const {
+        return visited[ordinal >> 6].load(std::memory_order_relaxed) & (uint64_t{1} << (ordinal & 63));
+    }
+
+    void expand_range(const uint32_t* first, const uint32_t* last, std::vector<uint32_t>& out) {
+        for (const uint32_t* it = first; it != last; ++it) {
+            const uint32_t from = *it;
+            for (AdjacencyIndex::RelationId relation : relations) {
+                Neighbours neighbours = graph.neighbours(from, relation, direction);
+                if (!latest) {
+                    neighbours = neighbours.as_of(as_of);
+                }
+                neighbours.for_each([&](uint32_t to) {
+                    if (to < entity_count && claim(to)) {
+                        // Only the claiming thread writes this slot
+                        if (parents) (*parents)[to] = from;
+                        out.push_back(to);
+                    }
+                });
+            }
+        }
+    }
+
+    std::vector<uint32_t> expand(const std::vector<uint32_t>& frontier, size_t threads) {
+        std::vector<uint32_t> next;
+        const uint32_t* data = frontier.data();
+        if (threads <= 1 || frontier.size() < kParallelFrontier) {
+            expand_range(data, data + frontier.size(), next);
+            return next;
+        }
+
+        const size_t chunks = (frontier.size() + kChunkSize - 1) / kChunkSize;
+        const size_t workers = std::min(threads, chunks);
+        std::atomic<size_t> next_chunk{0};
+        std::vector<std::vector<uint32_t>> found(workers);
+        std::vector<std::exception_ptr> errors(workers);
+
+        auto work = [&](size_t worker) {
+            try {
+                for (size_t chunk; (chunk = next_chunk.fetch_add(1)) < chunks;) {
+                    const size_t begin = chunk * kChunkSize;
+                    const size_t end = std::min(frontier.size(), begin + kChunkSize);
+                    expand_range(data + begin, data + end, found[worker]);
+                }
+            } catch (...) {
+                errors[worker] = std::current_exception();
+                next_chunk.store(chunks);
+            }
+        };
+
+        std::vector<std::thread> pool;
+        pool.reserve(workers - 1);
+        for (size_t worker = 1; worker < workers; ++worker) {
+            try {
+                pool.emplace_back(work, worker);
+            } catch (const std::system_error&) {
+                break;  // Fewer threads: the remaining chunks run below
+            }
+        }
+        work(0);
+        for (auto& thread : pool) {
+            thread.join();
+        }
+        for (const auto& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+
+        size_t total = 0;
+        for (const auto& part : found) total += part.size();
+        next.reserve(total);
+        for (const auto& part : found) next.insert(next.end(), part.begin(), part.end());
+        return next;
+    }
+};
+
+GraphTraversal::GraphTraversal(const AtomStore& store, size_t threads)
+    : m_store(store),
+      m_threads(threads > 0 ? threads : std::max<size_t>(1, std::thread::hardware_concurrency())) {}
+
+std::vector<EntityBitmap> GraphTraversal::run(const std::vector<uint32_t>& sources, const TraversalOptions& options,
+                                              const uint32_t* stop_at, std::vector<uint32_t>* parents) const {
+    Search search(m_store, options, parents);
+
+    std::vector<uint32_t> frontier;
+    for (uint32_t source : sources) {
+        if (source < search.entity_count && search.claim(source)) {
+            frontier.push_back(source);
+        }
+    }
+
+    std::vector<EntityBitmap> levels;
+    if (frontier.empty()) {
+        return levels;
+    }
+    levels.push_back(EntityBitmap::from_rows(frontier));
+
+    for (uint32_t hop = 0; hop < options.max_hops && !search.relations.empty(); ++hop) {
+        if (stop_at && search.is_visited(*stop_at)) {
+            break;
+        }
+        frontier = search.expand(frontier, m_threads);
+        if (frontier.empty()) {
+            break;
+        }
+        levels.push_back(EntityBitmap::from_rows(frontier));
+    }
+    return levels;
+}
+
+std::vector<EntityBitmap> GraphTraversal::bfs_levels(const std::vector<uint32_t>& sources,
+                                                     const TraversalOptions& options) const {
+    return run(sources, options, nullptr, nullptr);
+}
+
+EntityBitmap GraphTraversal::k_hop(const types::EntityId& start, const TraversalOptions& options) const {
+    EntityBitmap reached;
+    auto ordinal = m_store.find_ordinal(start);
+    if (!ordinal) {
+        return reached;
+    }
+    auto levels = run({*ordinal}, options, nullptr, nullptr);
+    for (size_t hop = 1; hop < levels.size(); ++hop) {
+        reached |= levels[hop];
+    }
+    return reached;
+}
+
+bool GraphTraversal::reachable(const types::EntityId& source, const types::EntityId& target,
+                               const TraversalOptions& options) const {
+    auto from = m_store.find_ordinal(source);
+    auto to = m_store.find_ordinal(target);
+    if (!from || !to) {
+        return false;
+    }
+    auto levels = run({*from}, options, &*to, nullptr);
+    return !levels.empty() && levels.back().contains(*to);
+}
+
+std::vector<types::EntityId> GraphTraversal::shortest_path(const types::EntityId& source,
+                                                           const types::EntityId& target,
+                                                           const TraversalOptions& options) const {
+    std::vector<types::EntityId> path;
+    auto from = m_store.find_ordinal(source);
+    auto to = m_store.find_ordinal(target);
+    if (!from || !to) {
+        return path;
+    }
+
+    std::vector<uint32_t> parents;
+    auto levels = run({*from}, options, &*to, &parents);
+    if (levels.empty() || !levels.back().contains(*to)) {
+        return path;
+    }
+
+    // Walk predecessors back to the source
+    for (uint32_t at = *to; at != *from; at = parents[at]) {
+        path.push_back(m_store.entity_at(at));
+    }
+    path.push_back(source);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+} // namespace gtaf::core
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "../types/types.h"
+#include "adjacency_index.h"
+#include "atom_store.h"
+#include "entity_bitmap.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace gtaf::core {
+
+/**
+ * @brief Parameters shared by all GraphTraversal queries
+ */
+struct TraversalOptions {
+    /**
+     * @brief Relations to follow (empty: every relation)
+     *
+     * Names no edge has used match nothing.
+     */
+    std::vector<std::string> relations;
+
+    EdgeDirection direction = EdgeDirection::Outgoing;
+
+    /**
+     * @brief Maximum number of hops from the sources
+     */
+    uint32_t max_hops = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * @brief Snapshot to traverse (invalid: pin AtomStore::current_lsn())
+     *
+     * Only edges visible at this LSN are followed, so a traversal sees one
+     * consistent version of the graph and older versions can be queried.
+     */
+    types::LogSequenceNumber as_of{};
+};
+
+/**
+ * @brief Multi-hop traversal over the store's adjacency index
+ *
+ * Breadth-first, level-synchronous expansion over dense entity ordinals:
+ * a flat visited bitmap (one bit per ordinal) deduplicates discoveries,
+ * and large frontiers are split into chunks expanded on worker threads
+ * that claim vertices with an atomic fetch_or on the bitmap. Small
+ * frontiers are expanded inline, where thread start-up would dominate.
+ *
+ * Results are EntityBitmaps, so they combine directly with QueryIndex
+ * select_* results, e.g. "work requests within 3 hops of this customer":
+ *
+ *   GraphTraversal graph(store);
+ *   TraversalOptions options;
+ *   options.max_hops = 3;
+ *   auto nearby = graph.k_hop(customer, options) & index.select_equals("type", "work_request");
+ *
+ * Like other readers, a traversal must not run concurrently with appends
+ * to the store; it never modifies the store itself.
+ */
+class GraphTraversal {
+public:
+    /**
+     * @brief Construct a traversal engine for a store
+     *
+     * @param store Reference to the atom store (must outlive this engine)
+     * @param threads Worker threads for large frontiers (0: hardware concurrency)
+     */
+    explicit GraphTraversal(const AtomStore& store, size_t threads = 0);
+
+    const AtomStore& store() const noexcept { return m_store; }
+
+    size_t thread_count() const noexcept { return m_threads; }
+
+    /**
+     * @brief Breadth-first levels from a set of source ordinals
+     *
+     * levels[0] holds the (known) sources and levels[h] the ordinals first
+     * reached after h hops, up to options.max_hops. Trailing empty levels
+     * are not included.
+     */
+    std::vector<EntityBitmap> bfs_levels(const std::vector<uint32_t>& sources,
+                                         const TraversalOptions& options = {}) const;
+
+    /**
+     * @brief Entities reachable from start within options.max_hops hops
+     *
+     * The start entity itself is not included. Unknown entities reach nothing.
+     */
+    EntityBitmap k_hop(const types::EntityId& start, const TraversalOptions& options = {}) const;
+
+    /**
+     * @brief Whether target is reachable from source (stops at the first hit)
+     *
+     * An entity always reaches itself.
+     */
+    bool reachable(const types::EntityId& source, const types::EntityId& target,
+                   const TraversalOptions& options = {}) const;
+
+    /**
+     * @brief A path with the fewest hops from source to target
+     *
+     * @return Entities from source to target inclusive, or empty if the
+     *         target is unreachable within options.max_hops
+     */
+    std::vector<types::EntityId> shortest_path(const types::EntityId& source, const types::EntityId& target,
+                                               const TraversalOptions& options = {}) const;
+
+private:
+    struct Search;
+
+    /**
+     * @brief Run a BFS, optionally stopping once stop_at is discovered
+     *
+     * @param parents If non-null, resized and filled with each discovered
+     *                ordinal's predecessor
+     */
+    std::vector<EntityBitmap> run(const std::vector<uint32_t>& sources, const TraversalOptions& options,
+                                  const uint32_t* stop_at, std::vector<uint32_t>* parents) const;
+
+    const AtomStore& m_store;
+    size_t m_threads;
+};
+
+} // namespace gtaf::core
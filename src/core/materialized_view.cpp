@@ -0,0 +1,397 @@
+#include "materialized_view.h"
+#include <cmath>
+#include <type_traits>
+
+namespace gtaf::core {
+
+ViewKey to_view_key(const types::AtomValue& value) {
+    return std::visit([](const auto& v) -> ViewKey {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, double>) {
+            // NaN is unordered, which would break map and sort keys
+            return std::isnan(v) ? ViewKey{} : ViewKey{v};
+        } else if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, int64_t> ||
+                             std::is_same_v<T, std::string>) {
+            return v;
+        } else {
+            return std::monostate{};
+        }
+    }, value);
+}
+
+// ---- MaterializedView Implementation ----
+
+MaterializedView::MaterializedView(const AtomStore& store, std::optional<ViewFilter> filter)
+    : m_store(store), m_filter(std::move(filter)) {}
+
+MaterializedView::~MaterializedView() {
+    unsubscribe();
+}
+
+size_t MaterializedView::build() {
+    std::lock_guard lock(m_mutex);
+    reset();
+    m_matches.clear();
+
+    size_t changed = 0;
+    const size_t count = m_store.entity_count();
+    for (uint32_t ordinal = 0; ordinal < count; ++ordinal) {
+        // Refs are in LSN order, so applying each in turn leaves the latest values
+        for (const auto& ref : m_store.get_entity_atoms_at(ordinal)) {
+            const Atom* atom = m_store.get_atom(ref);
+            if (atom && handle(ordinal, atom->type_tag(), atom->value())) {
+                ++changed;
+            }
+        }
+    }
+    m_applied_lsn = m_store.current_lsn().value;
+    m_layout_version = m_store.layout_version();
+    m_dirty = true;
+    return changed;
+}
+
+size_t MaterializedView::apply(const std::vector<AtomStore::AppendEvent>& events) {
+    std::lock_guard lock(m_mutex);
+    const uint64_t applied = m_applied_lsn;
+    size_t changed = 0;
+    for (const auto& event : events) {
+        if (event.lsn.value <= m_applied_lsn) {
+            continue;
+        }
+        if (handle(event.ordinal, event.atom->type_tag(), event.atom->value())) {
+            ++changed;
+        }
+        m_applied_lsn = event.lsn.value;
+    }
+    // Republish even if nothing changed: snapshots report the LSN they reflect
+    if (m_applied_lsn != applied) {
+        m_dirty = true;
+    }
+    return changed;
+}
+
+bool MaterializedView::handle(uint32_t ordinal, const std::string& tag, const types::AtomValue& value) {
+    bool changed = false;
+    if (m_filter && tag == m_filter->tag) {
+        if (ordinal >= m_matches.size()) {
+            m_matches.resize(ordinal + 1, 0);
+        }
+        const bool now = to_view_key(value) == m_filter->value;
+        if (now != static_cast<bool>(m_matches[ordinal])) {
+            m_matches[ordinal] = now;
+            on_membership(ordinal, now);
+            changed = true;
+        }
+    }
+    return on_value(ordinal, tag, value) || changed;
+}
+
+size_t MaterializedView::catch_up() {
+    uint64_t applied = 0;
+    bool relaid = false;
+    {
+        std::lock_guard lock(m_mutex);
+        applied = m_applied_lsn;
+        relaid = m_layout_version != m_store.layout_version();
+    }
+    if (relaid || m_store.current_lsn().value < applied) {
+        return build();   // Reloaded or compacted since the view was built
+    }
+    if (m_store.current_lsn().value == applied) {
+        return 0;
+    }
+
+    // Per-entity references are in LSN order, so only each tail needs walking
+    std::vector<AtomStore::AppendEvent> events;
+    const size_t count = m_store.entity_count();
+    for (uint32_t ordinal = 0; ordinal < count; ++ordinal) {
+        const auto& refs = m_store.get_entity_atoms_at(ordinal);
+        for (auto it = refs.rbegin(); it != refs.rend() && it->lsn.value > applied; ++it) {
+            if (const Atom* atom = m_store.get_atom(*it)) {
+                events.push_back({m_store.entity_at(ordinal), ordinal, atom, it->lsn});
+            }
+        }
+    }
+    std::sort(events.begin(), events.end(),
+              [](const auto& a, const auto& b) { return a.lsn < b.lsn; });
+
+    size_t changed = apply(events);
+    std::lock_guard lock(m_mutex);
+    if (m_applied_lsn < m_store.current_lsn().value) {
+        m_applied_lsn = m_store.current_lsn().value;
+        m_dirty = true;
+    }
+    return changed;
+}
+
+void MaterializedView::subscribe(AtomStore& store) {
+    unsubscribe();
+    catch_up();
+    m_subscribed_store = &store;
+    m_listener_id = store.add_append_listener(
+        [this](const std::vector<AtomStore::AppendEvent>& events) { apply(events); },
+        [this] { build(); });
+}
+
+void MaterializedView::unsubscribe() {
+    if (m_subscribed_store) {
+        m_subscribed_store->remove_append_listener(m_listener_id);
+        m_subscribed_store = nullptr;
+        m_listener_id = 0;
+    }
+}
+
+types::LogSequenceNumber MaterializedView::applied_lsn() const {
+    std::lock_guard lock(m_mutex);
+    return {m_applied_lsn};
+}
+
+// ---- ProjectionView Implementation ----
+
+ProjectionView::ProjectionView(const AtomStore& store, std::vector<std::string> tags,
+                               std::optional<ViewFilter> filter)
+    : MaterializedView(store, std::move(filter)) {
+    std::vector<std::string> unique;
+    for (auto& tag : tags) {
+        if (m_columns.emplace(tag, unique.size()).second) {
+            unique.push_back(std::move(tag));
+        }
+    }
+    m_tags = std::make_shared<const std::vector<std::string>>(std::move(unique));
+}
+
+ProjectionView::~ProjectionView() {
+    unsubscribe();
+}
+
+void ProjectionView::reset() {
+    m_chunks.clear();
+    m_rows = 0;
+    m_size = 0;
+    m_published.reset();
+}
+
+ProjectionView::Chunk& ProjectionView::writable(uint32_t ordinal) {
+    const size_t index = ordinal / kChunkRows;
+    if (index >= m_chunks.size()) {
+        m_chunks.resize(index + 1);
+    }
+    auto& chunk = m_chunks[index];
+    if (!chunk) {
+        chunk = std::make_shared<Chunk>();
+        chunk->cells.resize(kChunkRows * m_tags->size());
+        chunk->matches.resize(kChunkRows, 0);
+    } else if (chunk.use_count() > 1) {
+        // Still referenced by a snapshot: copy on write
+        chunk = std::make_shared<Chunk>(*chunk);
+    }
+    m_rows = std::max<size_t>(m_rows, size_t{ordinal} + 1);
+    return *chunk;
+}
+
+bool ProjectionView::on_value(uint32_t ordinal, const std::string& tag, const types::AtomValue& value) {
+    auto it = m_columns.find(tag);
+    if (it == m_columns.end()) {
+        return false;
+    }
+    Chunk& chunk = writable(ordinal);
+    const size_t row = ordinal % kChunkRows;
+    chunk.cells[row * m_tags->size() + it->second] = value;
+
+    // Unfiltered views hold every entity with a projected value
+    if (!filter() && !chunk.matches[row]) {
+        chunk.matches[row] = 1;
+        ++m_size;
+    }
+    return true;
+}
+
+void ProjectionView::on_membership(uint32_t ordinal, bool matches) {
+    Chunk& chunk = writable(ordinal);
+    chunk.matches[ordinal % kChunkRows] = matches;
+    if (matches) {
+        ++m_size;
+    } else {
+        --m_size;
+    }
+}
+
+std::shared_ptr<const ProjectionView::Snapshot> ProjectionView::snapshot() const {
+    std::lock_guard lock(m_mutex);
+    if (m_published && !m_dirty) {
+        return m_published;
+    }
+
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->m_lsn = m_applied_lsn;
+    snapshot->m_size = m_size;
+    snapshot->m_rows = m_rows;
+    snapshot->m_tags = m_tags;
+    snapshot->m_chunks.assign(m_chunks.begin(), m_chunks.end());
+    m_published = std::move(snapshot);
+    m_dirty = false;
+    return m_published;
+}
+
+std::optional<size_t> ProjectionView::Snapshot::column(const std::string& tag) const {
+    auto it = std::find(m_tags->begin(), m_tags->end(), tag);
+    if (it == m_tags->end()) {
+        return std::nullopt;
+    }
+    return static_cast<size_t>(it - m_tags->begin());
+}
+
+bool ProjectionView::Snapshot::contains(uint32_t ordinal) const {
+    const size_t index = ordinal / kChunkRows;
+    return ordinal < m_rows && m_chunks[index] && m_chunks[index]->matches[ordinal % kChunkRows];
+}
+
+const types::AtomValue* ProjectionView::Snapshot::get(uint32_t ordinal, size_t column) const {
+    if (column >= m_tags->size() || !contains(ordinal)) {
+        return nullptr;
+    }
+    const auto& cell = m_chunks[ordinal / kChunkRows]->cells[(ordinal % kChunkRows) * m_tags->size() + column];
+    return std::holds_alternative<std::monostate>(cell) ? nullptr : &cell;
+}
+
+// ---- AggregateView Implementation ----
+
+namespace {
+
+std::optional<double> numeric(const types::AtomValue& value) {
+    if (auto* i = std::get_if<int64_t>(&value)) return static_cast<double>(*i);
+    if (auto* d = std::get_if<double>(&value)) {
+        // NaN keys in the extremes map would break its ordering
+        return std::isnan(*d) ? std::nullopt : std::optional<double>(*d);
+    }
+    return std::nullopt;
+}
+
+// Neumaier summation: keeps the low-order bits a plain running sum loses,
+// so retracting a value restores the previous sum instead of drifting
+void accumulate(double& sum, double& compensation, double value) {
+    const double total = sum + value;
+    if (std::abs(sum) >= std::abs(value)) {
+        compensation += (sum - total) + value;
+    } else {
+        compensation += (value - total) + sum;
+    }
+    sum = total;
+}
+
+} // namespace
+
+AggregateView::AggregateView(const AtomStore& store, AggregateSpec spec)
+    : MaterializedView(store, spec.filter), m_spec(std::move(spec)) {}
+
+AggregateView::~AggregateView() {
+    unsubscribe();
+}
+
+void AggregateView::reset() {
+    m_members.clear();
+    m_groups.clear();
+    m_published.reset();
+}
+
+bool AggregateView::on_value(uint32_t ordinal, const std::string& tag, const types::AtomValue& value) {
+    const bool is_key = tag == m_spec.group_by;
+    const bool is_value = m_spec.op != AggregateOp::Count && tag == m_spec.value_tag;
+    if (!is_key && !is_value) {
+        return false;
+    }
+    if (ordinal >= m_members.size()) {
+        m_members.resize(ordinal + 1);
+    }
+
+    // Replace the entity's contribution: retract with the old state, add with the new
+    if (contributes(ordinal)) {
+        retract(ordinal);
+    }
+    Member& member = m_members[ordinal];
+    if (is_key) member.key = to_view_key(value);
+    if (is_value) member.value = numeric(value);
+    if (contributes(ordinal)) {
+        add(ordinal);
+    }
+    return true;
+}
+
+void AggregateView::on_membership(uint32_t ordinal, bool now_matches) {
+    if (ordinal >= m_members.size() || std::holds_alternative<std::monostate>(m_members[ordinal].key)) {
+        return;
+    }
+    if (now_matches) {
+        add(ordinal);
+    } else {
+        retract(ordinal);
+    }
+}
+
+void AggregateView::add(uint32_t ordinal) {
+    const Member& member = m_members[ordinal];
+    Accumulator& group = m_groups[member.key];
+    ++group.count;
+    if (member.value) {
+        ++group.values;
+        accumulate(group.sum, group.compensation, *member.value);
+        if (m_spec.op == AggregateOp::Min || m_spec.op == AggregateOp::Max) {
+            ++group.extremes[*member.value];
+        }
+    }
+}
+
+void AggregateView::retract(uint32_t ordinal) {
+    const Member& member = m_members[ordinal];
+    auto it = m_groups.find(member.key);
+    if (it == m_groups.end()) {
+        return;
+    }
+    Accumulator& group = it->second;
+    if (member.value) {
+        if (--group.values == 0) {
+            group.sum = 0.0;   // Exact again once the last value is gone
+            group.compensation = 0.0;
+        } else {
+            accumulate(group.sum, group.compensation, -*member.value);
+        }
+        if (auto extreme = group.extremes.find(*member.value); extreme != group.extremes.end()) {
+            if (--extreme->second == 0) group.extremes.erase(extreme);
+        }
+    }
+    if (--group.count == 0) {
+        m_groups.erase(it);
+    }
+}
+
+std::shared_ptr<const AggregateView::Snapshot> AggregateView::snapshot() const {
+    std::lock_guard lock(m_mutex);
+    if (m_published && !m_dirty) {
+        return m_published;
+    }
+
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->m_lsn = m_applied_lsn;
+    snapshot->m_groups.reserve(m_groups.size());
+    for (const auto& [key, group] : m_groups) {
+        AggregateGroup result{key, group.count, group.values, 0.0};
+        switch (m_spec.op) {
+            case AggregateOp::Count: result.value = static_cast<double>(group.count); break;
+            case AggregateOp::Sum: result.value = group.values ? group.sum + group.compensation : 0.0; break;
+            case AggregateOp::Min: result.value = group.values ? group.extremes.begin()->first : 0.0; break;
+            case AggregateOp::Max: result.value = group.values ? group.extremes.rbegin()->first : 0.0; break;
+        }
+        snapshot->m_groups.push_back(std::move(result));
+    }
+    m_published = std::move(snapshot);
+    m_dirty = false;
+    return m_published;
+}
+
+const AggregateGroup* AggregateView::Snapshot::find(const ViewKey& key) const {
+    auto it = std::lower_bound(m_groups.begin(), m_groups.end(), key,
+                               [](const AggregateGroup& group, const ViewKey& k) { return group.key < k; });
+    return it != m_groups.end() && it->key == key ? &*it : nullptr;
+}
+
+} // namespace gtaf::core
@@ -0,0 +1,375 @@
+#pragma once
+
+#include "../types/types.h"
+#include "atom_store.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace gtaf::core {
+
+/**
+ * @brief Comparable scalar used for view filters and group keys
+ *
+ * Values of other types (vectors, blobs, edges) and NaN convert to
+ * monostate, so every key has a strict weak order.
+ */
+using ViewKey = std::variant<std::monostate, bool, int64_t, double, std::string>;
+
+[[nodiscard]] ViewKey to_view_key(const types::AtomValue& value);
+
+/**
+ * @brief Restricts a view to entities whose latest value of a tag equals a key
+ */
+struct ViewFilter {
+    std::string tag;
+    ViewKey value;
+};
+
+/**
+ * @brief Common maintenance of a view derived from each entity's latest values
+ *
+ * A view keeps per-entity state addressed by store ordinal. build()
+ * populates it from the store; afterwards, like QueryIndex, subscribe()
+ * applies every committed append incrementally at O(batch) cost.
+ *
+ * Readers never see the mutable state: snapshot() (on the concrete views)
+ * returns an immutable, shared snapshot as of the last applied LSN (also
+ * after appends that left the view unchanged), which stays valid and
+ * unchanged however long it is held. Snapshots may be taken from any
+ * thread while appends are applied.
+ */
+class MaterializedView {
+public:
+    /**
+     * @param store Store to maintain the view over (must outlive the view)
+     * @param filter Only entities matching the filter contribute (none: all)
+     */
+    MaterializedView(const AtomStore& store, std::optional<ViewFilter> filter);
+
+    /**
+     * @brief Unsubscribes from the store if still subscribed
+     */
+    virtual ~MaterializedView();
+
+    // The store listener captures this view, so it must stay in place
+    MaterializedView(const MaterializedView&) = delete;
+    MaterializedView& operator=(const MaterializedView&) = delete;
+
+    /**
+     * @brief (Re)compute the view from every reference in the store
+     *
+     * @return Number of references that changed the view
+     */
+    size_t build();
+
+    /**
+     * @brief Apply committed references in LSN order (see QueryIndex::apply())
+     *
+     * @return Number of events that changed the view
+     */
+    size_t apply(const std::vector<AtomStore::AppendEvent>& events);
+
+    /**
+     * @brief Apply every store reference newer than applied_lsn()
+     *
+     * Rebuilds instead if the store's layout_version() changed since the
+     * last build() (after a load() or compact()): a load() restarts
+     * ordinals and LSNs, so the view's state cannot be caught up from them.
+     *
+     * @return Number of references that changed the view
+     */
+    size_t catch_up();
+
+    /**
+     * @brief Apply every future append committed to a store
+     *
+     * Appends committed since the view was built (or last applied) are
+     * caught up first, so none are lost between build() and subscribe().
+     * A load() into the store while subscribed rebuilds the view from the
+     * loaded contents. The store must be the one the view was built from
+     * and must outlive the subscription. Re-subscribing replaces any
+     * previous subscription.
+     */
+    void subscribe(AtomStore& store);
+
+    /**
+     * @brief Stop receiving appends (no-op if not subscribed)
+     */
+    void unsubscribe();
+
+    [[nodiscard]] bool is_subscribed() const noexcept { return m_subscribed_store != nullptr; }
+
+    /**
+     * @brief Highest store LSN reflected in the view
+     */
+    [[nodiscard]] types::LogSequenceNumber applied_lsn() const;
+
+    [[nodiscard]] const std::optional<ViewFilter>& filter() const noexcept { return m_filter; }
+
+protected:
+    /**
+     * @brief Drop all derived state (lock held)
+     */
+    virtual void reset() = 0;
+
+    /**
+     * @brief Apply an entity's new latest value of a tag (lock held)
+     *
+     * Called after the filter membership for the same value was updated.
+     *
+     * @return true if the view changed
+     */
+    virtual bool on_value(uint32_t ordinal, const std::string& tag, const types::AtomValue& value) = 0;
+
+    /**
+     * @brief An entity started or stopped matching the filter (lock held)
+     */
+    virtual void on_membership(uint32_t ordinal, bool matches) = 0;
+
+    [[nodiscard]] bool matches(uint32_t ordinal) const noexcept {
+        return !m_filter || (ordinal < m_matches.size() && m_matches[ordinal]);
+    }
+
+    const AtomStore& m_store;
+
+    // Guards derived state between the applying thread and snapshot readers
+    mutable std::mutex m_mutex;
+    uint64_t m_applied_lsn = 0;
+    uint64_t m_layout_version = 0;   // Store layout_version() at the last build()
+    mutable bool m_dirty = true;   // Changed or advanced since the last published snapshot
+
+private:
+    bool handle(uint32_t ordinal, const std::string& tag, const types::AtomValue& value);
+
+    std::optional<ViewFilter> m_filter;
+    std::vector<uint8_t> m_matches;   // Ordinal -> matches the filter
+
+    AtomStore* m_subscribed_store = nullptr;
+    AtomStore::ListenerId m_listener_id = 0;
+};
+
+/**
+ * @brief Latest values of a fixed set of tags for every (matching) entity
+ *
+ * Rows are stored in fixed-size chunks shared with published snapshots.
+ * A write to a chunk still referenced by a snapshot copies that chunk
+ * first, so taking a snapshot costs O(entities / kChunkRows) pointer
+ * copies and an update at most one chunk copy.
+ */
+class ProjectionView final : public MaterializedView {
+public:
+    static constexpr size_t kChunkRows = 1024;
+
+    struct Chunk {
+        std::vector<types::AtomValue> cells;   // kChunkRows x column count, row-major
+        std::vector<uint8_t> matches;          // Row matches the filter
+    };
+
+    /**
+     * @brief Immutable state of a ProjectionView at one LSN
+     */
+    class Snapshot {
+    public:
+        [[nodiscard]] types::LogSequenceNumber lsn() const noexcept { return {m_lsn}; }
+
+        /**
+         * @brief Number of matching entities
+         */
+        [[nodiscard]] size_t size() const noexcept { return m_size; }
+
+        [[nodiscard]] const std::vector<std::string>& tags() const noexcept { return *m_tags; }
+        [[nodiscard]] std::optional<size_t> column(const std::string& tag) const;
+
+        [[nodiscard]] bool contains(uint32_t ordinal) const;
+
+        /**
+         * @brief Latest value of a column for a matching entity
+         *
+         * @return Value, or nullptr if the entity does not match or has none
+         */
+        [[nodiscard]] const types::AtomValue* get(uint32_t ordinal, size_t column) const;
+
+        /**
+         * @brief Visit matching entities in ordinal order as fn(ordinal, row)
+         *
+         * Absent values in the row are monostate.
+         */
+        template<typename Fn>
+        void for_each(Fn&& fn) const;
+
+    private:
+        friend class ProjectionView;
+
+        uint64_t m_lsn = 0;
+        size_t m_size = 0;
+        size_t m_rows = 0;
+        std::shared_ptr<const std::vector<std::string>> m_tags;
+        std::vector<std::shared_ptr<const Chunk>> m_chunks;
+    };
+
+    /**
+     * @param tags Tags to project (duplicates share a column)
+     */
+    ProjectionView(const AtomStore& store, std::vector<std::string> tags,
+                   std::optional<ViewFilter> filter = std::nullopt);
+
+    ~ProjectionView() override;
+
+    [[nodiscard]] const std::vector<std::string>& tags() const noexcept { return *m_tags; }
+
+    /**
+     * @brief Current state, shared with other readers until the next change
+     */
+    [[nodiscard]] std::shared_ptr<const Snapshot> snapshot() const;
+
+protected:
+    void reset() override;
+    bool on_value(uint32_t ordinal, const std::string& tag, const types::AtomValue& value) override;
+    void on_membership(uint32_t ordinal, bool matches) override;
+
+private:
+    /**
+     * @brief Chunk holding an ordinal, unshared and allocated (lock held)
+     */
+    Chunk& writable(uint32_t ordinal);
+
+    std::shared_ptr<const std::vector<std::string>> m_tags;
+    std::map<std::string, size_t> m_columns;
+    std::vector<std::shared_ptr<Chunk>> m_chunks;
+    size_t m_rows = 0;                 // Ordinal high-water mark + 1
+    size_t m_size = 0;                 // Matching entities
+    mutable std::shared_ptr<const Snapshot> m_published;
+};
+
+/**
+ * @brief Aggregate functions of an AggregateView
+ */
+enum class AggregateOp : uint8_t {
+    Count = 0,   // Entities per group
+    Sum = 1,
+    Min = 2,
+    Max = 3
+};
+
+/**
+ * @brief Definition of an AggregateView
+ */
+struct AggregateSpec {
+    std::string group_by;              // Tag whose latest value is the group key
+    AggregateOp op = AggregateOp::Count;
+    std::string value_tag;             // Numeric tag aggregated by Sum/Min/Max
+    std::optional<ViewFilter> filter;
+};
+
+/**
+ * @brief One group of an AggregateView snapshot
+ */
+struct AggregateGroup {
+    ViewKey key;
+    uint64_t count = 0;                // Entities in the group
+    uint64_t values = 0;               // Entities with a numeric value (Sum/Min/Max)
+    double value = 0.0;                // Aggregate (Count: count); meaningless while values == 0
+};
+
+/**
+ * @brief count/sum/min/max of each entity's latest value, grouped by a tag
+ *
+ * Each entity contributes its latest value_tag (int64 or double; NaN
+ * counts as no value) to the group named by its latest group_by value;
+ * entities without a group key are left out. A changed value or key retracts the old contribution and
+ * adds the new one, so updates cost O(log groups) (O(log distinct values)
+ * for Min/Max, which keep a value multiset per group). Sums accumulate in
+ * double precision with compensated summation, so retractions do not drift.
+ */
+class AggregateView final : public MaterializedView {
+public:
+    /**
+     * @brief Immutable state of an AggregateView at one LSN
+     */
+    class Snapshot {
+    public:
+        [[nodiscard]] types::LogSequenceNumber lsn() const noexcept { return {m_lsn}; }
+
+        /**
+         * @brief Non-empty groups sorted by key
+         */
+        [[nodiscard]] const std::vector<AggregateGroup>& groups() const noexcept { return m_groups; }
+
+        [[nodiscard]] const AggregateGroup* find(const ViewKey& key) const;
+
+    private:
+        friend class AggregateView;
+
+        uint64_t m_lsn = 0;
+        std::vector<AggregateGroup> m_groups;
+    };
+
+    AggregateView(const AtomStore& store, AggregateSpec spec);
+
+    ~AggregateView() override;
+
+    [[nodiscard]] const AggregateSpec& spec() const noexcept { return m_spec; }
+
+    /**
+     * @brief Current state, shared with other readers until the next change
+     */
+    [[nodiscard]] std::shared_ptr<const Snapshot> snapshot() const;
+
+protected:
+    void reset() override;
+    bool on_value(uint32_t ordinal, const std::string& tag, const types::AtomValue& value) override;
+    void on_membership(uint32_t ordinal, bool matches) override;
+
+private:
+    struct Accumulator {
+        uint64_t count = 0;
+        uint64_t values = 0;
+        double sum = 0.0;
+        double compensation = 0.0;             // Low-order bits lost by sum
+        std::map<double, uint32_t> extremes;   // Min/Max: value -> multiplicity
+    };
+
+    struct Member {
+        ViewKey key;
+        std::optional<double> value;
+    };
+
+    bool contributes(uint32_t ordinal) const {
+        return matches(ordinal) && !std::holds_alternative<std::monostate>(m_members[ordinal].key);
+    }
+
+    void add(uint32_t ordinal);
+    void retract(uint32_t ordinal);
+
+    AggregateSpec m_spec;
+    std::vector<Member> m_members;     // Ordinal -> latest key and value
+    std::map<ViewKey, Accumulator> m_groups;
+    mutable std::shared_ptr<const Snapshot> m_published;
+};
+
+// Template implementation (must be in header)
+template<typename Fn>
+void ProjectionView::Snapshot::for_each(Fn&& fn) const {
+    const size_t width = m_tags->size();
+    for (size_t c = 0; c < m_chunks.size(); ++c) {
+        const Chunk* chunk = m_chunks[c].get();
+        if (!chunk) continue;
+        const size_t rows = std::min(kChunkRows, m_rows - c * kChunkRows);
+        for (size_t r = 0; r < rows; ++r) {
+            if (!chunk->matches[r]) continue;
+            fn(static_cast<uint32_t>(c * kChunkRows + r),
+               std::span<const types::AtomValue>(chunk->cells.data() + r * width, width));
+        }
+    }
+}
+
+} // namespace gtaf::core
@@ -1,11 +1,12 @@
 #include "node.h"
+#include <algorithm>
 
 namespace gtaf::core {
 
 // ---- Node Implementation ----
 
-Node::Node(types::EntityId entity_id)
-    : m_entity_id(entity_id) {}
+Node::Node(types::EntityId entity_id, bool record_history)
+    : m_entity_id(entity_id), m_record_history(record_history) {}
 
 const types::EntityId& Node::entity_id() const noexcept {
     return m_entity_id;
@@ -17,39 +18,76 @@ void Node::apply(
     const types::AtomValue& value,
     types::LogSequenceNumber lsn
 ) {
-    auto& slot = m_latest_by_tag[type_tag];
-    if (!slot || lsn > slot->lsn) {
-        slot = Entry{ atom_id, value, lsn };
+    apply(atom_id, TagDictionary::global().intern(type_tag), value, lsn);
+}
+
+void Node::apply(
+    const types::AtomId& atom_id,
+    TagId tag,
+    const types::AtomValue& value,
+    types::LogSequenceNumber lsn
+) {
+    auto it = std::lower_bound(m_properties.begin(), m_properties.end(), tag,
+                               [](const Property& property, TagId id) { return property.tag < id; });
+    if (it == m_properties.end() || it->tag != tag) {
+        m_properties.insert(it, Property{ tag, lsn, atom_id, value });
+    } else if (lsn > it->lsn) {
+        it->lsn = lsn;
+        it->atom_id = atom_id;
+        it->value = value;
     }
 
-    m_history.emplace_back(atom_id, lsn);
+    if (m_record_history) {
+        m_history.emplace_back(atom_id, lsn);
+    }
+}
+
+const Node::Property* Node::find(const std::string& type_tag) const {
+    auto tag = TagDictionary::global().find(type_tag);
+    return tag ? find(*tag) : nullptr;
+}
+
+const Node::Property* Node::find(TagId tag) const {
+    auto it = std::lower_bound(m_properties.begin(), m_properties.end(), tag,
+                               [](const Property& property, TagId id) { return property.tag < id; });
+    return it != m_properties.end() && it->tag == tag ? it : nullptr;
 }
 
 std::optional<types::AtomId> Node::latest_atom(const std::string& type_tag) const {
-    if (auto it = m_latest_by_tag.find(type_tag); it != m_latest_by_tag.end()) {
-        if (it->second) {
-            return it->second->atom_id;
-        }
+    if (const Property* property = find(type_tag)) {
+        return property->atom_id;
+    }
+    return std::nullopt;
+}
+
+std::optional<types::AtomId> Node::latest_atom(TagId tag) const {
+    if (const Property* property = find(tag)) {
+        return property->atom_id;
     }
     return std::nullopt;
 }
 
 std::optional<types::AtomValue> Node::get(const std::string& type_tag) const {
-    if (auto it = m_latest_by_tag.find(type_tag); it != m_latest_by_tag.end()) {
-        if (it->second) {
-            return it->second->value;
-        }
+    if (const Property* property = find(type_tag)) {
+        return property->value;
+    }
+    return std::nullopt;
+}
+
+std::optional<types::AtomValue> Node::get(TagId tag) const {
+    if (const Property* property = find(tag)) {
+        return property->value;
     }
     return std::nullopt;
 }
 
 std::unordered_map<std::string, types::AtomValue> Node::get_all() const {
     std::unordered_map<std::string, types::AtomValue> result;
+    result.reserve(m_properties.size());
 
-    for (const auto& [tag, entry_opt] : m_latest_by_tag) {
-        if (entry_opt) {
-            result[tag] = entry_opt->value;
-        }
+    const auto& tags = TagDictionary::global();
+    for (const auto& property : m_properties) {
+        result[tags.name(property.tag)] = property.value;
     }
 
     return result;
@@ -60,4 +98,25 @@ Node::history() const noexcept {
     return m_history;
 }
 
+size_t Node::memory_bytes() const noexcept {
+    size_t bytes = sizeof(Node) + m_history.capacity() * sizeof(m_history[0]);
+    if (!m_properties.is_inline()) {
+        bytes += m_properties.capacity() * sizeof(Property);
+    }
+
+    // Value payloads outside the variant itself
+    for (const auto& property : m_properties) {
+        if (auto* text = std::get_if<std::string>(&property.value)) {
+            bytes += text->capacity();
+        } else if (auto* vector = std::get_if<types::Vector>(&property.value)) {
+            bytes += vector->capacity() * sizeof(float);
+        } else if (auto* blob = std::get_if<std::vector<uint8_t>>(&property.value)) {
+            bytes += blob->capacity();
+        } else if (auto* edge = std::get_if<types::EdgeValue>(&property.value)) {
+            bytes += edge->relation.capacity();
+        }
+    }
+    return bytes;
+}
+
 } // namespace gtaf::core
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../types/types.h"
+#include "small_vector.h"
+#include "tag_dictionary.h"
 #include <unordered_map>
 #include <vector>
 #include <optional>
@@ -11,14 +13,23 @@ namespace gtaf::core {
  * @brief Represents the projected state of a single entity
  *
  * A Node is a derived, mutable view rebuilt from the atom log.
- * It tracks the latest atom for each type_tag and maintains full history.
+ * It tracks the latest atom for each type_tag and, on request, the full
+ * history of applied atoms.
+ *
+ * Properties are kept flat, sorted by interned TagId (see TagDictionary),
+ * with the first kInlineProperties stored inside the Node itself; typical
+ * entities therefore project without any per-property allocation.
  */
 class Node final {
 public:
+    static constexpr size_t kInlineProperties = 4;
+
     /**
      * @brief Construct a Node for a given entity
+     *
+     * @param record_history Keep every applied (atom, LSN) for history()
      */
-    explicit Node(types::EntityId entity_id);
+    explicit Node(types::EntityId entity_id, bool record_history = false);
 
     /**
      * @brief Get the entity ID this Node represents
@@ -29,7 +40,7 @@ public:
      * @brief Apply an atom that belongs to this entity
      *
      * Updates the latest atom for the type_tag if the LSN is newer.
-     * Always appends to history.
+     * Appends to history when recording it.
      * Stores the projected value for fast reads.
      */
     void apply(
@@ -39,25 +50,50 @@ public:
         types::LogSequenceNumber lsn
     );
 
+    /**
+     * @brief apply() for a tag already interned in TagDictionary::global()
+     */
+    void apply(
+        const types::AtomId& atom_id,
+        TagId tag,
+        const types::AtomValue& value,
+        types::LogSequenceNumber lsn
+    );
+
     /**
      * @brief Query the latest atom for a given type_tag
      *
+     * Looks the tag up in TagDictionary::global() (see get()).
+     *
      * @return AtomId if found, nullopt otherwise
      */
     [[nodiscard]] std::optional<types::AtomId>
     latest_atom(const std::string& type_tag) const;
+    [[nodiscard]] std::optional<types::AtomId> latest_atom(TagId tag) const;
 
     /**
-     * @brief Query the latest value for a given type_tag (fast read path)
+     * @brief Query the latest value for a given type_tag
      *
      * Returns the projected value without fetching from atom log.
-     * This is the primary read method for Row projections.
+     * Convenient for one-off reads; each call takes the shared lock of
+     * TagDictionary::global(), so loops over many Nodes should use
+     * get(TagId) instead.
      *
      * @return AtomValue if found, nullopt otherwise
      */
     [[nodiscard]] std::optional<types::AtomValue>
     get(const std::string& type_tag) const;
 
+    /**
+     * @brief get() for a tag already interned in TagDictionary::global() (fast read path)
+     *
+     * Skips the dictionary lookup and its lock: resolve the TagId once per
+     * tag with ProjectionEngine::find_tag() (or AtomStore::find_tag()) and
+     * read it from every Node. This is the primary read method for Row
+     * projections.
+     */
+    [[nodiscard]] std::optional<types::AtomValue> get(TagId tag) const;
+
     /**
      * @brief Get all current property values as a map
      *
@@ -68,24 +104,43 @@ public:
     [[nodiscard]] std::unordered_map<std::string, types::AtomValue>
     get_all() const;
 
+    /**
+     * @brief Number of tags with a projected value
+     */
+    [[nodiscard]] size_t size() const noexcept { return m_properties.size(); }
+
+    [[nodiscard]] bool records_history() const noexcept { return m_record_history; }
+
     /**
      * @brief Get the complete history of atoms applied to this Node
+     *
+     * Empty unless the Node was constructed with record_history.
      */
     [[nodiscard]] const std::vector<std::pair<types::AtomId, types::LogSequenceNumber>>&
     history() const noexcept;
 
+    /**
+     * @brief Approximate heap footprint in bytes (used by NodeCache budgets)
+     */
+    [[nodiscard]] size_t memory_bytes() const noexcept;
+
 private:
-    struct Entry {
+    struct Property {
+        TagId tag;
+        types::LogSequenceNumber lsn;
         types::AtomId atom_id;
         types::AtomValue value;                 // Projected value for fast reads
-        types::LogSequenceNumber lsn;
     };
 
+    const Property* find(const std::string& type_tag) const;
+    const Property* find(TagId tag) const;
+
     // ---- Identity ----
     types::EntityId m_entity_id;
+    bool m_record_history;
 
     // ---- Derived state (Row Projection) ----
-    std::unordered_map<std::string, std::optional<Entry>> m_latest_by_tag;
+    SmallVector<Property, kInlineProperties> m_properties;   // Sorted by tag
     std::vector<std::pair<types::AtomId, types::LogSequenceNumber>> m_history;
 };
 
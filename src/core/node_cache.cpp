@@ -0,0 +1,78 @@
+#include "node_cache.h"
+
+namespace gtaf::core {
+
+// ---- NodeCache Implementation ----
+
+NodeCache::NodeCache(size_t budget_bytes)
+    : m_budget_bytes(budget_bytes), m_shard_budget(budget_bytes / kShards) {}
+
+void NodeCache::insert(uint32_t ordinal, uint64_t lsn, const Node& node) {
+    const size_t bytes = node.memory_bytes();
+    if (bytes > m_shard_budget) {
+        return;
+    }
+
+    Shard& shard = shard_of(ordinal);
+    std::lock_guard lock(shard.mutex);
+
+    auto it = shard.entries.find(ordinal);
+    if (it != shard.entries.end()) {
+        Entry& entry = it->second;
+        if (entry.lsn == lsn) {
+            return;
+        }
+        entry.node = node;
+        entry.lsn = lsn;
+        shard.lru.splice(shard.lru.begin(), shard.lru, entry.position);
+        resize(shard, entry, bytes);
+        return;
+    }
+
+    shard.lru.push_front(ordinal);
+    shard.entries.emplace(ordinal, Entry{node, lsn, bytes, shard.lru.begin()});
+    shard.bytes += bytes;
+    evict(shard);
+}
+
+void NodeCache::resize(Shard& shard, Entry& entry, size_t bytes) {
+    shard.bytes = shard.bytes - entry.bytes + bytes;
+    entry.bytes = bytes;
+    evict(shard);
+}
+
+void NodeCache::evict(Shard& shard) {
+    while (shard.bytes > m_shard_budget && !shard.lru.empty()) {
+        auto it = shard.entries.find(shard.lru.back());
+        shard.bytes -= it->second.bytes;
+        shard.entries.erase(it);
+        shard.lru.pop_back();
+        m_evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void NodeCache::clear() {
+    for (auto& shard : m_shards) {
+        std::lock_guard lock(shard.mutex);
+        shard.entries.clear();
+        shard.lru.clear();
+        shard.bytes = 0;
+    }
+}
+
+NodeCacheStats NodeCache::stats() const {
+    NodeCacheStats stats;
+    stats.hits = m_hits.load(std::memory_order_relaxed);
+    stats.patches = m_patches.load(std::memory_order_relaxed);
+    stats.misses = m_misses.load(std::memory_order_relaxed);
+    stats.evictions = m_evictions.load(std::memory_order_relaxed);
+    stats.budget_bytes = m_budget_bytes;
+    for (const auto& shard : m_shards) {
+        std::lock_guard lock(shard.mutex);
+        stats.entries += shard.entries.size();
+        stats.bytes += shard.bytes;
+    }
+    return stats;
+}
+
+} // namespace gtaf::core
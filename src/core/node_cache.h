@@ -0,0 +1,137 @@
+#pragma once
+
+#include "node.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace gtaf::core {
+
+/**
+ * @brief Counters of a NodeCache
+ */
+struct NodeCacheStats {
+    uint64_t hits = 0;          // Served as cached
+    uint64_t patches = 0;       // Served after applying newer references
+    uint64_t misses = 0;        // Rebuilt from the log
+    uint64_t evictions = 0;     // Dropped to stay within budget
+    size_t entries = 0;
+    size_t bytes = 0;           // Approximate (see Node::memory_bytes())
+    size_t budget_bytes = 0;
+};
+
+/**
+ * @brief Bounded LRU cache of projected Nodes keyed by entity ordinal
+ *
+ * Each entry remembers the LSN of the newest reference it reflects. A
+ * lookup passes the entity's current newest LSN: equal entries are hits,
+ * older ones are brought up to date in place by the caller-supplied patch
+ * (only the newer references are applied), so appends never need to
+ * reach the cache.
+ *
+ * Entries are spread over independently locked shards, each with its own
+ * LRU list and an equal share of the memory budget, so concurrent readers
+ * of different entities rarely contend. Nodes larger than a shard's share
+ * are not cached.
+ */
+class NodeCache {
+public:
+    /**
+     * @param budget_bytes Approximate upper bound on cached Node memory
+     */
+    explicit NodeCache(size_t budget_bytes);
+
+    NodeCache(const NodeCache&) = delete;
+    NodeCache& operator=(const NodeCache&) = delete;
+
+    /**
+     * @brief Copy of the cached Node for an ordinal, patched up to latest_lsn
+     *
+     * @param patch Called as patch(node, from_lsn) under the shard lock when
+     *              the entry is older than latest_lsn; must apply every
+     *              reference newer than from_lsn
+     * @return Node, or nullopt on a miss
+     */
+    template<typename Patch>
+    std::optional<Node> find(uint32_t ordinal, uint64_t latest_lsn, Patch&& patch);
+
+    /**
+     * @brief Cache a Node reflecting the references up to lsn
+     *
+     * Replaces an existing entry unless it reflects the same LSN.
+     */
+    void insert(uint32_t ordinal, uint64_t lsn, const Node& node);
+
+    /**
+     * @brief Drop all entries (counters are kept)
+     */
+    void clear();
+
+    [[nodiscard]] NodeCacheStats stats() const;
+
+private:
+    static constexpr size_t kShards = 16;
+
+    struct Entry {
+        Node node;
+        uint64_t lsn;
+        size_t bytes;
+        std::list<uint32_t>::iterator position;   // In Shard::lru
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<uint32_t, Entry> entries;
+        std::list<uint32_t> lru;                  // Most recently used first
+        size_t bytes = 0;
+    };
+
+    Shard& shard_of(uint32_t ordinal) noexcept { return m_shards[ordinal % kShards]; }
+
+    /**
+     * @brief Account a resized entry and evict from the cold end (lock held)
+     */
+    void resize(Shard& shard, Entry& entry, size_t bytes);
+    void evict(Shard& shard);
+
+    size_t m_budget_bytes;
+    size_t m_shard_budget;
+    std::array<Shard, kShards> m_shards;
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_patches{0};
+    std::atomic<uint64_t> m_misses{0};
+    std::atomic<uint64_t> m_evictions{0};
+};
+
+template<typename Patch>
+std::optional<Node> NodeCache::find(uint32_t ordinal, uint64_t latest_lsn, Patch&& patch) {
+    Shard& shard = shard_of(ordinal);
+    std::lock_guard lock(shard.mutex);
+
+    auto it = shard.entries.find(ordinal);
+    if (it == shard.entries.end() || it->second.lsn > latest_lsn) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    Entry& entry = it->second;
+    shard.lru.splice(shard.lru.begin(), shard.lru, entry.position);
+    if (entry.lsn == latest_lsn) {
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        return entry.node;
+    }
+
+    patch(entry.node, entry.lsn);
+    entry.lsn = latest_lsn;
+    m_patches.fetch_add(1, std::memory_order_relaxed);
+    Node copy = entry.node;
+    resize(shard, entry, entry.node.memory_bytes());  // May evict the entry itself
+    return copy;
+}
+
+} // namespace gtaf::core
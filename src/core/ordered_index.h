@@ -0,0 +1,263 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace gtaf::core {
+
+/**
+ * @brief Sorted (key, row) secondary index with fence pointers
+ *
+ * Answers range, min/max and top-k queries in O(log n + k):
+ * - A main run of entries sorted by (key, row), with one fence key per
+ *   block of FENCE_STRIDE entries so searches touch a small, cache-resident
+ *   fence array before a single block.
+ * - A small sorted delta run absorbing incremental inserts, merged into
+ *   the main run once it grows past a fraction of it.
+ * - Removals from the main run set a tombstone bit instead of shifting
+ *   the array; tombstones are dropped on the next merge.
+ *
+ * Rows are dense entity ordinals. The index does not own values; callers
+ * must remove(old_key, row) before insert(new_key, row) when a row changes.
+ */
+template<typename Key>
+class OrderedIndex {
+public:
+    struct Entry {
+        Key key;
+        uint32_t row;
+
+        bool operator<(const Entry& other) const noexcept {
+            return key < other.key || (key == other.key && row < other.row);
+        }
+        bool operator==(const Entry& other) const noexcept = default;
+    };
+
+    static constexpr size_t FENCE_STRIDE = 64;
+
+    /**
+     * @brief Replace contents with a bulk set of entries (sorted here)
+     */
+    void build(std::vector<Entry> entries) {
+        if (!std::is_sorted(entries.begin(), entries.end())) {
+            std::sort(entries.begin(), entries.end());
+        }
+        m_main = std::move(entries);
+        m_delta.clear();
+        m_dead.assign((m_main.size() + 63) / 64, 0);
+        m_dead_count = 0;
+        rebuild_fences();
+    }
+
+    /**
+     * @brief Add a (key, row) pair
+     */
+    void insert(Key key, uint32_t row) {
+        Entry entry{key, row};
+        m_delta.insert(std::upper_bound(m_delta.begin(), m_delta.end(), entry), entry);
+        if (m_delta.size() > std::max<size_t>(1024, m_main.size() / 16)) {
+            merge();
+        }
+    }
+
+    /**
+     * @brief Remove a (key, row) pair previously inserted
+     *
+     * @return true if the pair was present
+     */
+    bool remove(Key key, uint32_t row) {
+        Entry entry{key, row};
+        auto dit = std::lower_bound(m_delta.begin(), m_delta.end(), entry);
+        if (dit != m_delta.end() && *dit == entry) {
+            m_delta.erase(dit);
+            return true;
+        }
+
+        size_t pos = lower_bound_main(entry);
+        if (pos < m_main.size() && m_main[pos] == entry && !is_dead(pos)) {
+            m_dead[pos >> 6] |= uint64_t{1} << (pos & 63);
+            ++m_dead_count;
+            if (m_dead_count > m_main.size() / 4) {
+                merge();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Number of live entries
+     */
+    [[nodiscard]] size_t size() const noexcept {
+        return m_main.size() - m_dead_count + m_delta.size();
+    }
+
+    /**
+     * @brief Invoke fn(row, key) for every live entry with low <= key <= high
+     *
+     * Entries from the main run are visited in key order, followed by
+     * entries from the delta run in key order.
+     */
+    template<typename Fn>
+    void for_each_in_range(Key low, Key high, Fn&& fn) const {
+        if (high < low) {
+            return;
+        }
+        size_t pos = lower_bound_key(low);
+        for (; pos < m_main.size() && !(high < m_main[pos].key); ++pos) {
+            if (!is_dead(pos)) {
+                fn(m_main[pos].row, m_main[pos].key);
+            }
+        }
+        auto it = std::lower_bound(m_delta.begin(), m_delta.end(), low,
+            [](const Entry& e, Key k) { return e.key < k; });
+        for (; it != m_delta.end() && !(high < it->key); ++it) {
+            fn(it->row, it->key);
+        }
+    }
+
+    /**
+     * @brief Count live entries with low <= key <= high
+     */
+    [[nodiscard]] size_t count_in_range(Key low, Key high) const {
+        size_t count = 0;
+        for_each_in_range(low, high, [&](uint32_t, Key) { ++count; });
+        return count;
+    }
+
+    /**
+     * @brief Smallest live entry, if any
+     */
+    [[nodiscard]] std::optional<Entry> min() const {
+        std::optional<Entry> result;
+        visit_ordered(false, [&](const Entry& e) { result = e; return false; });
+        return result;
+    }
+
+    /**
+     * @brief Largest live entry, if any
+     */
+    [[nodiscard]] std::optional<Entry> max() const {
+        std::optional<Entry> result;
+        visit_ordered(true, [&](const Entry& e) { result = e; return false; });
+        return result;
+    }
+
+    /**
+     * @brief The k smallest (or largest) live entries, in order
+     */
+    [[nodiscard]] std::vector<Entry> top_k(size_t k, bool largest) const {
+        std::vector<Entry> result;
+        if (k == 0) {
+            return result;
+        }
+        result.reserve(std::min(k, size()));
+        visit_ordered(largest, [&](const Entry& e) {
+            result.push_back(e);
+            return result.size() < k;
+        });
+        return result;
+    }
+
+    /**
+     * @brief Fold the delta run and tombstones into a fresh main run
+     */
+    void merge() {
+        std::vector<Entry> merged;
+        merged.reserve(size());
+        size_t i = 0;
+        auto d = m_delta.begin();
+        while (i < m_main.size() || d != m_delta.end()) {
+            if (i < m_main.size() && is_dead(i)) {
+                ++i;
+                continue;
+            }
+            if (d == m_delta.end() || (i < m_main.size() && m_main[i] < *d)) {
+                merged.push_back(m_main[i++]);
+            } else {
+                merged.push_back(*d++);
+            }
+        }
+        m_main = std::move(merged);
+        m_delta.clear();
+        m_dead.assign((m_main.size() + 63) / 64, 0);
+        m_dead_count = 0;
+        rebuild_fences();
+    }
+
+    /**
+     * @brief Approximate heap footprint in bytes
+     */
+    [[nodiscard]] size_t memory_bytes() const noexcept {
+        return (m_main.capacity() + m_delta.capacity()) * sizeof(Entry)
+             + m_fences.capacity() * sizeof(Key)
+             + m_dead.capacity() * sizeof(uint64_t);
+    }
+
+private:
+    [[nodiscard]] bool is_dead(size_t pos) const noexcept {
+        return (m_dead[pos >> 6] >> (pos & 63)) & 1u;
+    }
+
+    void rebuild_fences() {
+        m_fences.clear();
+        m_fences.reserve(m_main.size() / FENCE_STRIDE + 1);
+        for (size_t i = 0; i < m_main.size(); i += FENCE_STRIDE) {
+            m_fences.push_back(m_main[i].key);
+        }
+    }
+
+    // First main position whose key is >= key, searching fences first
+    [[nodiscard]] size_t lower_bound_key(Key key) const {
+        auto fence = std::lower_bound(m_fences.begin(), m_fences.end(), key);
+        size_t block = static_cast<size_t>(fence - m_fences.begin());
+        // Equal keys may start in the previous block
+        size_t begin = block == 0 ? 0 : (block - 1) * FENCE_STRIDE;
+        size_t end = std::min(m_main.size(), block * FENCE_STRIDE + 1);
+        auto it = std::lower_bound(m_main.begin() + begin, m_main.begin() + end, key,
+            [](const Entry& e, Key k) { return e.key < k; });
+        return static_cast<size_t>(it - m_main.begin());
+    }
+
+    [[nodiscard]] size_t lower_bound_main(const Entry& entry) const {
+        size_t pos = lower_bound_key(entry.key);
+        auto it = std::lower_bound(m_main.begin() + pos, m_main.end(), entry);
+        return static_cast<size_t>(it - m_main.begin());
+    }
+
+    // Visit live entries in ascending (or descending) order until fn returns false
+    template<typename Fn>
+    void visit_ordered(bool descending, Fn&& fn) const {
+        if (!descending) {
+            size_t i = 0;
+            size_t d = 0;
+            while (i < m_main.size() || d < m_delta.size()) {
+                if (i < m_main.size() && is_dead(i)) { ++i; continue; }
+                const Entry& e = (d == m_delta.size() || (i < m_main.size() && m_main[i] < m_delta[d]))
+                    ? m_main[i++] : m_delta[d++];
+                if (!fn(e)) return;
+            }
+        } else {
+            size_t i = m_main.size();
+            size_t d = m_delta.size();
+            while (i > 0 || d > 0) {
+                if (i > 0 && is_dead(i - 1)) { --i; continue; }
+                const Entry& e = (d == 0 || (i > 0 && m_delta[d - 1] < m_main[i - 1]))
+                    ? m_main[--i] : m_delta[--d];
+                if (!fn(e)) return;
+            }
+        }
+    }
+
+    std::vector<Entry> m_main;        // Sorted by (key, row)
+    std::vector<Key> m_fences;        // m_main[i * FENCE_STRIDE].key
+    std::vector<uint64_t> m_dead;     // Tombstone bit per main entry
+    size_t m_dead_count = 0;
+    std::vector<Entry> m_delta;       // Sorted recent inserts
+};
+
+} // namespace gtaf::core
@@ -3,6 +3,14 @@
 #include <stdexcept>
 #include <iostream>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GTAF_HAVE_MMAP 1
+#endif
+
 namespace gtaf::core {
 
 // ---- BinaryWriter Implementation ----
@@ -128,7 +136,18 @@ void BinaryReader::refill_buffer() {
 void BinaryReader::ensure_available(size_t bytes) {
     if (m_buffer_pos + bytes > m_buffer_end) {
         refill_buffer();
+        if (m_buffer_pos + bytes > m_buffer_end) {
+            throw std::runtime_error("Unexpected end of file");
+        }
+    }
+}
+
+bool BinaryReader::at_end() {
+    if (m_buffer_pos < m_buffer_end) {
+        return false;
     }
+    refill_buffer();
+    return m_buffer_pos >= m_buffer_end;
 }
 
 uint8_t BinaryReader::read_u8() {
@@ -237,4 +256,138 @@ types::Timestamp BinaryReader::read_timestamp() {
     return read_u64();
 }
 
+// ---- MappedFile Implementation ----
+
+MappedFile::MappedFile(const std::string& filepath) {
+#ifdef GTAF_HAVE_MMAP
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file for reading: " + filepath);
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            ::madvise(addr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+            m_data = static_cast<const uint8_t*>(addr);
+            m_size = static_cast<size_t>(st.st_size);
+            m_mapped = true;
+        }
+    }
+    ::close(fd);
+    if (m_mapped) {
+        return;
+    }
+#endif
+    // Portable fallback: read the whole file once
+    std::ifstream stream(filepath, std::ios::binary | std::ios::ate);
+    if (!stream) {
+        throw std::runtime_error("Failed to open file for reading: " + filepath);
+    }
+    auto length = static_cast<size_t>(stream.tellg());
+    stream.seekg(0);
+    m_fallback.resize(length);
+    if (length > 0 && !stream.read(reinterpret_cast<char*>(m_fallback.data()), static_cast<std::streamsize>(length))) {
+        throw std::runtime_error("Failed to read file: " + filepath);
+    }
+    m_data = m_fallback.data();
+    m_size = length;
+}
+
+MappedFile::~MappedFile() {
+#ifdef GTAF_HAVE_MMAP
+    if (m_mapped) {
+        ::munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+#endif
+}
+
+// ---- MemoryReader Implementation ----
+
+MemoryReader::MemoryReader(const uint8_t* data, size_t size)
+    : m_data(data), m_size(size) {}
+
+void MemoryReader::require(size_t bytes) const {
+    if (bytes > m_size - m_pos) {
+        throw std::runtime_error("Unexpected end of data");
+    }
+}
+
+uint8_t MemoryReader::read_u8() {
+    require(1);
+    return m_data[m_pos++];
+}
+
+uint32_t MemoryReader::read_u32() {
+    uint32_t value;
+    read_bytes(&value, sizeof(value));
+    return value;
+}
+
+uint64_t MemoryReader::read_u64() {
+    uint64_t value;
+    read_bytes(&value, sizeof(value));
+    return value;
+}
+
+void MemoryReader::read_bytes(void* data, size_t size) {
+    require(size);
+    if (size > 0) {
+        std::memcpy(data, m_data + m_pos, size);
+        m_pos += size;
+    }
+}
+
+std::string MemoryReader::read_string() {
+    uint32_t length = read_u32();
+    require(length);
+    std::string result(reinterpret_cast<const char*>(m_data + m_pos), length);
+    m_pos += length;
+    return result;
+}
+
+types::EntityId MemoryReader::read_entity_id() {
+    types::EntityId id;
+    read_bytes(id.bytes.data(), id.bytes.size());
+    return id;
+}
+
+types::AtomValue MemoryReader::read_atom_value() {
+    uint8_t index = read_u8();
+
+    switch (index) {
+        case 0: // monostate
+            return std::monostate{};
+        case 1: // bool
+            return read_u8() != 0;
+        case 2: // int64_t
+            return static_cast<int64_t>(read_u64());
+        case 3: { // double
+            double value;
+            read_bytes(&value, sizeof(double));
+            return value;
+        }
+        case 4: // string
+            return read_string();
+        case 5: { // vector<float>
+            std::vector<float> vec;
+            read_array(vec, read_u32());
+            return vec;
+        }
+        case 6: { // vector<uint8_t>
+            std::vector<uint8_t> vec;
+            read_array(vec, read_u32());
+            return vec;
+        }
+        case 7: { // EdgeValue
+            types::EdgeValue edge;
+            edge.target = read_entity_id();
+            edge.relation = read_string();
+            return edge;
+        }
+        default:
+            throw std::runtime_error("Unknown variant index in atom value");
+    }
+}
+
 } // namespace gtaf::core
@@ -3,6 +3,7 @@
 #include "../types/types.h"
 #include "atom.h"
 #include <fstream>
+#include <stdexcept>
 #include <vector>
 #include <string>
 
@@ -38,6 +39,13 @@ public:
 
     bool is_open() const { return m_stream.is_open(); }
 
+    /**
+     * @brief Flush buffered data
+     *
+     * @return false if any write so far failed
+     */
+    bool flush() { return static_cast<bool>(m_stream.flush()); }
+
 private:
     std::ofstream m_stream;
 };
@@ -69,6 +77,13 @@ public:
     bool is_open() const { return m_stream.is_open(); }
     bool eof() const { return m_stream.eof(); }
 
+    /**
+     * @brief Check whether every byte of the file has been consumed
+     *
+     * Unlike eof(), accounts for data still buffered (and refills if needed).
+     */
+    bool at_end();
+
 private:
     void refill_buffer();
     void ensure_available(size_t bytes);
@@ -82,4 +97,73 @@ private:
     size_t m_buffer_end = 0;
 };
 
+/**
+ * @brief Read-only view of a whole file, memory-mapped where supported
+ *
+ * Uses mmap on POSIX systems so large files are paged in on demand and
+ * never copied through a stream buffer. Elsewhere (or if mapping fails)
+ * the file is read into memory once.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filepath);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool is_mapped() const { return m_mapped; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_mapped = false;
+    std::vector<uint8_t> m_fallback;  // Owns the bytes when not mapped
+};
+
+/**
+ * @brief Bounds-checked deserialization from an in-memory byte range
+ *
+ * Mirrors BinaryReader for data that is already in memory (e.g. a
+ * MappedFile). Throws std::runtime_error when reading past the end.
+ */
+class MemoryReader {
+public:
+    MemoryReader(const uint8_t* data, size_t size);
+
+    // Primitive types
+    uint8_t read_u8();
+    uint32_t read_u32();
+    uint64_t read_u64();
+    void read_bytes(void* data, size_t size);
+
+    // GTAF types
+    std::string read_string();
+    types::EntityId read_entity_id();
+    types::AtomValue read_atom_value();
+
+    /**
+     * @brief Bulk-read count trivially copyable elements into a vector
+     */
+    template<typename T>
+    void read_array(std::vector<T>& out, size_t count) {
+        if (count > remaining() / sizeof(T)) {
+            throw std::runtime_error("Unexpected end of data");
+        }
+        out.resize(count);
+        read_bytes(out.data(), count * sizeof(T));
+    }
+
+    size_t remaining() const { return m_size - m_pos; }
+
+private:
+    void require(size_t bytes) const;
+
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_pos = 0;
+};
+
 } // namespace gtaf::core
@@ -1,27 +1,138 @@
 #include "projection_engine.h"
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <system_error>
+#include <thread>
 #include <unordered_set>
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
 namespace gtaf::core {
 
+namespace {
+
+// Atoms applied ahead of the one being prefetched
+constexpr size_t kPrefetchDistance = 8;
+
+inline void prefetch(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    (void)address;
+#endif
+}
+
+} // namespace
+
 // ---- ProjectionEngine Implementation ----
 
 ProjectionEngine::ProjectionEngine(const AtomStore& store)
     : m_store(store) {}
 
 Node ProjectionEngine::rebuild(types::EntityId entity) const {
-    Node node(entity);
+    if (auto ordinal = m_store.find_ordinal(entity)) {
+        return rebuild_at(*ordinal);
+    }
+    return Node(entity, true);  // No atoms for this entity
+}
+
+Node ProjectionEngine::rebuild(types::EntityId entity, types::LogSequenceNumber as_of) const {
+    if (auto ordinal = m_store.find_ordinal(entity)) {
+        return rebuild_at(*ordinal, as_of);
+    }
+    return Node(entity, true);
+}
+
+Node ProjectionEngine::rebuild_at(uint32_t ordinal, types::LogSequenceNumber as_of) const {
+    // The current state may be served from the cache
+    if (!as_of.is_valid() || as_of >= m_store.current_lsn()) {
+        return rebuild_at(ordinal);
+    }
+    return project_at(ordinal, true, as_of);
+}
+
+std::span<const AtomReference> ProjectionEngine::refs_as_of(uint32_t ordinal, types::LogSequenceNumber as_of) const {
+    const auto& refs = m_store.get_entity_atoms_at(ordinal);
+    if (!as_of.is_valid() || refs.empty() || refs.back().lsn <= as_of) {
+        return refs;
+    }
+    auto end = std::upper_bound(refs.begin(), refs.end(), as_of,
+                                [](types::LogSequenceNumber lsn, const AtomReference& ref) { return lsn < ref.lsn; });
+    return {refs.data(), static_cast<size_t>(end - refs.begin())};
+}
+
+TagId ProjectionEngine::tag_of(const Atom& atom) const {
+    if (auto id = m_store.find_tag(atom.type_tag())) {
+        return *id;
+    }
+    return TagDictionary::global().intern(atom.type_tag());   // Not reached for stored atoms
+}
 
-    // Get all atom references for this entity (already sorted by LSN)
-    const auto* refs = m_store.get_entity_atoms(entity);
-    if (!refs) {
-        return node;  // No atoms for this entity
+Node ProjectionEngine::rebuild_at(uint32_t ordinal) const {
+    if (!m_cache) {
+        return project_at(ordinal, true);
     }
 
-    // Apply each atom in chronological order
-    for (const auto& ref : *refs) {
-        const Atom* atom = m_store.get_atom(ref.atom_id);
+    // After load() an ordinal may name another entity; after compact() cached
+    // entries would still hold the references it trimmed
+    uint64_t filled = m_cache_layout.load(std::memory_order_acquire);
+    const uint64_t layout = m_store.layout_version();
+    if (filled != layout && m_cache_layout.compare_exchange_strong(filled, layout)) {
+        m_cache->clear();
+    }
+
+    const auto& refs = m_store.get_entity_atoms_at(ordinal);
+    const uint64_t latest = refs.empty() ? 0 : refs.back().lsn.value;
+
+    // Refs are appended in LSN order (a mutable snapshot follows its mutation),
+    // so a stale entry only needs the tail after it, each ref at its own version
+    auto cached = m_cache->find(ordinal, latest, [&](Node& node, uint64_t from) {
+        auto it = std::upper_bound(refs.begin(), refs.end(), from,
+                                   [](uint64_t lsn, const AtomReference& ref) { return lsn < ref.lsn.value; });
+        for (; it != refs.end(); ++it) {
+            if (const Atom* atom = m_store.get_atom(*it)) {
+                node.apply(atom->atom_id(), tag_of(*atom), atom->value(), it->lsn);
+            }
+        }
+    });
+    if (cached) {
+        return std::move(*cached);
+    }
+
+    Node node = project_at(ordinal, true);
+    m_cache->insert(ordinal, latest, node);
+    return node;
+}
+
+void ProjectionEngine::enable_cache(size_t budget_bytes) {
+    m_cache = std::make_unique<NodeCache>(budget_bytes);
+    m_cache_layout.store(m_store.layout_version(), std::memory_order_release);
+}
+
+void ProjectionEngine::disable_cache() {
+    m_cache.reset();
+}
+
+NodeCacheStats ProjectionEngine::cache_stats() const {
+    return m_cache ? m_cache->stats() : NodeCacheStats{};
+}
+
+Node ProjectionEngine::project_at(uint32_t ordinal, bool with_history, types::LogSequenceNumber as_of) const {
+    Node node(m_store.entity_at(ordinal), with_history);
+
+    // Apply each atom in chronological order (per-entity refs are appended in
+    // LSN order); mutable atoms resolve to the version each ref recorded
+    for (const auto& ref : refs_as_of(ordinal, as_of)) {
+        const Atom* atom = m_store.get_atom(ref);
         if (atom) {
-            node.apply(atom->atom_id(), atom->type_tag(), atom->value(), ref.lsn);
+            node.apply(atom->atom_id(), tag_of(*atom), atom->value(), ref.lsn);
         }
     }
 
@@ -32,20 +143,223 @@ std::vector<types::EntityId> ProjectionEngine::get_all_entities() const {
     return m_store.get_all_entities();
 }
 
-std::unordered_map<types::EntityId, Node, EntityIdHash> ProjectionEngine::rebuild_all() const {
+std::unordered_map<types::EntityId, Node, EntityIdHash> ProjectionEngine::rebuild_all(bool with_history) const {
     std::unordered_map<types::EntityId, Node, EntityIdHash> nodes;
 
-    // Get all entities from the reference layer
-    auto entities = m_store.get_all_entities();
+    const size_t count = m_store.entity_count();
+    nodes.reserve(count);
 
-    // Rebuild each entity
-    for (const auto& entity : entities) {
-        nodes.emplace(entity, rebuild(entity));
+    // Rebuild each entity by ordinal
+    for (uint32_t ordinal = 0; ordinal < count; ++ordinal) {
+        nodes.emplace(m_store.entity_at(ordinal), project_at(ordinal, with_history));
     }
 
     return nodes;
 }
 
+ProjectionBatch ProjectionEngine::build_batch(uint32_t first, uint32_t last, const StreamingOptions& options) const {
+    ProjectionBatch batch;
+    batch.first_ordinal = first;
+    batch.nodes.reserve(last - first);
+    if (!options.prefetch) {
+        for (uint32_t ordinal = first; ordinal < last; ++ordinal) {
+            batch.nodes.push_back(project_at(ordinal, options.with_history, options.as_of));
+        }
+        return batch;
+    }
+
+    // Resolve every atom of the batch first: the content-index probes are
+    // independent, so their cache misses overlap instead of serializing
+    std::vector<const Atom*> atoms;
+    for (uint32_t ordinal = first; ordinal < last; ++ordinal) {
+        for (const auto& ref : refs_as_of(ordinal, options.as_of)) {
+            atoms.push_back(m_store.get_atom(ref));
+        }
+    }
+
+    // Tags resolve through the store's map, keeping workers off the shared dictionary lock
+    size_t next = 0;
+    for (uint32_t ordinal = first; ordinal < last; ++ordinal) {
+        Node& node = batch.nodes.emplace_back(m_store.entity_at(ordinal), options.with_history);
+        for (const auto& ref : refs_as_of(ordinal, options.as_of)) {
+            if (next + kPrefetchDistance < atoms.size() && atoms[next + kPrefetchDistance]) {
+                prefetch(atoms[next + kPrefetchDistance]);
+            }
+            const Atom* atom = atoms[next++];
+            if (!atom) continue;
+            node.apply(atom->atom_id(), tag_of(*atom), atom->value(), ref.lsn);
+        }
+    }
+    return batch;
+}
+
+void ProjectionEngine::rebuild_all_batches(const std::function<void(ProjectionBatch&)>& callback,
+                                           const StreamingOptions& options) const {
+    const size_t count = m_store.entity_count();
+    const size_t batch_size = std::max<size_t>(1, options.batch_size);
+    const size_t batches = (count + batch_size - 1) / batch_size;
+    auto bounds = [&](size_t index) {
+        const size_t begin = index * batch_size;
+        return std::pair<uint32_t, uint32_t>(static_cast<uint32_t>(begin),
+                                             static_cast<uint32_t>(std::min(count, begin + batch_size)));
+    };
+
+    const size_t threads = options.threads > 0
+        ? options.threads : std::max<size_t>(1, std::thread::hardware_concurrency());
+    const size_t workers = std::min(threads, batches);
+    if (workers <= 1) {
+        for (size_t index = 0; index < batches; ++index) {
+            auto [first, last] = bounds(index);
+            ProjectionBatch batch = build_batch(first, last, options);
+            callback(batch);
+        }
+        return;
+    }
+
+    const size_t max_in_flight = options.max_in_flight > 0 ? options.max_in_flight : 2 * workers;
+
+    // Workers claim batches in order; the calling thread delivers them
+    std::mutex mutex;
+    std::condition_variable built;          // A batch is ready or a worker failed
+    std::condition_variable consumed;       // A batch was delivered or the stream stopped
+    std::map<size_t, ProjectionBatch> ready;
+    size_t claimed = 0;
+    size_t delivered = 0;
+    bool stop = false;
+    std::exception_ptr error;
+
+    auto work = [&] {
+        for (;;) {
+            size_t index;
+            {
+                std::unique_lock lock(mutex);
+                consumed.wait(lock, [&] { return stop || claimed == batches || claimed - delivered < max_in_flight; });
+                if (stop || claimed == batches) return;
+                index = claimed++;
+            }
+            try {
+                auto [first, last] = bounds(index);
+                ProjectionBatch batch = build_batch(first, last, options);
+                std::lock_guard lock(mutex);
+                ready.emplace(index, std::move(batch));
+            } catch (...) {
+                std::lock_guard lock(mutex);
+                if (!error) error = std::current_exception();
+                stop = true;
+                consumed.notify_all();
+            }
+            built.notify_one();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers);
+    for (size_t worker = 0; worker < workers; ++worker) {
+        try {
+            pool.emplace_back(work);
+        } catch (const std::system_error&) {
+            break;  // Fewer threads
+        }
+    }
+    auto finish = [&] {
+        {
+            std::lock_guard lock(mutex);
+            stop = true;
+        }
+        consumed.notify_all();
+        for (auto& thread : pool) thread.join();
+    };
+
+    if (pool.empty()) {
+        for (size_t index = 0; index < batches; ++index) {
+            auto [first, last] = bounds(index);
+            ProjectionBatch batch = build_batch(first, last, options);
+            callback(batch);
+        }
+        return;
+    }
+
+    try {
+        for (size_t next = 0; next < batches; ++next) {
+            ProjectionBatch batch;
+            {
+                std::unique_lock lock(mutex);
+                built.wait(lock, [&] {
+                    return error || (options.ordered ? ready.count(next) > 0 : !ready.empty());
+                });
+                if (error) break;
+                auto it = options.ordered ? ready.find(next) : ready.begin();
+                batch = std::move(it->second);
+                ready.erase(it);
+            }
+            callback(batch);
+            {
+                std::lock_guard lock(mutex);
+                ++delivered;
+            }
+            consumed.notify_one();
+        }
+    } catch (...) {
+        finish();
+        throw;
+    }
+    finish();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+ColumnarProjection ProjectionEngine::project_columns(const std::vector<ColumnSpec>& specs) const {
+    ColumnarProjection projection;
+    projection.m_rows = m_store.entity_count();
+    projection.m_lsn = m_store.current_lsn().value;
+
+    // Tag -> column slot, so each reference costs one lookup
+    std::unordered_map<std::string, size_t> slot_of;
+    slot_of.reserve(specs.size());
+    for (const auto& spec : specs) {
+        if (slot_of.emplace(spec.tag, projection.m_columns.size()).second) {
+            projection.m_tags.push_back(spec.tag);
+            projection.m_columns.emplace_back(spec.type);
+            projection.m_columns.back().resize(projection.m_rows);
+        }
+    }
+    if (projection.m_columns.empty()) {
+        return projection;
+    }
+
+    // Latest value per slot for the current entity, referenced in place
+    std::vector<const types::AtomValue*> latest(projection.m_columns.size());
+
+    for (uint32_t ordinal = 0; ordinal < projection.m_rows; ++ordinal) {
+        std::fill(latest.begin(), latest.end(), nullptr);
+
+        // Refs are in LSN order, so the last match per tag is the latest value
+        for (const auto& ref : m_store.get_entity_atoms_at(ordinal)) {
+            const Atom* atom = m_store.get_atom(ref.atom_id);
+            if (!atom) continue;
+            auto it = slot_of.find(atom->type_tag());
+            if (it != slot_of.end()) {
+                latest[it->second] = &atom->value();
+            }
+        }
+
+        for (size_t i = 0; i < latest.size(); ++i) {
+            if (!latest[i]) continue;
+            if (auto* edge = std::get_if<types::EdgeValue>(latest[i])) {
+                // Edges project as the target's ordinal; unknown targets stay null
+                if (auto target = m_store.find_ordinal(edge->target)) {
+                    projection.m_columns[i].set_edge(ordinal, *target);
+                }
+            } else {
+                projection.m_columns[i].set(ordinal, *latest[i]);
+            }
+        }
+    }
+
+    return projection;
+}
+
 // Template implementation must be in header or explicitly instantiated
 // For now, we'll move this to the header as an inline definition
 
@@ -1,20 +1,62 @@
 // projection_engine.h
 #pragma once
 #include "atom_store.h"
+#include "columnar_projection.h"
 #include "node.h"
+#include "node_cache.h"
+#include <atomic>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 #include <cstring>
+#include <functional>
+#include <span>
 
 namespace gtaf::core {
 
 // EntityIdHash is now defined in atom_store.h
 
+/**
+ * @brief Nodes of consecutive entity ordinals, as delivered by rebuild_all_batches()
+ */
+struct ProjectionBatch {
+    uint32_t first_ordinal = 0;
+    std::vector<Node> nodes;            // nodes[i] projects ordinal first_ordinal + i
+};
+
+/**
+ * @brief Tuning of rebuild_all_streaming() and rebuild_all_batches()
+ */
+struct StreamingOptions {
+    size_t batch_size = 1000;           // Entities per batch
+    size_t threads = 0;                 // Builder threads (0: hardware concurrency, 1: calling thread)
+    size_t max_in_flight = 0;           // Batches built but not yet delivered (0: 2 per thread)
+    bool ordered = true;                // Deliver batches in ordinal order
+    bool prefetch = true;               // Resolve a batch's atoms up front and prefetch ahead
+    bool with_history = false;          // Record each Node's history()
+    types::LogSequenceNumber as_of{};   // Project as of this LSN (invalid: latest)
+};
+
 /**
  * @brief Engine for rebuilding Node projections from the atom store
  *
  * The ProjectionEngine iterates through the store and reconstructs
  * entity state by filtering and applying relevant atoms.
+ *
+ * With enable_cache(), rebuild() and rebuild_at() serve repeated requests
+ * for the same entity from a bounded NodeCache, applying only references
+ * appended since the cached projection. Full scans (rebuild_all(),
+ * rebuild_all_streaming()) bypass the cache so they cannot flush it.
+ * Cached lookups may run concurrently on reader threads, as long as no
+ * thread appends to the store meanwhile; readers should resolve tags with
+ * find_tag() and read Nodes through Node::get(TagId).
+ *
+ * Example:
+ *   auto status = projector.find_tag("user.status");
+ *   for (uint32_t ordinal : ordinals) {
+ *       Node node = projector.rebuild_at(ordinal);
+ *       if (auto value = status ? node.get(*status) : std::nullopt) { ... }
+ *   }
  */
 class ProjectionEngine {
 public:
@@ -25,17 +67,86 @@ public:
      */
     explicit ProjectionEngine(const AtomStore& store);
 
+    /**
+     * @brief The store this engine projects from
+     */
+    const AtomStore& store() const noexcept { return m_store; }
+
+    /**
+     * @brief TagId of a tag for Node::get(TagId), from the store's own map
+     *
+     * Resolve once per tag, not per Node: the string Node accessors look
+     * the tag up in TagDictionary::global() under its shared lock.
+     *
+     * @return TagId, or nullopt if no atom in the store has the tag
+     */
+    [[nodiscard]] std::optional<TagId> find_tag(const std::string& tag) const { return m_store.find_tag(tag); }
+
     /**
      * @brief Rebuild a Node projection for a specific entity
      *
      * Scans the entire log, filters atoms by entity_id, and applies them
-     * in sequence to build the current state.
+     * in sequence to build the current state. The Node records history().
      *
      * @param entity The entity to rebuild
      * @return Fully reconstructed Node
      */
     Node rebuild(types::EntityId entity) const;
 
+    /**
+     * @brief Rebuild an entity as it was after the reference at as_of
+     *
+     * Applies only the references with LSN <= as_of, found by binary
+     * search over the entity's LSN-sorted references, so a historical
+     * projection costs the same as a current one. The Node records
+     * history() up to as_of. An invalid or current as_of is rebuild().
+     */
+    Node rebuild(types::EntityId entity, types::LogSequenceNumber as_of) const;
+
+    /**
+     * @brief Rebuild a Node projection by dense entity ordinal
+     *
+     * Skips the EntityId hash lookup; see AtomStore::find_ordinal().
+     *
+     * @param ordinal Ordinal below AtomStore::entity_count()
+     */
+    Node rebuild_at(uint32_t ordinal) const;
+    Node rebuild_at(uint32_t ordinal, types::LogSequenceNumber as_of) const;
+
+    /**
+     * @brief Project an entity by ordinal straight from the log
+     *
+     * Bypasses the cache and, by default, skips history(); this is the
+     * compact form used by full scans.
+     *
+     * @param as_of Apply only references with LSN <= as_of (invalid: all)
+     */
+    Node project_at(uint32_t ordinal, bool with_history = false, types::LogSequenceNumber as_of = {}) const;
+
+    /**
+     * @brief Cache projected Nodes for rebuild() and rebuild_at()
+     *
+     * Replaces any previous cache (and its counters). Not thread-safe
+     * with respect to concurrent rebuilds. Entries are dropped when the
+     * store's layout_version() changes: load() reassigns ordinals, and
+     * compact() moves atoms and trims references.
+     *
+     * @param budget_bytes Approximate memory bound for cached Nodes
+     */
+    void enable_cache(size_t budget_bytes);
+
+    /**
+     * @brief Drop the cache; later rebuilds always read the log
+     */
+    void disable_cache();
+
+    [[nodiscard]] bool cache_enabled() const noexcept { return m_cache != nullptr; }
+
+    /**
+     * @brief Cache counters (all zero when the cache is disabled)
+     */
+    [[nodiscard]] NodeCacheStats cache_stats() const;
+
     /**
      * @brief Get all unique entity IDs present in the log
      *
@@ -51,19 +162,21 @@ public:
      * Efficiently builds a complete projection by scanning the log once
      * and distributing atoms to their respective nodes.
      *
+     * @param with_history Record each Node's history() (off: latest values only)
      * @return Map of entity_id -> Node for all entities
      */
-    std::unordered_map<types::EntityId, Node, EntityIdHash> rebuild_all() const;
+    std::unordered_map<types::EntityId, Node, EntityIdHash> rebuild_all(bool with_history = false) const;
 
     /**
      * @brief Stream-process all nodes with a callback function
      *
-     * Efficiently builds nodes in batches and processes them via callback,
-     * keeping memory usage bounded. This combines the performance of rebuild_all
-     * (single pass through atom log) with the memory efficiency of on-demand rebuilding.
+     * Builds nodes in batches and processes them via callback, keeping
+     * memory usage bounded. See rebuild_all_batches() for how batches are
+     * built; the callback always runs on the calling thread.
      *
      * @param callback Function called for each (entity_id, node) pair
      * @param batch_size Number of nodes to build before invoking callbacks (default: 1000)
+     * @param with_history Record each Node's history() (off: latest values only)
      *
      * Example:
      *   projector.rebuild_all_streaming([&](const EntityId& id, const Node& node) {
@@ -72,36 +185,92 @@ public:
      *   });
      */
     template<typename Callback>
-    void rebuild_all_streaming(Callback callback, size_t batch_size = 1000) const;
+    void rebuild_all_streaming(Callback callback, size_t batch_size = 1000, bool with_history = false) const;
+
+    template<typename Callback>
+    void rebuild_all_streaming(Callback callback, const StreamingOptions& options) const;
+
+    /**
+     * @brief Stream every entity as it was at as_of (see rebuild(entity, as_of))
+     *
+     * Entities without references up to as_of are delivered as empty Nodes.
+     */
+    template<typename Callback>
+    void rebuild_all_streaming(Callback callback, types::LogSequenceNumber as_of) const;
+
+    /**
+     * @brief Build every Node in batches on a worker pool, delivering whole batches
+     *
+     * Worker threads claim batches of consecutive ordinals and build them
+     * while the calling thread consumes finished ones, so the next batches
+     * are already projected by the time the callback returns. At most
+     * StreamingOptions::max_in_flight batches exist at once; workers wait
+     * for the consumer beyond that. Unordered delivery hands over whichever
+     * batch is ready first.
+     *
+     * The callback runs on the calling thread and may move Nodes out of the
+     * batch. An exception from it or from a worker stops the stream and is
+     * rethrown here. The store must not be appended to meanwhile.
+     */
+    void rebuild_all_batches(const std::function<void(ProjectionBatch&)>& callback,
+                             const StreamingOptions& options = {}) const;
+
+    /**
+     * @brief Project the latest value of each tag into ordinal-aligned columns
+     *
+     * Makes one pass over the reference layer without building Nodes. Use
+     * this instead of rebuild_all() when a query reads a few tags of every
+     * entity.
+     *
+     * @param specs Tags (and column types) to project; duplicates share a column
+     * @return One column per spec, each with AtomStore::entity_count() rows
+     */
+    ColumnarProjection project_columns(const std::vector<ColumnSpec>& specs) const;
 
 private:
+    /**
+     * @brief An entity's references with LSN <= as_of (invalid: all)
+     */
+    std::span<const AtomReference> refs_as_of(uint32_t ordinal, types::LogSequenceNumber as_of) const;
+
+    /**
+     * @brief TagId of an atom's tag from the store's map (no global dictionary lock)
+     */
+    TagId tag_of(const Atom& atom) const;
+
+    /**
+     * @brief Project ordinals [first, last) for rebuild_all_batches()
+     */
+    ProjectionBatch build_batch(uint32_t first, uint32_t last, const StreamingOptions& options) const;
+
     const AtomStore& m_store;
+    std::unique_ptr<NodeCache> m_cache;
+    mutable std::atomic<uint64_t> m_cache_layout{0};   // Store layout_version() the cache was filled under
 };
 
 // Template implementation (must be in header)
 template<typename Callback>
-void ProjectionEngine::rebuild_all_streaming(Callback callback, [[maybe_unused]] size_t batch_size) const {
-    // Get all entities from the reference layer
-    auto entities = m_store.get_all_entities();
-
-    // Process each entity directly - no batching needed since we're streaming
-    for (const auto& entity : entities) {
-        // Build node inline and pass to callback immediately
-        Node node(entity);
-
-        // Get atom references directly (no copy, just pointer)
-        const auto* refs = m_store.get_entity_atoms(entity);
-        if (refs) {
-            for (const auto& ref : *refs) {
-                const Atom* atom = m_store.get_atom(ref.atom_id);
-                if (atom) {
-                    node.apply(atom->atom_id(), atom->type_tag(), atom->value(), ref.lsn);
-                }
-            }
-        }
+void ProjectionEngine::rebuild_all_streaming(Callback callback, types::LogSequenceNumber as_of) const {
+    StreamingOptions options;
+    options.as_of = as_of;
+    rebuild_all_streaming(std::move(callback), options);
+}
 
-        callback(entity, node);
-    }
+template<typename Callback>
+void ProjectionEngine::rebuild_all_streaming(Callback callback, size_t batch_size, bool with_history) const {
+    StreamingOptions options;
+    options.batch_size = batch_size;
+    options.with_history = with_history;
+    rebuild_all_streaming(std::move(callback), options);
+}
+
+template<typename Callback>
+void ProjectionEngine::rebuild_all_streaming(Callback callback, const StreamingOptions& options) const {
+    rebuild_all_batches([&](ProjectionBatch& batch) {
+        for (const Node& node : batch.nodes) {
+            callback(node.entity_id(), node);
+        }
+    }, options);
 }
 
 } // namespace gtaf::core
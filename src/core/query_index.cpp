@@ -1,94 +1,586 @@
 #include "query_index.h"
+#include "persistence.h"
 #include <algorithm>
 #include <cctype>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <limits>
 
 namespace gtaf::core {
 
+namespace {
+
+// QueryIndex file format version (bump on layout changes)
+constexpr uint32_t kIndexFormatVersion = 1;
+
+// Ordered index entries are written as packed (key, row) pairs: no padding bytes
+template<typename Key>
+void write_ordered(BinaryWriter& writer, const OrderedIndex<Key>& order, Key lowest, Key highest) {
+    std::vector<uint8_t> packed;
+    packed.reserve(order.size() * (sizeof(Key) + sizeof(uint32_t)));
+    order.for_each_in_range(lowest, highest, [&](uint32_t row, Key key) {
+        const auto* k = reinterpret_cast<const uint8_t*>(&key);
+        const auto* r = reinterpret_cast<const uint8_t*>(&row);
+        packed.insert(packed.end(), k, k + sizeof(Key));
+        packed.insert(packed.end(), r, r + sizeof(uint32_t));
+    });
+    writer.write_u64(packed.size() / (sizeof(Key) + sizeof(uint32_t)));
+    writer.write_bytes(packed.data(), packed.size());
+}
+
+template<typename Key>
+void read_ordered(MemoryReader& reader, OrderedIndex<Key>& order, size_t rows) {
+    uint64_t count = reader.read_u64();
+    if (count > reader.remaining() / (sizeof(Key) + sizeof(uint32_t))) {
+        throw std::runtime_error("Unexpected end of data");
+    }
+    std::vector<uint8_t> packed;
+    reader.read_array(packed, count * (sizeof(Key) + sizeof(uint32_t)));
+    std::vector<typename OrderedIndex<Key>::Entry> entries(count);
+    const uint8_t* ptr = packed.data();
+    for (auto& entry : entries) {
+        std::memcpy(&entry.key, ptr, sizeof(Key));
+        std::memcpy(&entry.row, ptr + sizeof(Key), sizeof(uint32_t));
+        ptr += sizeof(Key) + sizeof(uint32_t);
+        if (entry.row >= rows) {
+            throw std::runtime_error("Ordered index row out of range");
+        }
+    }
+    order.build(std::move(entries));  // Already sorted: no re-sort
+}
+
+template<typename T>
+bool compare(T lhs, QueryIndex::CompareOp op, T rhs) {
+    switch (op) {
+        case QueryIndex::CompareOp::Eq: return lhs == rhs;
+        case QueryIndex::CompareOp::Ne: return lhs != rhs;
+        case QueryIndex::CompareOp::Lt: return lhs < rhs;
+        case QueryIndex::CompareOp::Le: return lhs <= rhs;
+        case QueryIndex::CompareOp::Gt: return lhs > rhs;
+        case QueryIndex::CompareOp::Ge: return lhs >= rhs;
+    }
+    return false;
+}
+
+// Case-insensitive substring test against an already upper-cased needle (no allocation)
+bool contains_upper(std::string_view haystack, std::string_view upper_needle) {
+    if (upper_needle.size() > haystack.size()) {
+        return false;
+    }
+    auto it = std::search(haystack.begin(), haystack.end(), upper_needle.begin(), upper_needle.end(),
+        [](char a, char b) {
+            return std::toupper(static_cast<unsigned char>(a)) == static_cast<unsigned char>(b);
+        });
+    return it != haystack.end() || upper_needle.empty();
+}
+
+bool is_int_column(const Column& column) {
+    return column.type() == ColumnType::Int64 || column.type() == ColumnType::Timestamp;
+}
+
+// Translate a comparison into an inclusive [low, high] range; false if empty or Ne
+bool int_range_for(QueryIndex::CompareOp op, int64_t value, int64_t& low, int64_t& high) {
+    constexpr int64_t kMin = std::numeric_limits<int64_t>::min();
+    constexpr int64_t kMax = std::numeric_limits<int64_t>::max();
+    switch (op) {
+        case QueryIndex::CompareOp::Eq: low = value; high = value; return true;
+        case QueryIndex::CompareOp::Le: low = kMin; high = value; return true;
+        case QueryIndex::CompareOp::Ge: low = value; high = kMax; return true;
+        case QueryIndex::CompareOp::Lt:
+            if (value == kMin) return false;
+            low = kMin; high = value - 1; return true;
+        case QueryIndex::CompareOp::Gt:
+            if (value == kMax) return false;
+            low = value + 1; high = kMax; return true;
+        case QueryIndex::CompareOp::Ne: return false;
+    }
+    return false;
+}
+
+bool double_range_for(QueryIndex::CompareOp op, double value, double& low, double& high) {
+    constexpr double kInf = std::numeric_limits<double>::infinity();
+    if (std::isnan(value)) {
+        return false;   // Nothing compares true against NaN
+    }
+    switch (op) {
+        case QueryIndex::CompareOp::Eq: low = value; high = value; return true;
+        case QueryIndex::CompareOp::Le: low = -kInf; high = value; return true;
+        case QueryIndex::CompareOp::Ge: low = value; high = kInf; return true;
+        case QueryIndex::CompareOp::Lt:
+            if (value == -kInf) return false;
+            low = -kInf; high = std::nextafter(value, -kInf); return true;
+        case QueryIndex::CompareOp::Gt:
+            if (value == kInf) return false;
+            low = std::nextafter(value, kInf); high = kInf; return true;
+        case QueryIndex::CompareOp::Ne: return false;
+    }
+    return false;
+}
+
+} // namespace
+
 QueryIndex::QueryIndex(const ProjectionEngine& projector)
     : m_projector(&projector), m_store(nullptr) {}
 
 QueryIndex::QueryIndex(const AtomStore& store)
     : m_projector(nullptr), m_store(&store) {}
 
-size_t QueryIndex::build_indexes_direct(const std::vector<std::string>& tags) {
-    if (!m_store || tags.empty()) {
+QueryIndex::~QueryIndex() {
+    unsubscribe();
+}
+
+void QueryIndex::subscribe(AtomStore& store) {
+    unsubscribe();
+    catch_up();
+    m_subscribed_store = &store;
+    m_listener_id = store.add_append_listener(
+        [this](const std::vector<AtomStore::AppendEvent>& events) { apply(events); },
+        [this] { rebuild(); });
+}
+
+void QueryIndex::unsubscribe() {
+    if (m_subscribed_store) {
+        m_subscribed_store->remove_append_listener(m_listener_id);
+        m_subscribed_store = nullptr;
+        m_listener_id = 0;
+    }
+}
+
+const AtomStore* QueryIndex::source_store() const {
+    if (m_store) {
+        return m_store;
+    }
+    return m_projector ? &m_projector->store() : nullptr;
+}
+
+size_t QueryIndex::catch_up() {
+    const AtomStore* store = source_store();
+    if (store && store->current_lsn().value < m_applied_lsn) {
+        return rebuild();   // Reloaded: ordinals and LSNs restarted
+    }
+    if (!store || store->current_lsn().value <= m_applied_lsn) {
+        return 0;
+    }
+
+    // Per-entity references are in LSN order, so only each tail needs walking
+    std::vector<AtomStore::AppendEvent> events;
+    const size_t count = store->entity_count();
+    for (uint32_t ordinal = 0; ordinal < count; ++ordinal) {
+        const auto& refs = store->get_entity_atoms_at(ordinal);
+        for (auto it = refs.rbegin(); it != refs.rend() && it->lsn.value > m_applied_lsn; ++it) {
+            if (const Atom* atom = store->get_atom(*it)) {
+                events.push_back({store->entity_at(ordinal), ordinal, atom, it->lsn});
+            }
+        }
+    }
+    std::sort(events.begin(), events.end(),
+              [](const auto& a, const auto& b) { return a.lsn < b.lsn; });
+
+    size_t applied = apply(events);
+    m_applied_lsn = store->current_lsn().value;
+    return applied;
+}
+
+size_t QueryIndex::rebuild() {
+    std::vector<IndexSpec> specs;
+    specs.reserve(m_tags.size());
+    for (const auto& [tag, index] : m_tags) {
+        specs.push_back({tag, index.type, index.ordered, index.trigram});
+    }
+    if (specs.empty()) {
+        const AtomStore* store = source_store();
+        m_applied_lsn = store ? store->current_lsn().value : 0;
+        return 0;
+    }
+    return build_typed_indexes(specs);
+}
+
+bool QueryIndex::save(const std::string& filepath) const {
+    static_assert(sizeof(types::EntityId) == 16, "entity table is written as raw 16-byte ids");
+    try {
+        BinaryWriter writer(filepath);
+
+        // Write header
+        writer.write_bytes("GTQI", 4);  // Magic
+        writer.write_u32(kIndexFormatVersion);
+        writer.write_u64(m_applied_lsn);
+
+        // Store ordinal table the rows refer to (validated against the store on load)
+        const auto& entities = source_store()->entities();
+        writer.write_u64(entities.size());
+        writer.write_bytes(entities.data(), entities.size() * sizeof(types::EntityId));
+
+        // Tags: forward column plus the ordered index (expensive to re-sort)
+        writer.write_u32(static_cast<uint32_t>(m_tags.size()));
+        for (const auto& [tag, index] : m_tags) {
+            writer.write_string(tag);
+            writer.write_u8(static_cast<uint8_t>((index.ordered ? 1 : 0) | (index.trigram ? 2 : 0)));
+            index.column.write_to(writer);
+
+            if (index.ordered && is_int_column(index.column)) {
+                write_ordered(writer, index.int_order,
+                              std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max());
+            } else if (index.ordered && index.column.type() == ColumnType::Double) {
+                write_ordered(writer, index.double_order,
+                              -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
+            }
+        }
+
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to save index: " << e.what() << "\n";
+        return false;
+    }
+}
+
+bool QueryIndex::load(const std::string& filepath) {
+    try {
+        MappedFile file(filepath);
+        MemoryReader reader(file.data(), file.size());
+
+        // Read and verify header
+        char magic[4];
+        reader.read_bytes(magic, 4);
+        if (std::memcmp(magic, "GTQI", 4) != 0) {
+            std::cerr << "Invalid index file format (bad magic)\n";
+            return false;
+        }
+        uint32_t version = reader.read_u32();
+        if (version != kIndexFormatVersion) {
+            std::cerr << "Unsupported index version: " << version << " (expected " << kIndexFormatVersion << ")\n";
+            return false;
+        }
+        uint64_t applied_lsn = reader.read_u64();
+        const AtomStore* store = source_store();
+        if (store && applied_lsn > store->current_lsn().value) {
+            std::cerr << "Index is newer than the store (LSN " << applied_lsn << " > "
+                      << store->current_lsn().value << ")\n";
+            return false;
+        }
+
+        // Rows are store ordinals: the saved table must be a prefix of the store's
+        std::vector<types::EntityId> entities;
+        reader.read_array(entities, reader.read_u64());
+        if (store && (entities.size() > store->entity_count() ||
+                      !std::equal(entities.begin(), entities.end(), store->entities().begin()))) {
+            std::cerr << "Index entity ordinals do not match the store\n";
+            return false;
+        }
+
+        // Tags are staged and swapped in only once the whole file has parsed
+        std::unordered_map<std::string, TagIndex> tags;
+        uint32_t tag_count = reader.read_u32();
+        for (uint32_t t = 0; t < tag_count; ++t) {
+            std::string tag = reader.read_string();
+            uint8_t flags = reader.read_u8();
+            TagIndex& index = tags[tag];
+            index.ordered = (flags & 1) != 0;
+            index.trigram = (flags & 2) != 0;
+            index.column = Column::read_from(reader);
+            index.type = index.column.type();
+
+            uint32_t last_row = 0;
+            index.column.for_each_valid([&](uint32_t row) { last_row = row; });
+            if (index.column.count() > 0 && last_row >= entities.size()) {
+                throw std::runtime_error("Column row out of range for tag " + tag);
+            }
+
+            if (index.ordered && is_int_column(index.column)) {
+                read_ordered(reader, index.int_order, entities.size());
+            } else if (index.ordered && index.column.type() == ColumnType::Double) {
+                read_ordered(reader, index.double_order, entities.size());
+            } else if (index.column.type() == ColumnType::String) {
+                finish_string_tag(index);
+            }
+        }
+
+        m_tags = std::move(tags);
+        m_applied_lsn = applied_lsn;
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to load index: " << e.what() << "\n";
+        return false;
+    }
+
+    catch_up();
+    return true;
+}
+
+size_t QueryIndex::apply(const std::vector<AtomStore::AppendEvent>& events) {
+    size_t applied = 0;
+    for (const auto& event : events) {
+        if (event.lsn.value <= m_applied_lsn) {
+            continue;
+        }
+        // Events arrive in LSN order, so applying each in turn leaves the latest value
+        if (update_at(event.ordinal, event.atom->type_tag(), event.atom->value())) {
+            ++applied;
+        }
+        m_applied_lsn = event.lsn.value;
+    }
+    return applied;
+}
+
+std::optional<uint32_t> QueryIndex::find_ordinal(const types::EntityId& entity) const {
+    return source_store()->find_ordinal(entity);
+}
+
+const types::EntityId& QueryIndex::entity_at(uint32_t ordinal) const {
+    return source_store()->entity_at(ordinal);
+}
+
+size_t QueryIndex::entity_count() const {
+    return source_store()->entity_count();
+}
+
+const Column* QueryIndex::find_column(const std::string& tag) const {
+    auto it = m_tags.find(tag);
+    return it == m_tags.end() ? nullptr : &it->second.column;
+}
+
+const QueryIndex::TagIndex* QueryIndex::find_tag(const std::string& tag) const {
+    auto it = m_tags.find(tag);
+    return it == m_tags.end() ? nullptr : &it->second;
+}
+
+QueryIndex::TagIndex& QueryIndex::reset_tag(const IndexSpec& spec, size_t rows) {
+    auto& index = m_tags[spec.tag];
+    index = TagIndex{};
+    index.column = Column(spec.type);
+    index.column.resize(rows);
+    index.type = spec.type;
+    index.ordered = spec.ordered;
+    index.trigram = spec.trigram;
+    return index;
+}
+
+void QueryIndex::sync_trigrams(TagIndex& index) {
+    const Column& column = index.column;
+    while (index.trigram_codes < column.dictionary_size()) {
+        uint32_t code = index.trigram_codes++;
+        index.trigrams.add(code, column.dictionary_value(code));
+    }
+}
+
+void QueryIndex::finish_string_tag(TagIndex& index) {
+    index.values.build(index.column);
+    index.trigrams.clear();
+    index.trigram_codes = 0;
+    if (index.trigram) {
+        sync_trigrams(index);
+    }
+}
+
+void QueryIndex::finish_tag(TagIndex& index) {
+    if (index.column.type() == ColumnType::String) {
+        finish_string_tag(index);
+        return;
+    }
+    if (!index.ordered) {
+        return;
+    }
+    const Column& column = index.column;
+    if (is_int_column(column)) {
+        std::vector<OrderedIndex<int64_t>::Entry> entries;
+        entries.reserve(column.count());
+        const int64_t* values = column.ints().data();
+        column.for_each_valid([&](uint32_t row) { entries.push_back({values[row], row}); });
+        index.int_order.build(std::move(entries));
+    } else if (column.type() == ColumnType::Double) {
+        std::vector<OrderedIndex<double>::Entry> entries;
+        entries.reserve(column.count());
+        const double* values = column.doubles().data();
+        column.for_each_valid([&](uint32_t row) {
+            if (!std::isnan(values[row])) entries.push_back({values[row], row});
+        });
+        index.double_order.build(std::move(entries));
+    }
+}
+
+std::vector<uint32_t> QueryIndex::rows_with_codes(
+    const TagIndex& index,
+    const std::vector<uint32_t>& codes
+) const {
+    const Column& column = index.column;
+    size_t estimate = 0;
+    for (uint32_t code : codes) {
+        estimate += index.values.posting_size(code);
+    }
+
+    // Large selections: one sequential pass over the code array beats merging postings
+    if (estimate > column.count() / 8) {
+        std::vector<uint8_t> wanted(column.dictionary_size(), 0);
+        for (uint32_t code : codes) {
+            wanted[code] = 1;
+        }
+        const uint32_t* row_codes = column.codes().data();
+        return collect_rows(column, [&](uint32_t row) { return wanted[row_codes[row]] != 0; });
+    }
+
+    std::vector<uint32_t> rows;
+    rows.reserve(estimate);
+    for (uint32_t code : codes) {
+        index.values.for_each_row(code, column, [&](uint32_t row) { rows.push_back(row); });
+    }
+    if (codes.size() > 1) {
+        std::sort(rows.begin(), rows.end());
+    }
+    return rows;
+}
+
+std::vector<types::EntityId> QueryIndex::to_entities(const std::vector<uint32_t>& rows) const {
+    const auto& entities = source_store()->entities();
+    std::vector<types::EntityId> results;
+    results.reserve(rows.size());
+    for (uint32_t row : rows) {
+        results.push_back(entities[row]);
+    }
+    return results;
+}
+
+bool QueryIndex::update(
+    const types::EntityId& entity,
+    const std::string& tag,
+    const types::AtomValue& value
+) {
+    auto ordinal = find_ordinal(entity);
+    return ordinal && update_at(*ordinal, tag, value);
+}
+
+bool QueryIndex::update_at(uint32_t row, const std::string& tag, const types::AtomValue& value) {
+    auto it = m_tags.find(tag);
+    if (it == m_tags.end()) {
+        return false;
+    }
+    TagIndex& index = it->second;
+    Column& column = index.column;
+
+    // Withdraw the previous value from secondary structures
+    const bool had_value = column.is_valid(row);
+    uint32_t old_code = 0;
+    if (had_value) {
+        if (index.ordered && is_int_column(column)) {
+            index.int_order.remove(column.ints()[row], row);
+        } else if (index.ordered && column.type() == ColumnType::Double) {
+            index.double_order.remove(column.doubles()[row], row);
+        } else if (column.type() == ColumnType::String) {
+            old_code = column.codes()[row];
+        }
+    }
+
+    const ColumnType old_type = column.type();
+    const bool stored = column.set(row, value);
+    if (column.type() != old_type && old_type != ColumnType::Auto) {
+        // An Auto column widened on a conflicting value: every row was rewritten
+        index.int_order = {};
+        index.double_order = {};
+        index.values = {};
+        finish_tag(index);
+        return true;
+    }
+
+    if (!stored) {
+        if (had_value && column.type() == ColumnType::String) {
+            index.values.mark_stale();
+        }
+        column.set_null(row);
+        return true;
+    }
+
+    if (column.type() == ColumnType::String) {
+        uint32_t code = column.codes()[row];
+        if (!had_value || code != old_code) {
+            if (had_value) {
+                index.values.mark_stale();
+            }
+            // Stale postings only cost verification time; rebuild once they dominate,
+            // dropping the values no row holds any more (which renumbers the codes)
+            if (index.values.stale_rows() > column.count() / 4 + 1024) {
+                column.compact_dictionary();
+                finish_string_tag(index);   // Resyncs the trigram index too
+                return true;
+            }
+            index.values.add(code, row);
+        }
+        if (index.trigram) {
+            sync_trigrams(index);
+        }
+        return true;
+    }
+
+    if (index.ordered) {
+        if (is_int_column(column)) {
+            index.int_order.insert(column.ints()[row], row);
+        } else if (column.type() == ColumnType::Double && !std::isnan(column.doubles()[row])) {
+            index.double_order.insert(column.doubles()[row], row);
+        }
+    }
+    return true;
+}
+
+size_t QueryIndex::build_indexes_direct(const std::vector<IndexSpec>& specs) {
+    if (!m_store || specs.empty()) {
         return 0;
     }
 
-    const size_t num_tags = tags.size();
+    const size_t num_tags = specs.size();
 
     // Create tag -> index mapping for O(1) lookup
     std::unordered_map<std::string, size_t> tag_to_index;
     tag_to_index.reserve(num_tags);
     for (size_t i = 0; i < num_tags; ++i) {
-        tag_to_index[tags[i]] = i;
+        tag_to_index[specs[i].tag] = i;
     }
 
-    // Get all entities
-    auto entities = m_store->get_all_entities();
+    // Rows are store ordinals, so columns are sized once up front
+    const size_t entity_count = m_store->entity_count();
 
-    // Pre-create and reserve indexes for all requested tags
-    for (const auto& tag : tags) {
-        auto& index = m_string_indexes[tag];
-        index.clear();
-        index.reserve(entities.size());
+    // Pre-create and size columns for all requested tags
+    std::vector<TagIndex*> indexes(num_tags);
+    for (size_t i = 0; i < num_tags; ++i) {
+        indexes[i] = &reset_tag(specs[i], entity_count);
     }
 
-    // Track latest value per tag using flat arrays (faster than hash map per entity)
+    // Track latest value per tag using flat arrays (faster than hash map per entity).
+    // Values are referenced in place in the store; nothing is copied until stored.
     struct LatestValue {
-        std::string value;
+        const types::AtomValue* value = nullptr;
         uint64_t lsn = 0;
-        bool has_value = false;
     };
 
-    // Reuse these vectors across entities to avoid repeated allocations
+    // Reuse this vector across entities to avoid repeated allocations
     std::vector<LatestValue> latest_values(num_tags);
 
     size_t total_indexed = 0;
     size_t entities_processed = 0;
 
-    // Process each entity directly
-    for (const auto& entity : entities) {
+    // Process each entity directly, in ordinal order
+    for (uint32_t ordinal = 0; ordinal < entity_count; ++ordinal) {
         // Reset latest values for this entity
-        for (size_t i = 0; i < num_tags; ++i) {
-            latest_values[i].has_value = false;
-            latest_values[i].lsn = 0;
+        for (auto& latest : latest_values) {
+            latest.value = nullptr;
+            latest.lsn = 0;
         }
 
-        // Get atom references for this entity
-        const auto* refs = m_store->get_entity_atoms(entity);
-        if (!refs) continue;
-
         // Scan atoms and track latest value per tag
-        for (const auto& ref : *refs) {
+        for (const auto& ref : m_store->get_entity_atoms_at(ordinal)) {
             const Atom* atom = m_store->get_atom(ref.atom_id);
             if (!atom) continue;
 
-            const std::string& type_tag = atom->type_tag();
-
             // Only process tags we're interested in
-            auto it = tag_to_index.find(type_tag);
+            auto it = tag_to_index.find(atom->type_tag());
             if (it == tag_to_index.end()) continue;
 
-            size_t idx = it->second;
-
-            // Check if this is newer than what we have
-            if (!latest_values[idx].has_value || ref.lsn.value > latest_values[idx].lsn) {
-                // Extract string value
-                const auto& value = atom->value();
-                if (std::holds_alternative<std::string>(value)) {
-                    latest_values[idx].value = std::get<std::string>(value);
-                    latest_values[idx].lsn = ref.lsn.value;
-                    latest_values[idx].has_value = true;
-                }
+            auto& latest = latest_values[it->second];
+            if (!latest.value || ref.lsn.value > latest.lsn) {
+                latest.value = &atom->value();
+                latest.lsn = ref.lsn.value;
             }
         }
 
-        // Store results in indexes
+        // Store results in columns
         for (size_t i = 0; i < num_tags; ++i) {
-            if (latest_values[i].has_value) {
-                m_string_indexes[tags[i]][entity] = std::move(latest_values[i].value);
+            if (latest_values[i].value && indexes[i]->column.set(ordinal, *latest_values[i].value)) {
                 total_indexed++;
             }
         }
@@ -99,6 +591,11 @@ size_t QueryIndex::build_indexes_direct(const std::vector<std::string>& tags) {
         }
     }
 
+    for (auto* index : indexes) {
+        finish_tag(*index);
+    }
+
+    m_applied_lsn = m_store->current_lsn().value;
     return total_indexed;
 }
 
@@ -108,13 +605,22 @@ size_t QueryIndex::build_index(const std::string& tag) {
 }
 
 size_t QueryIndex::build_indexes(const std::vector<std::string>& tags) {
-    if (tags.empty()) {
+    std::vector<IndexSpec> specs;
+    specs.reserve(tags.size());
+    for (const auto& tag : tags) {
+        specs.push_back({tag, ColumnType::Auto});
+    }
+    return build_typed_indexes(specs);
+}
+
+size_t QueryIndex::build_typed_indexes(const std::vector<IndexSpec>& specs) {
+    if (specs.empty()) {
         return 0;
     }
 
     // Use direct store access if available (much faster)
     if (m_store) {
-        return build_indexes_direct(tags);
+        return build_indexes_direct(specs);
     }
 
     // Fall back to ProjectionEngine approach
@@ -122,115 +628,447 @@ size_t QueryIndex::build_indexes(const std::vector<std::string>& tags) {
         return 0;
     }
 
-    // Get all entities
-    auto entities = m_projector->get_all_entities();
+    const size_t entity_count = m_projector->store().entity_count();
 
-    // Pre-create and reserve indexes for all requested tags
-    for (const auto& tag : tags) {
-        auto& index = m_string_indexes[tag];
-        index.clear();
-        index.reserve(entities.size());
+    // Pre-create and size columns for all requested tags
+    std::vector<TagIndex*> indexes(specs.size());
+    for (size_t i = 0; i < specs.size(); ++i) {
+        indexes[i] = &reset_tag(specs[i], entity_count);
+    }
+
+    // Resolve tags once; a tag the store has never seen indexes no rows
+    std::vector<std::optional<TagId>> tag_ids(specs.size());
+    for (size_t i = 0; i < specs.size(); ++i) {
+        tag_ids[i] = m_projector->store().find_tag(specs[i].tag);
     }
 
     size_t total_indexed = 0;
 
-    // Use streaming to rebuild nodes once and extract all tag values
-    m_projector->rebuild_all_streaming([&](const types::EntityId& entity, const Node& node) {
-        for (const auto& tag : tags) {
-            auto value = node.get(tag);
-            if (value && std::holds_alternative<std::string>(*value)) {
-                m_string_indexes[tag][entity] = std::get<std::string>(*value);
+    // Rebuild each node once (by ordinal) and extract all tag values
+    for (uint32_t ordinal = 0; ordinal < entity_count; ++ordinal) {
+        Node node = m_projector->project_at(ordinal);
+        for (size_t i = 0; i < specs.size(); ++i) {
+            if (!tag_ids[i]) continue;
+            auto value = node.get(*tag_ids[i]);
+            if (value && indexes[i]->column.set(ordinal, *value)) {
                 total_indexed++;
             }
         }
-    });
+    }
 
+    for (auto* index : indexes) {
+        finish_tag(*index);
+    }
+
+    m_applied_lsn = source_store()->current_lsn().value;
     return total_indexed;
 }
 
-std::vector<types::EntityId> QueryIndex::find_contains(
+std::vector<uint32_t> QueryIndex::match_contains(
     const std::string& tag,
     const std::string& substring
 ) const {
-    std::vector<types::EntityId> results;
-
-    auto it = m_string_indexes.find(tag);
-    if (it == m_string_indexes.end()) {
-        return results;  // Tag not indexed
+    const Column* column = find_column(tag);
+    if (!column || column->type() != ColumnType::String) {
+        return {};  // Tag not indexed
     }
 
-    // Convert substring to uppercase for case-insensitive search
+    // Convert substring to uppercase once for case-insensitive search
     std::string upper_substring = substring;
     std::transform(upper_substring.begin(), upper_substring.end(),
                    upper_substring.begin(), ::toupper);
 
-    const auto& index = it->second;
-    results.reserve(index.size() / 10);  // Estimate
+    const TagIndex* index = find_tag(tag);
+
+    // Match distinct values first; the trigram index narrows which ones to verify
+    std::vector<uint32_t> codes;
+    if (index->trigram && index->trigrams.candidates(upper_substring, codes)) {
+        codes.erase(std::remove_if(codes.begin(), codes.end(), [&](uint32_t code) {
+            return !contains_upper(column->dictionary_value(code), upper_substring);
+        }), codes.end());
+    } else {
+        for (uint32_t code = 0; code < column->dictionary_size(); ++code) {
+            if (contains_upper(column->dictionary_value(code), upper_substring)) {
+                codes.push_back(code);
+            }
+        }
+    }
+
+    return rows_with_codes(*index, codes);
+}
 
-    for (const auto& [entity, value] : index) {
-        // Convert value to uppercase
-        std::string upper_value = value;
-        std::transform(upper_value.begin(), upper_value.end(),
-                       upper_value.begin(), ::toupper);
+std::vector<uint32_t> QueryIndex::match_int_where(
+    const std::string& tag,
+    const std::function<bool(int64_t)>& predicate
+) const {
+    const Column* column = find_column(tag);
+    if (!column) {
+        return {};  // Tag not indexed
+    }
+
+    if (is_int_column(*column)) {
+        const int64_t* values = column->ints().data();
+        return collect_rows(*column, [&](uint32_t row) { return predicate(values[row]); });
+    }
 
-        if (upper_value.find(upper_substring) != std::string::npos) {
-            results.push_back(entity);
+    if (column->type() != ColumnType::String) {
+        return {};
+    }
+
+    // Legacy path: integers indexed as strings are parsed once per distinct value
+    std::vector<uint8_t> verdicts(column->dictionary_size());
+    for (size_t code = 0; code < verdicts.size(); ++code) {
+        const std::string& value = column->dictionary_value(static_cast<uint32_t>(code));
+        if (value.empty()) {
+            continue;
+        }
+        try {
+            verdicts[code] = predicate(std::stoll(value)) ? 1 : 0;
+        } catch (...) {
+            // Skip invalid integers
         }
     }
+    const uint32_t* codes = column->codes().data();
+    return collect_rows(*column, [&](uint32_t row) { return verdicts[codes[row]] != 0; });
+}
 
-    return results;
+std::vector<uint32_t> QueryIndex::match_int(
+    const std::string& tag,
+    CompareOp op,
+    int64_t value
+) const {
+    const TagIndex* index = find_tag(tag);
+    if (!index || !is_int_column(index->column)) {
+        return {};
+    }
+
+    if (index->ordered && op != CompareOp::Ne) {
+        int64_t low = 0, high = 0;
+        if (!int_range_for(op, value, low, high)) {
+            return {};
+        }
+        return match_int_between(tag, low, high);
+    }
+
+    const int64_t* values = index->column.ints().data();
+    return collect_rows(index->column, [&](uint32_t row) { return compare(values[row], op, value); });
 }
 
-std::vector<types::EntityId> QueryIndex::find_int_where(
+std::vector<uint32_t> QueryIndex::match_int_between(
     const std::string& tag,
-    std::function<bool(int64_t)> predicate
+    int64_t low,
+    int64_t high
 ) const {
-    std::vector<types::EntityId> results;
+    const TagIndex* index = find_tag(tag);
+    if (!index || !is_int_column(index->column)) {
+        return {};
+    }
 
-    auto it = m_string_indexes.find(tag);
-    if (it == m_string_indexes.end()) {
-        return results;  // Tag not indexed
+    if (index->ordered) {
+        std::vector<uint32_t> rows;
+        index->int_order.for_each_in_range(low, high, [&](uint32_t row, int64_t) { rows.push_back(row); });
+        return rows;
     }
 
-    const auto& index = it->second;
-    results.reserve(index.size() / 10);  // Estimate
+    const int64_t* values = index->column.ints().data();
+    return collect_rows(index->column, [&](uint32_t row) {
+        return values[row] >= low && values[row] <= high;
+    });
+}
 
-    for (const auto& [entity, value] : index) {
-        if (!value.empty()) {
-            try {
-                int64_t int_value = std::stoll(value);
-                if (predicate(int_value)) {
-                    results.push_back(entity);
-                }
-            } catch (...) {
-                // Skip invalid integers
-            }
+std::vector<uint32_t> QueryIndex::match_double(
+    const std::string& tag,
+    CompareOp op,
+    double value
+) const {
+    const TagIndex* index = find_tag(tag);
+    if (!index) {
+        return {};
+    }
+    const Column* column = &index->column;
+    if (column->type() == ColumnType::Double && index->ordered && op != CompareOp::Ne) {
+        double low = 0.0, high = 0.0;
+        if (!double_range_for(op, value, low, high)) {
+            return {};
         }
+        return match_double_between(tag, low, high);
+    }
+    if (column->type() == ColumnType::Double) {
+        const double* values = column->doubles().data();
+        return collect_rows(*column, [&](uint32_t row) { return compare(values[row], op, value); });
+    }
+    if (column->type() == ColumnType::Int64) {
+        const int64_t* values = column->ints().data();
+        return collect_rows(*column, [&](uint32_t row) {
+            return compare(static_cast<double>(values[row]), op, value);
+        });
     }
+    return {};
+}
 
-    return results;
+std::vector<uint32_t> QueryIndex::match_double_between(
+    const std::string& tag,
+    double low,
+    double high
+) const {
+    const TagIndex* index = find_tag(tag);
+    if (!index || std::isnan(low) || std::isnan(high) || low > high) {
+        return {};
+    }
+    const Column* column = &index->column;
+    if (column->type() == ColumnType::Double && index->ordered) {
+        std::vector<uint32_t> rows;
+        index->double_order.for_each_in_range(low, high, [&](uint32_t row, double) { rows.push_back(row); });
+        return rows;
+    }
+    if (column->type() == ColumnType::Double) {
+        const double* values = column->doubles().data();
+        return collect_rows(*column, [&](uint32_t row) {
+            return values[row] >= low && values[row] <= high;
+        });
+    }
+    if (column->type() == ColumnType::Int64) {
+        const int64_t* values = column->ints().data();
+        return collect_rows(*column, [&](uint32_t row) {
+            double v = static_cast<double>(values[row]);
+            return v >= low && v <= high;
+        });
+    }
+    return {};
+}
+
+std::vector<uint32_t> QueryIndex::match_bool(const std::string& tag, bool value) const {
+    const Column* column = find_column(tag);
+    if (!column || column->type() != ColumnType::Bool) {
+        return {};
+    }
+    const uint8_t wanted = value ? 1 : 0;
+    const uint8_t* values = column->bools().data();
+    return collect_rows(*column, [&](uint32_t row) { return values[row] == wanted; });
+}
+
+std::optional<types::AtomValue> QueryIndex::min_value(const std::string& tag) const {
+    auto rows = top_k(tag, 1, false);
+    if (rows.empty()) {
+        return std::nullopt;
+    }
+    return find_column(tag)->get(*find_ordinal(rows[0]));
 }
 
-std::vector<types::EntityId> QueryIndex::find_equals(
+std::optional<types::AtomValue> QueryIndex::max_value(const std::string& tag) const {
+    auto rows = top_k(tag, 1, true);
+    if (rows.empty()) {
+        return std::nullopt;
+    }
+    return find_column(tag)->get(*find_ordinal(rows[0]));
+}
+
+std::vector<types::EntityId> QueryIndex::top_k(const std::string& tag, size_t k, bool largest) const {
+    const TagIndex* index = find_tag(tag);
+    if (!index || k == 0) {
+        return {};
+    }
+    const Column& column = index->column;
+
+    std::vector<uint32_t> rows;
+    if (is_int_column(column)) {
+        if (index->ordered) {
+            for (const auto& entry : index->int_order.top_k(k, largest)) rows.push_back(entry.row);
+            return to_entities(rows);
+        }
+        OrderedIndex<int64_t> scratch;
+        std::vector<OrderedIndex<int64_t>::Entry> entries;
+        const int64_t* values = column.ints().data();
+        column.for_each_valid([&](uint32_t row) { entries.push_back({values[row], row}); });
+        scratch.build(std::move(entries));
+        for (const auto& entry : scratch.top_k(k, largest)) rows.push_back(entry.row);
+    } else if (column.type() == ColumnType::Double) {
+        if (index->ordered) {
+            for (const auto& entry : index->double_order.top_k(k, largest)) rows.push_back(entry.row);
+            return to_entities(rows);
+        }
+        OrderedIndex<double> scratch;
+        std::vector<OrderedIndex<double>::Entry> entries;
+        const double* values = column.doubles().data();
+        column.for_each_valid([&](uint32_t row) {
+            if (!std::isnan(values[row])) entries.push_back({values[row], row});
+        });
+        scratch.build(std::move(entries));
+        for (const auto& entry : scratch.top_k(k, largest)) rows.push_back(entry.row);
+    }
+    return to_entities(rows);
+}
+
+bool QueryIndex::is_ordered(const std::string& tag) const {
+    const TagIndex* index = find_tag(tag);
+    return index && index->ordered &&
+           (is_int_column(index->column) || index->column.type() == ColumnType::Double);
+}
+
+std::vector<uint32_t> QueryIndex::match_equals(
     const std::string& tag,
     const std::string& value
 ) const {
-    std::vector<types::EntityId> results;
+    const Column* column = find_column(tag);
+    if (!column) {
+        return {};  // Tag not indexed
+    }
 
-    auto it = m_string_indexes.find(tag);
-    if (it == m_string_indexes.end()) {
-        return results;  // Tag not indexed
+    if (column->type() == ColumnType::String) {
+        auto code = column->find_code(value);
+        if (!code) {
+            return {};
+        }
+        std::vector<uint32_t> rows;
+        const ValueIndex& values = find_tag(tag)->values;
+        rows.reserve(values.posting_size(*code));
+        values.for_each_row(*code, *column, [&](uint32_t row) { rows.push_back(row); });
+        return rows;
     }
 
-    const auto& index = it->second;
-    results.reserve(index.size() / 10);  // Estimate
+    // Typed column: coerce the needle once, then compare natively
+    Column needle(column->type());
+    if (!needle.set(0, value)) {
+        return {};
+    }
+    switch (column->type()) {
+        case ColumnType::Int64:
+        case ColumnType::Timestamp:
+            return match_int(tag, CompareOp::Eq, needle.ints()[0]);
+        case ColumnType::Double:
+            return match_double(tag, CompareOp::Eq, needle.doubles()[0]);
+        case ColumnType::Bool:
+            return match_bool(tag, needle.bools()[0] != 0);
+        default:
+            return {};
+    }
+}
 
-    for (const auto& [entity, indexed_value] : index) {
-        if (indexed_value == value) {
-            results.push_back(entity);
+std::vector<uint32_t> QueryIndex::match_in(
+    const std::string& tag,
+    const std::vector<std::string>& values
+) const {
+    const TagIndex* index = find_tag(tag);
+    if (!index || values.empty()) {
+        return {};
+    }
+
+    if (index->column.type() == ColumnType::String) {
+        std::vector<uint32_t> codes;
+        codes.reserve(values.size());
+        for (const auto& value : values) {
+            if (auto code = index->column.find_code(value)) {
+                codes.push_back(*code);
+            }
         }
+        std::sort(codes.begin(), codes.end());
+        codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+        return rows_with_codes(*index, codes);
     }
 
+    // Typed column: union of per-value lookups, deduplicated by ordinal
+    std::vector<uint32_t> rows;
+    for (const auto& value : values) {
+        auto matched = match_equals(tag, value);
+        rows.insert(rows.end(), matched.begin(), matched.end());
+    }
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    return rows;
+}
+
+// ---- Entity-returning predicates ----
+
+std::vector<types::EntityId> QueryIndex::find_contains(const std::string& tag, const std::string& substring) const {
+    return to_entities(match_contains(tag, substring));
+}
+
+std::vector<types::EntityId> QueryIndex::find_int_where(
+    const std::string& tag,
+    std::function<bool(int64_t)> predicate
+) const {
+    return to_entities(match_int_where(tag, predicate));
+}
+
+std::vector<types::EntityId> QueryIndex::find_int(const std::string& tag, CompareOp op, int64_t value) const {
+    return to_entities(match_int(tag, op, value));
+}
+
+std::vector<types::EntityId> QueryIndex::find_int_between(const std::string& tag, int64_t low, int64_t high) const {
+    return to_entities(match_int_between(tag, low, high));
+}
+
+std::vector<types::EntityId> QueryIndex::find_double(const std::string& tag, CompareOp op, double value) const {
+    return to_entities(match_double(tag, op, value));
+}
+
+std::vector<types::EntityId> QueryIndex::find_double_between(const std::string& tag, double low, double high) const {
+    return to_entities(match_double_between(tag, low, high));
+}
+
+std::vector<types::EntityId> QueryIndex::find_bool(const std::string& tag, bool value) const {
+    return to_entities(match_bool(tag, value));
+}
+
+std::vector<types::EntityId> QueryIndex::find_equals(const std::string& tag, const std::string& value) const {
+    return to_entities(match_equals(tag, value));
+}
+
+std::vector<types::EntityId> QueryIndex::find_in(const std::string& tag, const std::vector<std::string>& values) const {
+    return to_entities(match_in(tag, values));
+}
+
+// ---- Bitmap-returning predicates ----
+
+EntityBitmap QueryIndex::select_all() const {
+    return EntityBitmap::range(0, static_cast<uint32_t>(entity_count()));
+}
+
+EntityBitmap QueryIndex::select_present(const std::string& tag) const {
+    const Column* column = find_column(tag);
+    if (!column) {
+        return {};
+    }
+    return EntityBitmap::from_rows(collect_rows(*column, [](uint32_t) { return true; }));
+}
+
+EntityBitmap QueryIndex::select_contains(const std::string& tag, const std::string& substring) const {
+    return EntityBitmap::from_rows(match_contains(tag, substring));
+}
+
+EntityBitmap QueryIndex::select_equals(const std::string& tag, const std::string& value) const {
+    return EntityBitmap::from_rows(match_equals(tag, value));
+}
+
+EntityBitmap QueryIndex::select_in(const std::string& tag, const std::vector<std::string>& values) const {
+    return EntityBitmap::from_rows(match_in(tag, values));
+}
+
+EntityBitmap QueryIndex::select_int(const std::string& tag, CompareOp op, int64_t value) const {
+    return EntityBitmap::from_rows(match_int(tag, op, value));
+}
+
+EntityBitmap QueryIndex::select_int_between(const std::string& tag, int64_t low, int64_t high) const {
+    return EntityBitmap::from_rows(match_int_between(tag, low, high));
+}
+
+EntityBitmap QueryIndex::select_double(const std::string& tag, CompareOp op, double value) const {
+    return EntityBitmap::from_rows(match_double(tag, op, value));
+}
+
+EntityBitmap QueryIndex::select_double_between(const std::string& tag, double low, double high) const {
+    return EntityBitmap::from_rows(match_double_between(tag, low, high));
+}
+
+EntityBitmap QueryIndex::select_bool(const std::string& tag, bool value) const {
+    return EntityBitmap::from_rows(match_bool(tag, value));
+}
+
+std::vector<types::EntityId> QueryIndex::to_entities(const EntityBitmap& rows) const {
+    const auto& entities = source_store()->entities();
+    std::vector<types::EntityId> results;
+    results.reserve(rows.cardinality());
+    rows.for_each([&](uint32_t row) { results.push_back(entities[row]); });
     return results;
 }
 
@@ -238,34 +1076,85 @@ std::optional<std::string> QueryIndex::get_string(
     const std::string& tag,
     const types::EntityId& entity
 ) const {
-    auto tag_it = m_string_indexes.find(tag);
-    if (tag_it == m_string_indexes.end()) {
+    const Column* column = find_column(tag);
+    auto ordinal = find_ordinal(entity);
+    if (!column || !ordinal || column->type() != ColumnType::String || !column->is_valid(*ordinal)) {
+        return std::nullopt;
+    }
+    return column->string_at(*ordinal);
+}
+
+std::optional<int64_t> QueryIndex::get_int(
+    const std::string& tag,
+    const types::EntityId& entity
+) const {
+    const Column* column = find_column(tag);
+    auto ordinal = find_ordinal(entity);
+    if (!column || !ordinal || !is_int_column(*column) || !column->is_valid(*ordinal)) {
         return std::nullopt;
     }
+    return column->ints()[*ordinal];
+}
 
-    const auto& index = tag_it->second;
-    auto entity_it = index.find(entity);
-    if (entity_it == index.end()) {
+std::optional<double> QueryIndex::get_double(
+    const std::string& tag,
+    const types::EntityId& entity
+) const {
+    const Column* column = find_column(tag);
+    auto ordinal = find_ordinal(entity);
+    if (!column || !ordinal || !column->is_valid(*ordinal)) {
         return std::nullopt;
     }
+    if (column->type() == ColumnType::Double) {
+        return column->doubles()[*ordinal];
+    }
+    if (column->type() == ColumnType::Int64) {
+        return static_cast<double>(column->ints()[*ordinal]);
+    }
+    return std::nullopt;
+}
 
-    return entity_it->second;
+std::optional<bool> QueryIndex::get_bool(
+    const std::string& tag,
+    const types::EntityId& entity
+) const {
+    const Column* column = find_column(tag);
+    auto ordinal = find_ordinal(entity);
+    if (!column || !ordinal || column->type() != ColumnType::Bool || !column->is_valid(*ordinal)) {
+        return std::nullopt;
+    }
+    return column->bools()[*ordinal] != 0;
 }
 
 bool QueryIndex::is_indexed(const std::string& tag) const {
-    return m_string_indexes.find(tag) != m_string_indexes.end();
+    return m_tags.find(tag) != m_tags.end();
+}
+
+std::optional<ColumnType> QueryIndex::column_type(const std::string& tag) const {
+    const Column* column = find_column(tag);
+    if (!column) {
+        return std::nullopt;
+    }
+    return column->type();
 }
 
 QueryIndex::IndexStats QueryIndex::get_stats() const {
     IndexStats stats;
-    stats.num_indexed_tags = m_string_indexes.size();
+    stats.num_indexed_tags = m_tags.size();
     stats.num_indexed_entities = 0;
     stats.total_entries = 0;
+    stats.memory_bytes = 0;
 
-    for (const auto& [tag, index] : m_string_indexes) {
-        stats.total_entries += index.size();
-        if (index.size() > stats.num_indexed_entities) {
-            stats.num_indexed_entities = index.size();
+    for (const auto& [tag, index] : m_tags) {
+        const Column& column = index.column;
+        stats.total_entries += column.count();
+        stats.memory_bytes += column.memory_bytes()
+                            + index.int_order.memory_bytes()
+                            + index.double_order.memory_bytes()
+                            + index.values.memory_bytes()
+                            + index.trigrams.memory_bytes();
+        if (column.count() > stats.num_indexed_entities) {
+            stats.num_indexed_entities = column.count();
         }
     }
 
@@ -3,6 +3,11 @@
 #include "../types/types.h"
 #include "projection_engine.h"
 #include "atom_store.h"
+#include "column.h"
+#include "entity_bitmap.h"
+#include "ordered_index.h"
+#include "trigram_index.h"
+#include "value_index.h"
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -16,9 +21,47 @@ namespace gtaf::core {
  *
  * Indexes store only the indexed field values, not full nodes.
  * This dramatically reduces memory while enabling fast filtering.
+ *
+ * Each indexed tag is a typed Column addressed by the store's dense entity
+ * ordinal (AtomStore::find_ordinal()), so per-entity reads are array
+ * lookups with no EntityId hashing, and numeric predicates run over native
+ * int64/double arrays instead of re-parsing strings per row. Numeric and
+ * timestamp tags additionally keep an OrderedIndex so range, min/max and
+ * top-k queries cost O(log n + k). String tags are dictionary-encoded with
+ * a ValueIndex from each distinct value to its rows, so equality and
+ * IN-list lookups cost O(1) plus the result size; they can also opt into a
+ * TrigramIndex for substring search.
+ *
+ * Every find_* predicate has a select_* counterpart returning an
+ * EntityBitmap over entity ordinals, so multi-predicate filters combine
+ * with bitmap AND/OR/ANDNOT and materialize EntityIds only once.
+ *
+ * After a build, subscribe() keeps the index current: each append or batch
+ * committed to the store is applied at O(batch) cost instead of a rebuild.
+ * save()/load() persist the index with the store LSN it reflects, so a
+ * restarted process only applies the atoms appended after that watermark.
  */
 class QueryIndex {
 public:
+    /**
+     * @brief Requested physical type for an indexed tag
+     *
+     * ColumnType::Auto picks the type from the atom values' variant type.
+     * An explicit type coerces values once at build time (e.g. numeric
+     * strings to Int64, ISO dates to Timestamp).
+     */
+    struct IndexSpec {
+        std::string tag;
+        ColumnType type = ColumnType::Auto;
+        bool ordered = true;   // Keep a sorted range index for numeric/timestamp columns
+        bool trigram = false;  // Keep a trigram index for find_contains on string columns
+    };
+
+    /**
+     * @brief Comparison operator for typed predicates
+     */
+    enum class CompareOp : uint8_t { Eq, Ne, Lt, Le, Gt, Ge };
+
     /**
      * @brief Construct a query index from a projection engine
      */
@@ -29,6 +72,15 @@ public:
      */
     explicit QueryIndex(const AtomStore& store);
 
+    /**
+     * @brief Unsubscribes from the store if still subscribed
+     */
+    ~QueryIndex();
+
+    // The store listener captures this index, so it must stay in place
+    QueryIndex(const QueryIndex&) = delete;
+    QueryIndex& operator=(const QueryIndex&) = delete;
+
     /**
      * @brief Build an index for a specific property tag
      *
@@ -48,9 +100,110 @@ public:
      */
     size_t build_indexes(const std::vector<std::string>& tags);
 
+    /**
+     * @brief Build typed indexes for multiple tags in a single pass
+     *
+     * @param specs Tags with their requested column types
+     * @return Total number of index entries created
+     */
+    size_t build_typed_indexes(const std::vector<IndexSpec>& specs);
+
+    /**
+     * @brief Apply a newer value for an indexed tag without rebuilding
+     *
+     * The column and any secondary structures are updated in place. Values
+     * for tags that are not indexed are ignored; values that cannot be
+     * represented in the column type clear the entity's entry.
+     *
+     * @return true if the tag is indexed, the entity is known to the store,
+     *         and the update was applied
+     */
+    bool update(const types::EntityId& entity, const std::string& tag, const types::AtomValue& value);
+
+    /**
+     * @brief Apply committed references in LSN order (latest LSN wins)
+     *
+     * Events at or below applied_lsn() are skipped, so replaying an overlap
+     * is harmless. References to tags that are not indexed are ignored.
+     *
+     * @return Number of events that updated an indexed tag
+     */
+    size_t apply(const std::vector<AtomStore::AppendEvent>& events);
+
+    /**
+     * @brief Apply every future append committed to a store
+     *
+     * Appends committed since the index was built (or last applied) are
+     * caught up first, so none are lost between a build and subscribe().
+     * A store load() rebuilds every indexed tag. The store must be the one
+     * the index was built from and must outlive the subscription.
+     * Re-subscribing replaces any previous subscription.
+     */
+    void subscribe(AtomStore& store);
+
+    /**
+     * @brief Stop receiving appends (no-op if not subscribed)
+     */
+    void unsubscribe();
+
+    [[nodiscard]] bool is_subscribed() const noexcept { return m_subscribed_store != nullptr; }
+
+    /**
+     * @brief Highest store LSN reflected in the index
+     *
+     * Set to the store's current LSN by a build and advanced by apply().
+     */
+    [[nodiscard]] types::LogSequenceNumber applied_lsn() const noexcept { return {m_applied_lsn}; }
+
+    /**
+     * @brief Apply every store reference newer than applied_lsn()
+     *
+     * If the store's LSN is behind applied_lsn() (it was reloaded), the
+     * index is rebuilt instead.
+     *
+     * @return Number of references that updated an indexed tag
+     */
+    size_t catch_up();
+
+    /**
+     * @brief Rebuild every indexed tag from the store with its original spec
+     *
+     * @return Number of entity values indexed
+     */
+    size_t rebuild();
+
+    /**
+     * @brief Save all indexed tags to a binary file
+     *
+     * Writes the store's entity ordinal table, each typed column and its ordered
+     * index, stamped with applied_lsn(). Value postings and trigram indexes
+     * are derived on load.
+     *
+     * @param filepath Path to output file
+     * @return true on success, false on failure
+     */
+    bool save(const std::string& filepath) const;
+
+    /**
+     * @brief Load an index saved by save(), then catch up with the store
+     *
+     * The file is memory-mapped where supported. Fails (leaving the index
+     * unchanged) if the file is malformed, has an unsupported version,
+     * reflects a later LSN than the store holds, or was saved against
+     * different entity ordinals.
+     *
+     * @param filepath Path to input file
+     * @return true on success, false on failure
+     */
+    bool load(const std::string& filepath);
+
     /**
      * @brief Get all entity IDs where a string field contains a substring (case-insensitive)
      *
+     * The needle is tested once per distinct value, not once per row. With
+     * a trigram index and a needle of 3+ characters, only distinct values
+     * in the intersection of the needle's posting lists are verified.
+     *
      * @param tag The property tag
      * @param substring The substring to search for
      * @return Vector of matching entity IDs
@@ -60,6 +213,10 @@ public:
     /**
      * @brief Get all entity IDs where an integer field matches a condition
      *
+     * Runs natively on Int64/Timestamp columns; String columns are parsed
+     * once per distinct value for backwards compatibility. Prefer find_int() or find_int_if()
+     * on hot paths.
+     *
      * @param tag The property tag
      * @param predicate Function that returns true if the value matches
      * @return Vector of matching entity IDs
@@ -69,15 +226,121 @@ public:
         std::function<bool(int64_t)> predicate
     ) const;
 
+    /**
+     * @brief Get all entity IDs where an integer field satisfies a predicate
+     *
+     * Template version of find_int_where(): the predicate is inlined into
+     * the scan loop over the native int64 array.
+     */
+    template<typename Predicate>
+    std::vector<types::EntityId> find_int_if(const std::string& tag, Predicate predicate) const;
+
+    /**
+     * @brief Compare an Int64 or Timestamp field against a constant
+     *
+     * Uses the ordered index when present (all operators except Ne).
+     */
+    std::vector<types::EntityId> find_int(const std::string& tag, CompareOp op, int64_t value) const;
+
+    /**
+     * @brief Get entities whose Int64/Timestamp field lies in [low, high]
+     */
+    std::vector<types::EntityId> find_int_between(const std::string& tag, int64_t low, int64_t high) const;
+
+    /**
+     * @brief Compare a Double (or Int64) field against a constant
+     */
+    std::vector<types::EntityId> find_double(const std::string& tag, CompareOp op, double value) const;
+
+    /**
+     * @brief Get entities whose Double (or Int64) field lies in [low, high]
+     */
+    std::vector<types::EntityId> find_double_between(const std::string& tag, double low, double high) const;
+
+    /**
+     * @brief Get entities whose Bool field equals a value
+     */
+    std::vector<types::EntityId> find_bool(const std::string& tag, bool value) const;
+
+    /**
+     * @brief Smallest value of a numeric or timestamp field
+     */
+    std::optional<types::AtomValue> min_value(const std::string& tag) const;
+
+    /**
+     * @brief Largest value of a numeric or timestamp field
+     */
+    std::optional<types::AtomValue> max_value(const std::string& tag) const;
+
+    /**
+     * @brief Entities holding the k largest (or smallest) values of a numeric field
+     *
+     * @return Entity IDs ordered from the most to the least extreme value
+     */
+    std::vector<types::EntityId> top_k(const std::string& tag, size_t k, bool largest = true) const;
+
+    /**
+     * @brief Check whether a tag has an ordered range index
+     */
+    bool is_ordered(const std::string& tag) const;
+
     /**
      * @brief Get all entity IDs where a string field equals a value
      *
+     * String columns answer from the value index in O(1) plus the result
+     * size. On typed columns the value is coerced to the column type first.
+     *
      * @param tag The property tag
      * @param value The exact value to match
      * @return Vector of matching entity IDs
      */
     std::vector<types::EntityId> find_equals(const std::string& tag, const std::string& value) const;
 
+    /**
+     * @brief Get all entity IDs where a field equals any of several values (IN-list)
+     *
+     * Duplicate values are ignored; each matching entity appears once.
+     *
+     * @return Matching entity IDs in ascending ordinal order
+     */
+    std::vector<types::EntityId> find_in(const std::string& tag, const std::vector<std::string>& values) const;
+
+    // ---- Bitmap result sets ----
+
+    /**
+     * @brief Every entity known to the index (the universe for NOT)
+     */
+    EntityBitmap select_all() const;
+
+    /**
+     * @brief Entities holding a value for a tag (IS NOT NULL)
+     */
+    EntityBitmap select_present(const std::string& tag) const;
+
+    EntityBitmap select_contains(const std::string& tag, const std::string& substring) const;
+    EntityBitmap select_equals(const std::string& tag, const std::string& value) const;
+    EntityBitmap select_in(const std::string& tag, const std::vector<std::string>& values) const;
+    EntityBitmap select_int(const std::string& tag, CompareOp op, int64_t value) const;
+    EntityBitmap select_int_between(const std::string& tag, int64_t low, int64_t high) const;
+    EntityBitmap select_double(const std::string& tag, CompareOp op, double value) const;
+    EntityBitmap select_double_between(const std::string& tag, double low, double high) const;
+    EntityBitmap select_bool(const std::string& tag, bool value) const;
+
+    /**
+     * @brief Materialize the entity IDs of a bitmap in ascending ordinal order
+     */
+    std::vector<types::EntityId> to_entities(const EntityBitmap& rows) const;
+
+    /**
+     * @brief Entity for an ordinal produced by a bitmap
+     */
+    const types::EntityId& entity_at(uint32_t ordinal) const;
+
+    /**
+     * @brief Number of entity ordinals in the store
+     */
+    size_t entity_count() const;
+
     /**
      * @brief Get indexed string value for an entity
      *
@@ -87,11 +350,31 @@ public:
      */
     std::optional<std::string> get_string(const std::string& tag, const types::EntityId& entity) const;
 
+    /**
+     * @brief Get indexed Int64/Timestamp value for an entity
+     */
+    std::optional<int64_t> get_int(const std::string& tag, const types::EntityId& entity) const;
+
+    /**
+     * @brief Get indexed Double value for an entity
+     */
+    std::optional<double> get_double(const std::string& tag, const types::EntityId& entity) const;
+
+    /**
+     * @brief Get indexed Bool value for an entity
+     */
+    std::optional<bool> get_bool(const std::string& tag, const types::EntityId& entity) const;
+
     /**
      * @brief Check if a tag has been indexed
      */
     bool is_indexed(const std::string& tag) const;
 
+    /**
+     * @brief Get the resolved column type of an indexed tag
+     */
+    std::optional<ColumnType> column_type(const std::string& tag) const;
+
     /**
      * @brief Get statistics about the index
      */
@@ -99,6 +382,7 @@ public:
         size_t num_indexed_tags;
         size_t num_indexed_entities;
         size_t total_entries;
+        size_t memory_bytes = 0;
     };
     IndexStats get_stats() const;
 
@@ -112,13 +396,131 @@ private:
      * - No history tracking
      * - Only scans for requested tags
      */
-    size_t build_indexes_direct(const std::vector<std::string>& tags);
+    size_t build_indexes_direct(const std::vector<IndexSpec>& specs);
+
+    /**
+     * @brief update() for an entity already resolved to its store ordinal
+     */
+    bool update_at(uint32_t row, const std::string& tag, const types::AtomValue& value);
+
+    /**
+     * @brief Look up the store ordinal for an entity
+     */
+    std::optional<uint32_t> find_ordinal(const types::EntityId& entity) const;
+
+    /**
+     * @brief Per-tag index state: forward column plus secondary structures
+     */
+    struct TagIndex {
+        Column column{ColumnType::Auto};
+        ColumnType type = ColumnType::Auto;  // Requested (the column may have widened)
+        bool ordered = false;                // Requested; effective for numeric types only
+        OrderedIndex<int64_t> int_order;     // Int64, Timestamp
+        OrderedIndex<double> double_order;   // Double
+        ValueIndex values;                   // String: dictionary code -> rows
+        bool trigram = false;                // Requested; effective for String only
+        TrigramIndex trigrams;               // Keyed by dictionary code
+        uint32_t trigram_codes = 0;          // Dictionary codes indexed so far
+    };
+
+    /**
+     * @brief Get the column for a tag, or nullptr if not indexed
+     */
+    const Column* find_column(const std::string& tag) const;
+
+    /**
+     * @brief Get the index state for a tag, or nullptr if not indexed
+     */
+    const TagIndex* find_tag(const std::string& tag) const;
+
+    /**
+     * @brief Reset a tag's state ahead of a bulk build
+     */
+    TagIndex& reset_tag(const IndexSpec& spec, size_t rows);
+
+    /**
+     * @brief Build secondary structures from a freshly filled column
+     */
+    void finish_tag(TagIndex& index);
+
+    /**
+     * @brief Build the value postings and trigram index of a string column
+     */
+    void finish_string_tag(TagIndex& index);
+
+    /**
+     * @brief The store this index reads from (directly or via the projector)
+     */
+    const AtomStore* source_store() const;
+
+    /**
+     * @brief Add dictionary values not yet seen by a tag's trigram index
+     */
+    void sync_trigrams(TagIndex& index);
+
+    /**
+     * @brief Rows holding any of the given dictionary codes, in row order
+     *
+     * Gathers posting lists when they are small relative to the column,
+     * otherwise scans the code array once.
+     */
+    std::vector<uint32_t> rows_with_codes(const TagIndex& index, const std::vector<uint32_t>& codes) const;
+
+    // Row-level predicate evaluation shared by find_* and select_*
+    std::vector<uint32_t> match_contains(const std::string& tag, const std::string& substring) const;
+    std::vector<uint32_t> match_int_where(const std::string& tag, const std::function<bool(int64_t)>& predicate) const;
+    std::vector<uint32_t> match_int(const std::string& tag, CompareOp op, int64_t value) const;
+    std::vector<uint32_t> match_int_between(const std::string& tag, int64_t low, int64_t high) const;
+    std::vector<uint32_t> match_double(const std::string& tag, CompareOp op, double value) const;
+    std::vector<uint32_t> match_double_between(const std::string& tag, double low, double high) const;
+    std::vector<uint32_t> match_bool(const std::string& tag, bool value) const;
+    std::vector<uint32_t> match_equals(const std::string& tag, const std::string& value) const;
+    std::vector<uint32_t> match_in(const std::string& tag, const std::vector<std::string>& values) const;
+
+    /**
+     * @brief Materialize entity IDs for a list of rows
+     */
+    std::vector<types::EntityId> to_entities(const std::vector<uint32_t>& rows) const;
+
+    /**
+     * @brief Collect every valid row satisfying a row predicate, in row order
+     */
+    template<typename RowPredicate>
+    std::vector<uint32_t> collect_rows(const Column& column, RowPredicate matches) const;
 
     const ProjectionEngine* m_projector = nullptr;
     const AtomStore* m_store = nullptr;
 
-    // Index: tag -> (entity_id -> string_value)
-    std::unordered_map<std::string, std::unordered_map<types::EntityId, std::string, EntityIdHash>> m_string_indexes;
+    // Index: tag -> typed column (addressed by entity ordinal) and secondary indexes
+    std::unordered_map<std::string, TagIndex> m_tags;
+
+    // Incremental maintenance
+    uint64_t m_applied_lsn = 0;
+    AtomStore* m_subscribed_store = nullptr;
+    AtomStore::ListenerId m_listener_id = 0;
 };
 
+// Template implementations (must be in header)
+template<typename RowPredicate>
+std::vector<uint32_t> QueryIndex::collect_rows(const Column& column, RowPredicate matches) const {
+    std::vector<uint32_t> rows;
+    rows.reserve(column.count() / 10);  // Estimate
+    column.for_each_valid([&](uint32_t row) {
+        if (matches(row)) {
+            rows.push_back(row);
+        }
+    });
+    return rows;
+}
+
+template<typename Predicate>
+std::vector<types::EntityId> QueryIndex::find_int_if(const std::string& tag, Predicate predicate) const {
+    const Column* column = find_column(tag);
+    if (!column || (column->type() != ColumnType::Int64 && column->type() != ColumnType::Timestamp)) {
+        return {};
+    }
+    const int64_t* values = column->ints().data();
+    return to_entities(collect_rows(*column, [&](uint32_t row) { return predicate(values[row]); }));
+}
+
 } // namespace gtaf::core
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace gtaf::core {
+
+/**
+ * @brief Vector that keeps its first N elements inside the object
+ *
+ * Up to N elements need no heap allocation; growing past N moves every
+ * element to one heap buffer, which is kept until the vector is destroyed
+ * or moved from. Iterators are plain pointers and are invalidated by any
+ * insertion.
+ */
+template<typename T, size_t N>
+class SmallVector {
+    static_assert(N > 0, "SmallVector needs inline capacity");
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() noexcept = default;
+
+    SmallVector(const SmallVector& other) {
+        reserve(other.m_size);
+        std::uninitialized_copy_n(other.data(), other.m_size, data());
+        m_size = other.m_size;
+    }
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        take(other);
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            SmallVector copy(other);
+            release();
+            take(copy);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            release();
+            take(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector() { release(); }
+
+    [[nodiscard]] size_t size() const noexcept { return m_size; }
+    [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+    [[nodiscard]] size_t capacity() const noexcept { return m_heap ? m_capacity : N; }
+
+    /**
+     * @brief True while the elements live in the inline buffer
+     */
+    [[nodiscard]] bool is_inline() const noexcept { return m_heap == nullptr; }
+
+    [[nodiscard]] T* data() noexcept { return m_heap ? m_heap : inline_data(); }
+    [[nodiscard]] const T* data() const noexcept { return m_heap ? m_heap : inline_data(); }
+
+    iterator begin() noexcept { return data(); }
+    iterator end() noexcept { return data() + m_size; }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + m_size; }
+
+    T& operator[](size_t i) noexcept { return data()[i]; }
+    const T& operator[](size_t i) const noexcept { return data()[i]; }
+
+    void reserve(size_t capacity) {
+        if (capacity > this->capacity()) {
+            grow(capacity);
+        }
+    }
+
+    /**
+     * @brief Insert before pos, shifting later elements up by one
+     */
+    iterator insert(const_iterator pos, T value) {
+        const size_t index = static_cast<size_t>(pos - begin());
+        if (m_size == capacity()) {
+            grow(capacity() * 2);
+        }
+
+        T* items = data();
+        if (index == m_size) {
+            ::new (static_cast<void*>(items + m_size)) T(std::move(value));
+        } else {
+            ::new (static_cast<void*>(items + m_size)) T(std::move(items[m_size - 1]));
+            std::move_backward(items + index, items + m_size - 1, items + m_size);
+            items[index] = std::move(value);
+        }
+        ++m_size;
+        return items + index;
+    }
+
+    void push_back(T value) { insert(end(), std::move(value)); }
+
+    void clear() noexcept {
+        std::destroy_n(data(), m_size);
+        m_size = 0;
+    }
+
+private:
+    T* inline_data() noexcept { return std::launder(reinterpret_cast<T*>(m_inline)); }
+    const T* inline_data() const noexcept { return std::launder(reinterpret_cast<const T*>(m_inline)); }
+
+    void grow(size_t capacity) {
+        std::allocator<T> allocator;
+        T* fresh = allocator.allocate(capacity);
+        try {
+            std::uninitialized_move_n(data(), m_size, fresh);
+        } catch (...) {
+            allocator.deallocate(fresh, capacity);
+            throw;
+        }
+        const size_t size = m_size;
+        release();
+        m_heap = fresh;
+        m_capacity = capacity;
+        m_size = size;
+    }
+
+    /**
+     * @brief Destroy the elements and free any heap buffer
+     */
+    void release() noexcept {
+        clear();
+        if (m_heap) {
+            std::allocator<T>().deallocate(m_heap, m_capacity);
+            m_heap = nullptr;
+            m_capacity = 0;
+        }
+    }
+
+    /**
+     * @brief Move other's elements into this (empty, inline) vector
+     */
+    void take(SmallVector& other) {
+        if (other.m_heap) {
+            m_heap = std::exchange(other.m_heap, nullptr);
+            m_capacity = std::exchange(other.m_capacity, 0);
+            m_size = std::exchange(other.m_size, 0);
+        } else {
+            std::uninitialized_move_n(other.data(), other.m_size, inline_data());
+            m_size = other.m_size;
+            other.clear();
+        }
+    }
+
+    alignas(T) unsigned char m_inline[N * sizeof(T)];
+    T* m_heap = nullptr;
+    size_t m_size = 0;
+    size_t m_capacity = 0;   // Heap capacity (0 while inline)
+};
+
+} // namespace gtaf::core
@@ -0,0 +1,47 @@
+#include "tag_dictionary.h"
+#include <mutex>
+
+namespace gtaf::core {
+
+// ---- TagDictionary Implementation ----
+
+TagDictionary& TagDictionary::global() {
+    static TagDictionary dictionary;
+    return dictionary;
+}
+
+TagId TagDictionary::intern(const std::string& tag) {
+    {
+        std::shared_lock lock(m_mutex);
+        if (auto it = m_ids.find(tag); it != m_ids.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock lock(m_mutex);
+    auto [it, inserted] = m_ids.emplace(tag, static_cast<TagId>(m_names.size()));
+    if (inserted) {
+        m_names.push_back(tag);
+    }
+    return it->second;
+}
+
+std::optional<TagId> TagDictionary::find(const std::string& tag) const {
+    std::shared_lock lock(m_mutex);
+    if (auto it = m_ids.find(tag); it != m_ids.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+const std::string& TagDictionary::name(TagId id) const {
+    std::shared_lock lock(m_mutex);
+    return m_names.at(id);
+}
+
+size_t TagDictionary::size() const {
+    std::shared_lock lock(m_mutex);
+    return m_names.size();
+}
+
+} // namespace gtaf::core
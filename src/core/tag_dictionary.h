@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace gtaf::core {
+
+/**
+ * @brief Dense id of an interned type_tag
+ */
+using TagId = uint32_t;
+
+/**
+ * @brief Append-only mapping between type_tags and dense TagIds
+ *
+ * Tags are few and repeat across millions of atoms, so projections store
+ * a 4-byte TagId per property instead of a string. Ids are assigned in
+ * first-seen order and never reused; names stay at a stable address once
+ * interned. All methods are safe to call from concurrent threads.
+ */
+class TagDictionary {
+public:
+    /**
+     * @brief Process-wide dictionary shared by all projections
+     */
+    static TagDictionary& global();
+
+    /**
+     * @brief Id of a tag, interning it on first use
+     */
+    TagId intern(const std::string& tag);
+
+    /**
+     * @brief Id of an already interned tag
+     */
+    [[nodiscard]] std::optional<TagId> find(const std::string& tag) const;
+
+    /**
+     * @brief Name of an interned tag (reference stays valid)
+     */
+    [[nodiscard]] const std::string& name(TagId id) const;
+
+    [[nodiscard]] size_t size() const;
+
+private:
+    mutable std::shared_mutex m_mutex;
+    std::unordered_map<std::string, TagId> m_ids;
+    std::deque<std::string> m_names;   // Deque: growth never moves names
+};
+
+} // namespace gtaf::core
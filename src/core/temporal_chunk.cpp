@@ -1,4 +1,6 @@
 #include "temporal_chunk.h"
+#include "persistence.h"
+#include <algorithm>
 #include <stdexcept>
 
 namespace gtaf::core {
@@ -90,4 +92,69 @@ const std::vector<types::LogSequenceNumber>& TemporalChunk::lsns() const noexcep
     return m_lsns;
 }
 
+types::Timestamp TemporalChunk::min_timestamp() const noexcept {
+    return m_timestamps.empty() ? 0 : *std::min_element(m_timestamps.begin(), m_timestamps.end());
+}
+
+types::Timestamp TemporalChunk::max_timestamp() const noexcept {
+    return m_timestamps.empty() ? 0 : *std::max_element(m_timestamps.begin(), m_timestamps.end());
+}
+
+size_t TemporalChunk::memory_bytes() const noexcept {
+    size_t bytes = sizeof(TemporalChunk) + m_metadata.tag.capacity()
+                 + m_values.capacity() * sizeof(types::AtomValue)
+                 + m_timestamps.capacity() * sizeof(types::Timestamp)
+                 + m_lsns.capacity() * sizeof(types::LogSequenceNumber);
+    for (const auto& value : m_values) {
+        if (auto* text = std::get_if<std::string>(&value)) {
+            bytes += text->capacity();
+        } else if (auto* vector = std::get_if<types::Vector>(&value)) {
+            bytes += vector->capacity() * sizeof(float);
+        } else if (auto* blob = std::get_if<std::vector<uint8_t>>(&value)) {
+            bytes += blob->capacity();
+        }
+    }
+    return bytes;
+}
+
+void TemporalChunk::write_to(BinaryWriter& writer) const {
+    writer.write_u64(m_metadata.chunk_id);
+    writer.write_entity_id(m_metadata.entity_id);
+    writer.write_string(m_metadata.tag);
+    writer.write_lsn(m_metadata.start_lsn);
+    writer.write_lsn(m_metadata.end_lsn);
+    writer.write_timestamp(m_metadata.created_at);
+    writer.write_timestamp(m_metadata.sealed_at);
+    writer.write_u8(m_metadata.is_sealed ? 1 : 0);
+
+    writer.write_u32(m_metadata.value_count);
+    writer.write_bytes(m_timestamps.data(), m_timestamps.size() * sizeof(types::Timestamp));
+    writer.write_bytes(m_lsns.data(), m_lsns.size() * sizeof(types::LogSequenceNumber));
+    for (const auto& value : m_values) {
+        writer.write_atom_value(value);
+    }
+}
+
+TemporalChunk TemporalChunk::read_from(MemoryReader& reader) {
+    TemporalChunk chunk;
+    auto& metadata = chunk.m_metadata;
+    metadata.chunk_id = reader.read_u64();
+    metadata.entity_id = reader.read_entity_id();
+    metadata.tag = reader.read_string();
+    metadata.start_lsn = {reader.read_u64()};
+    metadata.end_lsn = {reader.read_u64()};
+    metadata.created_at = reader.read_u64();
+    metadata.sealed_at = reader.read_u64();
+    metadata.is_sealed = reader.read_u8() != 0;
+
+    metadata.value_count = reader.read_u32();
+    reader.read_array(chunk.m_timestamps, metadata.value_count);
+    reader.read_array(chunk.m_lsns, metadata.value_count);
+    chunk.m_values.reserve(metadata.value_count);
+    for (uint32_t i = 0; i < metadata.value_count; ++i) {
+        chunk.m_values.push_back(reader.read_atom_value());
+    }
+    return chunk;
+}
+
 } // namespace gtaf::core
@@ -6,6 +6,9 @@
 
 namespace gtaf::core {
 
+class BinaryWriter;
+class MemoryReader;
+
 /**
  * @brief Metadata for a temporal chunk
  *
@@ -117,7 +120,30 @@ public:
      */
     [[nodiscard]] const std::vector<types::LogSequenceNumber>& lsns() const noexcept;
 
+    /**
+     * @brief Earliest and latest value timestamps (0 if empty)
+     */
+    [[nodiscard]] types::Timestamp min_timestamp() const noexcept;
+    [[nodiscard]] types::Timestamp max_timestamp() const noexcept;
+
+    /**
+     * @brief Approximate heap footprint of the values
+     */
+    [[nodiscard]] size_t memory_bytes() const noexcept;
+
+    /**
+     * @brief Serialize metadata and values (used to spill sealed chunks)
+     */
+    void write_to(BinaryWriter& writer) const;
+
+    /**
+     * @brief Deserialize a chunk written by write_to()
+     */
+    static TemporalChunk read_from(MemoryReader& reader);
+
 private:
+    TemporalChunk() = default;
+
     TemporalChunkMetadata m_metadata;
     std::vector<types::AtomValue> m_values;
     std::vector<types::Timestamp> m_timestamps;
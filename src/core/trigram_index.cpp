@@ -0,0 +1,111 @@
+#include "trigram_index.h"
+#include <algorithm>
+#include <cctype>
+
+namespace gtaf::core {
+
+namespace {
+
+inline uint32_t upper(char c) {
+    return static_cast<uint32_t>(std::toupper(static_cast<unsigned char>(c)));
+}
+
+// Intersect a sorted candidate list with a sorted posting list in place.
+// Gallops through the longer list when sizes are skewed.
+void intersect(std::vector<uint32_t>& acc, const std::vector<uint32_t>& posting) {
+    size_t out = 0;
+    if (posting.size() > acc.size() * 16) {
+        auto it = posting.begin();
+        for (uint32_t key : acc) {
+            it = std::lower_bound(it, posting.end(), key);
+            if (it == posting.end()) break;
+            if (*it == key) acc[out++] = key;
+        }
+    } else {
+        size_t i = 0, j = 0;
+        while (i < acc.size() && j < posting.size()) {
+            if (acc[i] < posting[j]) ++i;
+            else if (posting[j] < acc[i]) ++j;
+            else { acc[out++] = acc[i]; ++i; ++j; }
+        }
+    }
+    acc.resize(out);
+}
+
+} // namespace
+
+// ---- TrigramIndex Implementation ----
+
+void TrigramIndex::clear() {
+    m_postings.clear();
+}
+
+void TrigramIndex::extract(std::string_view value, std::vector<uint32_t>& grams) {
+    grams.clear();
+    if (value.size() < GRAM) {
+        return;
+    }
+    grams.reserve(value.size() - GRAM + 1);
+    uint32_t key = (upper(value[0]) << 8) | upper(value[1]);
+    for (size_t i = GRAM - 1; i < value.size(); ++i) {
+        key = ((key << 8) | upper(value[i])) & 0xFFFFFFu;
+        grams.push_back(key);
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+}
+
+void TrigramIndex::add(uint32_t key, std::string_view value) {
+    extract(value, m_scratch);
+    for (uint32_t gram : m_scratch) {
+        auto& posting = m_postings[gram];
+        if (posting.empty() || posting.back() < key) {
+            posting.push_back(key);
+        } else {
+            auto it = std::lower_bound(posting.begin(), posting.end(), key);
+            if (it == posting.end() || *it != key) {
+                posting.insert(it, key);
+            }
+        }
+    }
+}
+
+bool TrigramIndex::candidates(std::string_view needle, std::vector<uint32_t>& out) const {
+    out.clear();
+    if (needle.size() < GRAM) {
+        return false;
+    }
+
+    std::vector<uint32_t> grams;
+    extract(needle, grams);
+
+    // Gather posting lists; a missing trigram means no key can match
+    std::vector<const std::vector<uint32_t>*> lists;
+    lists.reserve(grams.size());
+    for (uint32_t gram : grams) {
+        auto it = m_postings.find(gram);
+        if (it == m_postings.end()) {
+            return true;
+        }
+        lists.push_back(&it->second);
+    }
+
+    // Intersect smallest first so the candidate set shrinks quickly
+    std::sort(lists.begin(), lists.end(),
+              [](const auto* a, const auto* b) { return a->size() < b->size(); });
+    out = *lists.front();
+    for (size_t i = 1; i < lists.size() && !out.empty(); ++i) {
+        intersect(out, *lists[i]);
+    }
+    return true;
+}
+
+size_t TrigramIndex::memory_bytes() const noexcept {
+    size_t bytes = m_postings.size() * (sizeof(uint32_t) + sizeof(std::vector<uint32_t>) + 2 * sizeof(void*));
+    for (const auto& [gram, posting] : m_postings) {
+        bytes += posting.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+} // namespace gtaf::core
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace gtaf::core {
+
+/**
+ * @brief Case-insensitive trigram posting-list index for substring search
+ *
+ * Every indexed value contributes its distinct upper-cased 3-byte windows;
+ * each trigram maps to a sorted list of keys containing it. A substring
+ * query intersects the posting lists of the needle's trigrams, smallest
+ * first, to produce a candidate set that the caller verifies against the
+ * actual values.
+ *
+ * QueryIndex keys the index by dictionary code rather than by row, so each
+ * distinct value is indexed once and the index is append-only; it is
+ * rebuilt whenever Column::compact_dictionary() renumbers the codes.
+ */
+class TrigramIndex {
+public:
+    /**
+     * @brief Minimum needle length the index can answer
+     */
+    static constexpr size_t GRAM = 3;
+
+    /**
+     * @brief Drop all postings
+     */
+    void clear();
+
+    /**
+     * @brief Add a key's value to the index
+     *
+     * Keys may be added in any order; appending ascending keys is O(1)
+     * per trigram.
+     */
+    void add(uint32_t key, std::string_view value);
+
+    /**
+     * @brief Compute candidate keys that may contain the needle
+     *
+     * @param needle Substring to search for (any case)
+     * @param out Receives candidate keys in ascending order
+     * @return false if the needle is shorter than GRAM (caller must scan)
+     */
+    bool candidates(std::string_view needle, std::vector<uint32_t>& out) const;
+
+    /**
+     * @brief Number of distinct trigrams
+     */
+    [[nodiscard]] size_t trigram_count() const noexcept { return m_postings.size(); }
+
+    /**
+     * @brief Approximate heap footprint in bytes
+     */
+    [[nodiscard]] size_t memory_bytes() const noexcept;
+
+private:
+    /**
+     * @brief Collect the distinct upper-cased trigram keys of a string
+     */
+    static void extract(std::string_view value, std::vector<uint32_t>& grams);
+
+    std::unordered_map<uint32_t, std::vector<uint32_t>> m_postings;
+    std::vector<uint32_t> m_scratch;   // Reused by add()
+};
+
+} // namespace gtaf::core
@@ -0,0 +1,43 @@
+#include "value_index.h"
+#include <algorithm>
+
+namespace gtaf::core {
+
+// ---- ValueIndex Implementation ----
+
+void ValueIndex::clear() {
+    m_postings.clear();
+    m_stale_rows = 0;
+}
+
+void ValueIndex::build(const Column& column) {
+    clear();
+    m_postings.resize(column.dictionary_size());
+    const uint32_t* codes = column.codes().data();
+    column.for_each_valid([&](uint32_t row) { m_postings[codes[row]].push_back(row); });
+}
+
+void ValueIndex::add(uint32_t code, uint32_t row) {
+    if (code >= m_postings.size()) {
+        m_postings.resize(code + 1);
+    }
+    auto& posting = m_postings[code];
+    if (posting.empty() || posting.back() < row) {
+        posting.push_back(row);
+        return;
+    }
+    auto it = std::lower_bound(posting.begin(), posting.end(), row);
+    if (it == posting.end() || *it != row) {
+        posting.insert(it, row);
+    }
+}
+
+size_t ValueIndex::memory_bytes() const noexcept {
+    size_t bytes = m_postings.capacity() * sizeof(std::vector<uint32_t>);
+    for (const auto& posting : m_postings) {
+        bytes += posting.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+} // namespace gtaf::core
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "column.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gtaf::core {
+
+/**
+ * @brief Hash-based value -> rows index over a dictionary-encoded column
+ *
+ * The column's dictionary already maps a value to its code in O(1); this
+ * index adds one sorted posting list of rows per code, so an equality or
+ * IN-list lookup costs a hash probe plus the size of the result instead
+ * of a full column scan.
+ *
+ * Removal is lazy: when a row changes value it stays in its old posting
+ * list until the next rebuild. for_each_row() filters such rows out by
+ * checking the column's current code, and stale_rows() lets the owner
+ * decide when to rebuild.
+ */
+class ValueIndex {
+public:
+    /**
+     * @brief Drop all postings
+     */
+    void clear();
+
+    /**
+     * @brief Rebuild postings from every valid row of a string column
+     */
+    void build(const Column& column);
+
+    /**
+     * @brief Add a row to the posting list of a code
+     *
+     * Appending ascending rows is O(1); out-of-order rows are inserted.
+     */
+    void add(uint32_t code, uint32_t row);
+
+    /**
+     * @brief Record that a row's previously indexed value was replaced
+     */
+    void mark_stale() noexcept { ++m_stale_rows; }
+
+    /**
+     * @brief Number of replaced values still present in posting lists
+     */
+    [[nodiscard]] size_t stale_rows() const noexcept { return m_stale_rows; }
+
+    /**
+     * @brief Number of rows (including stale ones) listed under a code
+     */
+    [[nodiscard]] size_t posting_size(uint32_t code) const noexcept {
+        return code < m_postings.size() ? m_postings[code].size() : 0;
+    }
+
+    /**
+     * @brief Invoke fn(row) for every row currently holding a code
+     */
+    template<typename Fn>
+    void for_each_row(uint32_t code, const Column& column, Fn&& fn) const {
+        if (code >= m_postings.size()) {
+            return;
+        }
+        const uint32_t* codes = column.codes().data();
+        for (uint32_t row : m_postings[code]) {
+            if (column.is_valid(row) && codes[row] == code) {
+                fn(row);
+            }
+        }
+    }
+
+    /**
+     * @brief Approximate heap footprint in bytes
+     */
+    [[nodiscard]] size_t memory_bytes() const noexcept;
+
+private:
+    std::vector<std::vector<uint32_t>> m_postings;  // Indexed by dictionary code
+    size_t m_stale_rows = 0;
+};
+
+} // namespace gtaf::core
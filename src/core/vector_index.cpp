@@ -0,0 +1,895 @@
+#include "vector_index.h"
+#include "persistence.h"
+#include "vector_kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+namespace gtaf::core {
+
+namespace {
+
+// VectorIndex file format version (bump on layout changes); version 1
+// files predate row encodings and hold float32 rows
+constexpr uint32_t kVectorFormatVersion = 2;
+
+// Tombstoned rows tolerated before compact(): at least this many, or as
+// many as there are live rows
+constexpr size_t kMinTombstones = 1024;
+
+constexpr uint32_t kMaxLevel = 31;
+
+// Distance to a row whose atom the store dropped (Atoms encoding)
+constexpr float kUnreachable = std::numeric_limits<float>::infinity();
+
+} // namespace
+
+VectorIndex::VectorIndex(const AtomStore& store)
+    : m_store(store) {}
+
+VectorIndex::~VectorIndex() {
+    unsubscribe();
+}
+
+// ---- Build and maintenance ----
+
+size_t VectorIndex::build(const std::string& tag, const Options& options) {
+    m_tag = tag;
+    m_options = options;
+    m_options.max_links = std::max<uint32_t>(m_options.max_links, 2);
+    m_options.ef_construction = std::max(m_options.ef_construction, m_options.max_links);
+    m_dimension = 0;
+    m_rows = Rows{};
+    m_positions_layout = m_store.layout_version();
+    m_row_ordinals.clear();
+    m_row_live.clear();
+    m_live_count = 0;
+    m_levels.clear();
+    m_layer0.clear();
+    m_upper.clear();
+    m_entry = kNoRow;
+    m_max_level = 0;
+
+    const size_t entity_count = m_store.entity_count();
+    m_ordinal_rows.assign(entity_count, kNoRow);
+
+    // Latest reference with the tag wins (per-entity refs are in LSN order)
+    for (uint32_t ordinal = 0; ordinal < entity_count; ++ordinal) {
+        const auto& refs = m_store.get_entity_atoms_at(ordinal);
+        for (auto it = refs.rbegin(); it != refs.rend(); ++it) {
+            const Atom* atom = m_store.get_atom(*it);
+            if (atom && atom->type_tag() == m_tag) {
+                update_at(ordinal, atom->value(), *it);
+                break;
+            }
+        }
+    }
+
+    m_applied_lsn = m_store.current_lsn().value;
+    return m_live_count;
+}
+
+bool VectorIndex::update(const types::EntityId& entity, const types::AtomValue& value) {
+    auto ordinal = m_store.find_ordinal(entity);
+    if (!ordinal) {
+        return false;
+    }
+    const AtomReference* ref = m_store.latest_ref_at(*ordinal, m_tag);
+    if (m_options.encoding == VectorEncoding::Atoms) {
+        const Atom* atom = ref ? m_store.get_atom(*ref) : nullptr;
+        const auto* stored = atom ? std::get_if<types::Vector>(&atom->value()) : nullptr;
+        const auto* given = std::get_if<types::Vector>(&value);
+        if (given && (!stored || *stored != *given)) {
+            return false;
+        }
+    }
+    return update_at(*ordinal, value, ref ? *ref : AtomReference{});
+}
+
+bool VectorIndex::update_at(uint32_t ordinal, const types::AtomValue& value, const AtomReference& ref) {
+    if (ordinal >= m_ordinal_rows.size()) {
+        m_ordinal_rows.resize(std::max<size_t>(ordinal + 1, m_store.entity_count()), kNoRow);
+    }
+
+    const auto* vector = std::get_if<types::Vector>(&value);
+    if (!vector || vector->empty() || (m_dimension != 0 && vector->size() != m_dimension)) {
+        return remove_at(ordinal);
+    }
+    if (m_dimension == 0) {
+        m_dimension = vector->size();
+    }
+
+    Probe probe = make_probe(*vector);
+    probe.ref = ref;
+
+    // Re-asserting the same embedding keeps the row (pointed at the newest copy)
+    const uint32_t current = m_ordinal_rows[ordinal];
+    if (current != kNoRow && row_equals(current, probe)) {
+        if (m_options.encoding == VectorEncoding::Atoms) {
+            resolve_positions();
+            m_rows.refs[current] = ref;
+            m_rows.positions[current] = position_of(ref);
+        }
+        return false;
+    }
+
+    remove_at(ordinal);
+    insert_row(ordinal, probe);
+
+    if (m_row_ordinals.size() - m_live_count > std::max(kMinTombstones, m_live_count)) {
+        compact();
+    }
+    return true;
+}
+
+bool VectorIndex::remove_at(uint32_t ordinal) {
+    const uint32_t row = m_ordinal_rows[ordinal];
+    if (row == kNoRow) {
+        return false;
+    }
+    m_row_live[row] = 0;
+    m_ordinal_rows[ordinal] = kNoRow;
+    --m_live_count;
+    return true;
+}
+
+void VectorIndex::insert_row(uint32_t ordinal, const Probe& probe) {
+    const auto row = static_cast<uint32_t>(m_row_ordinals.size());
+    switch (m_options.encoding) {
+        case VectorEncoding::Float32:
+            m_rows.floats.insert(m_rows.floats.end(), probe.values.begin(), probe.values.end());
+            break;
+        case VectorEncoding::Float16:
+            m_rows.halves.insert(m_rows.halves.end(), probe.halves.begin(), probe.halves.end());
+            break;
+        case VectorEncoding::Int8:
+            m_rows.codes.insert(m_rows.codes.end(), probe.codes.begin(), probe.codes.end());
+            m_rows.scales.push_back(probe.scale);
+            m_rows.norms.push_back(probe.norm);
+            break;
+        case VectorEncoding::Atoms:
+            resolve_positions();
+            m_rows.refs.push_back(probe.ref);
+            m_rows.positions.push_back(position_of(probe.ref));
+            m_rows.norms.push_back(probe.norm);
+            break;
+    }
+    m_row_ordinals.push_back(ordinal);
+    m_row_live.push_back(1);
+    m_ordinal_rows[ordinal] = row;
+    ++m_live_count;
+
+    if (m_options.approximate) {
+        link_row(row);
+    }
+}
+
+void VectorIndex::compact() {
+    Rows rows = std::move(m_rows);
+    std::vector<uint32_t> row_ordinals = std::move(m_row_ordinals);
+    std::vector<uint8_t> row_live = std::move(m_row_live);
+
+    m_rows = Rows{};
+    m_positions_layout = m_store.layout_version();
+    m_row_ordinals.clear();
+    m_row_live.clear();
+    m_live_count = 0;
+    m_levels.clear();
+    m_layer0.clear();
+    m_upper.clear();
+    m_entry = kNoRow;
+    m_max_level = 0;
+    std::fill(m_ordinal_rows.begin(), m_ordinal_rows.end(), kNoRow);
+
+    for (size_t row = 0; row < row_ordinals.size(); ++row) {
+        if (!row_live[row]) {
+            continue;
+        }
+        Probe probe = probe_from(rows, static_cast<uint32_t>(row));
+        if (probe.values.empty()) {
+            continue;   // Atoms: the store dropped the row's atom
+        }
+        insert_row(row_ordinals[row], probe);
+    }
+}
+
+size_t VectorIndex::apply(const std::vector<AtomStore::AppendEvent>& events) {
+    if (m_options.encoding == VectorEncoding::Atoms) {
+        resolve_positions();
+    }
+    size_t applied = 0;
+    for (const auto& event : events) {
+        if (event.lsn.value <= m_applied_lsn) {
+            continue;
+        }
+        if (event.atom->type_tag() == m_tag &&
+            update_at(event.ordinal, event.atom->value(), {event.atom->atom_id(), event.lsn})) {
+            ++applied;
+        }
+        m_applied_lsn = event.lsn.value;
+    }
+    return applied;
+}
+
+void VectorIndex::subscribe(AtomStore& store) {
+    unsubscribe();
+    catch_up();
+    m_subscribed_store = &store;
+    m_listener_id = store.add_append_listener(
+        [this](const std::vector<AtomStore::AppendEvent>& events) { apply(events); },
+        [this] {
+            // A load restarts ordinals and LSNs: rebuild with the same settings
+            const std::string tag = m_tag;
+            const Options options = m_options;
+            build(tag, options);
+        });
+}
+
+void VectorIndex::unsubscribe() {
+    if (m_subscribed_store) {
+        m_subscribed_store->remove_append_listener(m_listener_id);
+        m_subscribed_store = nullptr;
+        m_listener_id = 0;
+    }
+}
+
+size_t VectorIndex::catch_up() {
+    if (m_store.current_lsn().value <= m_applied_lsn) {
+        return 0;
+    }
+
+    // Per-entity references are in LSN order, so only each tail needs walking
+    std::vector<AtomStore::AppendEvent> events;
+    const size_t count = m_store.entity_count();
+    for (uint32_t ordinal = 0; ordinal < count; ++ordinal) {
+        const auto& refs = m_store.get_entity_atoms_at(ordinal);
+        for (auto it = refs.rbegin(); it != refs.rend() && it->lsn.value > m_applied_lsn; ++it) {
+            const Atom* atom = m_store.get_atom(*it);
+            if (atom && atom->type_tag() == m_tag) {
+                events.push_back({m_store.entity_at(ordinal), ordinal, atom, it->lsn});
+            }
+        }
+    }
+    std::sort(events.begin(), events.end(),
+              [](const auto& a, const auto& b) { return a.lsn < b.lsn; });
+
+    size_t applied = apply(events);
+    m_applied_lsn = m_store.current_lsn().value;
+    return applied;
+}
+
+// ---- Search ----
+
+VectorIndex::Probe VectorIndex::make_probe(std::span<const float> values) const {
+    Probe probe;
+    probe.values.assign(values.begin(), values.end());
+    const float squared_norm = kernels::dot(probe.values.data(), probe.values.data(), probe.values.size());
+    if (m_options.metric == VectorMetric::Cosine) {
+        const float norm = std::sqrt(squared_norm);
+        if (norm > 0.0f) {
+            for (float& value : probe.values) value /= norm;
+        }
+    }
+
+    switch (m_options.encoding) {
+        case VectorEncoding::Float32:
+            break;
+        case VectorEncoding::Atoms:
+            probe.norm = squared_norm;   // Of the stored values, which stay unnormalized
+            break;
+        case VectorEncoding::Float16:
+            probe.halves.resize(probe.values.size());
+            for (size_t i = 0; i < probe.values.size(); ++i) {
+                probe.halves[i] = kernels::float_to_half(probe.values[i]);
+            }
+            break;
+        case VectorEncoding::Int8: {
+            // Symmetric: the largest magnitude maps to +-127
+            float largest = 0.0f;
+            for (float value : probe.values) largest = std::max(largest, std::abs(value));
+            probe.scale = largest > 0.0f ? largest / 127.0f : 0.0f;
+            probe.codes.resize(probe.values.size());
+            for (size_t i = 0; i < probe.values.size(); ++i) {
+                const float code = probe.scale > 0.0f ? std::round(probe.values[i] / probe.scale) : 0.0f;
+                probe.codes[i] = static_cast<int8_t>(std::clamp(code, -127.0f, 127.0f));
+            }
+            probe.norm = probe.scale * probe.scale *
+                         static_cast<float>(kernels::dot_i8(probe.codes.data(), probe.codes.data(), probe.codes.size()));
+            break;
+        }
+    }
+    return probe;
+}
+
+VectorIndex::Probe VectorIndex::probe_from(const Rows& rows, uint32_t row) const {
+    Probe probe;
+    const size_t begin = static_cast<size_t>(row) * m_dimension;
+    switch (m_options.encoding) {
+        case VectorEncoding::Float32:
+            probe.values.assign(rows.floats.begin() + begin, rows.floats.begin() + begin + m_dimension);
+            break;
+        case VectorEncoding::Float16:
+            probe.halves.assign(rows.halves.begin() + begin, rows.halves.begin() + begin + m_dimension);
+            probe.values.resize(m_dimension);
+            for (size_t i = 0; i < m_dimension; ++i) {
+                probe.values[i] = kernels::half_to_float(probe.halves[i]);
+            }
+            break;
+        case VectorEncoding::Int8:
+            probe.codes.assign(rows.codes.begin() + begin, rows.codes.begin() + begin + m_dimension);
+            probe.scale = rows.scales[row];
+            probe.norm = rows.norms[row];
+            probe.values.resize(m_dimension);
+            for (size_t i = 0; i < m_dimension; ++i) {
+                probe.values[i] = probe.codes[i] * probe.scale;
+            }
+            break;
+        case VectorEncoding::Atoms:
+            if (const float* values = atom_values(rows.refs[row])) {
+                probe = make_probe(std::span<const float>(values, m_dimension));
+            }
+            probe.ref = rows.refs[row];
+            break;
+    }
+    return probe;
+}
+
+size_t VectorIndex::position_of(const AtomReference& ref) const {
+    auto position = m_store.atom_position(ref);
+    if (!position) {
+        return kNoPosition;
+    }
+    const auto* vector = std::get_if<types::Vector>(&m_store.atom_at(*position).value());
+    return vector && vector->size() == m_dimension ? *position : kNoPosition;
+}
+
+const float* VectorIndex::atom_values(const AtomReference& ref) const {
+    const size_t position = position_of(ref);
+    return position == kNoPosition ? nullptr
+                                   : std::get<types::Vector>(m_store.atom_at(position).value()).data();
+}
+
+const float* VectorIndex::row_values(uint32_t row) const {
+    const size_t position = m_rows.positions[row];
+    if (m_positions_layout != m_store.layout_version() || position == kNoPosition) {
+        return atom_values(m_rows.refs[row]);
+    }
+    return std::get<types::Vector>(m_store.atom_at(position).value()).data();
+}
+
+void VectorIndex::resolve_positions() {
+    if (m_positions_layout == m_store.layout_version()) {
+        return;
+    }
+    for (size_t row = 0; row < m_rows.refs.size(); ++row) {
+        m_rows.positions[row] = position_of(m_rows.refs[row]);
+    }
+    m_positions_layout = m_store.layout_version();
+}
+
+bool VectorIndex::row_equals(uint32_t row, const Probe& probe) const {
+    const size_t begin = static_cast<size_t>(row) * m_dimension;
+    switch (m_options.encoding) {
+        case VectorEncoding::Float32:
+            return std::equal(probe.values.begin(), probe.values.end(), m_rows.floats.begin() + begin);
+        case VectorEncoding::Float16:
+            return std::equal(probe.halves.begin(), probe.halves.end(), m_rows.halves.begin() + begin);
+        case VectorEncoding::Int8:
+            return probe.scale == m_rows.scales[row] &&
+                   std::equal(probe.codes.begin(), probe.codes.end(), m_rows.codes.begin() + begin);
+        case VectorEncoding::Atoms: {
+            const float* current = row_values(row);
+            const float* next = atom_values(probe.ref);
+            return current && next && std::equal(next, next + m_dimension, current);
+        }
+    }
+    return false;
+}
+
+float VectorIndex::distance(const Probe& probe, uint32_t row) const {
+    const size_t begin = static_cast<size_t>(row) * m_dimension;
+    const float* values = probe.values.data();
+
+    // Squared L2 directly where the kernel exists, otherwise via the dot product
+    float dot = 0.0f;
+    switch (m_options.encoding) {
+        case VectorEncoding::Float32:
+            if (m_options.metric == VectorMetric::L2) {
+                return kernels::squared_l2(values, m_rows.floats.data() + begin, m_dimension);
+            }
+            dot = kernels::dot(values, m_rows.floats.data() + begin, m_dimension);
+            break;
+        case VectorEncoding::Float16:
+            if (m_options.metric == VectorMetric::L2) {
+                return kernels::squared_l2_f16(values, m_rows.halves.data() + begin, m_dimension);
+            }
+            dot = kernels::dot_f16(values, m_rows.halves.data() + begin, m_dimension);
+            break;
+        case VectorEncoding::Int8:
+            dot = probe.scale * m_rows.scales[row] *
+                  static_cast<float>(kernels::dot_i8(probe.codes.data(), m_rows.codes.data() + begin, m_dimension));
+            if (m_options.metric == VectorMetric::L2) {
+                return std::max(0.0f, probe.norm + m_rows.norms[row] - 2.0f * dot);
+            }
+            break;
+        case VectorEncoding::Atoms: {
+            const float* stored = row_values(row);
+            if (!stored) {
+                return kUnreachable;
+            }
+            if (m_options.metric == VectorMetric::L2) {
+                return kernels::squared_l2(values, stored, m_dimension);
+            }
+            dot = kernels::dot(values, stored, m_dimension);
+            if (m_options.metric == VectorMetric::Cosine && m_rows.norms[row] > 0.0f) {
+                dot /= std::sqrt(m_rows.norms[row]);   // Stored values are not normalized
+            }
+            break;
+        }
+    }
+    return m_options.metric == VectorMetric::Cosine ? 1.0f - dot : -dot;
+}
+
+std::optional<types::Vector> VectorIndex::vector_at(uint32_t ordinal) const {
+    if (ordinal >= m_ordinal_rows.size() || m_ordinal_rows[ordinal] == kNoRow) {
+        return std::nullopt;
+    }
+    return row_probe(m_ordinal_rows[ordinal]).values;
+}
+
+std::vector<VectorMatch> VectorIndex::search_exact(std::span<const float> query, size_t k) const {
+    std::vector<VectorMatch> matches;
+    if (k == 0 || m_dimension == 0 || query.size() != m_dimension) {
+        return matches;
+    }
+    const Probe q = make_probe(query);
+
+    // Max-heap of the k best rows seen so far
+    std::priority_queue<Candidate> best;
+    const auto rows = static_cast<uint32_t>(m_row_ordinals.size());
+    for (uint32_t row = 0; row < rows; ++row) {
+        if (!m_row_live[row]) {
+            continue;
+        }
+        const float d = distance(q, row);
+        if (d == kUnreachable) {
+            continue;
+        }
+        if (best.size() < k) {
+            best.push({d, row});
+        } else if (d < best.top().distance) {
+            best.pop();
+            best.push({d, row});
+        }
+    }
+
+    matches.resize(best.size());
+    for (size_t i = matches.size(); i-- > 0;) {
+        matches[i] = {m_row_ordinals[best.top().row], best.top().distance};
+        best.pop();
+    }
+    return matches;
+}
+
+std::vector<VectorMatch> VectorIndex::search(std::span<const float> query, size_t k, size_t ef) const {
+    if (!m_options.approximate) {
+        return search_exact(query, k);
+    }
+    std::vector<VectorMatch> matches;
+    if (k == 0 || m_entry == kNoRow || query.size() != m_dimension) {
+        return matches;
+    }
+    const Probe q = make_probe(query);
+
+    // Greedy descent through the upper layers, then a wide search on layer 0
+    std::vector<Candidate> entry = {{distance(q, m_entry), m_entry}};
+    for (uint32_t level = m_max_level; level > 0; --level) {
+        entry = search_layer(q, entry, 1, level);
+    }
+    const size_t width = std::max(k, ef > 0 ? ef : static_cast<size_t>(m_options.ef_search));
+    for (const auto& candidate : search_layer(q, entry, width, 0)) {
+        if (m_row_live[candidate.row] && candidate.distance != kUnreachable) {
+            matches.push_back({m_row_ordinals[candidate.row], candidate.distance});
+            if (matches.size() == k) break;
+        }
+    }
+    return matches;
+}
+
+// ---- HNSW ----
+
+uint32_t* VectorIndex::links(uint32_t row, uint32_t level) {
+    return const_cast<uint32_t*>(std::as_const(*this).links(row, level));
+}
+
+const uint32_t* VectorIndex::links(uint32_t row, uint32_t level) const {
+    if (level == 0) {
+        return m_layer0.data() + static_cast<size_t>(row) * (link_capacity(0) + 1);
+    }
+    return m_upper[row].data() + static_cast<size_t>(level - 1) * (link_capacity(level) + 1);
+}
+
+void VectorIndex::link_row(uint32_t row) {
+    // Level drawn from an exponential distribution with mean 1 / ln(M)
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const double scale = 1.0 / std::log(static_cast<double>(m_options.max_links));
+    const auto level = static_cast<uint32_t>(
+        std::min<double>(kMaxLevel, std::floor(-std::log(1.0 - uniform(m_rng)) * scale)));
+
+    m_levels.push_back(static_cast<uint8_t>(level));
+    m_layer0.resize(m_layer0.size() + link_capacity(0) + 1, 0);
+    m_upper.emplace_back(static_cast<size_t>(level) * (link_capacity(1) + 1), 0);
+
+    if (m_entry == kNoRow) {
+        m_entry = row;
+        m_max_level = level;
+        return;
+    }
+
+    const Probe q = row_probe(row);
+    std::vector<Candidate> entry = {{distance(q, m_entry), m_entry}};
+    for (uint32_t lc = m_max_level; lc > level; --lc) {
+        entry = search_layer(q, entry, 1, lc);
+    }
+
+    for (uint32_t lc = std::min(level, m_max_level) + 1; lc-- > 0;) {
+        auto found = search_layer(q, entry, m_options.ef_construction, lc);
+        auto chosen = select_neighbours(found, m_options.max_links);
+
+        uint32_t* own = links(row, lc);
+        own[0] = static_cast<uint32_t>(chosen.size());
+        std::copy(chosen.begin(), chosen.end(), own + 1);
+
+        // Back-links; full lists are re-pruned with the same heuristic
+        const uint32_t capacity = link_capacity(lc);
+        for (uint32_t neighbour : chosen) {
+            uint32_t* list = links(neighbour, lc);
+            if (list[0] < capacity) {
+                list[1 + list[0]++] = row;
+                continue;
+            }
+            const Probe base = row_probe(neighbour);
+            if (base.values.empty()) {
+                continue;   // Atoms: the store dropped the neighbour's atom
+            }
+            std::vector<Candidate> pool;
+            pool.reserve(capacity + 1);
+            pool.push_back({distance(base, row), row});
+            for (uint32_t i = 0; i < list[0]; ++i) {
+                pool.push_back({distance(base, list[1 + i]), list[1 + i]});
+            }
+            std::sort(pool.begin(), pool.end());
+            auto kept = select_neighbours(pool, capacity);
+            list[0] = static_cast<uint32_t>(kept.size());
+            std::copy(kept.begin(), kept.end(), list + 1);
+        }
+        entry = std::move(found);
+    }
+
+    if (level > m_max_level) {
+        m_max_level = level;
+        m_entry = row;
+    }
+}
+
+std::vector<VectorIndex::Candidate> VectorIndex::search_layer(const Probe& query, const std::vector<Candidate>& entry,
+                                                              size_t ef, uint32_t level) const {
+    std::vector<uint64_t> visited((m_row_ordinals.size() + 63) / 64, 0);
+    auto visit = [&](uint32_t row) {
+        uint64_t& word = visited[row >> 6];
+        const uint64_t bit = uint64_t{1} << (row & 63);
+        const bool fresh = (word & bit) == 0;
+        word |= bit;
+        return fresh;
+    };
+
+    // Min-heap of rows to expand, max-heap of the ef best found
+    auto farther = [](const Candidate& a, const Candidate& b) { return b < a; };
+    std::priority_queue<Candidate, std::vector<Candidate>, decltype(farther)> frontier(farther);
+    std::priority_queue<Candidate> best;
+    for (const auto& candidate : entry) {
+        if (visit(candidate.row)) {
+            frontier.push(candidate);
+            best.push(candidate);
+        }
+    }
+    while (best.size() > ef) best.pop();
+
+    while (!frontier.empty()) {
+        const Candidate current = frontier.top();
+        if (best.size() >= ef && current.distance > best.top().distance) {
+            break;
+        }
+        frontier.pop();
+
+        const uint32_t* list = links(current.row, level);
+        for (uint32_t i = 0; i < list[0]; ++i) {
+            const uint32_t next = list[1 + i];
+            if (!visit(next)) {
+                continue;
+            }
+            const float d = distance(query, next);
+            if (d == kUnreachable) {
+                continue;
+            }
+            if (best.size() < ef || d < best.top().distance) {
+                frontier.push({d, next});
+                best.push({d, next});
+                if (best.size() > ef) best.pop();
+            }
+        }
+    }
+
+    std::vector<Candidate> result(best.size());
+    for (size_t i = result.size(); i-- > 0;) {
+        result[i] = best.top();
+        best.pop();
+    }
+    return result;
+}
+
+std::vector<uint32_t> VectorIndex::select_neighbours(const std::vector<Candidate>& candidates, uint32_t count) const {
+    // Keep a candidate only if it is closer to the base than to every
+    // neighbour already kept; top up with the closest skipped ones
+    std::vector<uint32_t> chosen;
+    std::vector<uint32_t> skipped;
+    for (const auto& candidate : candidates) {
+        if (chosen.size() >= count) break;
+        if (candidate.distance == kUnreachable) {
+            continue;   // Never link to a row whose atom the store dropped
+        }
+        bool diverse = true;
+        if (!chosen.empty()) {
+            const Probe probe = row_probe(candidate.row);
+            if (probe.values.empty()) {
+                continue;
+            }
+            for (uint32_t kept : chosen) {
+                if (distance(probe, kept) < candidate.distance) {
+                    diverse = false;
+                    break;
+                }
+            }
+        }
+        (diverse ? chosen : skipped).push_back(candidate.row);
+    }
+    for (size_t i = 0; i < skipped.size() && chosen.size() < count; ++i) {
+        chosen.push_back(skipped[i]);
+    }
+    return chosen;
+}
+
+// ---- Persistence ----
+
+bool VectorIndex::save(const std::string& filepath) const {
+    try {
+        BinaryWriter writer(filepath);
+
+        writer.write_bytes("GTVI", 4);  // Magic
+        writer.write_u32(kVectorFormatVersion);
+        writer.write_u64(m_applied_lsn);
+
+        // Store ordinal table the rows refer to (validated against the store on load)
+        const auto& entities = m_store.entities();
+        writer.write_u64(entities.size());
+        writer.write_bytes(entities.data(), entities.size() * sizeof(types::EntityId));
+
+        writer.write_string(m_tag);
+        writer.write_u8(static_cast<uint8_t>(m_options.metric));
+        writer.write_u8(static_cast<uint8_t>(m_options.encoding));
+        writer.write_u8(m_options.approximate ? 1 : 0);
+        writer.write_u32(m_options.max_links);
+        writer.write_u32(m_options.ef_construction);
+        writer.write_u32(m_options.ef_search);
+        writer.write_u64(m_dimension);
+
+        // Matrix rows, including tombstones (the graph still routes through them)
+        const size_t rows = m_row_ordinals.size();
+        writer.write_u64(rows);
+        writer.write_bytes(m_row_ordinals.data(), rows * sizeof(uint32_t));
+        writer.write_bytes(m_row_live.data(), rows);
+        writer.write_bytes(m_rows.floats.data(), m_rows.floats.size() * sizeof(float));
+        writer.write_bytes(m_rows.halves.data(), m_rows.halves.size() * sizeof(uint16_t));
+        writer.write_bytes(m_rows.codes.data(), m_rows.codes.size());
+        writer.write_bytes(m_rows.scales.data(), m_rows.scales.size() * sizeof(float));
+        writer.write_bytes(m_rows.norms.data(), m_rows.norms.size() * sizeof(float));
+        writer.write_bytes(m_rows.refs.data(), m_rows.refs.size() * sizeof(AtomReference));
+
+        if (m_options.approximate) {
+            writer.write_u32(m_entry);
+            writer.write_u32(m_max_level);
+            writer.write_bytes(m_levels.data(), m_levels.size());
+            writer.write_bytes(m_layer0.data(), m_layer0.size() * sizeof(uint32_t));
+            for (const auto& upper : m_upper) {
+                writer.write_bytes(upper.data(), upper.size() * sizeof(uint32_t));
+            }
+        }
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to save vector index: " << e.what() << "\n";
+        return false;
+    }
+}
+
+bool VectorIndex::load(const std::string& filepath) {
+    try {
+        MappedFile file(filepath);
+        MemoryReader reader(file.data(), file.size());
+
+        char magic[4];
+        reader.read_bytes(magic, 4);
+        if (std::memcmp(magic, "GTVI", 4) != 0) {
+            std::cerr << "Invalid vector index file format (bad magic)\n";
+            return false;
+        }
+        uint32_t version = reader.read_u32();
+        if (version != 1 && version != kVectorFormatVersion) {
+            std::cerr << "Unsupported vector index version: " << version
+                      << " (expected " << kVectorFormatVersion << ")\n";
+            return false;
+        }
+        uint64_t applied_lsn = reader.read_u64();
+        if (applied_lsn > m_store.current_lsn().value) {
+            std::cerr << "Vector index is newer than the store (LSN " << applied_lsn << " > "
+                      << m_store.current_lsn().value << ")\n";
+            return false;
+        }
+
+        // Rows are store ordinals: the saved table must be a prefix of the store's
+        std::vector<types::EntityId> entities;
+        reader.read_array(entities, reader.read_u64());
+        if (entities.size() > m_store.entity_count() ||
+            !std::equal(entities.begin(), entities.end(), m_store.entities().begin())) {
+            std::cerr << "Vector index entity ordinals do not match the store\n";
+            return false;
+        }
+
+        // Everything is staged in a scratch index and swapped in once parsed
+        VectorIndex staged(m_store);
+        staged.m_tag = reader.read_string();
+        uint8_t metric = reader.read_u8();
+        if (metric > static_cast<uint8_t>(VectorMetric::InnerProduct)) {
+            throw std::runtime_error("Unknown vector metric");
+        }
+        staged.m_options.metric = static_cast<VectorMetric>(metric);
+        uint8_t encoding = version >= 2 ? reader.read_u8() : 0;
+        if (encoding > static_cast<uint8_t>(VectorEncoding::Atoms)) {
+            throw std::runtime_error("Unknown vector encoding");
+        }
+        staged.m_options.encoding = static_cast<VectorEncoding>(encoding);
+        staged.m_options.approximate = reader.read_u8() != 0;
+        staged.m_options.max_links = reader.read_u32();
+        staged.m_options.ef_construction = reader.read_u32();
+        staged.m_options.ef_search = reader.read_u32();
+        staged.m_dimension = reader.read_u64();
+        if (staged.m_options.max_links < 2 || staged.m_options.max_links > 1024) {
+            throw std::runtime_error("Invalid HNSW link count");
+        }
+
+        const uint64_t rows = reader.read_u64();
+        if (rows >= kNoRow || (rows > 0 && staged.m_dimension == 0)) {
+            throw std::runtime_error("Invalid vector row count");
+        }
+        reader.read_array(staged.m_row_ordinals, rows);
+        reader.read_array(staged.m_row_live, rows);
+        if (staged.m_options.encoding != VectorEncoding::Atoms &&
+            staged.m_dimension > reader.remaining() / std::max<uint64_t>(rows, 1)) {
+            throw std::runtime_error("Unexpected end of data");
+        }
+        const size_t components = rows * staged.m_dimension;
+        switch (staged.m_options.encoding) {
+            case VectorEncoding::Float32:
+                reader.read_array(staged.m_rows.floats, components);
+                break;
+            case VectorEncoding::Float16:
+                reader.read_array(staged.m_rows.halves, components);
+                break;
+            case VectorEncoding::Int8:
+                reader.read_array(staged.m_rows.codes, components);
+                reader.read_array(staged.m_rows.scales, rows);
+                reader.read_array(staged.m_rows.norms, rows);
+                break;
+            case VectorEncoding::Atoms:
+                reader.read_array(staged.m_rows.norms, rows);
+                reader.read_array(staged.m_rows.refs, rows);
+                staged.m_rows.positions.resize(rows);
+                for (uint32_t row = 0; row < rows; ++row) {
+                    staged.m_rows.positions[row] = staged.position_of(staged.m_rows.refs[row]);
+                }
+                staged.m_positions_layout = m_store.layout_version();
+                break;
+        }
+
+        staged.m_ordinal_rows.assign(m_store.entity_count(), kNoRow);
+        for (uint32_t row = 0; row < rows; ++row) {
+            const uint32_t ordinal = staged.m_row_ordinals[row];
+            if (ordinal >= entities.size()) {
+                throw std::runtime_error("Vector row ordinal out of range");
+            }
+            if (staged.m_row_live[row]) {
+                if (staged.m_ordinal_rows[ordinal] != kNoRow) {
+                    throw std::runtime_error("Duplicate live vector row");
+                }
+                if (staged.m_options.encoding == VectorEncoding::Atoms &&
+                    staged.m_rows.positions[row] == kNoPosition) {
+                    throw std::runtime_error("Vector row atom not in the store");
+                }
+                staged.m_ordinal_rows[ordinal] = row;
+                ++staged.m_live_count;
+            }
+        }
+
+        if (staged.m_options.approximate) {
+            staged.m_entry = reader.read_u32();
+            staged.m_max_level = reader.read_u32();
+            reader.read_array(staged.m_levels, rows);
+            reader.read_array(staged.m_layer0, rows * (staged.link_capacity(0) + 1));
+            staged.m_upper.resize(rows);
+            for (uint32_t row = 0; row < rows; ++row) {
+                if (staged.m_levels[row] > kMaxLevel) {
+                    throw std::runtime_error("Invalid HNSW level");
+                }
+                reader.read_array(staged.m_upper[row],
+                                  static_cast<size_t>(staged.m_levels[row]) * (staged.link_capacity(1) + 1));
+            }
+            if (rows == 0 ? staged.m_entry != kNoRow
+                          : staged.m_entry >= rows || staged.m_levels[staged.m_entry] != staged.m_max_level) {
+                throw std::runtime_error("Invalid HNSW entry point");
+            }
+            for (uint32_t row = 0; row < rows; ++row) {
+                for (uint32_t level = 0; level <= staged.m_levels[row]; ++level) {
+                    const uint32_t* list = staged.links(row, level);
+                    bool ok = list[0] <= staged.link_capacity(level);
+                    for (uint32_t i = 0; ok && i < list[0]; ++i) {
+                        ok = list[1 + i] < rows && staged.m_levels[list[1 + i]] >= level;
+                    }
+                    if (!ok) {
+                        throw std::runtime_error("Invalid HNSW links");
+                    }
+                }
+            }
+        }
+
+        m_tag = std::move(staged.m_tag);
+        m_options = staged.m_options;
+        m_dimension = staged.m_dimension;
+        m_rows = std::move(staged.m_rows);
+        m_positions_layout = staged.m_positions_layout;
+        m_row_ordinals = std::move(staged.m_row_ordinals);
+        m_row_live = std::move(staged.m_row_live);
+        m_ordinal_rows = std::move(staged.m_ordinal_rows);
+        m_live_count = staged.m_live_count;
+        m_levels = std::move(staged.m_levels);
+        m_layer0 = std::move(staged.m_layer0);
+        m_upper = std::move(staged.m_upper);
+        m_entry = staged.m_entry;
+        m_max_level = staged.m_max_level;
+        m_applied_lsn = applied_lsn;
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to load vector index: " << e.what() << "\n";
+        return false;
+    }
+
+    catch_up();
+    return true;
+}
+
+size_t VectorIndex::memory_bytes() const noexcept {
+    size_t bytes = (m_rows.floats.capacity() + m_rows.scales.capacity() + m_rows.norms.capacity()) * sizeof(float) +
+                   m_rows.halves.capacity() * sizeof(uint16_t) + m_rows.codes.capacity() +
+                   m_rows.refs.capacity() * sizeof(AtomReference) + m_rows.positions.capacity() * sizeof(size_t) +
+                   (m_row_ordinals.capacity() + m_ordinal_rows.capacity() + m_layer0.capacity()) * sizeof(uint32_t) +
+                   m_row_live.capacity() + m_levels.capacity() +
+                   m_upper.capacity() * sizeof(std::vector<uint32_t>);
+    for (const auto& upper : m_upper) {
+        bytes += upper.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+} // namespace gtaf::core
@@ -0,0 +1,375 @@
+#pragma once
+
+#include "../types/types.h"
+#include "atom_store.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace gtaf::core {
+
+/**
+ * @brief Distance function of a VectorIndex (smaller is closer)
+ */
+enum class VectorMetric : uint8_t {
+    L2 = 0,            // Squared Euclidean distance
+    Cosine = 1,        // 1 - cosine similarity (vectors are normalized on insert)
+    InnerProduct = 2   // Negative dot product
+};
+
+/**
+ * @brief Row storage of a VectorIndex
+ *
+ * Sizes are the index's own, on top of the float32 atoms the store keeps
+ * (4 bytes per component): no encoding reduces stored embedding memory.
+ */
+enum class VectorEncoding : uint8_t {
+    Float32 = 0,   // Exact copy (4 bytes per component)
+    Float16 = 1,   // IEEE half precision (2 bytes per component)
+    Int8 = 2,      // Symmetric int8 with a per-vector scale (1 byte per component + 8 bytes)
+    Atoms = 3      // No copy: rows read the float32 atoms in the store (36 bytes per row)
+};
+
+/**
+ * @brief One k-nearest-neighbour result
+ */
+struct VectorMatch {
+    uint32_t ordinal;   // Entity ordinal (see AtomStore::entity_at())
+    float distance;
+};
+
+/**
+ * @brief k-nearest-neighbour index over the Vector values of one tag
+ *
+ * Each entity's latest Vector for the tag is copied into one contiguous
+ * row-major float matrix, so search_exact() is a single SIMD pass over
+ * memory with a bounded top-k heap. With Options::approximate the index
+ * also maintains an HNSW graph (hierarchical navigable small world) over
+ * the same rows; search() walks it in roughly O(log n) distance
+ * evaluations, trading recall for latency through the ef parameter.
+ *
+ * Options::encoding can keep the rows quantised instead: Float16 halves
+ * the matrix, Int8 (codes plus a per-row scale and squared norm) cuts it
+ * to about a quarter. Scans then read 2-4x fewer bytes; Float16 rows are
+ * widened in SIMD registers against a float32 query, and Int8 queries
+ * are quantised the same way so distances reduce to integer dot products
+ * in 16-bit lanes. vector_at() decodes a row on read. The atom log keeps
+ * the exact float32 values, so an index can always be rebuilt losslessly.
+ *
+ * The quantised encodings speed up scans; they do not shrink storage. The
+ * store always holds embeddings as float32 atoms, so a Float16 or Int8
+ * index adds 2 or 1 bytes per component on top of those 4: smaller than a
+ * Float32 index, but never below the atoms alone. Keeping embeddings
+ * quantised in the atom log itself is not supported. VectorEncoding::Atoms only avoids the
+ * extra copy: a row is the reference of the atom holding the vector, its
+ * position in the atom log and its squared norm, and distances read the
+ * float32 values in place. That removes the matrix entirely at the price
+ * of scattered reads; after the store compacts or reloads, rows resolve
+ * through its content index until the next append re-resolves their
+ * positions. Rows whose atom the store no longer holds are never returned.
+ *
+ * The dimension is fixed by the first vector indexed; values of another
+ * dimension or type clear the entity's entry. A changed vector is written
+ * to a new row and the old one is tombstoned (still used to navigate the
+ * graph, never returned); rows are repacked once tombstones outnumber
+ * live rows.
+ *
+ * Like QueryIndex, subscribe() applies every later append incrementally,
+ * and save()/load() persist the matrix and graph with the store LSN they
+ * reflect, catching up with newer appends on load.
+ */
+class VectorIndex {
+public:
+    struct Options {
+        VectorMetric metric = VectorMetric::L2;
+        VectorEncoding encoding = VectorEncoding::Float32;
+        bool approximate = true;        // Maintain the HNSW graph used by search()
+        uint32_t max_links = 16;        // HNSW M: links per node per layer (2M on layer 0)
+        uint32_t ef_construction = 100; // Candidate list size while inserting
+        uint32_t ef_search = 64;        // Default candidate list size for search()
+    };
+
+    /**
+     * @brief Construct an empty index over a store
+     *
+     * @param store Reference to the atom store (must outlive this index)
+     */
+    explicit VectorIndex(const AtomStore& store);
+
+    /**
+     * @brief Unsubscribes from the store if still subscribed
+     */
+    ~VectorIndex();
+
+    // The store listener captures this index, so it must stay in place
+    VectorIndex(const VectorIndex&) = delete;
+    VectorIndex& operator=(const VectorIndex&) = delete;
+
+    /**
+     * @brief (Re)build the index from each entity's latest value for a tag
+     *
+     * @return Number of vectors indexed
+     */
+    size_t build(const std::string& tag, const Options& options);
+    size_t build(const std::string& tag) { return build(tag, Options{}); }
+
+    [[nodiscard]] const std::string& tag() const noexcept { return m_tag; }
+    [[nodiscard]] const Options& options() const noexcept { return m_options; }
+
+    /**
+     * @brief Vector dimension (0 until the first vector is indexed)
+     */
+    [[nodiscard]] size_t dimension() const noexcept { return m_dimension; }
+
+    /**
+     * @brief Number of entities with an indexed vector
+     */
+    [[nodiscard]] size_t size() const noexcept { return m_live_count; }
+
+    /**
+     * @brief Decoded vector stored for an entity ordinal
+     *
+     * Normalized under VectorMetric::Cosine; approximate under the
+     * quantised encodings.
+     *
+     * @return Vector, or nullopt if the entity has no indexed vector
+     */
+    [[nodiscard]] std::optional<types::Vector> vector_at(uint32_t ordinal) const;
+
+    /**
+     * @brief Exact k nearest neighbours by brute-force scan, closest first
+     *
+     * Returns nothing for a query of the wrong dimension.
+     */
+    [[nodiscard]] std::vector<VectorMatch> search_exact(std::span<const float> query, size_t k) const;
+
+    /**
+     * @brief Approximate k nearest neighbours via the HNSW graph, closest first
+     *
+     * @param ef Candidate list size (0: Options::ef_search); larger values
+     *           raise recall and latency. Falls back to search_exact() when
+     *           the index was built without Options::approximate.
+     */
+    [[nodiscard]] std::vector<VectorMatch> search(std::span<const float> query, size_t k, size_t ef = 0) const;
+
+    /**
+     * @brief Apply a newer value of the indexed tag for an entity
+     *
+     * Under VectorEncoding::Atoms rows point into the store, so only the
+     * entity's latest stored value of the tag can be applied.
+     *
+     * @return true if the entity is known to the store and its entry changed
+     */
+    bool update(const types::EntityId& entity, const types::AtomValue& value);
+
+    /**
+     * @brief Apply committed references in LSN order (see QueryIndex::apply())
+     *
+     * @return Number of events that changed an entry
+     */
+    size_t apply(const std::vector<AtomStore::AppendEvent>& events);
+
+    /**
+     * @brief Apply every future append committed to a store
+     *
+     * Appends committed since the index was built (or last applied) are
+     * caught up first, so none are lost between build() and subscribe().
+     * A store load() rebuilds the index with the same tag and options.
+     * The store must be the one the index was built from and must outlive
+     * the subscription. Re-subscribing replaces any previous subscription.
+     */
+    void subscribe(AtomStore& store);
+
+    /**
+     * @brief Stop receiving appends (no-op if not subscribed)
+     */
+    void unsubscribe();
+
+    [[nodiscard]] bool is_subscribed() const noexcept { return m_subscribed_store != nullptr; }
+
+    /**
+     * @brief Highest store LSN reflected in the index
+     */
+    [[nodiscard]] types::LogSequenceNumber applied_lsn() const noexcept { return {m_applied_lsn}; }
+
+    /**
+     * @brief Apply every store reference newer than applied_lsn()
+     *
+     * @return Number of references that changed an entry
+     */
+    size_t catch_up();
+
+    /**
+     * @brief Drop tombstoned rows and rebuild the graph over the live ones
+     */
+    void compact();
+
+    /**
+     * @brief Save the matrix and graph to a binary file
+     *
+     * @return true on success, false on failure
+     */
+    bool save(const std::string& filepath) const;
+
+    /**
+     * @brief Load an index saved by save(), then catch up with the store
+     *
+     * Fails (leaving the index unchanged) if the file is malformed, has an
+     * unsupported version, reflects a later LSN than the store holds, or
+     * was saved against different entity ordinals.
+     *
+     * @return true on success, false on failure
+     */
+    bool load(const std::string& filepath);
+
+    /**
+     * @brief Approximate heap footprint in bytes
+     */
+    [[nodiscard]] size_t memory_bytes() const noexcept;
+
+private:
+    static constexpr uint32_t kNoRow = 0xFFFFFFFFu;
+    static constexpr size_t kNoPosition = static_cast<size_t>(-1);
+
+    struct Candidate {
+        float distance;
+        uint32_t row;
+        bool operator<(const Candidate& other) const noexcept { return distance < other.distance; }
+    };
+
+    /**
+     * @brief Encoded row matrix (only the arrays of the active encoding are used)
+     */
+    struct Rows {
+        std::vector<float> floats;      // Float32: dimension per row
+        std::vector<uint16_t> halves;   // Float16: dimension per row
+        std::vector<int8_t> codes;      // Int8: dimension per row
+        std::vector<float> scales;      // Int8: one per row
+        std::vector<float> norms;       // Int8, Atoms: squared norm of the decoded row / atom's values
+        std::vector<AtomReference> refs; // Atoms: atom holding each row's values
+        std::vector<size_t> positions;  // Atoms: its position in the log, or kNoPosition
+    };
+
+    /**
+     * @brief One side of a distance computation, in float32 and encoded form
+     */
+    struct Probe {
+        std::vector<float> values;      // Prepared (normalized for cosine) values
+        std::vector<uint16_t> halves;   // Float16 encoding
+        std::vector<int8_t> codes;      // Int8 encoding
+        float scale = 0.0f;
+        float norm = 0.0f;
+        AtomReference ref{};            // Atoms encoding
+    };
+
+    /**
+     * @brief Prepare values for the metric and encode them
+     */
+    Probe make_probe(std::span<const float> values) const;
+
+    /**
+     * @brief Probe for a stored row (decoded, encoding copied as is)
+     */
+    Probe row_probe(uint32_t row) const { return probe_from(m_rows, row); }
+    Probe probe_from(const Rows& rows, uint32_t row) const;
+
+    float distance(const Probe& probe, uint32_t row) const;
+
+    // ---- Atoms encoding ----
+
+    /**
+     * @brief Position of the atom behind a reference in the store's log
+     *
+     * @return kNoPosition unless the store holds a vector of the index's
+     *         dimension under the reference
+     */
+    size_t position_of(const AtomReference& ref) const;
+
+    /**
+     * @brief Values of the atom behind a reference (nullptr as position_of())
+     */
+    const float* atom_values(const AtomReference& ref) const;
+
+    /**
+     * @brief A row's values, via its cached position while still valid
+     */
+    const float* row_values(uint32_t row) const;
+
+    /**
+     * @brief Re-resolve row positions after the store's layout changed
+     */
+    void resolve_positions();
+
+    bool row_equals(uint32_t row, const Probe& probe) const;
+
+    /**
+     * @brief update() by ordinal
+     *
+     * @param ref Atom holding the value (rows point at it under the Atoms encoding)
+     */
+    bool update_at(uint32_t ordinal, const types::AtomValue& value, const AtomReference& ref);
+
+    /**
+     * @brief Tombstone the entity's current row, if any
+     */
+    bool remove_at(uint32_t ordinal);
+
+    /**
+     * @brief Append a row for an entity and link it into the graph
+     */
+    void insert_row(uint32_t ordinal, const Probe& probe);
+
+    // ---- HNSW ----
+
+    uint32_t* links(uint32_t row, uint32_t level);
+    const uint32_t* links(uint32_t row, uint32_t level) const;
+    uint32_t link_capacity(uint32_t level) const { return level == 0 ? 2 * m_options.max_links : m_options.max_links; }
+
+    void link_row(uint32_t row);
+
+    /**
+     * @brief Greedy best-first search of one layer, nearest ef candidates
+     *
+     * @return Candidates sorted closest first
+     */
+    std::vector<Candidate> search_layer(const Probe& query, const std::vector<Candidate>& entry,
+                                        size_t ef, uint32_t level) const;
+
+    /**
+     * @brief HNSW neighbour selection heuristic (keeps diverse directions)
+     */
+    std::vector<uint32_t> select_neighbours(const std::vector<Candidate>& candidates, uint32_t count) const;
+
+    const AtomStore& m_store;
+    std::string m_tag;
+    Options m_options;
+    size_t m_dimension = 0;
+
+    // Row-major matrix; rows are never reordered except by compact()
+    Rows m_rows;
+    std::vector<uint32_t> m_row_ordinals;   // Row -> entity ordinal
+    std::vector<uint8_t> m_row_live;        // 0 = tombstone
+    std::vector<uint32_t> m_ordinal_rows;   // Entity ordinal -> live row or kNoRow
+    uint64_t m_positions_layout = 0;        // Store layout_version() of Rows::positions
+    size_t m_live_count = 0;
+
+    // HNSW graph: per row a top level, a fixed-width layer-0 link block
+    // ([count, links...]) and concatenated blocks for the upper levels
+    std::vector<uint8_t> m_levels;
+    std::vector<uint32_t> m_layer0;
+    std::vector<std::vector<uint32_t>> m_upper;
+    uint32_t m_entry = kNoRow;
+    uint32_t m_max_level = 0;
+    std::mt19937 m_rng{0x5eed};
+
+    // Incremental maintenance
+    uint64_t m_applied_lsn = 0;
+    AtomStore* m_subscribed_store = nullptr;
+    AtomStore::ListenerId m_listener_id = 0;
+};
+
+} // namespace gtaf::core
@@ -0,0 +1,373 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define GTAF_VECTOR_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define GTAF_VECTOR_SSE2 1
+#endif
+
+namespace gtaf::core::kernels {
+
+/**
+ * @brief Distance kernels used by VectorIndex
+ *
+ * Compiled to AVX2/FMA when the build enables it (-mavx2 -mfma or
+ * /arch:AVX2), SSE2 on any other x86-64 target, and to an 8-lane
+ * portable loop elsewhere. All variants accumulate in independent lanes,
+ * so results may differ from a sequential sum in the last bits.
+ *
+ * Besides float32 rows there are kernels for the quantised encodings:
+ * IEEE half-precision rows against a float32 query, widened in registers
+ * (with F16C when available, otherwise by shifting the bits into place and
+ * rescaling, see widen_half()), and int8 rows against an int8 query,
+ * multiplied in 16-bit lanes and accumulated in 32-bit lanes (exact up to
+ * ~130k dimensions).
+ */
+
+/**
+ * @brief IEEE 754 binary16 to float32 (exact)
+ */
+inline float half_to_float(uint16_t half) {
+    const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+    uint32_t exponent = (half >> 10) & 0x1Fu;
+    uint32_t mantissa = half & 0x3FFu;
+    uint32_t bits;
+    if (exponent == 0x1F) {
+        bits = sign | 0x7F800000u | (mantissa << 13);          // Inf / NaN
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        bits = sign;
+    } else {
+        exponent = 113;                                         // Subnormal: normalize
+        while ((mantissa & 0x400u) == 0) {
+            mantissa <<= 1;
+            --exponent;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+    }
+    return std::bit_cast<float>(bits);
+}
+
+/**
+ * @brief Branch-free binary16 to float32, as used by the kernels without F16C
+ *
+ * The exponent and mantissa shifted into float position, multiplied by
+ * 2^112, rebias normal values and normalize subnormal ones in one step
+ * (exact unless denormals are flushed to zero); Inf/NaN only need their
+ * exponent saturated. Compilers vectorize loops over it.
+ */
+inline float widen_half(uint16_t half) {
+    const float magnitude = std::bit_cast<float>(static_cast<uint32_t>(half & 0x7FFFu) << 13) * 0x1p112f;
+    const uint32_t special = (half & 0x7C00u) == 0x7C00u ? 0x7F800000u : 0u;
+    return std::bit_cast<float>(std::bit_cast<uint32_t>(magnitude) | special |
+                                (static_cast<uint32_t>(half & 0x8000u) << 16));
+}
+
+/**
+ * @brief float32 to IEEE 754 binary16, rounding to nearest even
+ */
+inline uint16_t float_to_half(float value) {
+    const uint32_t bits = std::bit_cast<uint32_t>(value);
+    const auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    const uint32_t magnitude = bits & 0x7FFFFFFFu;
+    if (magnitude >= 0x7F800000u) {
+        return sign | (magnitude > 0x7F800000u ? 0x7E00u : 0x7C00u);
+    }
+    if (magnitude >= 0x477FF000u) {
+        return sign | 0x7C00u;                                  // Rounds past 65504
+    }
+    uint32_t half;
+    uint32_t rest;
+    uint32_t halfway;
+    if (magnitude < 0x38800000u) {                              // Half subnormal
+        if (magnitude < 0x33000000u) {
+            return sign;
+        }
+        const uint32_t shift = 126 - (magnitude >> 23);
+        const uint32_t mantissa = (magnitude & 0x7FFFFFu) | 0x800000u;
+        half = mantissa >> shift;
+        rest = mantissa & ((1u << shift) - 1);
+        halfway = 1u << (shift - 1);
+    } else {
+        half = (magnitude - 0x38000000u) >> 13;
+        rest = magnitude & 0x1FFFu;
+        halfway = 0x1000u;
+    }
+    if (rest > halfway || (rest == halfway && (half & 1u))) {
+        ++half;                                                 // Carries into the exponent
+    }
+    return sign | static_cast<uint16_t>(half);
+}
+
+#if defined(GTAF_VECTOR_AVX2)
+
+inline float horizontal_sum(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+    return _mm_cvtss_f32(sum);
+}
+
+inline float dot(const float* a, const float* b, size_t n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+    float sum = horizontal_sum(_mm256_add_ps(acc0, acc1));
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+inline float squared_l2(const float* a, const float* b, size_t n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+        acc0 = _mm256_fmadd_ps(d0, d0, acc0);
+        acc1 = _mm256_fmadd_ps(d1, d1, acc1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        acc0 = _mm256_fmadd_ps(d, d, acc0);
+    }
+    float sum = horizontal_sum(_mm256_add_ps(acc0, acc1));
+    for (; i < n; ++i) sum += (a[i] - b[i]) * (a[i] - b[i]);
+    return sum;
+}
+
+inline int32_t dot_i8(const int8_t* a, const int8_t* b, size_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i va = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        __m256i vb = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+    }
+    alignas(32) int32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    int32_t sum = ((lanes[0] + lanes[4]) + (lanes[1] + lanes[5])) + ((lanes[2] + lanes[6]) + (lanes[3] + lanes[7]));
+    for (; i < n; ++i) sum += static_cast<int32_t>(a[i]) * b[i];
+    return sum;
+}
+
+// Eight halves widened to float32
+inline __m256 widen_halves(const uint16_t* b) {
+    const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+#if defined(__F16C__)
+    return _mm256_cvtph_ps(raw);
+#else
+    const __m256i h = _mm256_cvtepu16_epi32(raw);
+    __m256 value = _mm256_mul_ps(
+        _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(0x7FFF)), 13)),
+        _mm256_castsi256_ps(_mm256_set1_epi32(0x77800000)));               // * 2^112
+    const __m256i special = _mm256_cmpeq_epi32(_mm256_and_si256(h, _mm256_set1_epi32(0x7C00)),
+                                                _mm256_set1_epi32(0x7C00));
+    const __m256i high = _mm256_or_si256(_mm256_and_si256(special, _mm256_set1_epi32(0x7F800000)),
+                                         _mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(0x8000)), 16));
+    return _mm256_or_ps(value, _mm256_castsi256_ps(high));
+#endif
+}
+
+inline float dot_f16(const float* a, const uint16_t* b, size_t n) {
+    __m256 acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), widen_halves(b + i), acc);
+    }
+    float sum = horizontal_sum(acc);
+    for (; i < n; ++i) sum += a[i] * half_to_float(b[i]);
+    return sum;
+}
+
+inline float squared_l2_f16(const float* a, const uint16_t* b, size_t n) {
+    __m256 acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + i), widen_halves(b + i));
+        acc = _mm256_fmadd_ps(d, d, acc);
+    }
+    float sum = horizontal_sum(acc);
+    for (; i < n; ++i) sum += (a[i] - half_to_float(b[i])) * (a[i] - half_to_float(b[i]));
+    return sum;
+}
+
+#elif defined(GTAF_VECTOR_SSE2)
+
+inline float horizontal_sum(__m128 v) {
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 0x55));
+    return _mm_cvtss_f32(v);
+}
+
+inline float dot(const float* a, const float* b, size_t n) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    float sum = horizontal_sum(_mm_add_ps(acc0, acc1));
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+inline float squared_l2(const float* a, const float* b, size_t n) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128 d0 = _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+        __m128 d1 = _mm_sub_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4));
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(d0, d0));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(d1, d1));
+    }
+    float sum = horizontal_sum(_mm_add_ps(acc0, acc1));
+    for (; i < n; ++i) sum += (a[i] - b[i]) * (a[i] - b[i]);
+    return sum;
+}
+
+inline int32_t dot_i8(const int8_t* a, const int8_t* b, size_t n) {
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        // Sign-extend bytes to 16 bits: duplicate each byte, then shift arithmetically
+        __m128i a_lo = _mm_srai_epi16(_mm_unpacklo_epi8(va, va), 8);
+        __m128i a_hi = _mm_srai_epi16(_mm_unpackhi_epi8(va, va), 8);
+        __m128i b_lo = _mm_srai_epi16(_mm_unpacklo_epi8(vb, vb), 8);
+        __m128i b_hi = _mm_srai_epi16(_mm_unpackhi_epi8(vb, vb), 8);
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(a_lo, b_lo));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(a_hi, b_hi));
+    }
+    alignas(16) int32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    int32_t sum = (lanes[0] + lanes[2]) + (lanes[1] + lanes[3]);
+    for (; i < n; ++i) sum += static_cast<int32_t>(a[i]) * b[i];
+    return sum;
+}
+
+// Four halves (zero-extended to 32-bit lanes) widened to float32, see widen_half()
+inline __m128 widen_halves(__m128i h) {
+    __m128 value = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7FFF)), 13)),
+                              _mm_castsi128_ps(_mm_set1_epi32(0x77800000)));   // * 2^112
+    const __m128i special = _mm_cmpeq_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7C00)), _mm_set1_epi32(0x7C00));
+    const __m128i high = _mm_or_si128(_mm_and_si128(special, _mm_set1_epi32(0x7F800000)),
+                                      _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16));
+    return _mm_or_ps(value, _mm_castsi128_ps(high));
+}
+
+inline float dot_f16(const float* a, const uint16_t* b, size_t n) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), widen_halves(_mm_unpacklo_epi16(raw, zero))));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), widen_halves(_mm_unpackhi_epi16(raw, zero))));
+    }
+    float sum = horizontal_sum(_mm_add_ps(acc0, acc1));
+    for (; i < n; ++i) sum += a[i] * half_to_float(b[i]);
+    return sum;
+}
+
+inline float squared_l2_f16(const float* a, const uint16_t* b, size_t n) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        __m128 d0 = _mm_sub_ps(_mm_loadu_ps(a + i), widen_halves(_mm_unpacklo_epi16(raw, zero)));
+        __m128 d1 = _mm_sub_ps(_mm_loadu_ps(a + i + 4), widen_halves(_mm_unpackhi_epi16(raw, zero)));
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(d0, d0));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(d1, d1));
+    }
+    float sum = horizontal_sum(_mm_add_ps(acc0, acc1));
+    for (; i < n; ++i) sum += (a[i] - half_to_float(b[i])) * (a[i] - half_to_float(b[i]));
+    return sum;
+}
+
+#else
+
+inline float dot(const float* a, const float* b, size_t n) {
+    float acc[8] = {};
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (size_t lane = 0; lane < 8; ++lane) acc[lane] += a[i + lane] * b[i + lane];
+    }
+    float sum = ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+inline float squared_l2(const float* a, const float* b, size_t n) {
+    float acc[8] = {};
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (size_t lane = 0; lane < 8; ++lane) {
+            const float d = a[i + lane] - b[i + lane];
+            acc[lane] += d * d;
+        }
+    }
+    float sum = ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+    for (; i < n; ++i) sum += (a[i] - b[i]) * (a[i] - b[i]);
+    return sum;
+}
+
+inline int32_t dot_i8(const int8_t* a, const int8_t* b, size_t n) {
+    int32_t acc[8] = {};
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (size_t lane = 0; lane < 8; ++lane) acc[lane] += static_cast<int32_t>(a[i + lane]) * b[i + lane];
+    }
+    int32_t sum = ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+    for (; i < n; ++i) sum += static_cast<int32_t>(a[i]) * b[i];
+    return sum;
+}
+
+inline float dot_f16(const float* a, const uint16_t* b, size_t n) {
+    float acc[8] = {};
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (size_t lane = 0; lane < 8; ++lane) acc[lane] += a[i + lane] * widen_half(b[i + lane]);
+    }
+    float sum = ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+    for (; i < n; ++i) sum += a[i] * half_to_float(b[i]);
+    return sum;
+}
+
+inline float squared_l2_f16(const float* a, const uint16_t* b, size_t n) {
+    float acc[8] = {};
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (size_t lane = 0; lane < 8; ++lane) {
+            const float d = a[i + lane] - widen_half(b[i + lane]);
+            acc[lane] += d * d;
+        }
+    }
+    float sum = ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+    for (; i < n; ++i) sum += (a[i] - half_to_float(b[i])) * (a[i] - half_to_float(b[i]));
+    return sum;
+}
+
+#endif
+
+} // namespace gtaf::core::kernels
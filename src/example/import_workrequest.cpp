@@ -353,13 +353,14 @@ int main(int argc, char* argv[]) {
         std::cout << "Example: To query a specific work request:\n";
         std::cout << "  1. Create EntityId from ID\n";
         std::cout << "  2. Call projector.rebuild(entity)\n";
-        std::cout << "  3. Use node.get(\"workrequest.name\") etc.\n\n";
+        std::cout << "  3. Resolve tags once with projector.find_tag(\"workrequest.name\"),\n";
+        std::cout << "     then read node.get(tag_id) etc.\n\n";
     }
 
     std::cout << "=== Next Steps ===\n";
     std::cout << "1. Load saved data: store.load(\"workrequest_import.dat\")\n";
     std::cout << "2. Build projections: projector.rebuild(entity_id)\n";
-    std::cout << "3. Query properties: node.get(\"workrequest.field\")\n";
+    std::cout << "3. Query properties: node.get(*projector.find_tag(\"workrequest.field\"))\n";
     std::cout << "4. Analyze deduplication savings\n\n";
 
     std::cout << "=== Demo Complete ===\n";
@@ -155,6 +155,17 @@ int main(int argc, char* argv[]) {
     std::cout << "  Memory after rebuild: " << format_memory(mem_after_rebuild)
               << " (+" << format_memory(mem_delta_rebuild) << ")\n\n";
 
+    // Resolve each tag to its TagId once, so reads skip the global dictionary
+    auto description_tag = projector.find_tag("workrequest.description");
+    auto design_id_tag = projector.find_tag("workrequest.attacheddesignid");
+    auto name_tag = projector.find_tag("workrequest.name");
+    auto customer_tag = projector.find_tag("workrequest.customername");
+    auto state_id_tag = projector.find_tag("workrequest.workrequeststateid");
+    auto status_tag = projector.find_tag("workrequest.cstemaxstatus");
+    auto value_of = [](const core::Node& node, std::optional<core::TagId> tag) -> std::optional<types::AtomValue> {
+        return tag ? node.get(*tag) : std::nullopt;
+    };
+
     // ========================================================================
     // QUERY 1: Select all work requests with description LIKE '%ADDS%'
     // ========================================================================
@@ -170,7 +181,7 @@ int main(int argc, char* argv[]) {
     for (const auto& [entity_id, node] : nodes) {
         scanned++;
 
-        auto desc = node.get("workrequest.description");
+        auto desc = value_of(node, description_tag);
 
         if (desc && std::holds_alternative<std::string>(*desc)) {
             std::string description = std::get<std::string>(*desc);
@@ -239,7 +250,7 @@ int main(int argc, char* argv[]) {
     for (const auto& [entity_id, node] : nodes) {
         scanned++;
 
-        auto design_id_val = node.get("workrequest.attacheddesignid");
+        auto design_id_val = value_of(node, design_id_tag);
 
         if (design_id_val && std::holds_alternative<std::string>(*design_id_val)) {
             std::string design_id_str = std::get<std::string>(*design_id_val);
@@ -259,19 +270,19 @@ int main(int argc, char* argv[]) {
                             wr.design_id = design_id;
 
                             // Get other fields
-                            if (auto name = node.get("workrequest.name")) {
+                            if (auto name = value_of(node, name_tag)) {
                                 if (std::holds_alternative<std::string>(*name)) {
                                     wr.name = std::get<std::string>(*name);
                                 }
                             }
 
-                            if (auto desc = node.get("workrequest.description")) {
+                            if (auto desc = value_of(node, description_tag)) {
                                 if (std::holds_alternative<std::string>(*desc)) {
                                     wr.description = std::get<std::string>(*desc);
                                 }
                             }
 
-                            if (auto customer = node.get("workrequest.customername")) {
+                            if (auto customer = value_of(node, customer_tag)) {
                                 if (std::holds_alternative<std::string>(*customer)) {
                                     wr.customer_name = std::get<std::string>(*customer);
                                 }
@@ -334,7 +345,7 @@ int main(int argc, char* argv[]) {
     for (const auto& [entity_id, node] : nodes) {
         scanned++;
 
-        auto state_id_val = node.get("workrequest.workrequeststateid");
+        auto state_id_val = value_of(node, state_id_tag);
 
         if (state_id_val && std::holds_alternative<std::string>(*state_id_val)) {
             std::string state_id_str = std::get<std::string>(*state_id_val);
@@ -349,25 +360,25 @@ int main(int argc, char* argv[]) {
                     wr.state_id = 1;
 
                     // Get other fields
-                    if (auto name = node.get("workrequest.name")) {
+                    if (auto name = value_of(node, name_tag)) {
                         if (std::holds_alternative<std::string>(*name)) {
                             wr.name = std::get<std::string>(*name);
                         }
                     }
 
-                    if (auto desc = node.get("workrequest.description")) {
+                    if (auto desc = value_of(node, description_tag)) {
                         if (std::holds_alternative<std::string>(*desc)) {
                             wr.description = std::get<std::string>(*desc);
                         }
                     }
 
-                    if (auto customer = node.get("workrequest.customername")) {
+                    if (auto customer = value_of(node, customer_tag)) {
                         if (std::holds_alternative<std::string>(*customer)) {
                             wr.customer_name = std::get<std::string>(*customer);
                         }
                     }
 
-                    if (auto status = node.get("workrequest.cstemaxstatus")) {
+                    if (auto status = value_of(node, status_tag)) {
                         if (std::holds_alternative<std::string>(*status)) {
                             wr.status = std::get<std::string>(*status);
                         }
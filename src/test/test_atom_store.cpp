@@ -2,6 +2,11 @@
 #include "../core/atom_store.h"
 #include "../types/hash_utils.h"
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <unordered_set>
 
 using namespace gtaf;
 using namespace gtaf::test;
@@ -52,6 +57,65 @@ TEST(AtomStore, CanonicalDeduplication) {
     ASSERT_EQ(stats.deduplicated_hits, 1);
 }
 
+TEST(AtomStore, WideContentHash) {
+    auto hash = [](const std::string& tag, const types::AtomValue& value) {
+        return types::compute_content_hash(tag, value);
+    };
+    auto halves = [](const types::AtomId& id) {
+        uint64_t lo, hi;
+        std::memcpy(&lo, id.bytes.data(), 8);
+        std::memcpy(&hi, id.bytes.data() + 8, 8);
+        return std::pair{lo, hi};
+    };
+
+    // No collisions in either 64-bit half over dense, similar inputs
+    std::unordered_set<uint64_t> lows, highs;
+    for (int64_t i = 0; i < 50000; ++i) {
+        auto [lo, hi] = halves(hash("n", i));
+        lows.insert(lo);
+        highs.insert(hi);
+        auto [slo, shi] = halves(hash("s", "key-" + std::to_string(i)));
+        lows.insert(slo);
+        highs.insert(shi);
+    }
+    ASSERT_EQ(lows.size(), 100000);
+    ASSERT_EQ(highs.size(), 100000);
+
+    // Fields cannot trade bytes, and zero padding is not free
+    ASSERT_TRUE(hash("ab", std::string("c")) != hash("a", std::string("bc")));
+    ASSERT_TRUE(hash("t", std::string("x")) != hash("t", std::string("x") + '\0'));
+    ASSERT_TRUE(hash("t", std::string()) != hash("t", std::monostate{}));
+
+    // Reordered stripes and single-bit changes in long inputs are seen
+    auto wide = [](const std::string& bytes) {
+        types::detail::WideHasher hasher;
+        hasher.update(bytes.data(), bytes.size());
+        return hasher.finalize();
+    };
+    std::string stripes = std::string(32, 'a') + std::string(32, 'b') + std::string(4032, 'c');
+    std::string swapped = std::string(32, 'b') + std::string(32, 'a') + std::string(4032, 'c');
+    ASSERT_TRUE(wide(stripes) != wide(swapped));
+    std::string split = stripes;   // Same bytes, fed in uneven pieces
+    types::detail::WideHasher pieces;
+    pieces.update(split.data(), 5);
+    pieces.update(split.data() + 5, 100);
+    pieces.update(split.data() + 105, split.size() - 105);
+    ASSERT_TRUE(pieces.finalize() == wide(stripes));
+
+    types::Vector embedding(768, 0.5f);
+    auto base = hash("embedding", embedding);
+    embedding[767] = 0.25f;
+    ASSERT_TRUE(hash("embedding", embedding) != base);
+    std::string text(4096, 'a');
+    auto long_text = hash("doc", text);
+    text.back() = 'b';
+    ASSERT_TRUE(hash("doc", text) != long_text);
+
+    // Deterministic, and distinct from the legacy algorithm
+    ASSERT_TRUE(hash("doc", text) == hash("doc", text));
+    ASSERT_TRUE(types::compute_content_hash("doc", text, types::HashAlgorithm::Fnv1a) != hash("doc", text));
+}
+
 TEST(AtomStore, TemporalNoDeduplication) {
     core::AtomStore log;
     auto entity = make_entity(1);
@@ -89,6 +153,176 @@ TEST(AtomStore, TemporalChunking) {
     ASSERT_EQ(std::get<double>(result.values[1499]), 1519.0);
 }
 
+TEST(AtomStore, TemporalRetention) {
+    core::AtomStore log;
+    log.set_chunk_size_threshold(10);
+    auto e1 = make_entity(1), e2 = make_entity(2);
+
+    log.set_retention_policy({"sensor.*", 0, 3});
+    log.set_retention_policy({"sensor.humidity", 0, 1});   // Exact tag beats the prefix
+    for (int i = 0; i < 100; ++i) {
+        log.append(e1, "sensor.temperature", static_cast<double>(i), types::AtomType::Temporal);
+        log.append(e2, "sensor.temperature", static_cast<double>(-i), types::AtomType::Temporal);
+        log.append(e1, "sensor.humidity", static_cast<double>(i), types::AtomType::Temporal);
+        log.append(e1, "audit", static_cast<int64_t>(i), types::AtomType::Temporal);
+    }
+
+    // Streams are independent: 3 + 3 + 1 + all 10 of the unmatched tag
+    ASSERT_EQ(log.sealed_chunk_count(), 17);
+    auto temps = log.query_temporal_all(e1, "sensor.temperature");
+    ASSERT_EQ(temps.total_count, 30);
+    ASSERT_EQ(std::get<double>(temps.values.front()), 70.0);
+    ASSERT_EQ(std::get<double>(temps.values.back()), 99.0);
+    ASSERT_EQ(std::get<double>(log.query_temporal_all(e2, "sensor.temperature").values.front()), -70.0);
+    ASSERT_EQ(log.query_temporal_all(e1, "sensor.humidity").total_count, 10);
+    ASSERT_EQ(log.query_temporal_all(e1, "audit").total_count, 100);
+
+    // Values still in the active chunk are never dropped
+    for (int i = 0; i < 5; ++i) {
+        log.append(e1, "audit", static_cast<int64_t>(100 + i), types::AtomType::Temporal);
+    }
+
+    // The periodic tick ages out idle streams
+    constexpr types::Timestamp kHour = 3600ULL * 1000000ULL;
+    log.set_retention_policy({"audit", kHour, 0});
+    ASSERT_EQ(log.enforce_retention(), 0);
+    auto later = temps.timestamps.back() + 2 * kHour;
+    ASSERT_EQ(log.enforce_retention(later), 10);
+    ASSERT_EQ(log.sealed_chunk_count(), 7);
+    ASSERT_EQ(log.query_temporal_all(e1, "audit").total_count, 5);
+
+    ASSERT_TRUE(log.remove_retention_policy("sensor.*"));
+    ASSERT_FALSE(log.remove_retention_policy("sensor.*"));
+    ASSERT_EQ(log.enforce_retention(later), 0);
+}
+
+TEST(AtomStore, TieredTemporalChunks) {
+    auto directory = std::filesystem::temp_directory_path() / "gtaf_test_tiering";
+    std::filesystem::remove_all(directory);
+    auto files = [&] {
+        return std::distance(std::filesystem::directory_iterator(directory), std::filesystem::directory_iterator{});
+    };
+
+    auto e1 = make_entity(1);
+    core::AtomStore::TemporalQueryResult expected;
+    {
+        core::AtomStore log;
+        log.set_chunk_size_threshold(10);
+        for (int i = 0; i < 200; ++i) {
+            log.append(e1, "sensor.temperature", static_cast<double>(i), types::AtomType::Temporal);
+            log.append(e1, "sensor.label", "reading " + std::to_string(i), types::AtomType::Temporal);
+        }
+        expected = log.query_temporal_all(e1, "sensor.temperature");
+        size_t resident = log.tiering_stats().resident_bytes;
+
+        // Keep roughly a quarter of the chunks resident; the rest go to disk
+        core::AtomStore::TieringOptions options;
+        options.directory = directory.string();
+        options.memory_budget_bytes = resident / 4;
+        options.cache_budget_bytes = resident / 8;
+        ASSERT_TRUE(log.enable_tiering(options));
+        auto stats = log.tiering_stats();
+        ASSERT_EQ(stats.resident_chunks + stats.spilled_chunks, 40);
+        ASSERT_TRUE(stats.spilled_chunks >= 20);
+        ASSERT_TRUE(stats.resident_bytes <= options.memory_budget_bytes);
+        ASSERT_EQ(files(), static_cast<long>(stats.spilled_chunks));
+
+        // Queries page spilled chunks back in transparently
+        auto all = log.query_temporal_all(e1, "sensor.temperature");
+        ASSERT_EQ(all.total_count, 200);
+        ASSERT_TRUE(all.lsns == expected.lsns);
+        for (size_t i = 0; i < all.values.size(); ++i) {
+            ASSERT_EQ(std::get<double>(all.values[i]), static_cast<double>(i));
+        }
+        auto labels = log.query_temporal_all(e1, "sensor.label");
+        ASSERT_EQ(std::get<std::string>(labels.values[7]), "reading 7");
+        ASSERT_TRUE(log.tiering_stats().cache.misses > 0);
+        ASSERT_TRUE(log.tiering_stats().cache.bytes <= options.cache_budget_bytes);
+
+        auto from = expected.timestamps[25], to = expected.timestamps[34];
+        auto range = log.query_temporal_range(e1, "sensor.temperature", from, to);
+        size_t in_range = std::count_if(expected.timestamps.begin(), expected.timestamps.end(),
+                                        [&](types::Timestamp t) { return t >= from && t <= to; });
+        ASSERT_EQ(range.total_count, in_range);
+        auto hits = log.tiering_stats().cache.hits;
+        log.query_temporal_range(e1, "sensor.temperature", from, to);
+        ASSERT_TRUE(log.tiering_stats().cache.hits > hits);
+
+        // New seals keep the budget; retention deletes the files it drops
+        for (int i = 200; i < 300; ++i) {
+            log.append(e1, "sensor.temperature", static_cast<double>(i), types::AtomType::Temporal);
+        }
+        ASSERT_TRUE(log.tiering_stats().resident_bytes <= options.memory_budget_bytes);
+        log.set_retention_policy({"sensor.label", 0, 5});
+        log.enforce_retention();
+        ASSERT_EQ(log.query_temporal_all(e1, "sensor.label").total_count, 50);
+        ASSERT_EQ(files(), static_cast<long>(log.tiering_stats().spilled_chunks));
+
+        // Everything ages out with max_age
+        constexpr types::Timestamp kHour = 3600ULL * 1000000ULL;
+        const types::Timestamp later = expected.timestamps.back() + 2 * kHour;
+        options.memory_budget_bytes = 0;
+        options.max_age = kHour;
+        ASSERT_TRUE(log.enable_tiering(options));
+        size_t warm = log.tiering_stats().resident_chunks;
+        ASSERT_TRUE(warm > 0);
+        ASSERT_EQ(log.spill_cold_chunks(later), warm);
+        ASSERT_EQ(log.tiering_stats().resident_bytes, 0);
+        ASSERT_EQ(log.query_temporal_all(e1, "sensor.temperature").total_count, 300);
+
+        // Disabling pages everything back in and removes the files
+        ASSERT_TRUE(log.disable_tiering());
+        ASSERT_EQ(log.tiering_stats().spilled_chunks, 0);
+        ASSERT_EQ(files(), 0);
+        ASSERT_EQ(log.query_temporal_all(e1, "sensor.temperature").total_count, 300);
+
+        ASSERT_TRUE(log.enable_tiering(options));
+        ASSERT_EQ(log.spill_cold_chunks(later), 35);
+        ASSERT_EQ(files(), 35);
+    }
+
+    // The store owns its chunk files
+    ASSERT_EQ(files(), 0);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(AtomStore, UnreadableChunkFile) {
+    auto directory = std::filesystem::temp_directory_path() / "gtaf_test_tiering_lost";
+    std::filesystem::remove_all(directory);
+
+    auto e1 = make_entity(1);
+    core::AtomStore log;
+    log.set_chunk_size_threshold(10);
+    for (int i = 0; i < 105; ++i) {
+        log.append(e1, "sensor.temperature", static_cast<double>(i), types::AtomType::Temporal);
+    }
+    core::AtomStore::TieringOptions options;
+    options.directory = directory.string();
+    options.memory_budget_bytes = 1;   // Spill every sealed chunk
+    options.cache_budget_bytes = 0;
+    ASSERT_TRUE(log.enable_tiering(options));
+    const size_t spilled = log.tiering_stats().spilled_chunks;
+    ASSERT_TRUE(spilled > 1);
+    ASSERT_TRUE(log.query_temporal_all(e1, "sensor.temperature").complete);
+
+    // A lost file is reported through the result instead of thrown from a const query
+    std::filesystem::remove(*std::filesystem::directory_iterator(directory));
+    core::AtomStore::TieringOptions moved = options;
+    moved.directory = (directory / "moved").string();
+    auto result = log.query_temporal_all(e1, "sensor.temperature");
+    ASSERT_FALSE(result.complete);
+    ASSERT_TRUE(result.total_count < 105);
+    ASSERT_TRUE(result.total_count > 0);
+
+    // Nothing is dropped while a file cannot be read
+    ASSERT_FALSE(log.disable_tiering());
+    ASSERT_FALSE(log.enable_tiering(moved));
+    ASSERT_EQ(log.tiering_stats().spilled_chunks, spilled);
+    ASSERT_EQ(log.query_temporal_all(e1, "sensor.temperature").total_count, result.total_count);
+
+    std::filesystem::remove_all(directory);
+}
+
 TEST(AtomStore, MutableStateSameId) {
     core::AtomStore log;
     auto entity = make_entity(1);
@@ -133,6 +367,60 @@ TEST(AtomStore, EdgeValues) {
     ASSERT_EQ(edge_value.relation, "follows");
 }
 
+TEST(AtomStore, AdjacencyIndex) {
+    core::AtomStore log;
+    auto e1 = make_entity(1), e2 = make_entity(2), e3 = make_entity(3), e50 = make_entity(50);
+    log.append(e2, "name", std::string("two"));
+    log.append(e3, "name", std::string("three"));
+    log.append(e1, "edge.follows.2", types::EdgeValue{e2, "follows"});
+    log.append(e1, "edge.follows.3", types::EdgeValue{e3, "follows"});
+    log.append(e1, "edge.follows.2", types::EdgeValue{e2, "follows"});  // Re-asserted: no new edge
+    log.append(e2, "edge.follows", types::EdgeValue{e1, "follows"});
+    log.append(e1, "edge.likes", types::EdgeValue{e3, "likes"});
+
+    const auto& graph = log.adjacency();
+    auto follows = graph.find_relation("follows");
+    ASSERT_TRUE(follows.has_value());
+    ASSERT_FALSE(graph.find_relation("edge.follows.2").has_value());
+    ASSERT_EQ(graph.relation_count(), 2);
+    ASSERT_EQ(graph.edge_count(), 4);
+
+    auto o1 = *log.find_ordinal(e1), o2 = *log.find_ordinal(e2), o3 = *log.find_ordinal(e3);
+    std::vector<uint32_t> out;
+    graph.outgoing(o1, *follows).for_each([&](uint32_t n) { out.push_back(n); });
+    ASSERT_EQ(out.size(), 2);
+    ASSERT_EQ(out[0], o2);
+    ASSERT_EQ(out[1], o3);
+    ASSERT_EQ(graph.incoming(o1, *follows).size(), 1);
+    ASSERT_EQ(graph.incoming(o3, *graph.find_relation("likes")).size(), 1);
+    ASSERT_TRUE(graph.outgoing(o3, *follows).empty());
+
+    // An edge to an entity without atoms appears once the target does
+    log.append(e1, "edge.follows.50", types::EdgeValue{e50, "follows"});
+    ASSERT_EQ(graph.outgoing(o1, *follows).size(), 2);
+    log.append(e50, "name", std::string("fifty"));
+    ASSERT_EQ(graph.outgoing(o1, *follows).size(), 3);
+    ASSERT_EQ(graph.incoming(*log.find_ordinal(e50), *follows).size(), 1);
+
+    // Enough edges to force merges into the CSR arrays
+    std::vector<core::AtomStore::BatchAtom> batch;
+    for (uint8_t source = 100; source < 200; ++source) {
+        for (uint8_t target = 100; target < 120; ++target) {
+            batch.push_back({make_entity(source), "edge.links." + std::to_string(target),
+                             types::EdgeValue{make_entity(target), "links"}});
+        }
+    }
+    log.append_batch(batch);
+    auto links = *graph.find_relation("links");
+    ASSERT_EQ(graph.edge_count(), 5 + 2000);
+    for (uint8_t id = 100; id < 200; ++id) {
+        ASSERT_EQ(graph.outgoing(*log.find_ordinal(make_entity(id)), links).size(), 20);
+    }
+    auto hub = graph.incoming(*log.find_ordinal(make_entity(110)), links);
+    ASSERT_EQ(hub.size(), 100);
+    ASSERT_TRUE(hub.compacted.size() > 0);
+}
+
 TEST(AtomStore, MultipleValueTypes) {
     core::AtomStore log;
     auto entity = make_entity(1);
@@ -176,3 +464,186 @@ TEST(AtomStore, TimestampMonotonicity) {
     // Timestamps should be non-decreasing (could be equal if very fast)
     ASSERT_TRUE(atom1.created_at() <= atom2.created_at());
 }
+
+TEST(AtomStore, AppendListenerEvents) {
+    core::AtomStore log;
+    auto entity = make_entity(1);
+
+    std::vector<std::vector<core::AtomStore::AppendEvent>> calls;
+    std::vector<std::string> tags;
+    auto id = log.add_append_listener([&](const std::vector<core::AtomStore::AppendEvent>& events) {
+        calls.push_back(events);
+        for (const auto& event : events) tags.push_back(event.atom->type_tag());
+    });
+
+    log.append(entity, "name", std::string("Alice"));
+    log.append_batch({
+        {entity, "name", std::string("Bob")},
+        {entity, "name", std::string("Alice")},  // Deduplicated content still commits a reference
+        {entity, "reading", 1.5, types::AtomType::Temporal}
+    });
+    ASSERT_EQ(calls.size(), 2);
+    ASSERT_EQ(calls[1].size(), 3);
+    ASSERT_EQ(calls[1][2].lsn.value, log.current_lsn().value);
+    ASSERT_EQ(std::get<std::string>(calls[1][1].atom->value()), "Alice");
+
+    // A mutation that triggers a snapshot reports both references in LSN order
+    for (int64_t i = 1; i <= 10; ++i) {
+        log.append(entity, "counter", i, types::AtomType::Mutable);
+    }
+    const auto& last = calls.back();
+    ASSERT_EQ(last.size(), 2);
+    ASSERT_TRUE(last[0].lsn < last[1].lsn);
+    ASSERT_EQ(last[1].atom->type_tag(), "counter.snapshot");
+
+    log.remove_append_listener(id);
+    log.append(entity, "name", std::string("Carol"));
+    ASSERT_EQ(calls.size(), 12);
+}
+
+TEST(AtomStore, DenseEntityOrdinals) {
+    core::AtomStore log;
+    auto entity1 = make_entity(1);
+    auto entity2 = make_entity(2);
+    auto entity3 = make_entity(3);
+
+    log.append(entity2, "name", std::string("Bob"));
+    log.append(entity1, "name", std::string("Alice"));
+    log.append_batch({
+        {entity3, "name", std::string("Carol")},
+        {entity2, "age", static_cast<int64_t>(40)},
+        {entity3, "reading", 1.5, types::AtomType::Temporal}
+    });
+
+    // Ordinals are assigned at first sight and never change
+    ASSERT_EQ(log.entity_count(), 3);
+    ASSERT_EQ(*log.find_ordinal(entity2), 0);
+    ASSERT_EQ(*log.find_ordinal(entity1), 1);
+    ASSERT_EQ(*log.find_ordinal(entity3), 2);
+    ASSERT_FALSE(log.find_ordinal(make_entity(4)).has_value());
+    ASSERT_EQ(log.entity_at(2), entity3);
+    ASSERT_EQ(log.get_all_entities(), log.entities());
+
+    // Mixed-classification batches keep per-entity refs in LSN order
+    const auto& refs = log.get_entity_atoms_at(2);
+    ASSERT_EQ(refs.size(), 2);
+    ASSERT_TRUE(refs[0].lsn < refs[1].lsn);
+    ASSERT_EQ(log.get_entity_atoms(entity2)->size(), 2);
+}
+
+TEST(AtomStore, LatestValueByTag) {
+    core::AtomStore log;
+    auto wide = make_entity(1);
+
+    // A wide entity with a long history, mixing classifications
+    for (int round = 0; round < 20; ++round) {
+        for (int field = 0; field < 12; ++field) {
+            log.append(wide, "f" + std::to_string(field), static_cast<int64_t>(round * 100 + field));
+        }
+        log.append(wide, "counter", static_cast<int64_t>(round), types::AtomType::Mutable);
+        log.append(wide, "reading", static_cast<double>(round), types::AtomType::Temporal);
+    }
+    log.append(wide, "f3", std::string("shared"));
+    log.append(make_entity(2), "f3", std::string("shared"));   // Deduplicated content
+    log.append_batch({{make_entity(3), "name", std::string("batch")}, {wide, "f5", std::string("batched")}});
+
+    ASSERT_EQ(std::get<std::string>(*log.get_latest_value(wide, "f3")), "shared");
+    ASSERT_EQ(std::get<std::string>(*log.get_latest_value(wide, "f5")), "batched");
+    ASSERT_EQ(std::get<int64_t>(*log.get_latest_value(wide, "f11")), 1911);
+    ASSERT_EQ(std::get<int64_t>(*log.get_latest_value(wide, "counter")), 19);
+    ASSERT_EQ(std::get<double>(*log.get_latest_value(wide, "reading")), 19.0);
+    ASSERT_FALSE(log.get_latest_value(wide, "name").has_value());
+    ASSERT_FALSE(log.get_latest_value(wide, "never-used-tag").has_value());
+    ASSERT_FALSE(log.get_latest_value(make_entity(9), "f3").has_value());
+
+    // The reference is the entity's newest for the tag
+    uint32_t ordinal = *log.find_ordinal(wide);
+    const auto* ref = log.latest_ref_at(ordinal, "f7");
+    ASSERT_TRUE(ref != nullptr);
+    ASSERT_EQ(std::get<int64_t>(log.get_atom(ref->atom_id)->value()), 1907);
+    for (const auto& later : log.get_entity_atoms_at(ordinal)) {
+        if (later.lsn > ref->lsn) {
+            ASSERT_NE(log.get_atom(later.atom_id)->type_tag(), "f7");
+        }
+    }
+
+    auto values = log.get_latest_values({make_entity(3), wide, make_entity(9), make_entity(2)}, "f3");
+    ASSERT_EQ(values.size(), 4);
+    ASSERT_FALSE(values[0].has_value());
+    ASSERT_EQ(std::get<std::string>(*values[1]), "shared");
+    ASSERT_FALSE(values[2].has_value());
+    ASSERT_EQ(std::get<std::string>(*values[3]), "shared");
+
+    // The table is rebuilt on load
+    std::string path = "test_latest_by_tag.dat";
+    ASSERT_TRUE(log.save(path));
+    core::AtomStore loaded;
+    ASSERT_TRUE(loaded.load(path));
+    ASSERT_EQ(std::get<std::string>(*loaded.get_latest_value(wide, "f5")), "batched");
+    ASSERT_EQ(std::get<int64_t>(*loaded.get_latest_value(wide, "f0")), 1900);
+    ASSERT_EQ(std::get<std::string>(*loaded.get_latest_value(make_entity(3), "name")), "batch");
+
+    // Loading over a store forgets the tags it held before
+    core::AtomStore replaced;
+    replaced.append(make_entity(4), "replaced-only", std::string("gone"));
+    ASSERT_TRUE(replaced.load(path));
+    ASSERT_FALSE(replaced.find_tag("replaced-only").has_value());
+    ASSERT_TRUE(replaced.find_tag("f5").has_value());
+    std::remove(path.c_str());
+}
+
+TEST(AtomStore, CompactRetainedHistory) {
+    core::AtomStore log;
+    auto e1 = make_entity(1), e2 = make_entity(2);
+
+    for (int64_t v = 0; v < 10; ++v) {
+        log.append(e1, "score", v);
+        log.append(e1, "counter", v, types::AtomType::Mutable);
+    }
+    log.append(e1, "name", std::string("one"));
+    log.append(e2, "name", std::string("one"));          // Shared canonical atom
+    log.append(e2, "score", static_cast<int64_t>(3));    // Shared with e1's history
+    auto cutoff = log.current_lsn();
+    log.append(e1, "score", static_cast<int64_t>(42));
+    log.append(e1, "score", static_cast<int64_t>(43));
+
+    // Keeping everything keeps every version of the mutable atom referenced
+    size_t atoms = log.get_stats().total_atoms;
+    auto full = log.compact();
+    ASSERT_EQ(full.references_removed, 0);
+    ASSERT_EQ(full.atoms_removed, 0);
+    ASSERT_EQ(log.get_stats().total_atoms, atoms);
+    ASSERT_EQ(log.get_entity_atoms(e1)->size(), 24);       // Includes the counter.snapshot reference
+    ASSERT_EQ(std::get<int64_t>(*log.get_latest_value(e1, "counter")), 9);
+
+    // Keep the newest version per tag, plus everything after the cutoff
+    core::AtomStore::CompactionOptions window;
+    window.keep_versions = 1;
+    window.keep_after = cutoff;
+    auto trimmed = log.compact(window);
+    ASSERT_TRUE(trimmed.bytes_reclaimed > 0);
+    ASSERT_EQ(log.get_entity_atoms(e1)->size(), 5);      // score 42, 43, counter, its snapshot, name
+    ASSERT_EQ(trimmed.references_removed, 19);
+    ASSERT_EQ(trimmed.atoms_removed, 18);                // score 0..9 except 3 (still held by e2), counter 0..8
+    ASSERT_EQ(std::get<int64_t>(*log.get_latest_value(e1, "score")), 43);
+    ASSERT_EQ(std::get<int64_t>(*log.get_latest_value(e1, "counter")), 9);
+    ASSERT_EQ(std::get<std::string>(*log.get_latest_value(e2, "name")), "one");
+    ASSERT_EQ(std::get<int64_t>(*log.get_latest_value(e2, "score")), 3);
+    for (const char* tag : {"score", "counter", "name"}) {
+        ASSERT_TRUE(log.find_tag(tag).has_value());
+    }
+
+    // Compacted atoms stay deduplicated against new appends
+    size_t before = log.get_stats().total_atoms;
+    log.append(make_entity(3), "score", static_cast<int64_t>(3));
+    ASSERT_EQ(log.get_stats().total_atoms, before);
+    ASSERT_EQ(log.compact().atoms_removed, 0);
+
+    std::string path = "test_compact.dat";
+    ASSERT_TRUE(log.save(path));
+    core::AtomStore loaded;
+    ASSERT_TRUE(loaded.load(path));
+    ASSERT_EQ(loaded.get_entity_atoms(e1)->size(), 5);
+    ASSERT_EQ(std::get<int64_t>(*loaded.get_latest_value(e1, "counter")), 9);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,69 @@
+#include "test_framework.h"
+#include "../core/entity_bitmap.h"
+#include <vector>
+
+using namespace gtaf;
+using namespace gtaf::test;
+
+TEST(EntityBitmap, AddRemoveContains) {
+    core::EntityBitmap bitmap;
+    ASSERT_TRUE(bitmap.empty());
+
+    bitmap.add(7);
+    bitmap.add(3);
+    bitmap.add(70000);
+    bitmap.add(7);  // Duplicate
+
+    ASSERT_EQ(bitmap.cardinality(), 3);
+    ASSERT_EQ(bitmap.container_count(), 2);
+    ASSERT_TRUE(bitmap.contains(3));
+    ASSERT_TRUE(bitmap.contains(70000));
+    ASSERT_FALSE(bitmap.contains(4));
+
+    ASSERT_TRUE(bitmap.remove(70000));
+    ASSERT_FALSE(bitmap.remove(70000));
+    ASSERT_EQ(bitmap.container_count(), 1);
+
+    std::vector<uint32_t> expected = {3, 7};
+    ASSERT_EQ(bitmap.to_vector(), expected);
+}
+
+TEST(EntityBitmap, DenseContainersConvert) {
+    // 10000 members in one chunk forces a bitmap container
+    auto dense = core::EntityBitmap::range(0, 10000);
+    ASSERT_EQ(dense.cardinality(), 10000);
+
+    // Removing all but a few members falls back to an array container
+    auto evens = core::EntityBitmap::range(0, 10000);
+    for (uint32_t row = 1; row < 10000; row += 2) {
+        evens.remove(row);
+    }
+    ASSERT_EQ(evens.cardinality(), 5000);
+    auto odd_free = dense - evens;
+    ASSERT_EQ(odd_free.cardinality(), 5000);
+    ASSERT_FALSE(odd_free.contains(0));
+    ASSERT_TRUE(odd_free.contains(9999));
+
+    // Representation is canonical, so equal sets compare equal
+    ASSERT_TRUE((odd_free | evens) == dense);
+}
+
+TEST(EntityBitmap, SetOperations) {
+    std::vector<uint32_t> a_rows, b_rows;
+    for (uint32_t i = 0; i < 200000; i += 3) a_rows.push_back(i);
+    for (uint32_t i = 0; i < 200000; i += 5) b_rows.push_back(i);
+    auto a = core::EntityBitmap::from_rows(a_rows);
+    auto b = core::EntityBitmap::from_rows(b_rows);
+
+    auto both = a & b;
+    ASSERT_EQ(both.cardinality(), 13334);  // Multiples of 15 below 200000
+    ASSERT_EQ(a.and_cardinality(b), both.cardinality());
+    ASSERT_EQ((a | b).cardinality(), a.cardinality() + b.cardinality() - both.cardinality());
+    ASSERT_EQ((a - b).cardinality(), a.cardinality() - both.cardinality());
+
+    // Iterator and for_each visit the same ordinals in ascending order
+    std::vector<uint32_t> iterated(both.begin(), both.end());
+    ASSERT_EQ(iterated, both.to_vector());
+    ASSERT_EQ(iterated.front(), 0);
+    ASSERT_EQ(iterated[1], 15);
+}
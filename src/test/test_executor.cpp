@@ -0,0 +1,237 @@
+#include "test_framework.h"
+#include "../core/atom_store.h"
+#include "../core/executor.h"
+#include "../core/projection_engine.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <string>
+
+using namespace gtaf;
+using namespace gtaf::test;
+using namespace gtaf::core::exec;
+
+// Helper to create test EntityIds
+types::EntityId make_entity_exec(uint32_t id) {
+    types::EntityId entity{};
+    std::fill(entity.bytes.begin(), entity.bytes.end(), 0);
+    std::memcpy(entity.bytes.data(), &id, sizeof(id));
+    return entity;
+}
+
+TEST(Executor, FilterProjectAggregateSort) {
+    core::AtomStore store;
+    const char* flags[] = {"A", "N", "R"};
+
+    // 3000 line items spread over three batches, interleaved with unrelated entities
+    std::map<std::string, std::pair<int64_t, double>> expected;  // flag -> (count, sum of qty * price)
+    for (uint32_t i = 0; i < 3000; ++i) {
+        auto item = make_entity_exec(i * 2);
+        const char* flag = flags[i % 3];
+        int64_t qty = i % 50;
+        double price = 10.0 + (i % 7);
+        store.append(item, "l.flag", std::string(flag));
+        store.append(item, "l.qty", qty);
+        store.append(item, "l.price", price);
+        store.append(item, "l.day", static_cast<int64_t>(i % 100));
+        store.append(make_entity_exec(i * 2 + 1), "other", static_cast<int64_t>(i));
+        if (i % 100 < 90) {
+            expected[flag].first += 1;
+            expected[flag].second += static_cast<double>(qty) * price;
+        }
+    }
+
+    core::ProjectionEngine projector(store);
+    auto projection = projector.project_columns({{"l.flag"}, {"l.qty"}, {"l.price"}, {"l.day"}});
+
+    auto plan = PlanBuilder::scan(projection, {"l.flag", "l.qty", "l.price", "l.day"})
+        .filter(col("l.day") < lit(90))
+        .project({{"flag", col("l.flag")}, {"qty", col("l.qty")}, {"amount", col("l.qty") * col("l.price")}})
+        .aggregate({"flag"}, {Aggregate::count_all("n"), Aggregate::sum("amount", "total"),
+                              Aggregate::max("qty", "max_qty"), Aggregate::avg("qty", "avg_qty")})
+        .sort({{"flag", false}})
+        .build();
+
+    ASSERT_TRUE(plan.has_value());
+    ASSERT_EQ(plan->schema().size(), 5);
+    ASSERT_TRUE(plan->schema()[2].type == DataType::Double);
+    ASSERT_TRUE(plan->schema()[3].type == DataType::Int64);
+
+    Table result = plan->execute();
+    ASSERT_EQ(result.row_count(), 3);
+    const Vector& flag = *result.find_column("flag");
+    ASSERT_EQ(std::string(flag.strings[0]), "R");
+    ASSERT_EQ(std::string(flag.strings[2]), "A");
+    for (size_t row = 0; row < 3; ++row) {
+        const auto& [count, total] = expected[std::string(flag.strings[row])];
+        ASSERT_EQ(result.find_column("n")->ints[row], count);
+        ASSERT_EQ(result.find_column("total")->doubles[row], total);
+        ASSERT_EQ(result.find_column("max_qty")->ints[row], 49);
+    }
+}
+
+TEST(Executor, NullsSortAndTopN) {
+    core::AtomStore store;
+    for (uint32_t i = 0; i < 10; ++i) {
+        auto entity = make_entity_exec(i);
+        store.append(entity, "name", "item" + std::to_string(i));
+        if (i % 4 != 0) {
+            store.append(entity, "score", static_cast<double>(i));
+        }
+    }
+
+    core::ProjectionEngine projector(store);
+    auto projection = projector.project_columns({{"name"}, {"score"}});
+
+    // Nulls sort first ascending; a limit after sort runs as top-N
+    auto lowest = PlanBuilder::scan(projection).sort({{"score"}}).limit(4).build()->execute();
+    ASSERT_EQ(lowest.row_count(), 4);
+    ASSERT_FALSE(lowest.find_column("score")->is_valid(0));
+    ASSERT_FALSE(lowest.find_column("score")->is_valid(2));
+    ASSERT_EQ(lowest.find_column("score")->doubles[3], 1.0);
+
+    auto highest = PlanBuilder::scan(projection).sort({{"score", false}}).limit(2).build()->execute();
+    ASSERT_EQ(std::string(highest.find_column("name")->strings[0]), "item9");
+    ASSERT_EQ(highest.find_column("score")->doubles[1], 7.0);
+
+    // Null comparisons are dropped by filters; OR with a true side is still true
+    auto filtered = PlanBuilder::scan(projection)
+        .filter(col("score") > lit(5.0) || col("name") == lit("item0"))
+        .build()->execute();
+    ASSERT_EQ(filtered.row_count(), 4);
+
+    // Global aggregate over an empty input still yields one row
+    auto empty = PlanBuilder::scan(projection)
+        .filter(col("score") > lit(100))
+        .aggregate({}, {Aggregate::count_all("n"), Aggregate::sum("score", "total")})
+        .build()->execute();
+    ASSERT_EQ(empty.row_count(), 1);
+    ASSERT_EQ(empty.find_column("n")->ints[0], 0);
+    ASSERT_FALSE(empty.find_column("total")->is_valid(0));
+
+    // Plain limit without a sort
+    ASSERT_EQ(PlanBuilder::scan(projection).limit(3).build()->execute().row_count(), 3);
+}
+
+TEST(Executor, RejectsInvalidPlans) {
+    core::AtomStore store;
+    store.append(make_entity_exec(1), "name", std::string("a"));
+    core::ProjectionEngine projector(store);
+    auto projection = projector.project_columns({{"name"}});
+
+    // Bind errors are recorded, not thrown; later steps are skipped
+    auto rejected = [](auto&& builder) {
+        std::string error;
+        return !builder.error().empty() && !builder.limit(1).build(&error) && !error.empty();
+    };
+    ASSERT_TRUE(rejected(PlanBuilder::scan(projection, {"missing"})));
+    ASSERT_TRUE(rejected(PlanBuilder::scan(projection).filter(col("nope") == lit(1))));
+    ASSERT_TRUE(rejected(PlanBuilder::scan(projection).filter(col("name") == lit(1))));
+    ASSERT_TRUE(rejected(PlanBuilder::scan(projection).aggregate({}, {Aggregate::sum("name", "s")})));
+    ASSERT_TRUE(rejected(PlanBuilder::scan(projection).sort({{"nope"}})));
+
+    auto first = PlanBuilder::scan(projection);
+    first.filter(col("nope") == lit(1)).filter(col("other") == lit(1));
+    ASSERT_EQ(first.error(), "Unknown column: nope");
+    ASSERT_TRUE(first.schema().empty());
+
+    auto built = PlanBuilder::scan(projection);
+    ASSERT_TRUE(built.build().has_value());
+    ASSERT_FALSE(built.build().has_value());
+
+    auto table = PlanBuilder::scan(projection).build()->execute();
+    ASSERT_TRUE(table.find_column("name") != nullptr);
+    ASSERT_TRUE(table.find_column("missing") == nullptr);
+}
+
+TEST(Executor, HashJoinAlongEdges) {
+    core::AtomStore store;
+    const char* segments[] = {"A", "B"};
+    for (uint32_t c = 0; c < 5; ++c) {
+        auto customer = make_entity_exec(100000 + c);
+        store.append(customer, "c.name", "cust" + std::to_string(c));
+        store.append(customer, "c.segment", std::string(segments[c % 2]));
+    }
+
+    // Orders spanning several batches; some edges dangle, some orders have none
+    std::map<std::string, int64_t> expected;  // customer name -> total amount (segment A only)
+    for (uint32_t i = 0; i < 3000; ++i) {
+        auto order = make_entity_exec(i);
+        const uint32_t c = i % 5;
+        store.append(order, "o.amount", static_cast<int64_t>(i));
+        if (i % 7 == 0) continue;
+        const uint32_t target = (i % 11 == 0) ? 200000 + i : 100000 + c;
+        store.append(order, "o.customer", types::EdgeValue{make_entity_exec(target), "customer"});
+        if (i % 11 != 0 && c % 2 == 0) {
+            expected["cust" + std::to_string(c)] += i;
+        }
+    }
+
+    core::ProjectionEngine projector(store);
+    auto projection = projector.project_columns({{"o.customer"}, {"o.amount"}, {"c.name"}, {"c.segment"}});
+
+    // Edges project as target ordinals; dangling targets are null
+    const core::Column* edges = projection.find("o.customer");
+    ASSERT_TRUE(edges->type() == core::ColumnType::Edge);
+    auto order1 = *store.find_ordinal(make_entity_exec(1));
+    ASSERT_EQ(edges->ints()[order1], static_cast<int64_t>(*store.find_ordinal(make_entity_exec(100001))));
+    ASSERT_FALSE(edges->is_valid(*store.find_ordinal(make_entity_exec(11))));
+
+    auto customers = [&] {
+        auto plan = PlanBuilder::scan(projection, {"c.name", "c.segment"}, "c_ordinal");
+        plan.filter(col("c.segment") == lit("A"));
+        return plan;
+    };
+    auto orders = [&] { return PlanBuilder::scan(projection, {"o.customer", "o.amount"}); };
+
+    // Probe with edges (build on customers), and the mirrored plan (build on the left)
+    auto by_edge = orders().join(customers(), "o.customer", "c_ordinal")
+        .aggregate({"c.name"}, {Aggregate::sum("o.amount", "total")})
+        .build()->execute();
+    auto mirrored = customers().join(orders(), "c_ordinal", "o.customer").build();
+    ASSERT_EQ(mirrored->schema()[0].name, "c.name");
+    auto mirrored_rows = mirrored->execute();
+
+    ASSERT_EQ(by_edge.row_count(), expected.size());
+    for (size_t row = 0; row < by_edge.row_count(); ++row) {
+        ASSERT_EQ(by_edge.find_column("total")->ints[row], expected[std::string(by_edge.find_column("c.name")->strings[row])]);
+    }
+    int64_t mirrored_total = 0;
+    for (size_t row = 0; row < mirrored_rows.row_count(); ++row) {
+        mirrored_total += mirrored_rows.find_column("o.amount")->ints[row];
+    }
+    int64_t expected_total = 0;
+    for (const auto& [name, total] : expected) expected_total += total;
+    ASSERT_EQ(mirrored_total, expected_total);
+
+    // Many-to-many on a string key: output pairs span several batches
+    auto pairs = customers()
+        .join(PlanBuilder::scan(projection, {"c.segment"}).project({{"segment", col("c.segment")}}),
+              "c.segment", "segment")
+        .aggregate({}, {Aggregate::count_all("n")})
+        .build()->execute();
+    ASSERT_EQ(pairs.find_column("n")->ints[0], 9);
+
+    ASSERT_FALSE(orders().join(orders(), "o.customer", "o.customer").build().has_value());
+    ASSERT_FALSE(orders().join(customers(), "o.customer", "c.name").build().has_value());
+
+    // A bind error on the right side carries over to the joined plan
+    auto broken = PlanBuilder::scan(projection, {"missing"});
+    auto joined = orders();
+    joined.join(broken, "o.customer", "c_ordinal");
+    ASSERT_EQ(joined.error(), "Column not projected: missing");
+    ASSERT_TRUE(broken.error().empty());
+
+    // Consumed or built right sides and self-joins are errors, not crashes
+    auto consumed = orders();
+    consumed.join(broken, "o.customer", "c_ordinal");
+    ASSERT_EQ(consumed.error(), "Right plan already built");
+    auto built = customers();
+    ASSERT_TRUE(built.build().has_value());
+    auto after_build = orders();
+    ASSERT_FALSE(after_build.join(built, "o.customer", "c_ordinal").build().has_value());
+    auto self = customers();
+    self.join(self, "c_ordinal", "c_ordinal");
+    ASSERT_EQ(self.error(), "Cannot join a plan with itself");
+    ASSERT_FALSE(self.build().has_value());
+}
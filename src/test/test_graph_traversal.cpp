@@ -0,0 +1,230 @@
+#include "test_framework.h"
+#include "../core/atom_store.h"
+#include "../core/graph_traversal.h"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+
+using namespace gtaf;
+using namespace gtaf::test;
+
+// Helper to create test EntityIds
+types::EntityId make_entity_graph(uint32_t id) {
+    types::EntityId entity{};
+    std::fill(entity.bytes.begin(), entity.bytes.end(), 0);
+    std::memcpy(entity.bytes.data(), &id, sizeof(id));
+    return entity;
+}
+
+namespace {
+
+void link(core::AtomStore& store, uint32_t from, uint32_t to, const std::string& relation) {
+    // One tag per edge: a tag holds a single (latest) edge
+    store.append(make_entity_graph(from), "edge." + relation + "." + std::to_string(to),
+                 types::EdgeValue{make_entity_graph(to), relation});
+}
+
+} // namespace
+
+TEST(GraphTraversal, HopsPathsAndSnapshots) {
+    // customer(1) -owns-> site(2) -hosts-> asset(3) -has-> request(4)
+    //             -owns-> site(5) -hosts-> asset(6); request(7) -about-> asset(6)
+    core::AtomStore store;
+    for (uint32_t id = 1; id <= 7; ++id) {
+        store.append(make_entity_graph(id), "name", "n" + std::to_string(id));
+    }
+    link(store, 1, 2, "owns");
+    link(store, 2, 3, "hosts");
+    link(store, 3, 4, "has");
+    auto before_second_site = store.current_lsn();
+    link(store, 1, 5, "owns");
+    link(store, 5, 6, "hosts");
+    link(store, 7, 6, "about");
+
+    core::GraphTraversal graph(store, 1);
+    auto ordinal = [&](uint32_t id) { return *store.find_ordinal(make_entity_graph(id)); };
+
+    core::TraversalOptions options;
+    options.max_hops = 2;
+    auto within_two = graph.k_hop(make_entity_graph(1), options);
+    ASSERT_EQ(within_two.cardinality(), 4);
+    ASSERT_TRUE(within_two.contains(ordinal(3)));
+    ASSERT_FALSE(within_two.contains(ordinal(4)));
+    ASSERT_FALSE(within_two.contains(ordinal(1)));
+
+    auto levels = graph.bfs_levels({ordinal(1)});
+    ASSERT_EQ(levels.size(), 4);
+    ASSERT_EQ(levels[1].cardinality(), 2);
+    ASSERT_TRUE(levels[3].contains(ordinal(4)));
+
+    // Relation filter and direction
+    core::TraversalOptions owns_only;
+    owns_only.relations = {"owns", "no-such-relation"};
+    ASSERT_EQ(graph.k_hop(make_entity_graph(1), owns_only).cardinality(), 2);
+    core::TraversalOptions upstream;
+    upstream.direction = core::EdgeDirection::Incoming;
+    ASSERT_TRUE(graph.reachable(make_entity_graph(6), make_entity_graph(7), upstream));
+    ASSERT_TRUE(graph.reachable(make_entity_graph(4), make_entity_graph(1), upstream));
+    ASSERT_FALSE(graph.reachable(make_entity_graph(1), make_entity_graph(7)));
+    ASSERT_TRUE(graph.reachable(make_entity_graph(7), make_entity_graph(7)));
+
+    auto path = graph.shortest_path(make_entity_graph(1), make_entity_graph(4));
+    ASSERT_EQ(path.size(), 4);
+    ASSERT_TRUE(path[1] == make_entity_graph(2));
+    ASSERT_TRUE(path[3] == make_entity_graph(4));
+    ASSERT_TRUE(graph.shortest_path(make_entity_graph(1), make_entity_graph(4), options).empty());
+    ASSERT_TRUE(graph.shortest_path(make_entity_graph(1), make_entity_graph(99)).empty());
+
+    // Pinned snapshot: the second site did not exist yet
+    core::TraversalOptions pinned;
+    pinned.as_of = before_second_site;
+    ASSERT_EQ(graph.k_hop(make_entity_graph(1), pinned).cardinality(), 3);
+    ASSERT_FALSE(graph.reachable(make_entity_graph(1), make_entity_graph(6), pinned));
+    ASSERT_TRUE(graph.reachable(make_entity_graph(1), make_entity_graph(6)));
+
+    // An edge to a target without atoms becomes visible when the target appears
+    link(store, 4, 8, "has");
+    auto before_target = store.current_lsn();
+    store.append(make_entity_graph(8), "name", std::string("n8"));
+    ASSERT_TRUE(graph.reachable(make_entity_graph(1), make_entity_graph(8)));
+    pinned.as_of = before_target;
+    ASSERT_FALSE(graph.reachable(make_entity_graph(1), make_entity_graph(8), pinned));
+}
+
+TEST(GraphTraversal, ParallelMatchesSerial) {
+    // Large frontiers so expansion runs on several threads
+    constexpr uint32_t kNodes = 60000;
+    core::AtomStore store;
+    std::vector<core::AtomStore::BatchAtom> batch;
+    for (uint32_t i = 0; i < kNodes; ++i) {
+        const uint32_t targets[] = {(i * 7 + 1) % kNodes, (i * 13 + 5) % kNodes, (i + 1) % kNodes};
+        for (size_t k = 0; k < 3; ++k) {
+            batch.push_back({make_entity_graph(i), "edge.next." + std::to_string(k),
+                             types::EdgeValue{make_entity_graph(targets[k]), "next"}});
+        }
+        if (batch.size() >= 30000) {
+            store.append_batch(batch);
+            batch.clear();
+        }
+    }
+    store.append_batch(batch);
+
+    // Reference BFS distances straight off the adjacency index
+    const auto& adjacency = store.adjacency();
+    auto next = *adjacency.find_relation("next");
+    const uint32_t source = *store.find_ordinal(make_entity_graph(0));
+    std::vector<int> distance(store.entity_count(), -1);
+    std::deque<uint32_t> queue = {source};
+    distance[source] = 0;
+    while (!queue.empty()) {
+        uint32_t at = queue.front();
+        queue.pop_front();
+        adjacency.outgoing(at, next).for_each([&](uint32_t to) {
+            if (distance[to] < 0) {
+                distance[to] = distance[at] + 1;
+                queue.push_back(to);
+            }
+        });
+    }
+
+    auto serial = core::GraphTraversal(store, 1).bfs_levels({source});
+    core::GraphTraversal parallel_graph(store, 4);
+    auto parallel = parallel_graph.bfs_levels({source});
+    ASSERT_EQ(parallel.size(), serial.size());
+    bool has_large_level = false;
+    for (size_t hop = 0; hop < parallel.size(); ++hop) {
+        ASSERT_TRUE(parallel[hop] == serial[hop]);
+        has_large_level |= parallel[hop].cardinality() > 8192;
+        parallel[hop].for_each([&](uint32_t ordinal) { ASSERT_EQ(distance[ordinal], static_cast<int>(hop)); });
+    }
+    ASSERT_TRUE(has_large_level);
+
+    auto far = std::max_element(distance.begin(), distance.end()) - distance.begin();
+    auto path = parallel_graph.shortest_path(make_entity_graph(0), store.entity_at(static_cast<uint32_t>(far)));
+    ASSERT_EQ(path.size(), static_cast<size_t>(distance[far] + 1));
+    for (size_t i = 1; i < path.size(); ++i) {
+        bool linked = false;
+        adjacency.outgoing(*store.find_ordinal(path[i - 1]), next).for_each([&](uint32_t to) {
+            linked |= to == *store.find_ordinal(path[i]);
+        });
+        ASSERT_TRUE(linked);
+    }
+}
+
+TEST(GraphTraversal, RepointedEdges) {
+    core::AtomStore store;
+    auto entity = [](uint32_t id) { return make_entity_graph(id); };
+    store.append(entity(5), "noise", static_cast<int64_t>(1));
+    store.append(entity(5), "noise", static_cast<int64_t>(2));
+    auto after_noise = store.current_lsn();
+    for (uint32_t id = 1; id <= 4; ++id) {
+        store.append(entity(id), "name", "n" + std::to_string(id));
+    }
+    auto ordinal = [&](uint32_t id) { return *store.find_ordinal(entity(id)); };
+
+    // The latest value of a tag is its only edge
+    store.append(entity(1), "edge.manager", types::EdgeValue{entity(2), "reports_to"});
+    auto before_move = store.current_lsn();
+    store.append(entity(1), "edge.manager", types::EdgeValue{entity(3), "reports_to"});
+    store.append(entity(1), "edge.mentor", types::EdgeValue{entity(3), "reports_to"});
+    auto before_second_move = store.current_lsn();
+    store.append(entity(1), "edge.manager", types::EdgeValue{entity(4), "reports_to"});  // Mentor keeps 1->3
+
+    // An edge to an absent target is dropped when superseded before it appears
+    store.append(entity(1), "edge.buddy", types::EdgeValue{entity(9), "buddy"});
+    store.append(entity(1), "edge.buddy", types::EdgeValue{entity(2), "buddy"});
+    store.append(entity(9), "name", std::string("n9"));
+
+    // Mutable edges retire the same way
+    store.append(entity(2), "edge.desk", types::EdgeValue{entity(3), "near"}, types::AtomType::Mutable);
+    auto before_desk = store.current_lsn();
+    store.append(entity(2), "edge.desk", types::EdgeValue{entity(4), "near"}, types::AtomType::Mutable);
+
+    auto check = [&](const core::AtomStore& source) {
+        const auto& adjacency = source.adjacency();
+        auto reports_to = *adjacency.find_relation("reports_to");
+        auto visit = [](const core::Neighbours& neighbours) {
+            std::vector<uint32_t> out;
+            neighbours.for_each([&](uint32_t to) { out.push_back(to); });
+            return out;
+        };
+        ASSERT_TRUE(visit(adjacency.outgoing(ordinal(1), reports_to)) == (std::vector<uint32_t>{ordinal(3), ordinal(4)}));
+        ASSERT_TRUE(adjacency.incoming(ordinal(2), reports_to).empty());
+        ASSERT_EQ(adjacency.outgoing(ordinal(1), reports_to).size(), 2);
+        ASSERT_TRUE(visit(adjacency.outgoing(ordinal(1), reports_to).as_of(before_move)) ==
+                    std::vector<uint32_t>{ordinal(2)});
+        ASSERT_TRUE(visit(adjacency.outgoing(ordinal(1), reports_to).as_of(before_second_move)) ==
+                    std::vector<uint32_t>{ordinal(3)});
+        ASSERT_EQ(adjacency.edge_count(), 4);   // 1->3, 1->4, 1->2 (buddy), 2->4
+
+        core::GraphTraversal graph(source, 1);
+        ASSERT_FALSE(graph.reachable(entity(1), entity(2), {.relations = {"reports_to"}}));
+        ASSERT_FALSE(graph.reachable(entity(1), entity(9)));
+        ASSERT_TRUE(graph.reachable(entity(1), entity(2), {.relations = {"buddy"}}));
+        ASSERT_TRUE(graph.reachable(entity(1), entity(2), {.relations = {"reports_to"}, .as_of = before_move}));
+        ASSERT_TRUE(graph.reachable(entity(2), entity(4), {.relations = {"near"}}));
+        ASSERT_FALSE(graph.reachable(entity(2), entity(3), {.relations = {"near"}}));
+        ASSERT_TRUE(graph.reachable(entity(2), entity(3), {.relations = {"near"}, .as_of = before_desk}));
+
+        // Traversals agree with latest-value projections
+        auto manager = source.get_latest_value(entity(1), "edge.manager");
+        ASSERT_TRUE(std::get<types::EdgeValue>(*manager).target == entity(4));
+    };
+    check(store);
+
+    std::string path = "test_repointed_edges.dat";
+    ASSERT_TRUE(store.save(path));
+    core::AtomStore loaded;
+    ASSERT_TRUE(loaded.load(path));
+    check(loaded);
+    std::remove(path.c_str());
+
+    // Rebuilding from the reference layer replays the retirements
+    core::AtomStore::CompactionOptions options;
+    options.keep_versions = 1;
+    options.keep_after = after_noise;
+    ASSERT_EQ(loaded.compact(options).references_removed, 1);
+    check(loaded);
+}
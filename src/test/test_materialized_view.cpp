@@ -0,0 +1,309 @@
+#include "test_framework.h"
+#include "../core/atom_store.h"
+#include "../core/materialized_view.h"
+#include <algorithm>
+#include <cstring>
+#include <atomic>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace gtaf;
+using namespace gtaf::test;
+
+// Helper to create test EntityIds
+types::EntityId make_entity_view(uint32_t id) {
+    types::EntityId entity{};
+    std::fill(entity.bytes.begin(), entity.bytes.end(), 0);
+    std::memcpy(entity.bytes.data(), &id, sizeof(id));
+    return entity;
+}
+
+TEST(MaterializedView, ProjectionViewTracksAppends) {
+    core::AtomStore store;
+    for (uint32_t id = 0; id < 3000; ++id) {
+        store.append(make_entity_view(id), "kind", std::string(id % 3 == 0 ? "ticket" : "asset"));
+        store.append(make_entity_view(id), "title", "t" + std::to_string(id));
+        if (id % 2 == 0) store.append(make_entity_view(id), "priority", static_cast<int64_t>(id % 5));
+    }
+
+    core::ProjectionView tickets(store, {"title", "priority", "title"}, core::ViewFilter{"kind", std::string("ticket")});
+    tickets.build();
+    tickets.subscribe(store);
+    ASSERT_EQ(tickets.tags().size(), 2);
+
+    auto before = tickets.snapshot();
+    ASSERT_EQ(before->size(), 1000);
+    ASSERT_TRUE(before->lsn() == store.current_lsn());
+    auto ordinal = [&](uint32_t id) { return *store.find_ordinal(make_entity_view(id)); };
+    size_t title = *before->column("title");
+    size_t priority = *before->column("priority");
+    ASSERT_EQ(std::get<std::string>(*before->get(ordinal(3), title)), "t3");
+    ASSERT_TRUE(before->get(ordinal(3), priority) == nullptr);
+    ASSERT_EQ(std::get<int64_t>(*before->get(ordinal(6), priority)), 1);
+    ASSERT_FALSE(before->contains(ordinal(1)));
+    ASSERT_TRUE(before->get(ordinal(1), title) == nullptr);
+
+    // Updates, a reclassified entity and a new one are applied as they commit
+    store.append(make_entity_view(3), "title", std::string("renamed"));
+    store.append(make_entity_view(1), "kind", std::string("ticket"));
+    store.append(make_entity_view(0), "kind", std::string("closed"));
+    store.append(make_entity_view(5000), "kind", std::string("ticket"));
+    ASSERT_TRUE(tickets.snapshot() != before);
+
+    auto after = tickets.snapshot();
+    ASSERT_TRUE(tickets.snapshot() == after);   // Unchanged views share one snapshot
+    ASSERT_EQ(after->size(), 1001);
+    ASSERT_EQ(std::get<std::string>(*after->get(ordinal(3), title)), "renamed");
+    ASSERT_EQ(std::get<std::string>(*after->get(ordinal(1), title)), "t1");
+    ASSERT_FALSE(after->contains(ordinal(0)));
+    ASSERT_TRUE(after->contains(ordinal(5000)));
+    ASSERT_TRUE(after->get(ordinal(5000), title) == nullptr);
+
+    // The earlier snapshot is untouched by the copy-on-write updates
+    ASSERT_EQ(std::get<std::string>(*before->get(ordinal(3), title)), "t3");
+    ASSERT_TRUE(before->contains(ordinal(0)));
+    ASSERT_FALSE(before->contains(ordinal(1)));
+
+    size_t visited = 0;
+    after->for_each([&](uint32_t row, std::span<const types::AtomValue> values) {
+        ASSERT_TRUE(after->contains(row));
+        ASSERT_EQ(values.size(), 2);
+        ++visited;
+    });
+    ASSERT_EQ(visited, after->size());
+
+    // An unfiltered view holds every entity with a projected value
+    core::ProjectionView all(store, {"priority"});
+    all.build();
+    ASSERT_EQ(all.snapshot()->size(), 1500);
+}
+
+TEST(MaterializedView, AggregateViewGroups) {
+    core::AtomStore store;
+    auto ticket = [&](uint32_t id, const std::string& status, int64_t cost) {
+        store.append(make_entity_view(id), "kind", std::string("ticket"));
+        store.append(make_entity_view(id), "status", status);
+        store.append(make_entity_view(id), "cost", cost);
+    };
+    ticket(1, "open", 10);
+    ticket(2, "open", 30);
+    ticket(3, "closed", 5);
+    store.append(make_entity_view(4), "status", std::string("open"));   // Not a ticket
+
+    auto make = [&](core::AggregateOp op) {
+        core::AggregateSpec spec;
+        spec.group_by = "status";
+        spec.op = op;
+        spec.value_tag = "cost";
+        spec.filter = core::ViewFilter{"kind", std::string("ticket")};
+        return std::make_unique<core::AggregateView>(store, spec);
+    };
+    auto count = make(core::AggregateOp::Count);
+    auto sum = make(core::AggregateOp::Sum);
+    auto min = make(core::AggregateOp::Min);
+    auto max = make(core::AggregateOp::Max);
+    for (auto* view : {count.get(), sum.get(), min.get(), max.get()}) {
+        view->build();
+        view->subscribe(store);
+    }
+
+    auto value = [](const core::AggregateView& view, const std::string& key) {
+        const auto* group = view.snapshot()->find(core::ViewKey(key));
+        return group ? group->value : -1.0;
+    };
+    ASSERT_EQ(count->snapshot()->groups().size(), 2);
+    ASSERT_EQ(value(*count, "open"), 2.0);
+    ASSERT_EQ(value(*sum, "open"), 40.0);
+    ASSERT_EQ(value(*min, "open"), 10.0);
+    ASSERT_EQ(value(*max, "open"), 30.0);
+    auto frozen = min->snapshot();
+
+    // Moving, re-pricing and reclassifying entities retracts old contributions
+    store.append(make_entity_view(1), "status", std::string("closed"));
+    store.append(make_entity_view(2), "cost", static_cast<int64_t>(7));
+    store.append(make_entity_view(4), "kind", std::string("ticket"));
+    store.append(make_entity_view(3), "kind", std::string("asset"));
+    ASSERT_EQ(value(*count, "open"), 2.0);     // Entities 2 and 4
+    ASSERT_EQ(value(*sum, "open"), 7.0);       // Entity 4 has no cost
+    ASSERT_EQ(sum->snapshot()->find(core::ViewKey(std::string("open")))->values, 1);
+    ASSERT_EQ(value(*min, "closed"), 10.0);
+    ASSERT_EQ(value(*max, "open"), 7.0);
+    ASSERT_EQ(value(*count, "closed"), 1.0);
+    ASSERT_EQ(frozen->find(core::ViewKey(std::string("open")))->value, 10.0);
+
+    store.append(make_entity_view(1), "kind", std::string("asset"));
+    ASSERT_TRUE(count->snapshot()->find(core::ViewKey(std::string("closed"))) == nullptr);
+
+    // A fresh build reproduces the incrementally maintained state
+    auto rebuilt = make(core::AggregateOp::Sum);
+    rebuilt->build();
+    auto lhs = rebuilt->snapshot()->groups();
+    auto rhs = sum->snapshot()->groups();
+    ASSERT_EQ(lhs.size(), rhs.size());
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        ASSERT_TRUE(lhs[i].key == rhs[i].key);
+        ASSERT_EQ(lhs[i].count, rhs[i].count);
+        ASSERT_EQ(lhs[i].value, rhs[i].value);
+    }
+}
+
+TEST(MaterializedView, SnapshotLsnAndExactSums) {
+    core::AtomStore store;
+    store.append(make_entity_view(1), "status", std::string("open"));
+    store.append(make_entity_view(1), "cost", 1e16);
+    store.append(make_entity_view(2), "status", std::string("open"));
+    store.append(make_entity_view(2), "cost", static_cast<int64_t>(1));
+
+    core::AggregateSpec spec;
+    spec.group_by = "status";
+    spec.op = core::AggregateOp::Sum;
+    spec.value_tag = "cost";
+    core::AggregateView sum(store, spec);
+    core::ProjectionView titles(store, {"title"});
+    for (core::MaterializedView* view : {static_cast<core::MaterializedView*>(&sum),
+                                         static_cast<core::MaterializedView*>(&titles)}) {
+        view->build();
+        view->subscribe(store);
+    }
+    auto before = titles.snapshot();
+
+    // Appends the views ignore still advance the LSN their snapshots report
+    store.append(make_entity_view(3), "noise", static_cast<int64_t>(0));
+    ASSERT_TRUE(titles.snapshot() != before);
+    ASSERT_TRUE(titles.snapshot()->lsn() == store.current_lsn());
+    ASSERT_TRUE(sum.snapshot()->lsn() == store.current_lsn());
+    ASSERT_TRUE(titles.snapshot() == titles.snapshot());
+    ASSERT_TRUE(before->lsn() < store.current_lsn());
+
+    // Retracting a large value leaves the small one it absorbed intact
+    store.append(make_entity_view(1), "cost", 0.5);
+    ASSERT_EQ(sum.snapshot()->find(core::ViewKey(std::string("open")))->value, 1.5);
+    store.append(make_entity_view(2), "status", std::string("closed"));
+    ASSERT_EQ(sum.snapshot()->find(core::ViewKey(std::string("open")))->value, 0.5);
+    ASSERT_EQ(sum.snapshot()->find(core::ViewKey(std::string("closed")))->value, 1.0);
+}
+
+TEST(MaterializedView, SnapshotsFromReaderThreads) {
+    core::AtomStore store;
+    core::AggregateSpec spec;
+    spec.group_by = "bucket";
+    spec.op = core::AggregateOp::Sum;
+    spec.value_tag = "amount";
+    core::AggregateView view(store, spec);
+    view.build();
+    view.subscribe(store);
+
+    // Readers only ever observe whole appends: each entity adds 1 to "b"
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::thread reader([&] {
+        while (!done.load()) {
+            auto snapshot = view.snapshot();
+            if (const auto* group = snapshot->find(core::ViewKey(std::string("b")))) {
+                if (group->value != static_cast<double>(group->count)) ++torn;
+            }
+        }
+    });
+    for (uint32_t id = 0; id < 2000; ++id) {
+        store.append_batch({{make_entity_view(id), "bucket", std::string("b")},
+                            {make_entity_view(id), "amount", static_cast<int64_t>(1)}});
+    }
+    done = true;
+    reader.join();
+    ASSERT_EQ(torn.load(), 0);
+    ASSERT_EQ(view.snapshot()->find(core::ViewKey(std::string("b")))->value, 2000.0);
+}
+
+TEST(MaterializedView, NaNAndCatchUp) {
+    core::AtomStore store;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    store.append(make_entity_view(1), "bucket", std::string("a"));
+    store.append(make_entity_view(1), "amount", 4.0);
+    store.append(make_entity_view(2), "bucket", std::string("a"));
+    store.append(make_entity_view(2), "amount", nan);
+    store.append(make_entity_view(3), "bucket", nan);
+    store.append(make_entity_view(3), "amount", 1.0);
+
+    core::AggregateSpec spec;
+    spec.group_by = "bucket";
+    spec.op = core::AggregateOp::Max;
+    spec.value_tag = "amount";
+    core::AggregateView view(store, spec);
+    view.build();
+
+    // NaN is no value, and a NaN key is no group
+    auto snapshot = view.snapshot();
+    ASSERT_EQ(snapshot->groups().size(), 1);
+    const auto* group = snapshot->find(core::ViewKey(std::string("a")));
+    ASSERT_EQ(group->count, 2);
+    ASSERT_EQ(group->values, 1);
+    ASSERT_EQ(group->value, 4.0);
+
+    // Appends between build() and subscribe() are not lost
+    store.append(make_entity_view(2), "amount", 9.0);
+    store.append(make_entity_view(2), "amount", nan);
+    store.append(make_entity_view(4), "bucket", std::string("a"));
+    store.append(make_entity_view(4), "amount", 6.0);
+    view.subscribe(store);
+    ASSERT_TRUE(view.applied_lsn() == store.current_lsn());
+    group = view.snapshot()->find(core::ViewKey(std::string("a")));
+    ASSERT_EQ(group->count, 3);
+    ASSERT_EQ(group->values, 2);
+    ASSERT_EQ(group->value, 6.0);
+
+    store.append(make_entity_view(1), "amount", 7.0);
+    ASSERT_EQ(view.snapshot()->find(core::ViewKey(std::string("a")))->value, 7.0);
+    ASSERT_EQ(view.catch_up(), 0);
+}
+
+TEST(MaterializedView, StoreReloadRebuilds) {
+    core::AtomStore store;
+    for (uint32_t i = 1; i <= 10; ++i) {
+        store.append(make_entity_view(i), "bucket", std::string("old"));
+        store.append(make_entity_view(i), "amount", static_cast<int64_t>(i));
+    }
+
+    core::AggregateSpec spec;
+    spec.group_by = "bucket";
+    spec.op = core::AggregateOp::Sum;
+    spec.value_tag = "amount";
+    core::AggregateView view(store, spec);
+    view.build();
+    view.subscribe(store);
+    ASSERT_EQ(view.snapshot()->find(core::ViewKey(std::string("old")))->value, 55.0);
+
+    // Loading a smaller file restarts ordinals and LSNs; the view is rebuilt
+    const std::string path = "test_materialized_view_reload.dat";
+    core::AtomStore other;
+    other.append(make_entity_view(20), "bucket", std::string("loaded"));
+    other.append(make_entity_view(20), "amount", static_cast<int64_t>(3));
+    ASSERT_TRUE(other.save(path));
+    ASSERT_TRUE(store.load(path));
+    std::remove(path.c_str());
+    ASSERT_TRUE(view.applied_lsn() == store.current_lsn());
+    ASSERT_TRUE(view.snapshot()->find(core::ViewKey(std::string("old"))) == nullptr);
+    ASSERT_EQ(view.snapshot()->find(core::ViewKey(std::string("loaded")))->value, 3.0);
+
+    // Appends after the load are applied under the new ordinals
+    store.append(make_entity_view(20), "amount", static_cast<int64_t>(5));
+    store.append(make_entity_view(21), "bucket", std::string("loaded"));
+    store.append(make_entity_view(21), "amount", static_cast<int64_t>(4));
+    const auto* group = view.snapshot()->find(core::ViewKey(std::string("loaded")));
+    ASSERT_EQ(group->count, 2);
+    ASSERT_EQ(group->value, 9.0);
+    ASSERT_EQ(view.catch_up(), 0);
+
+    // An unsubscribed view notices the reload on catch_up()
+    view.unsubscribe();
+    ASSERT_TRUE(other.save(path));
+    ASSERT_TRUE(store.load(path));
+    std::remove(path.c_str());
+    ASSERT_EQ(view.snapshot()->find(core::ViewKey(std::string("loaded")))->count, 2);
+    view.catch_up();
+    group = view.snapshot()->find(core::ViewKey(std::string("loaded")));
+    ASSERT_EQ(group->count, 1);
+    ASSERT_EQ(group->value, 3.0);
+}
@@ -2,6 +2,11 @@
 #include "../core/atom_store.h"
 #include "../core/projection_engine.h"
 #include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
 
 using namespace gtaf;
 using namespace gtaf::test;
@@ -242,3 +247,398 @@ TEST(ProjectionEngine, RebuildAllEfficiency) {
         ASSERT_EQ(node.get_all().size(), 10);
     }
 }
+
+TEST(ProjectionEngine, ProjectColumns) {
+    core::AtomStore store;
+    auto entity1 = make_entity_node(1);
+    auto entity2 = make_entity_node(2);
+    auto entity3 = make_entity_node(3);
+
+    store.append(entity1, "qty", std::string("17"));
+    store.append(entity1, "status", std::string("open"));
+    store.append(entity2, "status", std::string("closed"));
+    store.append(entity3, "qty", std::string("not a number"));
+    store.append(entity1, "qty", std::string("24"));  // Latest value wins
+
+    core::ProjectionEngine projector(store);
+    auto projection = projector.project_columns({
+        {"qty", core::ColumnType::Int64},
+        {"status"},
+        {"missing"}
+    });
+
+    ASSERT_EQ(projection.row_count(), 3);
+    ASSERT_EQ(projection.column_count(), 3);
+    ASSERT_TRUE(projection.lsn() == store.current_lsn());
+    ASSERT_TRUE(projection.find("other") == nullptr);
+
+    // Rows are store ordinals; unrepresentable and absent values are null
+    const core::Column& qty = *projection.find("qty");
+    uint32_t row1 = *store.find_ordinal(entity1);
+    ASSERT_EQ(qty.count(), 1);
+    ASSERT_EQ(qty.ints()[row1], 24);
+    ASSERT_FALSE(qty.is_valid(*store.find_ordinal(entity3)));
+
+    const core::Column& status = projection.column(1);
+    ASSERT_TRUE(status.type() == core::ColumnType::String);
+    ASSERT_EQ(status.string_at(*store.find_ordinal(entity2)), "closed");
+    ASSERT_EQ(projection.column(2).count(), 0);
+    ASSERT_EQ(projection.column(2).size(), 3);
+}
+
+TEST(Node, ProjectionCache) {
+    core::AtomStore store;
+    for (uint8_t id = 1; id <= 100; ++id) {
+        store.append(make_entity_node(id), "name", "entity" + std::to_string(id));
+        store.append(make_entity_node(id), "rank", static_cast<int64_t>(id));
+    }
+
+    core::ProjectionEngine projector(store);
+    ASSERT_FALSE(projector.cache_enabled());
+    projector.enable_cache(1 << 20);
+
+    auto first = projector.rebuild(make_entity_node(7));
+    auto second = projector.rebuild(make_entity_node(7));
+    auto stats = projector.cache_stats();
+    ASSERT_EQ(stats.misses, 1);
+    ASSERT_EQ(stats.hits, 1);
+    ASSERT_EQ(std::get<int64_t>(*second.get("rank")), 7);
+    ASSERT_EQ(second.history().size(), first.history().size());
+
+    // Appends are applied to the cached Node on the next lookup
+    store.append(make_entity_node(7), "rank", static_cast<int64_t>(700));
+    store.append(make_entity_node(7), "team", std::string("blue"));
+    auto patched = projector.rebuild(make_entity_node(7));
+    ASSERT_EQ(projector.cache_stats().patches, 1);
+    ASSERT_EQ(std::get<int64_t>(*patched.get("rank")), 700);
+    ASSERT_EQ(std::get<std::string>(*patched.get("team")), "blue");
+    ASSERT_EQ(patched.history().size(), 4);
+
+    // Full scans bypass the cache
+    projector.rebuild_all();
+    ASSERT_EQ(projector.cache_stats().entries, 1);
+
+    // A small budget keeps only the most recently used Nodes
+    size_t node_bytes = patched.memory_bytes();
+    projector.enable_cache(16 * node_bytes * 3);
+    for (uint8_t id = 1; id <= 100; ++id) {
+        projector.rebuild(make_entity_node(id));
+    }
+    stats = projector.cache_stats();
+    ASSERT_TRUE(stats.evictions > 0);
+    ASSERT_TRUE(stats.bytes <= stats.budget_bytes);
+    ASSERT_TRUE(stats.entries < 100);
+    projector.rebuild(make_entity_node(100));
+    ASSERT_EQ(projector.cache_stats().hits, 1);
+
+    // Concurrent readers observe the same projections
+    projector.enable_cache(1 << 20);
+    std::vector<std::thread> readers;
+    std::atomic<int> mismatches{0};
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            for (int round = 0; round < 50; ++round) {
+                for (uint8_t id = 1; id <= 100; ++id) {
+                    auto node = projector.rebuild(make_entity_node(id));
+                    int64_t expected = id == 7 ? 700 : id;
+                    if (std::get<int64_t>(*node.get("rank")) != expected) ++mismatches;
+                }
+            }
+        });
+    }
+    for (auto& reader : readers) reader.join();
+    ASSERT_EQ(mismatches.load(), 0);
+    stats = projector.cache_stats();
+    ASSERT_EQ(stats.hits + stats.misses, 4 * 50 * 100);
+    ASSERT_TRUE(stats.misses >= 100);
+
+    projector.disable_cache();
+    ASSERT_EQ(projector.cache_stats().hits, 0);
+}
+
+TEST(Node, ProjectionCacheMutable) {
+    core::AtomStore store;
+    auto entity = make_entity_node(1);
+    for (int64_t count = 1; count <= 8; ++count) {
+        store.append(entity, "logins", count, types::AtomType::Mutable);
+    }
+
+    core::ProjectionEngine projector(store);
+    core::ProjectionEngine uncached(store);
+    projector.enable_cache(1 << 20);
+    projector.rebuild(entity);
+
+    auto same = [](const core::Node& a, const core::Node& b) {
+        ASSERT_EQ(a.size(), b.size());
+        ASSERT_EQ(std::get<int64_t>(*a.get("logins")), std::get<int64_t>(*b.get("logins")));
+        ASSERT_EQ(a.get("logins.snapshot").has_value(), b.get("logins.snapshot").has_value());
+        ASSERT_TRUE(a.history() == b.history());
+    };
+
+    // The snapshot emitted between two lookups is patched in after its mutation
+    for (int64_t count = 9; count <= 11; ++count) {
+        store.append(entity, "logins", count, types::AtomType::Mutable);
+    }
+    auto patched = projector.rebuild(entity);
+    ASSERT_EQ(projector.cache_stats().patches, 1);
+    ASSERT_EQ(std::get<int64_t>(*patched.get("logins")), 11);
+    ASSERT_EQ(std::get<int64_t>(*patched.get("logins.snapshot")), 10);
+    same(patched, uncached.rebuild(entity));
+
+    store.append(entity, "logins", static_cast<int64_t>(12), types::AtomType::Mutable);
+    patched = projector.rebuild(entity);
+    ASSERT_EQ(projector.cache_stats().patches, 2);
+    ASSERT_EQ(std::get<int64_t>(*patched.get("logins")), 12);
+    same(patched, uncached.rebuild(entity));
+}
+
+TEST(Node, ProjectionCacheReload) {
+    const std::string filepath = "test_cache_reload.dat";
+    core::AtomStore other;
+    other.append(make_entity_node(2), "name", std::string("other"));
+    ASSERT_TRUE(other.save(filepath));
+
+    // Same ordinal and newest LSN as the entity cached below
+    core::AtomStore store;
+    store.append(make_entity_node(1), "name", std::string("first"));
+    core::ProjectionEngine projector(store);
+    projector.enable_cache(1 << 20);
+    ASSERT_EQ(std::get<std::string>(*projector.rebuild_at(0).get("name")), "first");
+
+    ASSERT_TRUE(store.load(filepath));
+    std::remove(filepath.c_str());
+    auto reloaded = projector.rebuild_at(0);
+    ASSERT_TRUE(reloaded.entity_id() == make_entity_node(2));
+    ASSERT_EQ(std::get<std::string>(*reloaded.get("name")), "other");
+    ASSERT_EQ(projector.cache_stats().hits, 0);
+}
+
+TEST(Node, CompactLayout) {
+    core::AtomStore store;
+    auto entity = make_entity_node(1);
+
+    // More tags than fit inline, interned in a different order than applied
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 9; i >= 0; --i) {
+            store.append(entity, "field" + std::to_string(i), static_cast<int64_t>(round * 100 + i));
+        }
+    }
+    store.append(make_entity_node(2), "field3", std::string("other"));
+
+    core::ProjectionEngine projector(store);
+    auto ordinal = *store.find_ordinal(entity);
+    auto compact = projector.project_at(ordinal);
+    ASSERT_FALSE(compact.records_history());
+    ASSERT_EQ(compact.history().size(), 0);
+    ASSERT_EQ(compact.size(), 10);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(std::get<int64_t>(*compact.get("field" + std::to_string(i))), 200 + i);
+    }
+    ASSERT_EQ(compact.get_all().size(), 10);
+
+    // TagIds resolved once through the engine read the same values
+    auto field7 = projector.find_tag("field7");
+    ASSERT_TRUE(field7.has_value());
+    ASSERT_EQ(std::get<int64_t>(*compact.get(*field7)), 207);
+    ASSERT_TRUE(*compact.latest_atom(*field7) == *compact.latest_atom("field7"));
+    ASSERT_FALSE(projector.find_tag("never-appended").has_value());
+
+    // History is kept only on request; values are identical either way
+    auto full = projector.rebuild(entity);
+    ASSERT_EQ(full.history().size(), 30);
+    auto same_fields = [](const core::Node& a, const core::Node& b) {
+        for (int i = 0; i < 10; ++i) {
+            auto tag = "field" + std::to_string(i);
+            if (std::get<int64_t>(*a.get(tag)) != std::get<int64_t>(*b.get(tag))) return false;
+        }
+        return a.size() == b.size();
+    };
+    ASSERT_TRUE(same_fields(full, compact));
+    ASSERT_TRUE(compact.memory_bytes() < full.memory_bytes());
+    ASSERT_EQ(projector.project_at(ordinal, true).history().size(), 30);
+
+    // Copies and moves keep the spilled properties intact
+    core::Node copy = compact;
+    core::Node moved = std::move(compact);
+    ASSERT_TRUE(same_fields(copy, moved));
+
+    // Small entities live entirely inside the Node
+    auto small = projector.project_at(*store.find_ordinal(make_entity_node(2)));
+    ASSERT_EQ(small.memory_bytes(), sizeof(core::Node) + std::get<std::string>(*small.get("field3")).capacity());
+
+    for (const auto& [id, node] : projector.rebuild_all()) {
+        ASSERT_EQ(node.history().size(), 0);
+    }
+    size_t with_history = 0;
+    projector.rebuild_all_streaming([&](const types::EntityId&, const core::Node& node) {
+        with_history += node.history().size();
+    }, 1000, true);
+    ASSERT_EQ(with_history, 31);
+}
+
+TEST(ProjectionEngine, ParallelStreaming) {
+    core::AtomStore store;
+    std::vector<core::AtomStore::BatchAtom> atoms;
+    for (uint32_t i = 0; i < 5000; ++i) {
+        types::EntityId entity{};
+        std::memcpy(entity.bytes.data(), &i, sizeof(i));
+        atoms.push_back({entity, "id", static_cast<int64_t>(i)});
+        atoms.push_back({entity, "name", "entity" + std::to_string(i % 97)});
+        if (i % 3 == 0) atoms.push_back({entity, "id", static_cast<int64_t>(i * 10)});
+    }
+    store.append_batch(atoms);
+
+    core::ProjectionEngine projector(store);
+    auto expected_id = [](uint32_t i) { return static_cast<int64_t>(i % 3 == 0 ? i * 10 : i); };
+    const auto caller = std::this_thread::get_id();
+
+    // Ordered delivery: consecutive batches, identical to the serial projection
+    core::StreamingOptions options;
+    options.batch_size = 64;
+    options.threads = 4;
+    options.max_in_flight = 3;
+    uint32_t next_ordinal = 0;
+    bool on_caller = true;
+    projector.rebuild_all_batches([&](core::ProjectionBatch& batch) {
+        on_caller &= std::this_thread::get_id() == caller;
+        ASSERT_EQ(batch.first_ordinal, next_ordinal);
+        for (size_t i = 0; i < batch.nodes.size(); ++i) {
+            auto reference = projector.project_at(next_ordinal);
+            ASSERT_TRUE(batch.nodes[i].entity_id() == reference.entity_id());
+            ASSERT_EQ(std::get<int64_t>(*batch.nodes[i].get("id")), std::get<int64_t>(*reference.get("id")));
+            ASSERT_EQ(std::get<std::string>(*batch.nodes[i].get("name")), std::get<std::string>(*reference.get("name")));
+            ++next_ordinal;
+        }
+    }, options);
+    ASSERT_EQ(next_ordinal, 5000);
+    ASSERT_TRUE(on_caller);
+
+    // Unordered delivery still covers each entity exactly once
+    options.ordered = false;
+    options.prefetch = false;
+    options.with_history = true;
+    std::vector<int> seen(store.entity_count(), 0);
+    size_t history = 0;
+    projector.rebuild_all_streaming([&](const types::EntityId& id, const core::Node& node) {
+        uint32_t i;
+        std::memcpy(&i, id.bytes.data(), sizeof(i));
+        ASSERT_EQ(std::get<int64_t>(*node.get("id")), expected_id(i));
+        ++seen[*store.find_ordinal(id)];
+        history += node.history().size();
+    }, options);
+    ASSERT_TRUE(std::all_of(seen.begin(), seen.end(), [](int n) { return n == 1; }));
+    ASSERT_EQ(history, atoms.size());
+
+    // A failing callback stops the stream and surfaces its exception
+    size_t delivered = 0;
+    bool thrown = false;
+    try {
+        projector.rebuild_all_batches([&](core::ProjectionBatch&) {
+            if (++delivered == 5) throw std::runtime_error("stop");
+        }, options);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    ASSERT_TRUE(thrown);
+    ASSERT_EQ(delivered, 5);
+}
+
+TEST(ProjectionEngine, TimeTravel) {
+    core::AtomStore store;
+    auto entity = make_entity_node(1);
+    std::vector<types::LogSequenceNumber> marks;
+    for (int64_t version = 1; version <= 50; ++version) {
+        store.append(entity, "version", version);
+        if (version == 20) store.append(entity, "owner", std::string("alice"));
+        marks.push_back(store.current_lsn());
+        store.append(make_entity_node(2), "noise", version);
+    }
+    auto before_late = store.current_lsn();
+    store.append(make_entity_node(3), "name", std::string("late"));
+
+    core::ProjectionEngine projector(store);
+    projector.enable_cache(1 << 20);
+    for (int64_t version = 1; version <= 50; ++version) {
+        auto node = projector.rebuild(entity, marks[version - 1]);
+        ASSERT_EQ(std::get<int64_t>(*node.get("version")), version);
+        ASSERT_EQ(node.get("owner").has_value(), version >= 20);
+        ASSERT_EQ(node.history().size(), static_cast<size_t>(version + (version >= 20 ? 1 : 0)));
+    }
+
+    // Between two references of the entity, the earlier one is visible
+    auto between = projector.rebuild(entity, {marks[9].value + 1});
+    ASSERT_EQ(std::get<int64_t>(*between.get("version")), 10);
+
+    // Before the entity's first reference, and at or after the current LSN
+    ASSERT_EQ(projector.rebuild(make_entity_node(2), marks[0]).size(), 0);
+    ASSERT_EQ(std::get<int64_t>(*projector.rebuild(entity, store.current_lsn()).get("version")), 50);
+    ASSERT_EQ(std::get<int64_t>(*projector.rebuild(entity, types::LogSequenceNumber{}).get("version")), 50);
+    ASSERT_EQ(projector.cache_stats().misses, 1);   // Historical rebuilds bypass the cache
+
+    // Streaming as of a past LSN: the late entity has no state yet
+    size_t visited = 0;
+    projector.rebuild_all_streaming([&](const types::EntityId& id, const core::Node& node) {
+        ++visited;
+        if (id == entity) ASSERT_EQ(std::get<int64_t>(*node.get("version")), 10);
+        if (id == make_entity_node(3)) ASSERT_EQ(node.size(), 0);
+        if (id == make_entity_node(2)) ASSERT_EQ(std::get<int64_t>(*node.get("noise")), 9);
+    }, marks[9]);
+    ASSERT_EQ(visited, 3);
+
+    core::StreamingOptions options;
+    options.as_of = before_late;
+    options.threads = 2;
+    options.batch_size = 1;
+    options.prefetch = false;
+    projector.rebuild_all_streaming([&](const types::EntityId& id, const core::Node& node) {
+        if (id == make_entity_node(3)) ASSERT_EQ(node.size(), 0);
+        if (id == entity) ASSERT_EQ(std::get<std::string>(*node.get("owner")), "alice");
+    }, options);
+}
+
+TEST(ProjectionEngine, MutableTimeTravel) {
+    core::AtomStore store;
+    auto entity = make_entity_node(1);
+    std::vector<types::LogSequenceNumber> marks;
+    for (int64_t count = 1; count <= 25; ++count) {
+        store.append(entity, "logins", count, types::AtomType::Mutable);
+        marks.push_back(store.current_lsn());
+        store.append(entity, "seen", count);
+    }
+
+    // Snapshots are referenced after the mutation that triggered them
+    const auto* refs = store.get_entity_atoms(entity);
+    ASSERT_TRUE(std::is_sorted(refs->begin(), refs->end(),
+                               [](const auto& a, const auto& b) { return a.lsn < b.lsn; }));
+
+    // Every mutation shares an AtomId, yet each LSN sees its own value
+    auto check = [&](const core::AtomStore& source) {
+        core::ProjectionEngine projector(source);
+        for (int64_t count = 1; count <= 25; ++count) {
+            auto node = projector.rebuild(entity, marks[count - 1]);
+            ASSERT_EQ(std::get<int64_t>(*node.get("logins")), count);
+            ASSERT_EQ(node.get("logins.snapshot").has_value(), count >= 10);
+        }
+        auto current = projector.rebuild(entity);
+        ASSERT_EQ(std::get<int64_t>(*current.get("logins")), 25);
+        ASSERT_EQ(std::get<int64_t>(*current.get("logins.snapshot")), 20);
+
+        // History entries resolve to the value of their own mutation
+        int64_t expected = 0;
+        for (const auto& [atom_id, lsn] : current.history()) {
+            const core::Atom* atom = source.get_atom(core::AtomReference{atom_id, lsn});
+            if (atom->type_tag() == "logins") {
+                ASSERT_EQ(std::get<int64_t>(atom->value()), ++expected);
+            }
+        }
+        ASSERT_EQ(expected, 25);
+    };
+    check(store);
+
+    std::string path = "test_mutable_time_travel.dat";
+    ASSERT_TRUE(store.save(path));
+    core::AtomStore loaded;
+    ASSERT_TRUE(loaded.load(path));
+    check(loaded);
+    std::remove(path.c_str());
+}
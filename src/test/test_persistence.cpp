@@ -1,5 +1,6 @@
 #include "test_framework.h"
 #include "../core/atom_store.h"
+#include "../core/persistence.h"
 #include <algorithm>
 #include <cstdio>
 
@@ -40,6 +41,27 @@ TEST(Persistence, SaveAndLoad) {
     std::remove(filepath.c_str());
 }
 
+TEST(Persistence, PreserveEntityOrdinals) {
+    std::string filepath = "test_persist_ordinals.dat";
+
+    core::AtomStore log;
+    for (uint8_t id : {5, 3, 9, 1}) {
+        log.append(make_entity_persist(id), "id", static_cast<int64_t>(id));
+    }
+    ASSERT_TRUE(log.save(filepath));
+
+    core::AtomStore loaded_log;
+    ASSERT_TRUE(loaded_log.load(filepath));
+    ASSERT_EQ(loaded_log.entities(), log.entities());
+    ASSERT_EQ(*loaded_log.find_ordinal(make_entity_persist(9)), 2);
+
+    // New entities continue the ordinal sequence
+    loaded_log.append(make_entity_persist(7), "id", static_cast<int64_t>(7));
+    ASSERT_EQ(*loaded_log.find_ordinal(make_entity_persist(7)), 4);
+
+    std::remove(filepath.c_str());
+}
+
 TEST(Persistence, PreserveStats) {
     std::string filepath = "test_persist_stats.dat";
     auto entity1 = make_entity_persist(1);
@@ -148,6 +170,38 @@ TEST(Persistence, PreserveEdgeValues) {
     std::remove(filepath.c_str());
 }
 
+TEST(Persistence, PreserveAdjacency) {
+    std::string filepath = "test_persist_adjacency.dat";
+    core::AtomStore log;
+    for (uint8_t id = 1; id <= 40; ++id) {
+        log.append(make_entity_persist(id), "edge.next",
+                   types::EdgeValue{make_entity_persist(static_cast<uint8_t>(id % 40 + 1)), "next"});
+    }
+    log.append(make_entity_persist(1), "edge.owner", types::EdgeValue{make_entity_persist(99), "owner"});
+    ASSERT_TRUE(log.save(filepath));
+
+    core::AtomStore loaded_log;
+    ASSERT_TRUE(loaded_log.load(filepath));
+    const auto& graph = loaded_log.adjacency();
+    ASSERT_EQ(graph.edge_count(), 40);
+    auto next = *graph.find_relation("next");
+    for (uint8_t id = 1; id <= 40; ++id) {
+        auto ordinal = *loaded_log.find_ordinal(make_entity_persist(id));
+        auto successor = *loaded_log.find_ordinal(make_entity_persist(static_cast<uint8_t>(id % 40 + 1)));
+        auto neighbours = graph.outgoing(ordinal, next);
+        ASSERT_EQ(neighbours.compacted.size(), 1);
+        ASSERT_EQ(neighbours.compacted[0], successor);
+        ASSERT_EQ(graph.incoming(successor, next).size(), 1);
+    }
+
+    // The parked edge survives the round trip and resolves later
+    loaded_log.append(make_entity_persist(99), "name", std::string("owner"));
+    auto owner = *graph.find_relation("owner");
+    ASSERT_EQ(graph.outgoing(*loaded_log.find_ordinal(make_entity_persist(1)), owner).size(), 1);
+
+    std::remove(filepath.c_str());
+}
+
 TEST(Persistence, PreserveAllValueTypes) {
     std::string filepath = "test_persist_types.dat";
     auto entity = make_entity_persist(1);
@@ -185,3 +239,61 @@ TEST(Persistence, PreserveAllValueTypes) {
 
     std::remove(filepath.c_str());
 }
+
+TEST(Persistence, HashAlgorithmVersioning) {
+    std::string filepath = "test_persist_hash.dat";
+    auto entity = make_entity_persist(1), other = make_entity_persist(2);
+
+    // A version 2 file, as written before the header recorded the hash
+    auto legacy_id = types::compute_content_hash("name", std::string("Alice"), types::HashAlgorithm::Fnv1a);
+    {
+        core::BinaryWriter writer(filepath);
+        writer.write_bytes("GTAF", 4);
+        writer.write_u32(2);
+        writer.write_u64(1);                       // next LSN
+        writer.write_u64(0);                       // next sequential atom id
+        writer.write_u64(1);
+        writer.write_atom_id(legacy_id);
+        writer.write_u8(static_cast<uint8_t>(types::AtomType::Canonical));
+        writer.write_string("name");
+        writer.write_atom_value(std::string("Alice"));
+        writer.write_timestamp(1);
+        writer.write_u64(1);
+        writer.write_entity_id(entity);
+        writer.write_u64(1);
+        writer.write_atom_id(legacy_id);
+        writer.write_lsn({1});
+        writer.write_u64(1);
+        writer.write_atom_id(legacy_id);
+        writer.write_u32(1);
+    }
+
+    // It keeps deduplicating against its FNV-1a ids
+    core::AtomStore legacy;
+    ASSERT_TRUE(legacy.load(filepath));
+    ASSERT_TRUE(legacy.hash_algorithm() == types::HashAlgorithm::Fnv1a);
+    ASSERT_FALSE(legacy.set_hash_algorithm(types::HashAlgorithm::Wide128));
+    ASSERT_TRUE(legacy.append(other, "name", std::string("Alice")).atom_id() == legacy_id);
+    ASSERT_EQ(legacy.all().size(), 1);
+
+    // Saving records the algorithm in a version 3 header
+    ASSERT_TRUE(legacy.save(filepath));
+    core::AtomStore reloaded;
+    ASSERT_TRUE(reloaded.load(filepath));
+    ASSERT_TRUE(reloaded.hash_algorithm() == types::HashAlgorithm::Fnv1a);
+    ASSERT_EQ(reloaded.get_entity_atoms(other)->size(), 1);
+
+    // New stores use the wide hash, and say so in their files
+    core::AtomStore fresh;
+    ASSERT_TRUE(fresh.hash_algorithm() == types::HashAlgorithm::Wide128);
+    auto atom = fresh.append(entity, "name", std::string("Alice"));
+    ASSERT_TRUE(atom.atom_id() != legacy_id);
+    ASSERT_TRUE(fresh.save(filepath));
+    core::AtomStore loaded;
+    ASSERT_TRUE(loaded.load(filepath));
+    ASSERT_TRUE(loaded.hash_algorithm() == types::HashAlgorithm::Wide128);
+    ASSERT_TRUE(loaded.append(other, "name", std::string("Alice")).atom_id() == atom.atom_id());
+    ASSERT_EQ(loaded.all().size(), 1);
+
+    std::remove(filepath.c_str());
+}
@@ -0,0 +1,488 @@
+#include "test_framework.h"
+#include "../core/atom_store.h"
+#include "../core/query_index.h"
+#include "../types/values_helper.h"
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+using namespace gtaf;
+using namespace gtaf::test;
+
+// Helper to create test EntityIds
+types::EntityId make_entity_index(uint8_t id) {
+    types::EntityId entity{};
+    std::fill(entity.bytes.begin(), entity.bytes.end(), 0);
+    entity.bytes[0] = id;
+    return entity;
+}
+
+TEST(QueryIndex, AutoTypedColumns) {
+    core::AtomStore store;
+    auto entity1 = make_entity_index(1);
+    auto entity2 = make_entity_index(2);
+
+    store.append(entity1, "name", std::string("Alice"));
+    store.append(entity1, "age", static_cast<int64_t>(30));
+    store.append(entity1, "score", 95.5);
+    store.append(entity1, "active", true);
+    store.append(entity2, "name", std::string("Bob"));
+    store.append(entity2, "age", static_cast<int64_t>(25));
+    store.append(entity2, "score", 80.0);
+    store.append(entity2, "active", false);
+
+    core::QueryIndex index(store);
+    ASSERT_EQ(index.build_indexes({"name", "age", "score", "active"}), 8);
+
+    ASSERT_TRUE(index.column_type("name") == core::ColumnType::String);
+    ASSERT_TRUE(index.column_type("age") == core::ColumnType::Int64);
+    ASSERT_TRUE(index.column_type("score") == core::ColumnType::Double);
+    ASSERT_TRUE(index.column_type("active") == core::ColumnType::Bool);
+
+    auto older = index.find_int("age", core::QueryIndex::CompareOp::Gt, 26);
+    ASSERT_EQ(older.size(), 1);
+    ASSERT_EQ(older[0], entity1);
+
+    auto high_score = index.find_double("score", core::QueryIndex::CompareOp::Ge, 90.0);
+    ASSERT_EQ(high_score.size(), 1);
+    ASSERT_EQ(high_score[0], entity1);
+
+    auto inactive = index.find_bool("active", false);
+    ASSERT_EQ(inactive.size(), 1);
+    ASSERT_EQ(inactive[0], entity2);
+
+    ASSERT_EQ(*index.get_int("age", entity2), 25);
+    ASSERT_EQ(*index.get_string("name", entity2), "Bob");
+    ASSERT_FALSE(index.get_string("age", entity2).has_value());
+}
+
+TEST(QueryIndex, AutoColumnsWidenOnConflict) {
+    // Mixed types must not null values, whichever entity comes first
+    for (bool int_first : {true, false}) {
+        core::AtomStore store;
+        auto a = make_entity_index(int_first ? 1 : 2);
+        auto b = make_entity_index(int_first ? 2 : 1);
+        store.append(int_first ? a : b, "status", int_first ? types::AtomValue{static_cast<int64_t>(7)}
+                                                            : types::AtomValue{std::string("open")});
+        store.append(int_first ? b : a, "status", int_first ? types::AtomValue{std::string("open")}
+                                                            : types::AtomValue{static_cast<int64_t>(7)});
+        store.append(a, "weight", static_cast<int64_t>(3));
+        store.append(b, "weight", 2.5);
+
+        core::QueryIndex index(store);
+        ASSERT_EQ(index.build_indexes({"status", "weight"}), 4);
+        ASSERT_TRUE(index.column_type("status") == core::ColumnType::String);
+        ASSERT_EQ(index.find_equals("status", "open").size(), 1);
+        ASSERT_EQ(index.find_equals("status", "open")[0], b);
+        ASSERT_EQ(index.find_contains("status", "ope").size(), 1);
+        ASSERT_EQ(*index.get_string("status", a), "7");
+        ASSERT_TRUE(index.column_type("weight") == core::ColumnType::Double);
+        ASSERT_EQ(index.find_double_between("weight", 2.0, 3.0).size(), 2);
+    }
+
+    // Incremental updates widen too, and the widened column keeps widening after a reload
+    const std::string path = "test_query_index_widen.gtqi";
+    core::AtomStore store;
+    store.append(make_entity_index(1), "qty", static_cast<int64_t>(5));
+    core::QueryIndex index(store);
+    index.build_indexes({"qty"});
+    index.subscribe(store);
+    store.append(make_entity_index(2), "qty", 1.5);
+    ASSERT_TRUE(index.column_type("qty") == core::ColumnType::Double);
+    ASSERT_EQ(index.find_double_between("qty", 1.0, 6.0).size(), 2);
+    ASSERT_TRUE(index.save(path));
+
+    core::QueryIndex loaded(store);
+    ASSERT_TRUE(loaded.load(path));
+    loaded.subscribe(store);
+    store.append(make_entity_index(3), "qty", std::string("many"));
+    ASSERT_TRUE(loaded.column_type("qty") == core::ColumnType::String);
+    ASSERT_EQ(*loaded.get_string("qty", make_entity_index(1)), "5");
+    ASSERT_EQ(*loaded.get_string("qty", make_entity_index(2)), "1.5");
+    ASSERT_EQ(loaded.find_equals("qty", "many").size(), 1);
+    ASSERT_FALSE(loaded.is_ordered("qty"));
+
+    std::remove(path.c_str());
+}
+
+TEST(QueryIndex, TypedCoercionFromStrings) {
+    core::AtomStore store;
+    auto entity1 = make_entity_index(1);
+    auto entity2 = make_entity_index(2);
+
+    store.append(entity1, "qty", std::string("17"));
+    store.append(entity1, "shipdate", std::string("1998-09-01"));
+    store.append(entity2, "qty", std::string("42"));
+    store.append(entity2, "shipdate", std::string("1998-12-01"));
+
+    core::QueryIndex index(store);
+    index.build_typed_indexes({
+        {"qty", core::ColumnType::Int64},
+        {"shipdate", core::ColumnType::Timestamp}
+    });
+
+    auto cutoff = types::parse_timestamp("1998-09-02");
+    ASSERT_TRUE(cutoff.has_value());
+    auto shipped = index.find_int("shipdate", core::QueryIndex::CompareOp::Le, static_cast<int64_t>(*cutoff));
+    ASSERT_EQ(shipped.size(), 1);
+    ASSERT_EQ(shipped[0], entity1);
+
+    ASSERT_EQ(index.find_int_between("qty", 10, 20).size(), 1);
+    ASSERT_EQ(index.find_int_if("qty", [](int64_t q) { return q % 2 == 0; }).size(), 1);
+    ASSERT_EQ(index.find_equals("qty", "42").size(), 1);
+    ASSERT_EQ(index.find_int_where("qty", [](int64_t q) { return q > 0; }).size(), 2);
+
+    // Dates must match in full; unrepresentable doubles are not cast to int64
+    ASSERT_EQ(*types::parse_timestamp("1998-09-02 12:30"), *cutoff + 45000000000ULL);
+    ASSERT_EQ(*types::parse_timestamp("1998-09-02T12:30:15"), *cutoff + 45015000000ULL);
+    ASSERT_FALSE(types::parse_timestamp("1998-09-02x").has_value());
+    ASSERT_FALSE(types::parse_timestamp("1998-09-02 12:30x").has_value());
+    ASSERT_FALSE(types::parse_timestamp("1998-09-02 12:30:15Z").has_value());
+    ASSERT_FALSE(types::parse_timestamp("1998-09-02 12:30.15").has_value());
+
+    // Out-of-range fields are rejected rather than rolled over into the next unit
+    ASSERT_FALSE(types::parse_timestamp("2024-02-31").has_value());
+    ASSERT_FALSE(types::parse_timestamp("2023-02-29").has_value());
+    ASSERT_FALSE(types::parse_timestamp("1900-02-29").has_value());
+    ASSERT_FALSE(types::parse_timestamp("2024-04-31").has_value());
+    ASSERT_FALSE(types::parse_timestamp("2024-01-01T99:99").has_value());
+    ASSERT_FALSE(types::parse_timestamp("2024-01-01T24:00").has_value());
+    ASSERT_FALSE(types::parse_timestamp("2024-01-01 23:60").has_value());
+    ASSERT_FALSE(types::parse_timestamp("2024-01-01 23:59:60").has_value());
+    ASSERT_EQ(*types::parse_timestamp("2024-02-29"), *types::parse_timestamp("2024-02-28") + 86400000000ULL);
+    ASSERT_TRUE(types::parse_timestamp("2000-02-29 23:59:59").has_value());
+    ASSERT_EQ(types::format_date(*types::parse_timestamp("2024-12-31")), "2024-12-31");
+
+    core::Column column(core::ColumnType::Int64);
+    ASSERT_TRUE(column.set(0, -0x1p63));
+    ASSERT_EQ(column.ints()[0], std::numeric_limits<int64_t>::min());
+    ASSERT_FALSE(column.set(1, 0x1p63));
+    ASSERT_FALSE(column.set(1, 1e300));
+    ASSERT_FALSE(column.set(1, -std::numeric_limits<double>::infinity()));
+    ASSERT_FALSE(column.set(1, std::numeric_limits<double>::quiet_NaN()));
+    ASSERT_FALSE(column.is_valid(1));
+
+    store.append(entity2, "qty", 1e19);
+    ASSERT_EQ(index.catch_up(), 1);
+    ASSERT_FALSE(index.get_int("qty", entity2).has_value());
+    ASSERT_EQ(index.find_int_where("qty", [](int64_t q) { return q > 0; }).size(), 1);
+}
+
+TEST(QueryIndex, LatestValueWins) {
+    core::AtomStore store;
+    auto entity = make_entity_index(1);
+
+    store.append(entity, "status", std::string("open"));
+    store.append(entity, "status", std::string("closed"));
+
+    core::QueryIndex index(store);
+    index.build_index("status");
+
+    ASSERT_EQ(index.find_equals("status", "open").size(), 0);
+    ASSERT_EQ(index.find_equals("status", "closed").size(), 1);
+    ASSERT_EQ(index.find_contains("status", "LOS").size(), 1);
+}
+
+TEST(QueryIndex, OrderedRangeQueries) {
+    core::AtomStore store;
+    for (uint8_t i = 1; i <= 100; ++i) {
+        store.append(make_entity_index(i), "qty", static_cast<int64_t>(i));
+        store.append(make_entity_index(i), "price", i * 1.5);
+    }
+
+    core::QueryIndex index(store);
+    index.build_indexes({"qty", "price"});
+    ASSERT_TRUE(index.is_ordered("qty"));
+    ASSERT_TRUE(index.is_ordered("price"));
+
+    ASSERT_EQ(index.find_int_between("qty", 10, 20).size(), 11);
+    ASSERT_EQ(index.find_int("qty", core::QueryIndex::CompareOp::Lt, 10).size(), 9);
+    ASSERT_EQ(index.find_int("qty", core::QueryIndex::CompareOp::Ge, 91).size(), 10);
+    ASSERT_EQ(index.find_int("qty", core::QueryIndex::CompareOp::Ne, 50).size(), 99);
+    ASSERT_EQ(index.find_double("price", core::QueryIndex::CompareOp::Gt, 148.5).size(), 1);
+
+    ASSERT_EQ(std::get<int64_t>(*index.min_value("qty")), 1);
+    ASSERT_EQ(std::get<int64_t>(*index.max_value("qty")), 100);
+
+    auto top = index.top_k("price", 3);
+    ASSERT_EQ(top.size(), 3);
+    ASSERT_EQ(top[0], make_entity_index(100));
+    ASSERT_EQ(top[2], make_entity_index(98));
+
+    // Strict comparisons at the infinities and NaN operands match nothing
+    constexpr double kInf = std::numeric_limits<double>::infinity();
+    constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+    store.append(make_entity_index(101), "price", -kInf);
+    store.append(make_entity_index(102), "price", kInf);
+    index.build_indexes({"qty", "price"});
+    ASSERT_TRUE(index.is_ordered("price"));
+    using Op = core::QueryIndex::CompareOp;
+    ASSERT_EQ(index.find_double("price", Op::Lt, -kInf).size(), 0);
+    ASSERT_EQ(index.find_double("price", Op::Gt, kInf).size(), 0);
+    ASSERT_EQ(index.find_double("price", Op::Le, -kInf).size(), 1);
+    ASSERT_EQ(index.find_double("price", Op::Ge, kInf).size(), 1);
+    ASSERT_EQ(index.find_double("price", Op::Lt, kInf).size(), 101);
+    ASSERT_EQ(index.find_double("price", Op::Gt, -kInf).size(), 101);
+    ASSERT_EQ(index.find_double("price", Op::Lt, kNaN).size(), 0);
+    ASSERT_EQ(index.find_double("price", Op::Eq, kNaN).size(), 0);
+    ASSERT_EQ(index.find_double_between("price", kNaN, kInf).size(), 0);
+    ASSERT_EQ(index.find_double_between("price", 3.0, 1.5).size(), 0);
+}
+
+TEST(QueryIndex, OrderedIndexIncrementalUpdate) {
+    core::AtomStore store;
+    for (uint8_t i = 1; i <= 10; ++i) {
+        store.append(make_entity_index(i), "qty", static_cast<int64_t>(i));
+    }
+
+    core::QueryIndex index(store);
+    index.build_index("qty");
+
+    // Rows are store ordinals, so a new entity must be known to the store first
+    store.append(make_entity_index(11), "label", std::string("new"));
+
+    // Move entity 1 to the top of the range and add a new entity
+    ASSERT_TRUE(index.update(make_entity_index(1), "qty", static_cast<int64_t>(500)));
+    ASSERT_TRUE(index.update(make_entity_index(11), "qty", static_cast<int64_t>(0)));
+    ASSERT_FALSE(index.update(make_entity_index(1), "unindexed", static_cast<int64_t>(1)));
+    ASSERT_FALSE(index.update(make_entity_index(12), "qty", static_cast<int64_t>(1)));
+
+    ASSERT_EQ(index.find_int_between("qty", 1, 10).size(), 9);
+    ASSERT_EQ(std::get<int64_t>(*index.max_value("qty")), 500);
+    ASSERT_EQ(std::get<int64_t>(*index.min_value("qty")), 0);
+    ASSERT_EQ(*index.get_int("qty", make_entity_index(1)), 500);
+
+    auto bottom = index.top_k("qty", 2, false);
+    ASSERT_EQ(bottom.size(), 2);
+    ASSERT_EQ(bottom[0], make_entity_index(11));
+    ASSERT_EQ(bottom[1], make_entity_index(2));
+}
+
+TEST(QueryIndex, TrigramContains) {
+    core::AtomStore store;
+    store.append(make_entity_index(1), "desc", std::string("Adds new fiber splice"));
+    store.append(make_entity_index(2), "desc", std::string("Remove pole"));
+    store.append(make_entity_index(3), "desc", std::string("PADDSTACK replacement"));
+
+    core::QueryIndex index(store);
+    index.build_typed_indexes({{.tag = "desc", .trigram = true}});
+
+    auto adds = index.find_contains("desc", "adds");
+    ASSERT_EQ(adds.size(), 2);
+    ASSERT_EQ(index.find_contains("desc", "POLE").size(), 1);
+    ASSERT_EQ(index.find_contains("desc", "missing").size(), 0);
+
+    // Needles shorter than a trigram fall back to a scan
+    ASSERT_EQ(index.find_contains("desc", "e").size(), 3);
+
+    // Replaced values must not match through stale postings
+    index.update(make_entity_index(2), "desc", std::string("Adds guy wire"));
+    ASSERT_EQ(index.find_contains("desc", "pole").size(), 0);
+    ASSERT_EQ(index.find_contains("desc", "ADDS").size(), 3);
+}
+
+TEST(QueryIndex, PrunesReplacedStrings) {
+    core::Column column(core::ColumnType::String);
+    column.set(0, std::string("a"));
+    column.set(1, std::string("b"));
+    column.set(2, std::string("c"));
+    column.set(0, std::string("d"));
+    column.set_null(2);
+    ASSERT_EQ(column.compact_dictionary(), 2);
+    ASSERT_EQ(column.dictionary_size(), 2);
+    ASSERT_EQ(column.string_at(0), "d");
+    ASSERT_EQ(column.string_at(1), "b");
+    ASSERT_FALSE(column.find_code("a").has_value());
+    ASSERT_EQ(*column.find_code("b"), 0);
+    ASSERT_EQ(column.compact_dictionary(), 0);
+
+    // Every rewrite leaves a value no row holds; the index drops them as it goes
+    core::AtomStore store;
+    for (uint8_t i = 1; i <= 20; ++i) {
+        store.append(make_entity_index(i), "note", std::string("note 0 of ") + std::to_string(i));
+    }
+    core::QueryIndex index(store);
+    index.build_typed_indexes({{.tag = "note", .trigram = true}});
+    index.subscribe(store);
+
+    auto rewrite = [&](int from, int to) {
+        for (int round = from; round < to; ++round) {
+            for (uint8_t i = 1; i <= 20; ++i) {
+                store.append(make_entity_index(i), "note",
+                             std::string("note ") + std::to_string(round) + " of " + std::to_string(i));
+            }
+        }
+    };
+    rewrite(1, 200);
+    const size_t early = index.get_stats().memory_bytes;
+    rewrite(200, 2000);
+    ASSERT_TRUE(index.get_stats().memory_bytes < early * 2);
+
+    ASSERT_EQ(index.find_equals("note", "note 1999 of 7").size(), 1);
+    ASSERT_EQ(index.find_equals("note", "note 1998 of 7").size(), 0);
+    ASSERT_EQ(index.find_contains("note", "NOTE 1999 ").size(), 20);
+    ASSERT_EQ(index.find_contains("note", "note 1500").size(), 0);
+    ASSERT_EQ(index.find_in("note", {"note 1999 of 3", "note 5 of 3", "note 1999 of 4"}).size(), 2);
+    ASSERT_EQ(*index.get_string("note", make_entity_index(9)), "note 1999 of 9");
+}
+
+TEST(QueryIndex, HashEqualityAndInList) {
+    core::AtomStore store;
+    const char* statuses[] = {"open", "closed", "pending"};
+    for (uint8_t i = 1; i <= 30; ++i) {
+        store.append(make_entity_index(i), "status", std::string(statuses[i % 3]));
+    }
+
+    core::QueryIndex index(store);
+    index.build_index("status");
+
+    ASSERT_EQ(index.find_equals("status", "open").size(), 10);
+    ASSERT_EQ(index.find_equals("status", "missing").size(), 0);
+    ASSERT_EQ(index.find_in("status", {"open", "pending", "open", "missing"}).size(), 20);
+
+    // Moving rows between values must not leave them in their old posting list
+    store.append(make_entity_index(31), "label", std::string("new"));
+    ASSERT_TRUE(index.update(make_entity_index(3), "status", std::string("closed")));
+    ASSERT_TRUE(index.update(make_entity_index(31), "status", std::string("archived")));
+    ASSERT_EQ(index.find_equals("status", "open").size(), 9);
+    ASSERT_EQ(index.find_equals("status", "closed").size(), 11);
+    ASSERT_EQ(index.find_equals("status", "archived").size(), 1);
+
+    // Moving back re-lists the row exactly once
+    ASSERT_TRUE(index.update(make_entity_index(3), "status", std::string("open")));
+    auto open = index.find_in("status", {"open"});
+    ASSERT_EQ(open.size(), 10);
+    ASSERT_EQ(std::count(open.begin(), open.end(), make_entity_index(3)), 1);
+    ASSERT_EQ(*index.get_string("status", make_entity_index(3)), "open");
+
+    ASSERT_EQ(index.find_contains("status", "EN").size(), 20);
+}
+
+TEST(QueryIndex, BitmapPredicateCombination) {
+    core::AtomStore store;
+    for (uint8_t i = 1; i <= 100; ++i) {
+        store.append(make_entity_index(i), "qty", static_cast<int64_t>(i));
+        store.append(make_entity_index(i), "flag", std::string(i % 2 ? "A" : "R"));
+    }
+    store.append(make_entity_index(101), "flag", std::string("A"));
+
+    core::QueryIndex index(store);
+    index.build_indexes({"qty", "flag"});
+
+    auto low_qty = index.select_int("qty", core::QueryIndex::CompareOp::Le, 10);
+    auto flag_a = index.select_equals("flag", "A");
+    ASSERT_EQ((low_qty & flag_a).cardinality(), 5);
+    ASSERT_EQ((low_qty | flag_a).cardinality(), 56);
+    ASSERT_EQ((flag_a - index.select_present("qty")).cardinality(), 1);
+    ASSERT_EQ((index.select_all() - flag_a).cardinality(), 50);
+
+    auto entities = index.to_entities(low_qty & flag_a);
+    ASSERT_EQ(entities.size(), 5);
+    ASSERT_EQ(entities[0], make_entity_index(1));
+    for (uint32_t ordinal : low_qty & flag_a) {
+        ASSERT_EQ(*index.get_string("flag", index.entity_at(ordinal)), "A");
+    }
+}
+
+TEST(QueryIndex, SubscribedIncrementalUpdates) {
+    core::AtomStore store;
+    store.append(make_entity_index(1), "qty", static_cast<int64_t>(5));
+    store.append(make_entity_index(1), "status", std::string("open"));
+
+    core::QueryIndex index(store);
+    index.build_indexes({"qty", "status"});
+    ASSERT_EQ(index.applied_lsn().value, store.current_lsn().value);
+    index.subscribe(store);
+
+    store.append(make_entity_index(2), "qty", static_cast<int64_t>(7));
+    store.append_batch({
+        {make_entity_index(1), "status", std::string("closed")},
+        {make_entity_index(3), "status", std::string("open")},
+        {make_entity_index(3), "status", std::string("closed")},  // Later LSN in the batch wins
+        {make_entity_index(3), "note", std::string("unindexed")}
+    });
+
+    ASSERT_EQ(index.find_int_between("qty", 0, 10).size(), 2);
+    ASSERT_EQ(index.find_equals("status", "open").size(), 0);
+    ASSERT_EQ(index.find_equals("status", "closed").size(), 2);
+    ASSERT_EQ(index.applied_lsn().value, store.current_lsn().value);
+
+    index.unsubscribe();
+    store.append(make_entity_index(4), "qty", static_cast<int64_t>(9));
+    ASSERT_EQ(index.find_int_between("qty", 0, 10).size(), 2);
+}
+
+TEST(QueryIndex, SubscribeCatchUpAndStoreReload) {
+    core::AtomStore store;
+    for (uint8_t i = 1; i <= 10; ++i) {
+        store.append(make_entity_index(i), "s", std::string("old"));
+    }
+
+    // An append between the build and subscribe() is not lost
+    core::QueryIndex index(store);
+    index.build_indexes({"s"});
+    store.append(make_entity_index(11), "s", std::string("gap"));
+    index.subscribe(store);
+    store.append(make_entity_index(12), "s", std::string("after"));
+    index.catch_up();
+    ASSERT_EQ(index.find_equals("s", "gap").size(), 1);
+    ASSERT_EQ(index.find_equals("s", "after").size(), 1);
+
+    // Loading a smaller file restarts ordinals and LSNs; the index is rebuilt
+    const std::string path = "test_query_index_reload.dat";
+    core::AtomStore other;
+    other.append(make_entity_index(20), "s", std::string("loaded"));
+    ASSERT_TRUE(other.save(path));
+    ASSERT_TRUE(store.load(path));
+    std::remove(path.c_str());
+    ASSERT_EQ(index.applied_lsn().value, store.current_lsn().value);
+    ASSERT_EQ(index.find_equals("s", "old").size(), 0);
+    ASSERT_EQ(index.find_equals("s", "loaded").size(), 1);
+
+    store.append(make_entity_index(21), "s", std::string("new"));
+    auto found = index.find_equals("s", "new");
+    ASSERT_EQ(found.size(), 1);
+    ASSERT_EQ(found[0], make_entity_index(21));
+}
+
+TEST(QueryIndex, SaveLoadWithCatchUp) {
+    const std::string path = "test_query_index.gtqi";
+    core::AtomStore store;
+    for (uint8_t i = 1; i <= 50; ++i) {
+        store.append(make_entity_index(i), "qty", static_cast<int64_t>(i));
+        store.append(make_entity_index(i), "price", i * 2.5);
+        store.append(make_entity_index(i), "status", std::string(i % 2 ? "open" : "closed"));
+    }
+
+    {
+        core::QueryIndex index(store);
+        index.build_typed_indexes({{"qty"}, {"price"}, {.tag = "status", .trigram = true}});
+        ASSERT_TRUE(index.save(path));
+    }
+
+    // Appends after the save are applied from the store on load
+    store.append(make_entity_index(1), "qty", static_cast<int64_t>(1000));
+    store.append(make_entity_index(51), "status", std::string("open"));
+
+    core::QueryIndex loaded(store);
+    ASSERT_TRUE(loaded.load(path));
+    ASSERT_EQ(loaded.applied_lsn().value, store.current_lsn().value);
+    ASSERT_TRUE(loaded.column_type("price") == core::ColumnType::Double);
+    ASSERT_TRUE(loaded.is_ordered("qty"));
+
+    ASSERT_EQ(loaded.find_int_between("qty", 1, 50).size(), 49);
+    ASSERT_EQ(std::get<int64_t>(*loaded.max_value("qty")), 1000);
+    ASSERT_EQ(loaded.find_double_between("price", 0.0, 25.0).size(), 10);
+    ASSERT_EQ(loaded.find_equals("status", "open").size(), 26);
+    ASSERT_EQ(loaded.find_contains("status", "LOSE").size(), 25);
+    ASSERT_EQ(*loaded.get_string("status", make_entity_index(2)), "closed");
+
+    // An index from a longer history cannot belong to a fresh store
+    core::AtomStore other;
+    core::QueryIndex mismatched(other);
+    ASSERT_FALSE(mismatched.load(path));
+    ASSERT_FALSE(loaded.load("nonexistent_index.gtqi"));
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,424 @@
+#include "test_framework.h"
+#include "../core/atom_store.h"
+#include "../core/vector_index.h"
+#include "../core/vector_kernels.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace gtaf;
+using namespace gtaf::test;
+
+// Helper to create test EntityIds
+types::EntityId make_entity_vec(uint32_t id) {
+    types::EntityId entity{};
+    std::fill(entity.bytes.begin(), entity.bytes.end(), 0);
+    std::memcpy(entity.bytes.data(), &id, sizeof(id));
+    return entity;
+}
+
+namespace {
+
+types::Vector random_vector(std::mt19937& rng, size_t dimension) {
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    types::Vector vector(dimension);
+    for (float& value : vector) value = normal(rng);
+    return vector;
+}
+
+// Reference top-k by squared L2 distance, as entity ordinals
+std::vector<uint32_t> brute_force(const core::AtomStore& store, const std::vector<types::Vector>& vectors,
+                                  const types::Vector& query, size_t k) {
+    std::vector<std::pair<float, uint32_t>> scored;
+    for (uint32_t i = 0; i < vectors.size(); ++i) {
+        float d = 0.0f;
+        for (size_t j = 0; j < query.size(); ++j) d += (vectors[i][j] - query[j]) * (vectors[i][j] - query[j]);
+        scored.push_back({d, *store.find_ordinal(make_entity_vec(i))});
+    }
+    std::partial_sort(scored.begin(), scored.begin() + k, scored.end());
+    std::vector<uint32_t> ordinals;
+    for (size_t i = 0; i < k; ++i) ordinals.push_back(scored[i].second);
+    return ordinals;
+}
+
+} // namespace
+
+TEST(VectorIndex, ExactAndApproximateSearch) {
+    constexpr size_t kDim = 37;  // Not a multiple of the SIMD width
+    std::mt19937 rng(7);
+    core::AtomStore store;
+    std::vector<types::Vector> vectors;
+    for (uint32_t i = 0; i < 3000; ++i) {
+        vectors.push_back(random_vector(rng, kDim));
+        store.append(make_entity_vec(i), "embedding", vectors.back());
+        store.append(make_entity_vec(i), "name", "doc" + std::to_string(i));
+    }
+    store.append(make_entity_vec(5000), "embedding", types::Vector(3, 1.0f));  // Wrong dimension: ignored
+
+    core::VectorIndex index(store);
+    ASSERT_EQ(index.build("embedding"), 3000);
+    ASSERT_EQ(index.dimension(), kDim);
+
+    size_t hits = 0;
+    for (int q = 0; q < 50; ++q) {
+        auto query = random_vector(rng, kDim);
+        auto expected = brute_force(store, vectors, query, 10);
+
+        auto exact = index.search_exact(query, 10);
+        ASSERT_EQ(exact.size(), 10);
+        for (size_t i = 0; i < 10; ++i) {
+            ASSERT_EQ(exact[i].ordinal, expected[i]);
+        }
+        ASSERT_TRUE(std::is_sorted(exact.begin(), exact.end(),
+                                   [](const auto& a, const auto& b) { return a.distance < b.distance; }));
+
+        for (const auto& match : index.search(query, 10, 100)) {
+            hits += std::count(expected.begin(), expected.end(), match.ordinal);
+        }
+    }
+    ASSERT_TRUE(hits >= 50 * 10 * 9 / 10);  // Recall@10 of at least 0.9
+
+    // An indexed vector is its own nearest neighbour
+    auto self = index.search(vectors[42], 1);
+    ASSERT_EQ(self[0].ordinal, *store.find_ordinal(make_entity_vec(42)));
+    ASSERT_TRUE(index.search(types::Vector(3, 0.0f), 5).empty());
+
+    // Cosine ignores magnitude
+    core::VectorIndex cosine(store);
+    core::VectorIndex::Options options;
+    options.metric = core::VectorMetric::Cosine;
+    options.approximate = false;
+    cosine.build("embedding", options);
+    types::Vector scaled = vectors[7];
+    for (float& value : scaled) value *= 25.0f;
+    auto nearest = cosine.search(scaled, 1);
+    ASSERT_EQ(nearest[0].ordinal, *store.find_ordinal(make_entity_vec(7)));
+    ASSERT_TRUE(nearest[0].distance < 1e-5f);
+}
+
+TEST(VectorIndex, SubscribeCatchUpAndStoreReload) {
+    core::AtomStore store;
+    store.append(make_entity_vec(1), "embedding", types::Vector(4, 1.0f));
+    store.append(make_entity_vec(2), "embedding", types::Vector(4, 2.0f));
+
+    // A vector appended between build() and subscribe() is indexed
+    core::VectorIndex index(store);
+    index.build("embedding");
+    store.append(make_entity_vec(3), "embedding", types::Vector(4, 3.0f));
+    index.subscribe(store);
+    index.catch_up();
+    ASSERT_EQ(index.size(), 3);
+
+    // Loading another file rebuilds the index over its ordinals
+    const std::string path = "test_vector_reload.dat";
+    core::AtomStore other;
+    other.append(make_entity_vec(10), "embedding", types::Vector(4, -1.0f));
+    ASSERT_TRUE(other.save(path));
+    ASSERT_TRUE(store.load(path));
+    std::remove(path.c_str());
+    ASSERT_EQ(index.size(), 1);
+    ASSERT_EQ(index.applied_lsn().value, store.current_lsn().value);
+
+    store.append(make_entity_vec(11), "embedding", types::Vector(4, 5.0f));
+    ASSERT_EQ(index.size(), 2);
+    auto nearest = index.search_exact(types::Vector(4, 5.0f), 1);
+    ASSERT_EQ(nearest[0].ordinal, *store.find_ordinal(make_entity_vec(11)));
+}
+
+TEST(VectorIndex, IncrementalUpdatesAndPersistence) {
+    std::string path = "test_vector_index.gtvi";
+    std::mt19937 rng(11);
+    core::AtomStore store;
+    for (uint32_t i = 0; i < 500; ++i) {
+        store.append(make_entity_vec(i), "embedding", random_vector(rng, 16));
+    }
+
+    core::VectorIndex index(store);
+    index.build("embedding");
+    index.subscribe(store);
+
+    // New, moved and cleared entries are applied on append
+    types::Vector target(16, 3.0f);
+    store.append(make_entity_vec(900), "embedding", target);
+    store.append(make_entity_vec(3), "embedding", types::Vector(16, -3.0f));
+    store.append(make_entity_vec(4), "embedding", std::string("not a vector"));
+    ASSERT_EQ(index.size(), 500);
+    ASSERT_EQ(index.search(target, 1)[0].ordinal, *store.find_ordinal(make_entity_vec(900)));
+    ASSERT_EQ(index.search(types::Vector(16, -3.0f), 1)[0].ordinal, *store.find_ordinal(make_entity_vec(3)));
+    for (const auto& match : index.search_exact(random_vector(rng, 16), 500)) {
+        ASSERT_NE(match.ordinal, *store.find_ordinal(make_entity_vec(4)));
+    }
+
+    // Repeated rewrites trigger compaction without losing entries
+    for (int round = 0; round < 5; ++round) {
+        for (uint32_t i = 100; i < 400; ++i) {
+            store.append(make_entity_vec(i), "embedding", random_vector(rng, 16));
+        }
+    }
+    ASSERT_EQ(index.size(), 500);
+    ASSERT_EQ(index.applied_lsn().value, store.current_lsn().value);
+    ASSERT_TRUE(index.save(path));
+
+    // Appends after the save are applied from the store on load
+    store.append(make_entity_vec(901), "embedding", types::Vector(16, 9.0f));
+
+    core::VectorIndex loaded(store);
+    ASSERT_TRUE(loaded.load(path));
+    ASSERT_EQ(loaded.size(), 501);
+    ASSERT_EQ(loaded.tag(), "embedding");
+    ASSERT_EQ(loaded.applied_lsn().value, store.current_lsn().value);
+    ASSERT_EQ(loaded.search(types::Vector(16, 9.0f), 1)[0].ordinal, *store.find_ordinal(make_entity_vec(901)));
+    auto query = random_vector(rng, 16);
+    auto before = index.search(query, 10);
+    auto after = loaded.search(query, 10);
+    ASSERT_EQ(before.size(), after.size());
+    for (size_t i = 0; i < before.size(); ++i) {
+        ASSERT_EQ(before[i].ordinal, after[i].ordinal);
+    }
+
+    // A file saved against another store is rejected
+    core::AtomStore other;
+    other.append(make_entity_vec(77), "embedding", types::Vector(16, 1.0f));
+    core::VectorIndex mismatched(other);
+    ASSERT_FALSE(mismatched.load(path));
+
+    std::remove(path.c_str());
+}
+
+TEST(VectorIndex, QuantisedEncodings) {
+    std::string path = "test_vector_index_int8.gtvi";
+    constexpr size_t kDim = 96;
+    std::mt19937 rng(3);
+    core::AtomStore store;
+    std::vector<types::Vector> vectors;
+    for (uint32_t i = 0; i < 2000; ++i) {
+        vectors.push_back(random_vector(rng, kDim));
+        store.append(make_entity_vec(i), "embedding", vectors.back());
+    }
+
+    auto build = [&](core::VectorIndex& index, core::VectorEncoding encoding, bool approximate) {
+        core::VectorIndex::Options options;
+        options.encoding = encoding;
+        options.approximate = approximate;
+        index.build("embedding", options);
+    };
+    core::VectorIndex full(store), half(store), int8(store);
+    build(full, core::VectorEncoding::Float32, false);
+    build(half, core::VectorEncoding::Float16, false);
+    build(int8, core::VectorEncoding::Int8, true);
+    core::VectorIndex int8_flat(store);
+    build(int8_flat, core::VectorEncoding::Int8, false);
+
+    // Matrix footprint drops roughly 2x and 4x
+    ASSERT_TRUE(half.memory_bytes() * 10 < full.memory_bytes() * 6);
+    ASSERT_TRUE(int8_flat.memory_bytes() * 10 < full.memory_bytes() * 4);
+
+    // Decoded rows stay close to the originals
+    auto decoded = half.vector_at(*store.find_ordinal(make_entity_vec(5)));
+    ASSERT_TRUE(decoded.has_value());
+    for (size_t j = 0; j < kDim; ++j) ASSERT_TRUE(std::abs((*decoded)[j] - vectors[5][j]) < 2e-3f);
+    decoded = int8.vector_at(*store.find_ordinal(make_entity_vec(5)));
+    float largest = 0.0f;
+    for (float value : vectors[5]) largest = std::max(largest, std::abs(value));
+    for (size_t j = 0; j < kDim; ++j) ASSERT_TRUE(std::abs((*decoded)[j] - vectors[5][j]) <= largest / 254.0f + 1e-6f);
+    ASSERT_FALSE(half.vector_at(5000).has_value());
+
+    size_t half_hits = 0, int8_hits = 0;
+    for (int q = 0; q < 30; ++q) {
+        auto query = random_vector(rng, kDim);
+        auto expected = brute_force(store, vectors, query, 10);
+        for (const auto& match : half.search_exact(query, 10)) {
+            half_hits += std::count(expected.begin(), expected.end(), match.ordinal);
+        }
+        for (const auto& match : int8.search(query, 10, 100)) {
+            int8_hits += std::count(expected.begin(), expected.end(), match.ordinal);
+        }
+    }
+    ASSERT_TRUE(half_hits >= 30 * 10 * 95 / 100);
+    ASSERT_TRUE(int8_hits >= 30 * 10 * 80 / 100);
+
+    // Quantised rows round-trip through save/load unchanged
+    ASSERT_TRUE(int8.save(path));
+    core::VectorIndex loaded(store);
+    ASSERT_TRUE(loaded.load(path));
+    ASSERT_TRUE(loaded.options().encoding == core::VectorEncoding::Int8);
+    auto query = random_vector(rng, kDim);
+    auto before = int8.search(query, 10);
+    auto after = loaded.search(query, 10);
+    ASSERT_EQ(before.size(), after.size());
+    for (size_t i = 0; i < before.size(); ++i) {
+        ASSERT_EQ(before[i].ordinal, after[i].ordinal);
+        ASSERT_EQ(before[i].distance, after[i].distance);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(VectorIndex, AtomBackedRows) {
+    std::string path = "test_vector_index_atoms.gtvi";
+    constexpr size_t kDim = 96;
+    std::mt19937 rng(5);
+    core::AtomStore store;
+    std::vector<types::Vector> vectors;
+    for (uint32_t i = 0; i < 2000; ++i) {
+        vectors.push_back(random_vector(rng, kDim));
+        store.append(make_entity_vec(i), "embedding", vectors.back());
+    }
+
+    core::VectorIndex::Options options;
+    options.approximate = false;
+    core::VectorIndex copied(store), borrowed(store);
+    copied.build("embedding", options);
+    options.encoding = core::VectorEncoding::Atoms;
+    borrowed.build("embedding", options);
+    options.metric = core::VectorMetric::Cosine;
+    options.approximate = true;
+    core::VectorIndex cosine(store);
+    cosine.build("embedding", options);
+
+    // No matrix: a reference and a norm per row
+    ASSERT_EQ(borrowed.size(), 2000);
+    ASSERT_TRUE(borrowed.memory_bytes() * 8 < copied.memory_bytes());
+
+    // Same values, same kernel: identical results
+    for (int q = 0; q < 10; ++q) {
+        auto query = random_vector(rng, kDim);
+        auto expected = copied.search_exact(query, 10);
+        auto actual = borrowed.search_exact(query, 10);
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQ(expected[i].ordinal, actual[i].ordinal);
+            ASSERT_EQ(expected[i].distance, actual[i].distance);
+        }
+    }
+    auto decoded = cosine.vector_at(*store.find_ordinal(make_entity_vec(5)));
+    ASSERT_TRUE(decoded.has_value());
+    float norm = 0.0f;
+    for (float value : vectors[5]) norm += value * value;
+    for (size_t j = 0; j < kDim; ++j) ASSERT_TRUE(std::abs((*decoded)[j] - vectors[5][j] / std::sqrt(norm)) < 1e-5f);
+    ASSERT_EQ(cosine.search(vectors[5], 1)[0].ordinal, *store.find_ordinal(make_entity_vec(5)));
+
+    // Rows follow new atoms, including each version of a mutable vector
+    borrowed.subscribe(store);
+    types::Vector target(kDim, 4.0f);
+    store.append(make_entity_vec(3), "embedding", target, types::AtomType::Mutable);
+    store.append(make_entity_vec(3), "embedding", types::Vector(kDim, 5.0f), types::AtomType::Mutable);
+    store.append(make_entity_vec(9), "embedding", target);
+    ASSERT_EQ(borrowed.search_exact(types::Vector(kDim, 5.0f), 1)[0].ordinal, *store.find_ordinal(make_entity_vec(3)));
+    ASSERT_EQ(borrowed.search_exact(target, 1)[0].ordinal, *store.find_ordinal(make_entity_vec(9)));
+    ASSERT_EQ((*borrowed.vector_at(*store.find_ordinal(make_entity_vec(3))))[0], 5.0f);
+
+    // Compacting the store moves the atoms: rows resolve by reference until the next append
+    store.compact();
+    ASSERT_EQ(borrowed.search_exact(target, 1)[0].ordinal, *store.find_ordinal(make_entity_vec(9)));
+    store.append(make_entity_vec(11), "embedding", types::Vector(kDim, -4.0f));
+    ASSERT_EQ(borrowed.search_exact(target, 1)[0].ordinal, *store.find_ordinal(make_entity_vec(9)));
+    ASSERT_EQ(borrowed.search_exact(types::Vector(kDim, -4.0f), 1)[0].ordinal, *store.find_ordinal(make_entity_vec(11)));
+
+    // Only the stored latest value can be applied directly
+    ASSERT_FALSE(borrowed.update(make_entity_vec(10), types::Vector(kDim, 7.0f)));
+    ASSERT_EQ((*borrowed.vector_at(*store.find_ordinal(make_entity_vec(10))))[0], vectors[10][0]);
+
+    // References round-trip; the values come from the store again
+    ASSERT_TRUE(borrowed.save(path));
+    core::VectorIndex loaded(store);
+    ASSERT_TRUE(loaded.load(path));
+    ASSERT_TRUE(loaded.options().encoding == core::VectorEncoding::Atoms);
+    ASSERT_EQ(loaded.size(), 2000);
+    auto query = random_vector(rng, kDim);
+    auto before = borrowed.search_exact(query, 10);
+    auto after = loaded.search_exact(query, 10);
+    ASSERT_EQ(before.size(), after.size());
+    for (size_t i = 0; i < before.size(); ++i) {
+        ASSERT_EQ(before[i].ordinal, after[i].ordinal);
+        ASSERT_EQ(before[i].distance, after[i].distance);
+    }
+
+    // ...so a file whose atoms are not in the store is rejected
+    core::AtomStore other;
+    for (uint32_t i = 0; i < 2000; ++i) {
+        other.append(make_entity_vec(i), "embedding", types::Vector(kDim, 1.0f));
+    }
+    core::VectorIndex mismatched(other);
+    ASSERT_FALSE(mismatched.load(path));
+
+    std::remove(path.c_str());
+}
+
+TEST(VectorIndex, AtomBackedGraphAfterCompaction) {
+    constexpr size_t kDim = 16;
+    std::mt19937 rng(21);
+    core::AtomStore store;
+    for (uint32_t i = 0; i < 40; ++i) {
+        store.append(make_entity_vec(i), "embedding", random_vector(rng, kDim));
+    }
+    core::VectorIndex::Options options;
+    options.encoding = core::VectorEncoding::Atoms;
+    options.max_links = 4;
+    core::VectorIndex index(store);
+    index.build("embedding", options);
+    index.subscribe(store);
+
+    // Re-point every entity, then trim the old embeddings out of the store:
+    // the tombstoned rows (and likely the entry point) lose their atoms
+    std::vector<types::Vector> latest;
+    for (uint32_t i = 0; i < 40; ++i) {
+        latest.push_back(random_vector(rng, kDim));
+        store.append(make_entity_vec(i), "embedding", latest.back());
+    }
+    core::AtomStore::CompactionOptions trim;
+    trim.keep_versions = 1;
+    ASSERT_TRUE(store.compact(trim).atoms_removed >= 40);
+
+    // Later appends link new rows past the dead ones
+    for (uint32_t i = 40; i < 80; ++i) {
+        latest.push_back(random_vector(rng, kDim));
+        store.append(make_entity_vec(i), "embedding", latest.back());
+    }
+    ASSERT_EQ(index.size(), 80);
+    for (uint32_t i : {0u, 39u, 40u, 79u}) {
+        auto matches = index.search(latest[i], 5, 80);
+        ASSERT_FALSE(matches.empty());
+        ASSERT_EQ(matches[0].ordinal, *store.find_ordinal(make_entity_vec(i)));
+        for (const auto& match : matches) ASSERT_TRUE(std::isfinite(match.distance));
+    }
+
+    // Repacking drops the dead rows from the graph for good
+    index.compact();
+    ASSERT_EQ(index.size(), 80);
+    ASSERT_EQ(index.search(latest[7], 1)[0].ordinal, *store.find_ordinal(make_entity_vec(7)));
+}
+
+TEST(VectorIndex, HalfKernels) {
+    // The branch-free widening is exact for every non-NaN half
+    for (uint32_t bits = 0; bits <= 0xFFFF; ++bits) {
+        const auto half = static_cast<uint16_t>(bits);
+        const float exact = core::kernels::half_to_float(half);
+        if (std::isnan(exact)) {
+            ASSERT_TRUE(std::isnan(core::kernels::widen_half(half)));
+        } else {
+            ASSERT_EQ(std::bit_cast<uint32_t>(core::kernels::widen_half(half)), std::bit_cast<uint32_t>(exact));
+        }
+    }
+
+    // Vector kernels (including their scalar tails) match a scalar reference
+    std::mt19937 rng(9);
+    for (size_t n : {1, 7, 8, 29, 64, 133}) {
+        auto a = random_vector(rng, n);
+        auto b = random_vector(rng, n);
+        std::vector<uint16_t> halves(n);
+        double dot = 0.0, l2 = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            halves[i] = core::kernels::float_to_half(b[i]);
+            const double value = core::kernels::half_to_float(halves[i]);
+            dot += a[i] * value;
+            l2 += (a[i] - value) * (a[i] - value);
+        }
+        ASSERT_TRUE(std::abs(core::kernels::dot_f16(a.data(), halves.data(), n) - dot) < 1e-3);
+        ASSERT_TRUE(std::abs(core::kernels::squared_l2_f16(a.data(), halves.data(), n) - l2) < 1e-3 * (1.0 + l2));
+    }
+}
@@ -179,6 +179,9 @@ size_t import_nation(core::AtomStore& store, const std::string& filename) {
         batch.push_back({entity, "nation.name", fields[1], types::AtomType::Canonical});
         batch.push_back({entity, "nation.regionkey", fields[2], types::AtomType::Canonical});
         batch.push_back({entity, "nation.comment", fields[3], types::AtomType::Canonical});
+        batch.push_back({entity, "nation.region",
+                         types::EdgeValue{create_entity_id("region", std::stoll(fields[2])), "region"},
+                         types::AtomType::Canonical});
 
         row_count++;
 
@@ -231,6 +234,9 @@ size_t import_supplier(core::AtomStore& store, const std::string& filename) {
         batch.push_back({entity, "supplier.phone", fields[4], types::AtomType::Canonical});
         batch.push_back({entity, "supplier.acctbal", fields[5], types::AtomType::Canonical});
         batch.push_back({entity, "supplier.comment", fields[6], types::AtomType::Canonical});
+        batch.push_back({entity, "supplier.nation",
+                         types::EdgeValue{create_entity_id("nation", std::stoll(fields[3])), "nation"},
+                         types::AtomType::Canonical});
 
         row_count++;
 
@@ -288,6 +294,9 @@ size_t import_customer(core::AtomStore& store, const std::string& filename) {
         batch.push_back({entity, "customer.acctbal", fields[5], types::AtomType::Canonical});
         batch.push_back({entity, "customer.mktsegment", fields[6], types::AtomType::Canonical});
         batch.push_back({entity, "customer.comment", fields[7], types::AtomType::Canonical});
+        batch.push_back({entity, "customer.nation",
+                         types::EdgeValue{create_entity_id("nation", std::stoll(fields[3])), "nation"},
+                         types::AtomType::Canonical});
 
         row_count++;
 
@@ -462,6 +471,9 @@ size_t import_orders(core::AtomStore& store, const std::string& filename) {
         batch.push_back({entity, "orders.clerk", fields[6], types::AtomType::Canonical});
         batch.push_back({entity, "orders.shippriority", fields[7], types::AtomType::Canonical});
         batch.push_back({entity, "orders.comment", fields[8], types::AtomType::Canonical});
+        batch.push_back({entity, "orders.customer",
+                         types::EdgeValue{create_entity_id("customer", std::stoll(fields[1])), "customer"},
+                         types::AtomType::Canonical});
 
         row_count++;
 
@@ -531,6 +543,12 @@ size_t import_lineitem(core::AtomStore& store, const std::string& filename) {
         batch.push_back({entity, "lineitem.shipinstruct", fields[13], types::AtomType::Canonical});
         batch.push_back({entity, "lineitem.shipmode", fields[14], types::AtomType::Canonical});
         batch.push_back({entity, "lineitem.comment", fields[15], types::AtomType::Canonical});
+        batch.push_back({entity, "lineitem.order",
+                         types::EdgeValue{create_entity_id("orders", orderkey), "order"},
+                         types::AtomType::Canonical});
+        batch.push_back({entity, "lineitem.supplier",
+                         types::EdgeValue{create_entity_id("supplier", std::stoll(fields[2])), "supplier"},
+                         types::AtomType::Canonical});
 
         row_count++;
 
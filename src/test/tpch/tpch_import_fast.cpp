@@ -86,6 +86,14 @@ inline void add_to_batch(std::vector<core::AtomStore::BatchAtom>& batch,
     batch.push_back({entity, tag, std::string(value), types::AtomType::Canonical});
 }
 
+// Helper to add a foreign-key edge to another table's entity
+inline void add_edge_to_batch(std::vector<core::AtomStore::BatchAtom>& batch,
+                              types::EntityId entity, const char* tag,
+                              uint64_t target_table, std::string_view target_key, const char* relation) {
+    types::EdgeValue edge{create_entity_id_fast(target_table, std::stoll(std::string(target_key))), relation};
+    batch.push_back({entity, tag, std::move(edge), types::AtomType::Canonical});
+}
+
 size_t import_region_fast(core::AtomStore& store, const std::string& filename) {
     std::cout << "Importing REGION from: " << filename << "\n";
     auto start_time = std::chrono::high_resolution_clock::now();
@@ -158,6 +166,7 @@ size_t import_nation_fast(core::AtomStore& store, const std::string& filename) {
         add_to_batch(batch, entity, "nation.name", fields[1]);
         add_to_batch(batch, entity, "nation.regionkey", fields[2]);
         add_to_batch(batch, entity, "nation.comment", fields[3]);
+        add_edge_to_batch(batch, entity, "nation.region", TABLE_REGION, fields[2], "region");
 
         row_count++;
     }
@@ -203,6 +212,7 @@ size_t import_supplier_fast(core::AtomStore& store, const std::string& filename)
         add_to_batch(batch, entity, "supplier.phone", fields[4]);
         add_to_batch(batch, entity, "supplier.acctbal", fields[5]);
         add_to_batch(batch, entity, "supplier.comment", fields[6]);
+        add_edge_to_batch(batch, entity, "supplier.nation", TABLE_NATION, fields[3], "nation");
 
         row_count++;
 
@@ -258,6 +268,7 @@ size_t import_customer_fast(core::AtomStore& store, const std::string& filename)
         add_to_batch(batch, entity, "customer.acctbal", fields[5]);
         add_to_batch(batch, entity, "customer.mktsegment", fields[6]);
         add_to_batch(batch, entity, "customer.comment", fields[7]);
+        add_edge_to_batch(batch, entity, "customer.nation", TABLE_NATION, fields[3], "nation");
 
         row_count++;
 
@@ -425,6 +436,7 @@ size_t import_orders_fast(core::AtomStore& store, const std::string& filename) {
         add_to_batch(batch, entity, "orders.clerk", fields[6]);
         add_to_batch(batch, entity, "orders.shippriority", fields[7]);
         add_to_batch(batch, entity, "orders.comment", fields[8]);
+        add_edge_to_batch(batch, entity, "orders.customer", TABLE_CUSTOMER, fields[1], "customer");
 
         row_count++;
 
@@ -497,6 +509,8 @@ size_t import_lineitem_fast(core::AtomStore& store, const std::string& filename)
         add_to_batch(batch, entity, "lineitem.shipinstruct", fields[13]);
         add_to_batch(batch, entity, "lineitem.shipmode", fields[14]);
         add_to_batch(batch, entity, "lineitem.comment", fields[15]);
+        add_edge_to_batch(batch, entity, "lineitem.order", TABLE_ORDERS, fields[0], "order");
+        add_edge_to_batch(batch, entity, "lineitem.supplier", TABLE_SUPPLIER, fields[2], "supplier");
 
         row_count++;
 
@@ -1,7 +1,9 @@
 #include "../../core/atom_store.h"
+#include "../../core/executor.h"
 #include "../../core/projection_engine.h"
 #include "../../core/query_index.h"
 #include "../../types/hash_utils.h"
+#include "../../types/values_helper.h"
 #include <iostream>
 #include <chrono>
 #include <fstream>
@@ -104,24 +106,29 @@ int main(int argc, char* argv[]) {
 
     start = std::chrono::high_resolution_clock::now();
 
-    // Build all indexes in a single pass for efficiency
-    std::cout << "Building all indexes in single pass...\n";
-    index.build_indexes({
-        // LINEITEM table
-        "lineitem.shipdate",
-        "lineitem.returnflag",
-        "lineitem.linestatus",
-        "lineitem.quantity",
-        "lineitem.extendedprice",
-        "lineitem.discount",
-        // ORDERS table
-        "orders.orderdate",
-        "orders.orderstatus",
-        "orders.totalprice",
-        // CUSTOMER table
-        "customer.mktsegment",
-        "customer.acctbal"
-    });
+    // Reuse indexes saved by a previous run; only atoms after their LSN are applied
+    const std::string index_file = data_file + ".qidx";
+    if (index.load(index_file)) {
+        std::cout << "Loaded saved indexes from: " << index_file << "\n";
+    } else {
+        // Build all indexes in a single pass for efficiency
+        std::cout << "Building all indexes in single pass...\n";
+        // Numeric and date fields are typed once here so queries never re-parse strings
+        // (LINEITEM is scanned through a columnar projection in Q1 instead)
+        using ColumnType = core::ColumnType;
+        index.build_typed_indexes({
+            // ORDERS table
+            {"orders.orderdate", ColumnType::Timestamp},
+            {"orders.orderstatus", ColumnType::String},
+            {"orders.totalprice", ColumnType::Double},
+            // CUSTOMER table
+            {"customer.mktsegment", ColumnType::String},
+            {"customer.acctbal", ColumnType::Double}
+        });
+        if (index.save(index_file)) {
+            std::cout << "  ✓ Saved indexes to: " << index_file << "\n";
+        }
+    }
 
     end = std::chrono::high_resolution_clock::now();
     auto index_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
@@ -136,109 +143,317 @@ int main(int argc, char* argv[]) {
     // TPC-H Query 1: Pricing Summary Report
     // ========================================================================
     std::cout << "=== TPC-H Query 1: Pricing Summary Report ===\n";
-    std::cout << "SQL: SELECT l_returnflag, l_linestatus, SUM(l_quantity), SUM(l_extendedprice)\n";
+    std::cout << "SQL: SELECT l_returnflag, l_linestatus, SUM(l_quantity), SUM(l_extendedprice),\n";
+    std::cout << "            SUM(l_extendedprice * (1 - l_discount)),\n";
+    std::cout << "            SUM(l_extendedprice * (1 - l_discount) * (1 + l_tax)),\n";
+    std::cout << "            AVG(l_quantity), AVG(l_extendedprice), AVG(l_discount), COUNT(*)\n";
     std::cout << "     FROM lineitem WHERE l_shipdate <= '1998-09-02'\n";
-    std::cout << "     GROUP BY l_returnflag, l_linestatus\n\n";
+    std::cout << "     GROUP BY l_returnflag, l_linestatus ORDER BY l_returnflag, l_linestatus\n\n";
 
+    // Project the LINEITEM columns once: typed, ordinal-aligned arrays
     start = std::chrono::high_resolution_clock::now();
-
-    // Find all lineitems with shipdate <= 1998-09-02
-    auto matching_lineitems = index.find_int_where("lineitem.shipdate", [](int64_t shipdate) {
-        // Parse date as YYYY-MM-DD (e.g., "1998-09-02")
-        // For simplicity, compare as string
-        return true; // Would need proper date parsing
+    using ColumnType = core::ColumnType;
+    auto lineitem = projector.project_columns({
+        {"lineitem.returnflag", ColumnType::String},
+        {"lineitem.linestatus", ColumnType::String},
+        {"lineitem.quantity", ColumnType::Double},
+        {"lineitem.extendedprice", ColumnType::Double},
+        {"lineitem.discount", ColumnType::Double},
+        {"lineitem.tax", ColumnType::Double},
+        {"lineitem.shipdate", ColumnType::Timestamp}
     });
+    end = std::chrono::high_resolution_clock::now();
+    auto projection_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Projected " << lineitem.column_count() << " lineitem columns in "
+              << projection_time.count() << "ms\n";
 
-    // Group by returnflag and linestatus
-    std::map<std::pair<std::string, std::string>, double> groups;
-
-    for (const auto& entity : matching_lineitems) {
-        auto returnflag = index.get_string("lineitem.returnflag", entity);
-        auto linestatus = index.get_string("lineitem.linestatus", entity);
+    start = std::chrono::high_resolution_clock::now();
 
-        if (returnflag && linestatus) {
-            auto key = std::make_pair(*returnflag, *linestatus);
-            groups[key] += 1.0; // Would sum quantity, price, etc.
-        }
+    // Vectorized plan: scan -> filter -> project -> hash aggregate -> sort
+    using namespace core::exec;
+    auto cutoff = types::parse_timestamp("1998-09-02");
+    auto disc_price = col("lineitem.extendedprice") * (lit(1.0) - col("lineitem.discount"));
+    std::string q1_error;
+    auto q1 = PlanBuilder::scan(lineitem)
+        .filter(col("lineitem.shipdate") <= lit(static_cast<int64_t>(*cutoff)))
+        .project({
+            {"l_returnflag", col("lineitem.returnflag")},
+            {"l_linestatus", col("lineitem.linestatus")},
+            {"l_quantity", col("lineitem.quantity")},
+            {"l_extendedprice", col("lineitem.extendedprice")},
+            {"l_discount", col("lineitem.discount")},
+            {"disc_price", disc_price},
+            {"charge", disc_price * (lit(1.0) + col("lineitem.tax"))}
+        })
+        .aggregate({"l_returnflag", "l_linestatus"}, {
+            Aggregate::sum("l_quantity", "sum_qty"),
+            Aggregate::sum("l_extendedprice", "sum_base_price"),
+            Aggregate::sum("disc_price", "sum_disc_price"),
+            Aggregate::sum("charge", "sum_charge"),
+            Aggregate::avg("l_quantity", "avg_qty"),
+            Aggregate::avg("l_extendedprice", "avg_price"),
+            Aggregate::avg("l_discount", "avg_disc"),
+            Aggregate::count_all("count_order")
+        })
+        .sort({{"l_returnflag"}, {"l_linestatus"}})
+        .build(&q1_error);
+    Table groups;
+    if (q1) {
+        groups = q1->execute();
+    } else {
+        std::cout << "Query 1 failed to bind: " << q1_error << "\n";
     }
 
     end = std::chrono::high_resolution_clock::now();
     auto query1_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
 
-    std::cout << "Found " << matching_lineitems.size() << " matching line items\n";
-    std::cout << "Grouped into " << groups.size() << " result rows\n";
+    int64_t matching_lineitems = 0;
+    for (size_t row = 0; row < groups.row_count(); ++row) {
+        matching_lineitems += groups.find_column("count_order")->ints[row];
+    }
+
+    std::cout << "Found " << matching_lineitems << " matching line items\n";
+    std::cout << "Grouped into " << groups.row_count() << " result rows\n";
     std::cout << "Query time: " << query1_time.count() << "ms\n\n";
 
-    // Show sample results
-    std::cout << "Sample results:\n";
-    int count = 0;
-    for (const auto& [key, value] : groups) {
-        std::cout << "  Return Flag: " << key.first
-                  << ", Line Status: " << key.second
-                  << ", Count: " << value << "\n";
-        if (++count >= 5) break;
+    // Show results
+    std::cout << "Results:\n";
+    for (size_t row = 0; row < groups.row_count(); ++row) {
+        std::cout << "  Return Flag: " << groups.find_column("l_returnflag")->strings[row]
+                  << ", Line Status: " << groups.find_column("l_linestatus")->strings[row]
+                  << ", Sum Qty: " << groups.find_column("sum_qty")->doubles[row]
+                  << ", Sum Charge: " << groups.find_column("sum_charge")->doubles[row]
+                  << ", Avg Disc: " << groups.find_column("avg_disc")->doubles[row]
+                  << ", Count: " << groups.find_column("count_order")->ints[row] << "\n";
     }
 
     // ========================================================================
-    // TPC-H Query 2: Shipping Priority (simplified)
+    // Multi-table queries: joins follow the EdgeValue relations of the import
+    // (lineitem.order, lineitem.supplier, orders.customer, customer.nation,
+    // supplier.nation, nation.region), probing edge-target ordinals against a
+    // hash table built on the smaller side's entity ordinals.
     // ========================================================================
-    std::cout << "\n\n=== TPC-H Query 2: Shipping Priority (simplified) ===\n";
-    std::cout << "SQL: SELECT o_orderkey, SUM(l_extendedprice * (1 - l_discount))\n";
+    std::cout << "\n\n=== Projecting Join Columns ===\n";
+    start = std::chrono::high_resolution_clock::now();
+    auto tables = projector.project_columns({
+        {"lineitem.order"},
+        {"lineitem.supplier"},
+        {"lineitem.extendedprice", ColumnType::Double},
+        {"lineitem.discount", ColumnType::Double},
+        {"lineitem.shipdate", ColumnType::Timestamp},
+        {"lineitem.returnflag", ColumnType::String},
+        {"orders.customer"},
+        {"orders.orderkey", ColumnType::Int64},
+        {"orders.orderdate", ColumnType::Timestamp},
+        {"orders.shippriority", ColumnType::Int64},
+        {"customer.nation"},
+        {"customer.custkey", ColumnType::Int64},
+        {"customer.name", ColumnType::String},
+        {"customer.acctbal", ColumnType::Double},
+        {"customer.phone", ColumnType::String},
+        {"customer.mktsegment", ColumnType::String},
+        {"supplier.nation"},
+        {"nation.region"},
+        {"nation.name", ColumnType::String},
+        {"region.name", ColumnType::String}
+    });
+    end = std::chrono::high_resolution_clock::now();
+    auto join_projection_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Projected " << tables.column_count() << " columns in "
+              << join_projection_time.count() << "ms\n";
+
+    // Stores imported before the edge columns existed fail to bind the joins;
+    // report the error and skip the query rather than executing a missing plan
+    auto execute_join = [](const char* query, PlanBuilder& builder) {
+        auto plan = builder.build();
+        if (!plan) {
+            std::cout << query << " skipped: " << builder.error() << "\n"
+                      << "  (re-import the data with gtaf_tpch_import to get the edge columns)\n";
+            return Table{};
+        }
+        return plan->execute();
+    };
+
+    auto date = [](const char* iso) { return lit(static_cast<int64_t>(*types::parse_timestamp(iso))); };
+    auto volume = col("lineitem.extendedprice") * (lit(1.0) - col("lineitem.discount"));
+
+    // ========================================================================
+    // TPC-H Query 3: Shipping Priority
+    // ========================================================================
+    std::cout << "\n\n=== TPC-H Query 3: Shipping Priority ===\n";
+    std::cout << "SQL: SELECT l_orderkey, SUM(l_extendedprice * (1 - l_discount)) AS revenue,\n";
+    std::cout << "            o_orderdate, o_shippriority\n";
     std::cout << "     FROM customer, orders, lineitem\n";
-    std::cout << "     WHERE c_mktsegment = 'BUILDING' AND c_custkey = o_custkey\n";
-    std::cout << "     GROUP BY o_orderkey ORDER BY revenue DESC LIMIT 10\n\n";
+    std::cout << "     WHERE c_mktsegment = 'BUILDING' AND c_custkey = o_custkey AND l_orderkey = o_orderkey\n";
+    std::cout << "       AND o_orderdate < '1995-03-15' AND l_shipdate > '1995-03-15'\n";
+    std::cout << "     GROUP BY l_orderkey, o_orderdate, o_shippriority\n";
+    std::cout << "     ORDER BY revenue DESC, o_orderdate LIMIT 10\n\n";
 
     start = std::chrono::high_resolution_clock::now();
 
-    // Find customers in BUILDING segment
-    auto building_customers = index.find_equals("customer.mktsegment", "BUILDING");
+    auto q3_customers = PlanBuilder::scan(tables, {"customer.mktsegment"}, "c_ordinal");
+    q3_customers.filter(col("customer.mktsegment") == lit("BUILDING"));
+    auto q3_orders = PlanBuilder::scan(tables, {"orders.customer", "orders.orderkey", "orders.orderdate",
+                                                "orders.shippriority"}, "o_ordinal");
+    q3_orders.filter(col("orders.orderdate") < date("1995-03-15"))
+        .join(q3_customers, "orders.customer", "c_ordinal");
+    auto q3_plan = PlanBuilder::scan(tables, {"lineitem.order", "lineitem.extendedprice", "lineitem.discount",
+                                              "lineitem.shipdate"});
+    q3_plan.filter(col("lineitem.shipdate") > date("1995-03-15"))
+        .join(q3_orders, "lineitem.order", "o_ordinal")
+        .project({
+            {"l_orderkey", col("orders.orderkey")},
+            {"o_orderdate", col("orders.orderdate")},
+            {"o_shippriority", col("orders.shippriority")},
+            {"volume", volume}
+        })
+        .aggregate({"l_orderkey", "o_orderdate", "o_shippriority"}, {Aggregate::sum("volume", "revenue")})
+        .sort({{"revenue", false}, {"o_orderdate"}})
+        .limit(10);
+    Table q3 = execute_join("Query 3", q3_plan);
 
-    std::cout << "Found " << building_customers.size() << " customers in BUILDING segment\n";
+    end = std::chrono::high_resolution_clock::now();
+    auto query3_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+
+    std::cout << "Query time: " << query3_time.count() << "ms\n\n";
+    std::cout << "Results:\n";
+    for (size_t row = 0; row < q3.row_count(); ++row) {
+        std::cout << "  Order: " << q3.find_column("l_orderkey")->ints[row]
+                  << ", Revenue: " << q3.find_column("revenue")->doubles[row]
+                  << ", Order Date: " << types::format_date(static_cast<types::Timestamp>(q3.find_column("o_orderdate")->ints[row]))
+                  << ", Ship Priority: " << q3.find_column("o_shippriority")->ints[row] << "\n";
+    }
+
+    // ========================================================================
+    // TPC-H Query 5: Local Supplier Volume
+    // ========================================================================
+    std::cout << "\n\n=== TPC-H Query 5: Local Supplier Volume ===\n";
+    std::cout << "SQL: SELECT n_name, SUM(l_extendedprice * (1 - l_discount)) AS revenue\n";
+    std::cout << "     FROM customer, orders, lineitem, supplier, nation, region\n";
+    std::cout << "     WHERE c_custkey = o_custkey AND l_orderkey = o_orderkey AND l_suppkey = s_suppkey\n";
+    std::cout << "       AND c_nationkey = s_nationkey AND s_nationkey = n_nationkey\n";
+    std::cout << "       AND n_regionkey = r_regionkey AND r_name = 'ASIA'\n";
+    std::cout << "       AND o_orderdate >= '1994-01-01' AND o_orderdate < '1995-01-01'\n";
+    std::cout << "     GROUP BY n_name ORDER BY revenue DESC\n\n";
+
+    start = std::chrono::high_resolution_clock::now();
+
+    auto q5_nations = PlanBuilder::scan(tables, {"nation.name", "nation.region"}, "n_ordinal");
+    q5_nations.join(PlanBuilder::scan(tables, {"region.name"}, "r_ordinal").filter(col("region.name") == lit("ASIA")),
+                    "nation.region", "r_ordinal");
+    auto q5_suppliers = PlanBuilder::scan(tables, {"supplier.nation"}, "s_ordinal");
+    q5_suppliers.join(q5_nations, "supplier.nation", "n_ordinal");
+    auto q5_orders = PlanBuilder::scan(tables, {"orders.customer", "orders.orderdate"}, "o_ordinal");
+    q5_orders.filter(col("orders.orderdate") >= date("1994-01-01") && col("orders.orderdate") < date("1995-01-01"))
+        .join(PlanBuilder::scan(tables, {"customer.nation"}, "c_ordinal"), "orders.customer", "c_ordinal");
+    auto q5_plan = PlanBuilder::scan(tables, {"lineitem.order", "lineitem.supplier", "lineitem.extendedprice",
+                                              "lineitem.discount"});
+    q5_plan.join(q5_orders, "lineitem.order", "o_ordinal")
+        .join(q5_suppliers, "lineitem.supplier", "s_ordinal")
+        .filter(col("customer.nation") == col("supplier.nation"))
+        .project({{"n_name", col("nation.name")}, {"volume", volume}})
+        .aggregate({"n_name"}, {Aggregate::sum("volume", "revenue")})
+        .sort({{"revenue", false}});
+    Table q5 = execute_join("Query 5", q5_plan);
 
     end = std::chrono::high_resolution_clock::now();
-    auto query2_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    auto query5_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
 
-    std::cout << "Query time: " << query2_time.count() << "ms\n";
+    std::cout << "Query time: " << query5_time.count() << "ms\n\n";
+    std::cout << "Results:\n";
+    for (size_t row = 0; row < q5.row_count(); ++row) {
+        std::cout << "  Nation: " << q5.find_column("n_name")->strings[row]
+                  << ", Revenue: " << q5.find_column("revenue")->doubles[row] << "\n";
+    }
 
     // ========================================================================
-    // Simple COUNT queries on each table
+    // TPC-H Query 10: Returned Item Reporting
     // ========================================================================
-    std::cout << "\n\n=== Table Row Counts ===\n";
+    std::cout << "\n\n=== TPC-H Query 10: Returned Item Reporting ===\n";
+    std::cout << "SQL: SELECT c_custkey, c_name, SUM(l_extendedprice * (1 - l_discount)) AS revenue,\n";
+    std::cout << "            c_acctbal, n_name, c_phone\n";
+    std::cout << "     FROM customer, orders, lineitem, nation\n";
+    std::cout << "     WHERE c_custkey = o_custkey AND l_orderkey = o_orderkey\n";
+    std::cout << "       AND o_orderdate >= '1993-10-01' AND o_orderdate < '1994-01-01'\n";
+    std::cout << "       AND l_returnflag = 'R' AND c_nationkey = n_nationkey\n";
+    std::cout << "     GROUP BY c_custkey, c_name, c_acctbal, c_phone, n_name\n";
+    std::cout << "     ORDER BY revenue DESC LIMIT 20\n\n";
 
-    struct TableCount {
-        std::string name;
-        size_t count;
-    };
+    start = std::chrono::high_resolution_clock::now();
 
-    std::vector<TableCount> table_counts;
+    auto q10_customers = PlanBuilder::scan(tables, {"customer.nation", "customer.custkey", "customer.name",
+                                                    "customer.acctbal", "customer.phone"}, "c_ordinal");
+    q10_customers.join(PlanBuilder::scan(tables, {"nation.name"}, "n_ordinal"), "customer.nation", "n_ordinal");
+    auto q10_orders = PlanBuilder::scan(tables, {"orders.customer", "orders.orderdate"}, "o_ordinal");
+    q10_orders.filter(col("orders.orderdate") >= date("1993-10-01") && col("orders.orderdate") < date("1994-01-01"))
+        .join(q10_customers, "orders.customer", "c_ordinal");
+    auto q10_plan = PlanBuilder::scan(tables, {"lineitem.order", "lineitem.returnflag", "lineitem.extendedprice",
+                                               "lineitem.discount"});
+    q10_plan.filter(col("lineitem.returnflag") == lit("R"))
+        .join(q10_orders, "lineitem.order", "o_ordinal")
+        .project({
+            {"c_custkey", col("customer.custkey")},
+            {"c_name", col("customer.name")},
+            {"c_acctbal", col("customer.acctbal")},
+            {"c_phone", col("customer.phone")},
+            {"n_name", col("nation.name")},
+            {"volume", volume}
+        })
+        .aggregate({"c_custkey", "c_name", "c_acctbal", "c_phone", "n_name"}, {Aggregate::sum("volume", "revenue")})
+        .sort({{"revenue", false}})
+        .limit(20);
+    Table q10 = execute_join("Query 10", q10_plan);
+
+    end = std::chrono::high_resolution_clock::now();
+    auto query10_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+
+    std::cout << "Query time: " << query10_time.count() << "ms\n\n";
+    std::cout << "Results:\n";
+    for (size_t row = 0; row < q10.row_count(); ++row) {
+        std::cout << "  Customer: " << q10.find_column("c_custkey")->ints[row]
+                  << " (" << q10.find_column("c_name")->strings[row] << ")"
+                  << ", Revenue: " << q10.find_column("revenue")->doubles[row]
+                  << ", Balance: " << q10.find_column("c_acctbal")->doubles[row]
+                  << ", Nation: " << q10.find_column("n_name")->strings[row]
+                  << ", Phone: " << q10.find_column("c_phone")->strings[row] << "\n";
+    }
+
+    // ========================================================================
+    // Simple COUNT queries on each table
+    // ========================================================================
+    std::cout << "\n\n=== Table Row Counts ===\n";
 
     start = std::chrono::high_resolution_clock::now();
 
-    // Count entities by table (based on entity ID structure)
-    std::map<std::string, size_t> counts_by_table;
-    for (const auto& entity : all_entities) {
-        // Extract table name from first 8 bytes (hash of table name)
-        // For now, we'll use indexes to determine tables
-        if (index.get_string("lineitem.orderkey", entity)) {
-            counts_by_table["lineitem"]++;
-        } else if (index.get_string("orders.orderkey", entity)) {
-            counts_by_table["orders"]++;
-        } else if (index.get_string("customer.custkey", entity)) {
-            counts_by_table["customer"]++;
-        } else if (index.get_string("part.partkey", entity)) {
-            counts_by_table["part"]++;
-        } else if (index.get_string("partsupp.partkey", entity)) {
-            counts_by_table["partsupp"]++;
-        } else if (index.get_string("supplier.suppkey", entity)) {
-            counts_by_table["supplier"]++;
-        }
+    // Count entities by table from a columnar projection of each table's key:
+    // a key tag belongs to one table only, so its valid rows are that table's rows
+    const std::pair<const char*, const char*> table_keys[] = {
+        {"lineitem", "lineitem.orderkey"},
+        {"orders", "orders.orderkey"},
+        {"customer", "customer.custkey"},
+        {"part", "part.partkey"},
+        {"partsupp", "partsupp.partkey"},
+        {"supplier", "supplier.suppkey"},
+        {"nation", "nation.nationkey"},
+        {"region", "region.regionkey"}
+    };
+    std::vector<core::ColumnSpec> key_specs;
+    for (const auto& [table, key_tag] : table_keys) {
+        key_specs.push_back({key_tag});
     }
+    auto keys = projector.project_columns(key_specs);
 
     end = std::chrono::high_resolution_clock::now();
     auto count_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
 
-    for (const auto& [table, count] : counts_by_table) {
-        std::cout << "  " << table << ": " << count << " rows\n";
+    for (const auto& [table, key_tag] : table_keys) {
+        const auto* key = keys.find(key_tag);
+        size_t count = key ? key->count() : 0;
+        if (count == 0) {
+            std::cout << "  ✗ " << table << ": no rows hold " << key_tag << "\n";
+        } else {
+            std::cout << "  " << table << ": " << count << " rows\n";
+        }
     }
     std::cout << "\nCount time: " << count_time.count() << "ms\n";
 
@@ -248,9 +463,15 @@ int main(int argc, char* argv[]) {
     std::cout << "\n\n=== Performance Summary ===\n";
     std::cout << "Load time: " << load_time.count() << "ms\n";
     std::cout << "Index build time: " << index_time.count() << "ms\n";
+    std::cout << "Query 1 projection time: " << projection_time.count() << "ms\n";
     std::cout << "Query 1 time: " << query1_time.count() << "ms\n";
-    std::cout << "Query 3 time: " << query2_time.count() << "ms\n";
-    std::cout << "Total time: " << (load_time.count() + index_time.count() + query1_time.count() + query2_time.count()) << "ms\n";
+    std::cout << "Join projection time: " << join_projection_time.count() << "ms\n";
+    std::cout << "Query 3 time: " << query3_time.count() << "ms\n";
+    std::cout << "Query 5 time: " << query5_time.count() << "ms\n";
+    std::cout << "Query 10 time: " << query10_time.count() << "ms\n";
+    std::cout << "Total time: " << (load_time.count() + index_time.count() + projection_time.count()
+                                    + query1_time.count() + join_projection_time.count() + query3_time.count()
+                                    + query5_time.count() + query10_time.count()) << "ms\n";
 
     size_t mem_final = get_memory_usage_kb();
     std::cout << "\n=== Memory Summary ===\n";
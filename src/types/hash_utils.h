@@ -1,18 +1,30 @@
 #pragma once
 
 #include "types.h"
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <cstdint>
 #include <cstring>
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <utility>
 
-// Simple SHA-256-like hash implementation for content addressing
-// In production, use a proper crypto library (OpenSSL, libsodium, etc.)
+// Content addressing hashes (not cryptographic). Stores record which one
+// produced their AtomIds, so the algorithm can change without breaking
+// deduplication against atoms already on disk.
 
 namespace gtaf::types {
 
+/**
+ * @brief Hash function behind compute_content_hash() (persisted; values are stable)
+ */
+enum class HashAlgorithm : uint8_t {
+    Fnv1a = 1,     // Legacy: byte-serial FNV-1a, second half derived from the first
+    Wide128 = 2    // Default: 4-lane multiply-accumulate, independent 64-bit halves
+};
+
 namespace detail {
     // FNV-1a constants
     constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
@@ -60,6 +72,206 @@ namespace detail {
         uint64_t m_hash;
     };
 
+    // ---- Wide128 ----
+    //
+    // An XXH3-style design: input is consumed in 32-byte stripes, each
+    // 64-bit lane accumulating lo32(d ^ k) * hi32(d ^ k) plus its
+    // neighbour's raw word, with the key k changing per stripe so that
+    // reordered stripes do not collide. The four lanes are independent
+    // 32x32->64 multiplies (one AVX2 vpmuludq), and a scramble every
+    // kStripesPerScramble stripes keeps high bits flowing back down. The
+    // two output halves fold the 256-bit state with different keys.
+
+    constexpr uint64_t WIDE_PRIME32_1 = 0x9E3779B1ULL;
+    constexpr uint64_t WIDE_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t WIDE_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr uint64_t WIDE_PRIME64_3 = 0x165667B19E3779F9ULL;
+
+    // Key material: splitmix64 stream, generated at compile time
+    constexpr std::array<uint64_t, 32> make_wide_secret() {
+        std::array<uint64_t, 32> secret{};
+        uint64_t state = 0x243F6A8885A308D3ULL;   // Digits of pi
+        for (auto& word : secret) {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            word = z ^ (z >> 31);
+        }
+        return secret;
+    }
+    inline constexpr std::array<uint64_t, 32> WIDE_SECRET = make_wide_secret();
+
+    inline uint64_t read_u64(const uint8_t* data) noexcept {
+        uint64_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    // 1..8 bytes as a little-endian word, using overlapping fixed-size
+    // loads instead of a variable-length copy
+    inline uint64_t read_small(const uint8_t* data, size_t len) noexcept {
+        if (len >= 4) {
+            uint32_t first, last;
+            std::memcpy(&first, data, 4);
+            std::memcpy(&last, data + len - 4, 4);
+            return first | (static_cast<uint64_t>(last) << ((len - 4) * 8));
+        }
+        return static_cast<uint64_t>(data[0])
+             | static_cast<uint64_t>(data[len >> 1]) << ((len >> 1) * 8)
+             | static_cast<uint64_t>(data[len - 1]) << ((len - 1) * 8);
+    }
+
+    // Full 64x64->128 product, folded to 64 bits
+    inline uint64_t mul_fold(uint64_t a, uint64_t b) noexcept {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t product = static_cast<__uint128_t>(a) * b;
+        return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+        uint64_t lo_lo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+        uint64_t hi_lo = (a >> 32) * (b & 0xFFFFFFFF);
+        uint64_t lo_hi = (a & 0xFFFFFFFF) * (b >> 32);
+        uint64_t hi_hi = (a >> 32) * (b >> 32);
+        uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+        uint64_t high = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+        uint64_t low = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+        return low ^ high;
+#endif
+    }
+
+    inline uint64_t avalanche(uint64_t h) noexcept {
+        h ^= h >> 37;
+        h *= WIDE_PRIME64_3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    // Streaming Wide128 accumulator - NO ALLOCATIONS
+    class WideHasher {
+    public:
+        static constexpr size_t kLanes = 4;
+        static constexpr size_t kStripe = kLanes * sizeof(uint64_t);
+        static constexpr size_t kStripesPerScramble = 16;
+
+        void update(const void* data, size_t len) {
+            // Fast path, small enough to inline, for the short fields most
+            // atoms consist of. They are OR-ed into the buffer as shifted
+            // words: byte-wise stores read back as words would stall on
+            // store forwarding in finalize()
+            if (std::endian::native == std::endian::little && len - 1 < sizeof(uint64_t) &&
+                len < kStripe - m_buffered) {
+                insert_word(read_small(static_cast<const uint8_t*>(data), len), len);
+                m_buffered += len;
+                m_length += len;
+                return;
+            }
+            update_bytes(static_cast<const uint8_t*>(data), len);
+        }
+
+        // Length-prefixed, so adjacent strings cannot trade bytes
+        void update_string(const std::string& str) {
+            uint64_t length = str.size();
+            update(&length, sizeof(length));
+            update(str.data(), str.size());
+        }
+
+        std::pair<uint64_t, uint64_t> finalize() const {
+            const auto& k = WIDE_SECRET;
+            if (m_length < kStripe) {
+                // Whole input is in the zero-padded buffer: fold it directly
+                uint64_t w0 = m_words[0], w1 = m_words[1], w2 = m_words[2], w3 = m_words[3];
+                uint64_t lo = m_length * WIDE_PRIME64_1
+                            + mul_fold(w0 ^ k[0], w1 ^ k[1]) + mul_fold(w2 ^ k[2], w3 ^ k[3]);
+                uint64_t hi = ~m_length * WIDE_PRIME64_2
+                            + mul_fold(w0 ^ k[4], w3 ^ k[5]) + mul_fold(w1 ^ k[6], w2 ^ k[7]);
+                return {avalanche(lo), avalanche(hi)};
+            }
+
+            auto acc = m_acc;
+            size_t stripe = m_stripe;
+            if (m_buffered > 0) {
+                accumulate(acc, stripe, buffer());   // Zero padded; the length disambiguates
+            }
+
+            uint64_t lo = m_length * WIDE_PRIME64_1
+                        + mul_fold(acc[0] ^ k[20], acc[1] ^ k[21])
+                        + mul_fold(acc[2] ^ k[22], acc[3] ^ k[23]);
+            uint64_t hi = ~m_length * WIDE_PRIME64_2
+                        + mul_fold(acc[0] ^ k[24], acc[3] ^ k[25])
+                        + mul_fold(acc[1] ^ k[26], acc[2] ^ k[27]);
+            return {avalanche(lo), avalanche(hi)};
+        }
+
+    private:
+        using Lanes = std::array<uint64_t, kLanes>;
+
+        uint8_t* buffer() noexcept { return reinterpret_cast<uint8_t*>(m_words.data()); }
+        const uint8_t* buffer() const noexcept { return reinterpret_cast<const uint8_t*>(m_words.data()); }
+
+        // Place len bytes (as a little-endian word) at m_buffered; the
+        // caller guarantees they fit in the stripe
+        void insert_word(uint64_t value, size_t len) noexcept {
+            size_t index = m_buffered / sizeof(uint64_t);
+            size_t shift = (m_buffered % sizeof(uint64_t)) * 8;
+            m_words[index] |= value << shift;
+            if (shift != 0 && shift + len * 8 > 64) {
+                m_words[index + 1] |= value >> (64 - shift);
+            }
+        }
+
+        void update_bytes(const uint8_t* bytes, size_t len) {
+            m_length += len;
+            if (len < kStripe - m_buffered) {
+                if (len > 0) {
+                    std::memcpy(buffer() + m_buffered, bytes, len);
+                }
+                m_buffered += len;
+                return;
+            }
+
+            if (m_buffered > 0) {
+                size_t take = kStripe - m_buffered;
+                std::memcpy(buffer() + m_buffered, bytes, take);
+                bytes += take;
+                len -= take;
+                accumulate(m_acc, m_stripe, buffer());
+                m_words.fill(0);
+                m_buffered = 0;
+            }
+
+            // Whole stripes straight from the input
+            for (; len >= kStripe; bytes += kStripe, len -= kStripe) {
+                accumulate(m_acc, m_stripe, bytes);
+            }
+
+            std::memcpy(buffer(), bytes, len);
+            m_buffered = len;
+        }
+
+        static void accumulate(Lanes& acc, size_t& stripe, const uint8_t* data) noexcept {
+            const uint64_t* key = WIDE_SECRET.data() + stripe;
+            for (size_t i = 0; i < kLanes; ++i) {
+                uint64_t word = read_u64(data + i * sizeof(uint64_t));
+                uint64_t keyed = word ^ key[i];
+                acc[i ^ 1] += word;
+                acc[i] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+            }
+            if (++stripe == kStripesPerScramble) {
+                for (size_t i = 0; i < kLanes; ++i) {
+                    acc[i] ^= acc[i] >> 47;
+                    acc[i] ^= WIDE_SECRET[28 + i];
+                    acc[i] *= WIDE_PRIME32_1;
+                }
+                stripe = 0;
+            }
+        }
+
+        Lanes m_acc{WIDE_PRIME32_1, WIDE_PRIME64_1, WIDE_PRIME64_2, WIDE_PRIME64_3};
+        Lanes m_words{};            // Partial stripe; bytes past m_buffered are zero
+        size_t m_buffered = 0;
+        size_t m_stripe = 0;        // Stripes since the last scramble
+        uint64_t m_length = 0;
+    };
+
     // Legacy class for backwards compatibility
     class HashAccumulator {
     public:
@@ -82,6 +294,100 @@ namespace detail {
 
 } // namespace detail
 
+namespace detail {
+
+    // Feed (type_tag, variant index, value) to a hasher. The FNV-1a byte
+    // sequence is frozen: it defines the AtomIds of legacy stores.
+    template<typename Hasher>
+    void hash_content(Hasher& hasher, const std::string& type_tag, const AtomValue& value) {
+        // Hash the type tag first
+        hasher.update_string(type_tag);
+
+        // Hash the variant index (to distinguish types)
+        size_t variant_index = value.index();
+        hasher.update(&variant_index, sizeof(variant_index));
+
+        // Hash the value based on its type
+        std::visit([&hasher](auto&& arg) {
+            using T = std::decay_t<decltype(arg)>;
+
+            if constexpr (std::is_same_v<T, std::monostate>) {
+                // Nothing to hash for null
+            }
+            else if constexpr (std::is_same_v<T, bool>) {
+                uint8_t b = arg ? 1 : 0;
+                hasher.update(&b, sizeof(b));
+            }
+            else if constexpr (std::is_same_v<T, int64_t>) {
+                hasher.update(&arg, sizeof(arg));
+            }
+            else if constexpr (std::is_same_v<T, double>) {
+                hasher.update(&arg, sizeof(arg));
+            }
+            else if constexpr (std::is_same_v<T, std::string>) {
+                hasher.update_string(arg);
+            }
+            else if constexpr (std::is_same_v<T, Vector>) {
+                // Hash vector dimensions and values
+                size_t size = arg.size();
+                hasher.update(&size, sizeof(size));
+                hasher.update(arg.data(), arg.size() * sizeof(float));
+            }
+            else if constexpr (std::is_same_v<T, std::vector<uint8_t>>) {
+                // Hash blob size and content
+                size_t size = arg.size();
+                hasher.update(&size, sizeof(size));
+                hasher.update(arg.data(), arg.size());
+            }
+            else if constexpr (std::is_same_v<T, EdgeValue>) {
+                // Hash target entity and relation
+                hasher.update(arg.target.bytes.data(), arg.target.bytes.size());
+                hasher.update_string(arg.relation);
+            }
+        }, value);
+    }
+
+    inline AtomId fnv1a_content_hash(const std::string& type_tag, const AtomValue& value) {
+        StreamingHasher hasher;
+        hash_content(hasher, type_tag, value);
+
+        // Finalize to 64-bit hash, then extend to 128-bit
+        uint64_t hash1 = hasher.finalize();
+
+        // Create second hash by continuing to hash with a salt (no new hasher needed)
+        // This is faster than creating a new hasher object
+        uint64_t hash2 = hash1;
+        constexpr uint64_t salt = 0xDEADBEEFCAFEBABEULL;
+        // Mix hash1 with salt using FNV-1a continuation
+        hash2 ^= (salt & 0xFF); hash2 *= FNV_PRIME;
+        hash2 ^= ((salt >> 8) & 0xFF); hash2 *= FNV_PRIME;
+        hash2 ^= ((salt >> 16) & 0xFF); hash2 *= FNV_PRIME;
+        hash2 ^= ((salt >> 24) & 0xFF); hash2 *= FNV_PRIME;
+        hash2 ^= ((salt >> 32) & 0xFF); hash2 *= FNV_PRIME;
+        hash2 ^= ((salt >> 40) & 0xFF); hash2 *= FNV_PRIME;
+        hash2 ^= ((salt >> 48) & 0xFF); hash2 *= FNV_PRIME;
+        hash2 ^= ((salt >> 56) & 0xFF); hash2 *= FNV_PRIME;
+
+        // Combine into 128-bit AtomId
+        AtomId atom_id{};
+        std::memcpy(atom_id.bytes.data(), &hash1, sizeof(hash1));
+        std::memcpy(atom_id.bytes.data() + 8, &hash2, sizeof(hash2));
+        return atom_id;
+    }
+
+    inline AtomId wide_content_hash(const std::string& type_tag, const AtomValue& value) {
+        WideHasher hasher;
+        hash_content(hasher, type_tag, value);
+        auto [lo, hi] = hasher.finalize();
+
+        AtomId atom_id{};
+        std::memcpy(atom_id.bytes.data(), &lo, sizeof(lo));
+        std::memcpy(atom_id.bytes.data() + 8, &hi, sizeof(hi));
+        return atom_id;
+    }
+
+} // namespace detail
+
 /**
  * @brief Compute content-based hash for an AtomValue
  *
@@ -92,80 +398,15 @@ namespace detail {
  *
  * @param type_tag The semantic type of the atom (e.g., "user.name")
  * @param value The atom value to hash
+ * @param algorithm Hash function (a store must keep using the one its AtomIds came from)
  * @return 128-bit hash as AtomId
  */
-inline AtomId compute_content_hash(const std::string& type_tag, const AtomValue& value) {
-    detail::StreamingHasher hasher;
-
-    // Hash the type tag first
-    hasher.update_string(type_tag);
-
-    // Hash the variant index (to distinguish types)
-    size_t variant_index = value.index();
-    hasher.update(&variant_index, sizeof(variant_index));
-
-    // Hash the value based on its type
-    std::visit([&hasher](auto&& arg) {
-        using T = std::decay_t<decltype(arg)>;
-
-        if constexpr (std::is_same_v<T, std::monostate>) {
-            // Nothing to hash for null
-        }
-        else if constexpr (std::is_same_v<T, bool>) {
-            uint8_t b = arg ? 1 : 0;
-            hasher.update(&b, sizeof(b));
-        }
-        else if constexpr (std::is_same_v<T, int64_t>) {
-            hasher.update(&arg, sizeof(arg));
-        }
-        else if constexpr (std::is_same_v<T, double>) {
-            hasher.update(&arg, sizeof(arg));
-        }
-        else if constexpr (std::is_same_v<T, std::string>) {
-            hasher.update_string(arg);
-        }
-        else if constexpr (std::is_same_v<T, Vector>) {
-            // Hash vector dimensions and values
-            size_t size = arg.size();
-            hasher.update(&size, sizeof(size));
-            hasher.update(arg.data(), arg.size() * sizeof(float));
-        }
-        else if constexpr (std::is_same_v<T, std::vector<uint8_t>>) {
-            // Hash blob size and content
-            size_t size = arg.size();
-            hasher.update(&size, sizeof(size));
-            hasher.update(arg.data(), arg.size());
-        }
-        else if constexpr (std::is_same_v<T, EdgeValue>) {
-            // Hash target entity and relation
-            hasher.update(arg.target.bytes.data(), arg.target.bytes.size());
-            hasher.update_string(arg.relation);
-        }
-    }, value);
-
-    // Finalize to 64-bit hash, then extend to 128-bit
-    uint64_t hash1 = hasher.finalize();
-
-    // Create second hash by continuing to hash with a salt (no new hasher needed)
-    // This is faster than creating a new hasher object
-    uint64_t hash2 = hash1;
-    constexpr uint64_t salt = 0xDEADBEEFCAFEBABEULL;
-    // Mix hash1 with salt using FNV-1a continuation
-    hash2 ^= (salt & 0xFF); hash2 *= detail::FNV_PRIME;
-    hash2 ^= ((salt >> 8) & 0xFF); hash2 *= detail::FNV_PRIME;
-    hash2 ^= ((salt >> 16) & 0xFF); hash2 *= detail::FNV_PRIME;
-    hash2 ^= ((salt >> 24) & 0xFF); hash2 *= detail::FNV_PRIME;
-    hash2 ^= ((salt >> 32) & 0xFF); hash2 *= detail::FNV_PRIME;
-    hash2 ^= ((salt >> 40) & 0xFF); hash2 *= detail::FNV_PRIME;
-    hash2 ^= ((salt >> 48) & 0xFF); hash2 *= detail::FNV_PRIME;
-    hash2 ^= ((salt >> 56) & 0xFF); hash2 *= detail::FNV_PRIME;
-
-    // Combine into 128-bit AtomId
-    AtomId atom_id{};
-    std::memcpy(atom_id.bytes.data(), &hash1, sizeof(hash1));
-    std::memcpy(atom_id.bytes.data() + 8, &hash2, sizeof(hash2));
-
-    return atom_id;
+inline AtomId compute_content_hash(const std::string& type_tag, const AtomValue& value,
+                                   HashAlgorithm algorithm = HashAlgorithm::Wide128) {
+    if (algorithm == HashAlgorithm::Fnv1a) {
+        return detail::fnv1a_content_hash(type_tag, value);
+    }
+    return detail::wide_content_hash(type_tag, value);
 }
 
 /**
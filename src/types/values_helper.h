@@ -2,6 +2,9 @@
 
 #include "types.h"
 #include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
 
 namespace gtaf::types {
 
@@ -29,4 +32,86 @@ T get_value_or(const AtomValue& val, T fallback) {
     return fallback;
 }
 
-} // namespace gtaf::types
\ No newline at end of file
+/**
+ * @brief Parse an ISO-8601 date or date-time string into a Timestamp
+ *
+ * Accepts "YYYY-MM-DD", optionally followed by 'T' or ' ' and "HH:MM[:SS]";
+ * the whole string must match and name a real calendar day and time of day
+ * (leap years included, no leap seconds). Times are interpreted as UTC.
+ *
+ * @return Microseconds since epoch, or nullopt if the string is not a date
+ */
+inline std::optional<Timestamp> parse_timestamp(std::string_view text) {
+    auto digits = [&](size_t pos, size_t len, int& out) {
+        if (pos + len > text.size()) return false;
+        out = 0;
+        for (size_t i = pos; i < pos + len; ++i) {
+            if (text[i] < '0' || text[i] > '9') return false;
+            out = out * 10 + (text[i] - '0');
+        }
+        return true;
+    };
+
+    int y = 0, m = 0, d = 0, hh = 0, mm = 0, ss = 0;
+    if (!digits(0, 4, y) || text.size() < 10 || text[4] != '-' || text[7] != '-' ||
+        !digits(5, 2, m) || !digits(8, 2, d)) {
+        return std::nullopt;
+    }
+    const bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+    static constexpr int kDaysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (m < 1 || m > 12 || y < 1970 || d < 1 ||
+        d > kDaysInMonth[m - 1] + (m == 2 && leap ? 1 : 0)) {
+        return std::nullopt;
+    }
+    if (text.size() != 10 && text.size() != 16 && text.size() != 19) {
+        return std::nullopt;
+    }
+    if (text.size() > 10) {
+        if ((text[10] != 'T' && text[10] != ' ') || !digits(11, 2, hh) ||
+            text[13] != ':' || !digits(14, 2, mm)) {
+            return std::nullopt;
+        }
+        if (text.size() == 19 && (text[16] != ':' || !digits(17, 2, ss))) {
+            return std::nullopt;
+        }
+        if (hh > 23 || mm > 59 || ss > 59) {
+            return std::nullopt;
+        }
+    }
+
+    // Days since 1970-01-01 (civil-from-days inverse, proleptic Gregorian)
+    y -= m <= 2;
+    const int era = y / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153u * static_cast<unsigned>(m > 2 ? m - 3 : m + 9) + 2u) / 5u + static_cast<unsigned>(d) - 1u;
+    const unsigned doe = yoe * 365u + yoe / 4u - yoe / 100u + doy;
+    const int64_t days = static_cast<int64_t>(era) * 146097 + static_cast<int64_t>(doe) - 719468;
+
+    const int64_t seconds = days * 86400 + hh * 3600 + mm * 60 + ss;
+    return static_cast<Timestamp>(seconds) * 1000000ULL;
+}
+
+/**
+ * @brief Format the UTC date of a Timestamp as "YYYY-MM-DD"
+ */
+inline std::string format_date(Timestamp timestamp) {
+    // civil-from-days, proleptic Gregorian
+    const int64_t z = static_cast<int64_t>(timestamp / 86400000000ULL) + 719468;
+    const int64_t era = z / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460u + doe / 36524u - doe / 146096u) / 365u;
+    const unsigned doy = doe - (365u * yoe + yoe / 4u - yoe / 100u);
+    const unsigned mp = (5u * doy + 2u) / 153u;
+    const unsigned d = doy - (153u * mp + 2u) / 5u + 1u;
+    const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+    const int64_t y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+
+    std::string out = std::to_string(y) + "-00-00";
+    out[out.size() - 5] = static_cast<char>('0' + m / 10);
+    out[out.size() - 4] = static_cast<char>('0' + m % 10);
+    out[out.size() - 2] = static_cast<char>('0' + d / 10);
+    out[out.size() - 1] = static_cast<char>('0' + d % 10);
+    return out;
+}
+
+} // namespace gtaf::types